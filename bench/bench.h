@@ -0,0 +1,66 @@
+#ifndef FOOLGO_BENCH_BENCH_H_
+#define FOOLGO_BENCH_BENCH_H_
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <vector>
+
+#include "../src/board/full_board.h"
+#include "../src/board/position.h"
+#include "../src/board/zob_hasher.h"
+#include "../src/util/rand.h"
+
+namespace foolgo {
+
+// Every fixture is generated from this seed, so that runs of benchmarks are
+// comparable.
+const uint32_t BENCH_SEED = 1;
+
+template<BoardLen BOARD_LEN>
+void InitHasher() {
+  static bool is_initialized = false;
+  if (!is_initialized) {
+    ZobHasher<BOARD_LEN>::Init(BENCH_SEED);
+    is_initialized = true;
+  }
+}
+
+// Returns the moves of a random game, in which a pass is
+// POSITION_INDEX_PASS.
+template<BoardLen BOARD_LEN>
+std::vector<PositionIndex> RandomGameMoves(uint64_t stream = 0) {
+  InitHasher<BOARD_LEN>();
+  RandomEngine random_engine(BENCH_SEED, stream);
+  FullBoard<BOARD_LEN> full_board;
+  full_board.Init();
+  std::vector<PositionIndex> moves;
+
+  while (!full_board.IsEnd()) {
+    BitSet<BOARD_LEN> playable_bitset =
+        full_board.PlayableIndexBitSet(NextForce(full_board));
+    int playable_count = playable_bitset.count();
+    PositionIndex index = playable_count == 0 ? POSITION_INDEX_PASS :
+        playable_bitset.Select(random_engine.Uniform(playable_count - 1));
+    Play(&full_board, index);
+    moves.push_back(index);
+  }
+
+  return moves;
+}
+
+// Plays the first share of the moves of a random game on the board, which
+// is a middle game position if the share is about a half. The board should
+// not have been initialized.
+template<BoardLen BOARD_LEN>
+void PlayRandomGame(FullBoard<BOARD_LEN> *full_board, float share,
+                    uint64_t stream = 0) {
+  std::vector<PositionIndex> moves = RandomGameMoves<BOARD_LEN>(stream);
+  full_board->Init();
+  for (std::size_t i = 0; i < moves.size() * share; ++i) {
+    Play(full_board, moves[i]);
+  }
+}
+
+}
+
+#endif
@@ -0,0 +1,93 @@
+#include "../../src/board/full_board.h"
+
+#include <vector>
+
+#include "../bench.h"
+
+namespace foolgo {
+
+// Replays a random game, and restarts it once it ends.
+template<BoardLen BOARD_LEN>
+void BM_FullBoardPlayMove(benchmark::State &state) {
+  std::vector<PositionIndex> moves = RandomGameMoves<BOARD_LEN>();
+  FullBoard<BOARD_LEN> empty_board, full_board;
+  empty_board.Init();
+  full_board.Copy(empty_board);
+  std::size_t move_i = 0;
+
+  for (auto _ : state) {
+    if (move_i == moves.size()) {
+      state.PauseTiming();
+      full_board.Copy(empty_board);
+      move_i = 0;
+      state.ResumeTiming();
+    }
+    Play(&full_board, moves[move_i++]);
+  }
+}
+BENCHMARK_TEMPLATE(BM_FullBoardPlayMove, 9);
+BENCHMARK_TEMPLATE(BM_FullBoardPlayMove, 19);
+
+// Plays and undoes each move of a middle game position, as descents do.
+template<BoardLen BOARD_LEN>
+void BM_FullBoardPlayMoveWithUndo(benchmark::State &state) {
+  FullBoard<BOARD_LEN> full_board;
+  PlayRandomGame(&full_board, 0.5f);
+  std::vector<PositionIndex> indexes =
+      full_board.PlayableIndexes(NextForce(full_board));
+  std::size_t index_i = 0;
+
+  for (auto _ : state) {
+    PlayWithUndo(&full_board, indexes[index_i]);
+    full_board.Undo();
+    index_i = (index_i + 1) % indexes.size();
+  }
+}
+BENCHMARK_TEMPLATE(BM_FullBoardPlayMoveWithUndo, 9);
+BENCHMARK_TEMPLATE(BM_FullBoardPlayMoveWithUndo, 19);
+
+template<BoardLen BOARD_LEN>
+void BM_FullBoardCopy(benchmark::State &state) {
+  FullBoard<BOARD_LEN> full_board, copy;
+  PlayRandomGame(&full_board, 0.5f);
+
+  for (auto _ : state) {
+    copy.Copy(full_board);
+    benchmark::DoNotOptimize(&copy);
+  }
+}
+BENCHMARK_TEMPLATE(BM_FullBoardCopy, 9);
+BENCHMARK_TEMPLATE(BM_FullBoardCopy, 19);
+
+template<BoardLen BOARD_LEN>
+void BM_FullBoardPlayableIndexes(benchmark::State &state) {
+  FullBoard<BOARD_LEN> full_board;
+  PlayRandomGame(&full_board, 0.5f);
+  Force force = NextForce(full_board);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(full_board.PlayableIndexes(force));
+  }
+}
+BENCHMARK_TEMPLATE(BM_FullBoardPlayableIndexes, 9);
+BENCHMARK_TEMPLATE(BM_FullBoardPlayableIndexes, 19);
+
+// Checks each playable point of a middle game position in turn.
+template<BoardLen BOARD_LEN>
+void BM_FullBoardIsSuicide(benchmark::State &state) {
+  FullBoard<BOARD_LEN> full_board;
+  PlayRandomGame(&full_board, 0.5f);
+  Force force = NextForce(full_board);
+  std::vector<PositionIndex> indexes = full_board.PlayableIndexes(force);
+  std::size_t index_i = 0;
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        full_board.IsSuicide(Move(force, indexes[index_i])));
+    index_i = (index_i + 1) % indexes.size();
+  }
+}
+BENCHMARK_TEMPLATE(BM_FullBoardIsSuicide, 9);
+BENCHMARK_TEMPLATE(BM_FullBoardIsSuicide, 19);
+
+}
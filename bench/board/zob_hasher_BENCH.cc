@@ -0,0 +1,44 @@
+#include "../../src/board/zob_hasher.h"
+
+#include <vector>
+
+#include "../../src/board/board_difference.h"
+#include "../bench.h"
+
+namespace foolgo {
+
+template<BoardLen BOARD_LEN>
+void BM_ZobHasherGetHash(benchmark::State &state) {
+  FullBoard<BOARD_LEN> full_board;
+  PlayRandomGame(&full_board, 0.5f);
+  const ZobHasher<BOARD_LEN> &hasher = *ZobHasher<BOARD_LEN>::InstancePtr();
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(hasher.GetHash(full_board));
+  }
+}
+BENCHMARK_TEMPLATE(BM_ZobHasherGetHash, 9);
+BENCHMARK_TEMPLATE(BM_ZobHasherGetHash, 19);
+
+// Updates the hash by the difference of a move capturing no pieces.
+template<BoardLen BOARD_LEN>
+void BM_ZobHasherGetHashIncremental(benchmark::State &state) {
+  FullBoard<BOARD_LEN> full_board;
+  PlayRandomGame(&full_board, 0.5f);
+  const ZobHasher<BOARD_LEN> &hasher = *ZobHasher<BOARD_LEN>::InstancePtr();
+  PositionIndex index =
+      full_board.PlayableIndexes(NextForce(full_board)).front();
+  BoardDifference board_difference;
+  board_difference.Init(full_board.LastForce(), full_board.KoIndex());
+  board_difference.ModifyToCurrentState(-1, index, false,
+                                        std::vector<PositionIndex>());
+  HashKey hash_key = full_board.HashKey();
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(hasher.GetHash(hash_key, board_difference));
+  }
+}
+BENCHMARK_TEMPLATE(BM_ZobHasherGetHashIncremental, 9);
+BENCHMARK_TEMPLATE(BM_ZobHasherGetHashIncremental, 19);
+
+}
@@ -0,0 +1,42 @@
+#include "../../src/game/monte_carlo_game.h"
+
+#include "../bench.h"
+
+namespace foolgo {
+
+// A whole game between random players from the empty board, as the game
+// class runs it.
+template<BoardLen BOARD_LEN>
+void BM_MonteCarloGameRun(benchmark::State &state) {
+  InitHasher<BOARD_LEN>();
+  FullBoard<BOARD_LEN> full_board;
+  full_board.Init();
+  uint32_t seed = BENCH_SEED;
+
+  for (auto _ : state) {
+    MonteCarloGame<BOARD_LEN> game(full_board, seed++);
+    game.Run();
+  }
+}
+BENCHMARK_TEMPLATE(BM_MonteCarloGameRun, 9);
+BENCHMARK_TEMPLATE(BM_MonteCarloGameRun, 13);
+BENCHMARK_TEMPLATE(BM_MonteCarloGameRun, 19);
+
+// A playout of the search from the empty board.
+template<BoardLen BOARD_LEN>
+void BM_RunRandomPlayout(benchmark::State &state) {
+  InitHasher<BOARD_LEN>();
+  FullBoard<BOARD_LEN> empty_board, playout_board;
+  empty_board.Init();
+  RandomEngine random_engine(BENCH_SEED);
+
+  for (auto _ : state) {
+    playout_board.Copy(empty_board);
+    RunRandomPlayout(&playout_board, &random_engine);
+  }
+}
+BENCHMARK_TEMPLATE(BM_RunRandomPlayout, 9);
+BENCHMARK_TEMPLATE(BM_RunRandomPlayout, 13);
+BENCHMARK_TEMPLATE(BM_RunRandomPlayout, 19);
+
+}
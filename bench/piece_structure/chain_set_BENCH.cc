@@ -0,0 +1,58 @@
+#include "../../src/piece_structure/chain_set.h"
+
+#include "../bench.h"
+
+namespace foolgo {
+namespace piece_structure {
+
+namespace {
+
+// Two black chains on the first row, which are separated by the middle
+// point.
+template<BoardLen BOARD_LEN>
+void InitSeparatedChains(ChainSet<BOARD_LEN> *chain_set) {
+  auto &calculator = PstionAndIndxCcltr<BOARD_LEN>::Ins();
+  for (BoardLen x = 0; x < BOARD_LEN; ++x) {
+    if (x == BOARD_LEN / 2) {
+      continue;
+    }
+    PositionIndex index = calculator.GetIndex(Position(x, 0));
+    chain_set->AddPiece(index, BLACK_FORCE);
+  }
+}
+
+}
+
+template<BoardLen BOARD_LEN>
+void BM_ChainSetCopy(benchmark::State &state) {
+  ChainSet<BOARD_LEN> chain_set, copy;
+  InitSeparatedChains(&chain_set);
+
+  for (auto _ : state) {
+    copy.Copy(chain_set);
+    benchmark::DoNotOptimize(&copy);
+  }
+}
+BENCHMARK_TEMPLATE(BM_ChainSetCopy, 9);
+BENCHMARK_TEMPLATE(BM_ChainSetCopy, 19);
+
+// Adds the piece merging both chains, which includes restoring the chains by
+// a copy, whose cost is measured by BM_ChainSetCopy.
+template<BoardLen BOARD_LEN>
+void BM_ChainSetMergeLists(benchmark::State &state) {
+  ChainSet<BOARD_LEN> chain_set, merged;
+  InitSeparatedChains(&chain_set);
+  PositionIndex index = PstionAndIndxCcltr<BOARD_LEN>::Ins().GetIndex(
+      Position(BOARD_LEN / 2, 0));
+
+  for (auto _ : state) {
+    merged.Copy(chain_set);
+    merged.AddPiece(index, BLACK_FORCE);
+    benchmark::DoNotOptimize(&merged);
+  }
+}
+BENCHMARK_TEMPLATE(BM_ChainSetMergeLists, 9);
+BENCHMARK_TEMPLATE(BM_ChainSetMergeLists, 19);
+
+}
+}
@@ -0,0 +1,89 @@
+#include "../../src/player/transposition_table.h"
+
+#include <memory>
+#include <vector>
+
+#include "../bench.h"
+
+namespace foolgo {
+
+namespace {
+
+const BoardLen BENCH_BOARD_LEN = 9;
+// Positions inserted by each thread.
+const int POSITION_COUNT = 4096;
+const std::size_t TABLE_MEMORY_BYTES = 64 << 20;
+
+typedef FullBoard<BENCH_BOARD_LEN> BenchBoard;
+
+// The table shared by threads of a run, which is created before the threads
+// start.
+TranspositionTable<BENCH_BOARD_LEN> *table_ptr = nullptr;
+
+void CreateTable(const benchmark::State &state) {
+  table_ptr = new TranspositionTable<BENCH_BOARD_LEN>(TABLE_MEMORY_BYTES);
+}
+
+void DeleteTable(const benchmark::State &state) {
+  delete table_ptr;
+  table_ptr = nullptr;
+}
+
+// Positions of random games, which are distinct among threads.
+std::vector<std::unique_ptr<BenchBoard>> RandomPositions(int thread_index) {
+  std::vector<std::unique_ptr<BenchBoard>> positions;
+  positions.reserve(POSITION_COUNT);
+
+  for (uint64_t game_i = 0; positions.size() < POSITION_COUNT; ++game_i) {
+    std::vector<PositionIndex> moves = RandomGameMoves<BENCH_BOARD_LEN>(
+        (static_cast<uint64_t>(thread_index) << 32) | game_i);
+    BenchBoard board;
+    board.Init();
+    for (std::size_t i = 0;
+        i < moves.size() && positions.size() < POSITION_COUNT; ++i) {
+      Play(&board, moves[i]);
+      // Openings are shared by games.
+      if (i >= 8) {
+        positions.push_back(std::unique_ptr<BenchBoard>(new BenchBoard));
+        positions.back()->Copy(board);
+      }
+    }
+  }
+
+  return positions;
+}
+
+}
+
+// Each iteration inserts a position not in the table.
+void BM_TranspositionTableInsert(benchmark::State &state) {
+  std::vector<std::unique_ptr<BenchBoard>> positions =
+      RandomPositions(state.thread_index());
+  std::size_t position_i = 0;
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        table_ptr->Insert(*positions[position_i++], NodeRecord(1, 0.5f)));
+  }
+}
+BENCHMARK(BM_TranspositionTableInsert)->Setup(CreateTable)
+    ->Teardown(DeleteTable)->Iterations(POSITION_COUNT)->ThreadRange(1, 8)
+    ->UseRealTime();
+
+void BM_TranspositionTableGet(benchmark::State &state) {
+  std::vector<std::unique_ptr<BenchBoard>> positions =
+      RandomPositions(state.thread_index());
+  for (const auto &position : positions) {
+    table_ptr->Insert(*position, NodeRecord(1, 0.5f));
+  }
+  std::size_t position_i = 0;
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(table_ptr->Get(*positions[position_i]));
+    position_i = (position_i + 1) % positions.size();
+  }
+}
+BENCHMARK(BM_TranspositionTableGet)->Setup(CreateTable)
+    ->Teardown(DeleteTable)->ThreadRange(1, 8)->UseRealTime();
+
+}
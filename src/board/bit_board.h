@@ -0,0 +1,402 @@
+#ifndef FOOLGO_SRC_BOARD_BIT_BOARD_H_
+#define FOOLGO_SRC_BOARD_BIT_BOARD_H_
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#include "../util/bitset_util.h"
+#include "position.h"
+
+namespace foolgo {
+
+/**
+ * A set of points of the board, whose bit i stands for the point of index i,
+ * i.e. bit x + y * BOARD_LEN stands for the point (x, y). Besides the
+ * interface of std::bitset used by the board, it supplies shifts towards the
+ * four orientations that do not wrap around board edges, so liberties and
+ * regions are computed by whole words.
+ *
+ * Words are padded to whole SIMD registers, and bitwise operations take one
+ * AVX2 or NEON instruction per register when the target supports it, which is
+ * to say when built with -mavx2 or for ARMv8. Bits
+ * beyond the board are always zero.
+ */
+template<BoardLen BOARD_LEN>
+class BitBoard {
+ public:
+  static const int WORD_COUNT = (BoardLenSquare<BOARD_LEN>() + 63) / 64;
+#if defined(__AVX2__)
+  static const int LANE_WORD_COUNT = 4;
+#elif defined(__ARM_NEON)
+  static const int LANE_WORD_COUNT = 2;
+#else
+  static const int LANE_WORD_COUNT = 1;
+#endif
+  static const int STORED_WORD_COUNT = (WORD_COUNT + LANE_WORD_COUNT - 1)
+      / LANE_WORD_COUNT * LANE_WORD_COUNT;
+
+  class Iterator;
+
+  BitBoard() {
+    reset();
+  }
+  // Reads WORD_COUNT words as given by Words(), whose bits beyond the board
+  // should be zero.
+  explicit BitBoard(const uint64_t *words) {
+    reset();
+    for (int i = 0; i < WORD_COUNT; ++i) {
+      words_[i] = words[i];
+    }
+  }
+
+  bool operator[](PositionIndex index) const {
+    return test(index);
+  }
+  bool test(PositionIndex index) const {
+    assert(index >= 0 && index < BoardLenSquare<BOARD_LEN>());
+    return (words_[index / 64] >> (index % 64)) & 1;
+  }
+
+  BitBoard &set() {
+    *this = GetMasks().board;
+    return *this;
+  }
+  BitBoard &set(PositionIndex index) {
+    assert(index >= 0 && index < BoardLenSquare<BOARD_LEN>());
+    words_[index / 64] |= uint64_t(1) << (index % 64);
+    return *this;
+  }
+  BitBoard &set(PositionIndex index, bool value) {
+    return value ? set(index) : reset(index);
+  }
+  BitBoard &reset() {
+    for (int i = 0; i < STORED_WORD_COUNT; ++i) {
+      words_[i] = 0;
+    }
+    return *this;
+  }
+  BitBoard &reset(PositionIndex index) {
+    assert(index >= 0 && index < BoardLenSquare<BOARD_LEN>());
+    words_[index / 64] &= ~(uint64_t(1) << (index % 64));
+    return *this;
+  }
+
+  int count() const;
+  bool any() const;
+  bool none() const {
+    return !any();
+  }
+
+  BitBoard &operator&=(const BitBoard &b);
+  BitBoard &operator|=(const BitBoard &b);
+  BitBoard &operator^=(const BitBoard &b);
+  // Removes the points of b.
+  BitBoard &AndNot(const BitBoard &b);
+
+  BitBoard operator&(const BitBoard &b) const {
+    return BitBoard(*this) &= b;
+  }
+  BitBoard operator|(const BitBoard &b) const {
+    return BitBoard(*this) |= b;
+  }
+  BitBoard operator^(const BitBoard &b) const {
+    return BitBoard(*this) ^= b;
+  }
+  BitBoard operator~() const {
+    return GetMasks().board ^ *this;
+  }
+  bool operator==(const BitBoard &b) const;
+  bool operator!=(const BitBoard &b) const {
+    return !(*this == b);
+  }
+
+  // Points moved one step towards an orientation, dropping those moved off
+  // the board.
+  BitBoard North() const;
+  BitBoard South() const;
+  BitBoard East() const;
+  BitBoard West() const;
+  // The points and their adjacent points.
+  BitBoard Dilate() const {
+    return *this | North() | South() | East() | West();
+  }
+  // Points not in the set but adjacent to it.
+  BitBoard Adjacent() const {
+    return BitBoard(Dilate()).AndNot(*this);
+  }
+  // Points of mask connected to points of the set through mask.
+  BitBoard FloodFill(const BitBoard &mask) const;
+
+  // Returns the index of the nth one, counting from zero.
+  PositionIndex Select(int n) const;
+  std::vector<PositionIndex> Indexes() const;
+
+  Iterator begin() const {
+    return Iterator(words_, 0);
+  }
+  Iterator end() const {
+    return Iterator(words_, WORD_COUNT);
+  }
+
+  const uint64_t *Words() const {
+    return words_;
+  }
+
+ private:
+  struct Masks;
+
+  // Not over aligned, since boards are allocated by new, which guarantees no
+  // more than the alignment of max_align_t before C++17.
+  uint64_t words_[STORED_WORD_COUNT];
+
+  static const Masks &GetMasks();
+
+  // Moves bits towards higher or lower indexes, by less than 64.
+  BitBoard ShiftUp(int shift) const;
+  BitBoard ShiftDown(int shift) const;
+};
+
+template<BoardLen BOARD_LEN>
+using BitSet = BitBoard<BOARD_LEN>;
+
+// Iterates over indexes of ones in increasing order.
+template<BoardLen BOARD_LEN>
+class BitBoard<BOARD_LEN>::Iterator {
+ public:
+  Iterator(const uint64_t *words, int word_index)
+      : words_(words), word_index_(word_index),
+        word_(word_index < WORD_COUNT ? words[word_index] : 0) {
+    SkipEmptyWords();
+  }
+
+  PositionIndex operator*() const {
+    return word_index_ * 64 + __builtin_ctzll(word_);
+  }
+  Iterator &operator++() {
+    word_ &= word_ - 1;
+    SkipEmptyWords();
+    return *this;
+  }
+  bool operator!=(const Iterator &iterator) const {
+    return word_index_ != iterator.word_index_ || word_ != iterator.word_;
+  }
+
+ private:
+  const uint64_t *words_;
+  int word_index_;
+  uint64_t word_;
+
+  void SkipEmptyWords() {
+    while (word_ == 0 && word_index_ < WORD_COUNT) {
+      if (++word_index_ < WORD_COUNT) {
+        word_ = words_[word_index_];
+      }
+    }
+  }
+};
+
+template<BoardLen BOARD_LEN>
+struct BitBoard<BOARD_LEN>::Masks {
+  BitBoard board;
+  BitBoard not_first_column;
+  BitBoard not_last_column;
+
+  Masks();
+};
+
+template<BoardLen BOARD_LEN>
+BitBoard<BOARD_LEN>::Masks::Masks() {
+  for (PositionIndex i = 0; i < BoardLenSquare<BOARD_LEN>(); ++i) {
+    board.set(i);
+    if (i % BOARD_LEN != 0) {
+      not_first_column.set(i);
+    }
+    if (i % BOARD_LEN != BOARD_LEN - 1) {
+      not_last_column.set(i);
+    }
+  }
+}
+
+template<BoardLen BOARD_LEN>
+const typename BitBoard<BOARD_LEN>::Masks &BitBoard<BOARD_LEN>::GetMasks() {
+  static const Masks masks;
+  return masks;
+}
+
+template<BoardLen BOARD_LEN>
+int BitBoard<BOARD_LEN>::count() const {
+  int result = 0;
+  for (int i = 0; i < WORD_COUNT; ++i) {
+    result += __builtin_popcountll(words_[i]);
+  }
+  return result;
+}
+
+template<BoardLen BOARD_LEN>
+bool BitBoard<BOARD_LEN>::any() const {
+  uint64_t result = 0;
+  for (int i = 0; i < WORD_COUNT; ++i) {
+    result |= words_[i];
+  }
+  return result != 0;
+}
+
+#if defined(__AVX2__)
+#define FOOLGO_BIT_BOARD_OPERATION(name, scalar_op, simd_op) \
+template<BoardLen BOARD_LEN> \
+BitBoard<BOARD_LEN> &BitBoard<BOARD_LEN>::name(const BitBoard &b) { \
+  for (int i = 0; i < STORED_WORD_COUNT; i += LANE_WORD_COUNT) { \
+    __m256i x = _mm256_loadu_si256( \
+        reinterpret_cast<const __m256i *>(words_ + i)); \
+    __m256i y = _mm256_loadu_si256( \
+        reinterpret_cast<const __m256i *>(b.words_ + i)); \
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(words_ + i), \
+                        simd_op(x, y)); \
+  } \
+  return *this; \
+}
+#define FOOLGO_AND_NOT(x, y) _mm256_andnot_si256(y, x)
+#define FOOLGO_AND _mm256_and_si256
+#define FOOLGO_OR _mm256_or_si256
+#define FOOLGO_XOR _mm256_xor_si256
+#elif defined(__ARM_NEON)
+#define FOOLGO_BIT_BOARD_OPERATION(name, scalar_op, simd_op) \
+template<BoardLen BOARD_LEN> \
+BitBoard<BOARD_LEN> &BitBoard<BOARD_LEN>::name(const BitBoard &b) { \
+  for (int i = 0; i < STORED_WORD_COUNT; i += LANE_WORD_COUNT) { \
+    uint64x2_t x = vld1q_u64(words_ + i); \
+    uint64x2_t y = vld1q_u64(b.words_ + i); \
+    vst1q_u64(words_ + i, simd_op(x, y)); \
+  } \
+  return *this; \
+}
+#define FOOLGO_AND_NOT vbicq_u64
+#define FOOLGO_AND vandq_u64
+#define FOOLGO_OR vorrq_u64
+#define FOOLGO_XOR veorq_u64
+#else
+#define FOOLGO_BIT_BOARD_OPERATION(name, scalar_op, simd_op) \
+template<BoardLen BOARD_LEN> \
+BitBoard<BOARD_LEN> &BitBoard<BOARD_LEN>::name(const BitBoard &b) { \
+  for (int i = 0; i < STORED_WORD_COUNT; ++i) { \
+    words_[i] = words_[i] scalar_op b.words_[i]; \
+  } \
+  return *this; \
+}
+#define FOOLGO_AND_NOT
+#define FOOLGO_AND
+#define FOOLGO_OR
+#define FOOLGO_XOR
+#endif
+
+FOOLGO_BIT_BOARD_OPERATION(operator&=, &, FOOLGO_AND)
+FOOLGO_BIT_BOARD_OPERATION(operator|=, |, FOOLGO_OR)
+FOOLGO_BIT_BOARD_OPERATION(operator^=, ^, FOOLGO_XOR)
+FOOLGO_BIT_BOARD_OPERATION(AndNot, & ~, FOOLGO_AND_NOT)
+
+#undef FOOLGO_BIT_BOARD_OPERATION
+#undef FOOLGO_AND_NOT
+#undef FOOLGO_AND
+#undef FOOLGO_OR
+#undef FOOLGO_XOR
+
+template<BoardLen BOARD_LEN>
+bool BitBoard<BOARD_LEN>::operator==(const BitBoard &b) const {
+  uint64_t difference = 0;
+  for (int i = 0; i < WORD_COUNT; ++i) {
+    difference |= words_[i] ^ b.words_[i];
+  }
+  return difference == 0;
+}
+
+template<BoardLen BOARD_LEN>
+BitBoard<BOARD_LEN> BitBoard<BOARD_LEN>::ShiftUp(int shift) const {
+  assert(shift > 0 && shift < 64);
+  BitBoard result;
+  result.words_[0] = words_[0] << shift;
+  for (int i = 1; i < WORD_COUNT; ++i) {
+    result.words_[i] = (words_[i] << shift) | (words_[i - 1] >> (64 - shift));
+  }
+  return result;
+}
+
+template<BoardLen BOARD_LEN>
+BitBoard<BOARD_LEN> BitBoard<BOARD_LEN>::ShiftDown(int shift) const {
+  assert(shift > 0 && shift < 64);
+  BitBoard result;
+  for (int i = 0; i < WORD_COUNT - 1; ++i) {
+    result.words_[i] = (words_[i] >> shift) | (words_[i + 1] << (64 - shift));
+  }
+  result.words_[WORD_COUNT - 1] = words_[WORD_COUNT - 1] >> shift;
+  return result;
+}
+
+template<BoardLen BOARD_LEN>
+inline BitBoard<BOARD_LEN> BitBoard<BOARD_LEN>::North() const {
+  return ShiftDown(BOARD_LEN);
+}
+
+template<BoardLen BOARD_LEN>
+inline BitBoard<BOARD_LEN> BitBoard<BOARD_LEN>::South() const {
+  return ShiftUp(BOARD_LEN) &= GetMasks().board;
+}
+
+template<BoardLen BOARD_LEN>
+inline BitBoard<BOARD_LEN> BitBoard<BOARD_LEN>::East() const {
+  return ShiftUp(1) &= GetMasks().not_first_column;
+}
+
+template<BoardLen BOARD_LEN>
+inline BitBoard<BOARD_LEN> BitBoard<BOARD_LEN>::West() const {
+  return (*this & GetMasks().not_first_column).ShiftDown(1);
+}
+
+template<BoardLen BOARD_LEN>
+BitBoard<BOARD_LEN> BitBoard<BOARD_LEN>::FloodFill(
+    const BitBoard &mask) const {
+  BitBoard current = *this & mask;
+
+  while (true) {
+    BitBoard next = current.Dilate() &= mask;
+    if (next == current) {
+      return current;
+    }
+    current = next;
+  }
+}
+
+template<BoardLen BOARD_LEN>
+PositionIndex BitBoard<BOARD_LEN>::Select(int n) const {
+  assert(count() > n);
+
+  for (int i = 0;; ++i) {
+    int word_count = __builtin_popcountll(words_[i]);
+    if (n < word_count) {
+      return i * 64 + util::SelectInWord(words_[i], n);
+    }
+    n -= word_count;
+  }
+}
+
+template<BoardLen BOARD_LEN>
+std::vector<PositionIndex> BitBoard<BOARD_LEN>::Indexes() const {
+  std::vector<PositionIndex> indexes;
+  indexes.reserve(count());
+
+  for (PositionIndex index : *this) {
+    indexes.push_back(index);
+  }
+
+  return indexes;
+}
+
+}
+
+#endif
@@ -1,9 +1,8 @@
 #ifndef FOOLGO_SRC_BOARD_BOARD_DIFFERENCE_H_
 #define FOOLGO_SRC_BOARD_BOARD_DIFFERENCE_H_
 
-#include <vector>
-
 #include "../def.h"
+#include "../util/fixed_vector.h"
 #include "force.h"
 #include "position.h"
 
@@ -31,10 +30,12 @@ class BoardDifference {
   BoardDifference() = default;
   ~BoardDifference() = default;
   void Init(Force last_force, PositionIndex ko_position_index);
-  void ModifyToCurrentState(
-      PositionIndex ko_position_index, PositionIndex move_position_index,
-      bool is_last_move_suicide,
-      const std::vector<PositionIndex> &removed_pieces_index);
+  // The removed pieces are a container of PositionIndex.
+  template<typename Indexes>
+  void ModifyToCurrentState(PositionIndex ko_position_index,
+                            PositionIndex move_position_index,
+                            bool is_last_move_suicide,
+                            const Indexes &removed_pieces_indexes);
 
   const Difference<PositionIndex> &KoChng() const {
     return ko_index_difference_;
@@ -42,14 +43,18 @@ class BoardDifference {
   const Difference<Force> &LastForceChng() const {
     return last_force_difference_;
   }
-  const std::vector<DifferenceWithIndex> &PointsChng() const {
+  // The removed pieces and the moved one, of no more than the largest area.
+  typedef util::FixedVector<DifferenceWithIndex,
+                            BoardLenSquare<MAX_BOARD_LEN>() + 1> PointChanges;
+
+  const PointChanges &PointsChng() const {
     return indexes_difference_;
   }
 
  private:
   Difference<PositionIndex> ko_index_difference_;
   Difference<Force> last_force_difference_;
-  std::vector<DifferenceWithIndex> indexes_difference_;
+  PointChanges indexes_difference_;
 
   DISALLOW_COPY_AND_ASSIGN_AND_MOVE(BoardDifference)
 };
@@ -60,6 +65,32 @@ inline void BoardDifference::Init(Force last_force,
   last_force_difference_.old_state = last_force;
 }
 
+template<typename Indexes>
+void BoardDifference::ModifyToCurrentState(
+    PositionIndex ko_position_index, PositionIndex move_position_index,
+    bool is_last_move_suicide, const Indexes &removed_pieces_indexes) {
+  last_force_difference_.current_state = OppositeForce(
+      last_force_difference_.old_state);
+  ko_index_difference_.current_state = ko_position_index;
+  indexes_difference_.clear();
+
+  PointState removed_pieces_color =
+      is_last_move_suicide ?
+          last_force_difference_.current_state :
+          last_force_difference_.old_state;
+
+  for (PositionIndex removed_index : removed_pieces_indexes) {
+    DifferenceWithIndex difference;
+    difference.Init(removed_index, removed_pieces_color, EMPTY_POINT);
+    indexes_difference_.push_back(difference);
+  }
+
+  DifferenceWithIndex move_difference;
+  move_difference.Init(move_position_index, EMPTY_POINT,
+                       last_force_difference_.current_state);
+  indexes_difference_.push_back(move_difference);
+}
+
 }
 
 #endif
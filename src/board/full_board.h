@@ -1,25 +1,28 @@
 #ifndef FOOLGO_SRC_BOARD_FULL_BOARD_H_
 #define FOOLGO_SRC_BOARD_FULL_BOARD_H_
 
-#include <functional>
+#include <algorithm>
 #include <array>
-#include <bitset>
 #include <cassert>
 #include <cstddef>
+#include <functional>
 #include <ostream>
 #include <vector>
 
 #include "def.h"
-#include "util/bitset_util.h"
-#include "util/vector_util.h"
+#include "util/fixed_vector.h"
+#include "util/trace.h"
 #include "piece_structure/chain_set.h"
 #include "piece_structure/eye_set.h"
+#include "bit_board.h"
 #include "board.h"
 #include "board_difference.h"
 #include "force.h"
 #include "full_board_hasher.h"
+#include "pattern.h"
 #include "pos_cal.h"
 #include "position.h"
+#include "symmetry.h"
 #include "zob_hasher.h"
 
 namespace foolgo {
@@ -52,6 +55,9 @@ std::string ForceAndPositionIndexToString(
 template<BoardLen BOARD_LEN>
 class FullBoard : private Board<BOARD_LEN> {
  public:
+  static_assert(BOARD_LEN <= MAX_BOARD_LEN,
+                "Board differences are bounded by the largest area.");
+
   static const PositionIndex NONE = -1;
 
   FullBoard() : ko_indx_(-1), last_force_(WHITE_FORCE), black_pieces_count_(0),
@@ -77,13 +83,83 @@ class FullBoard : private Board<BOARD_LEN> {
     return ko_indx_;
   }
 
+  // The index of the last move, or POSITION_INDEX_PASS after a pass or on
+  // the initial board.
+  PositionIndex LastMoveIndex() const {
+    return last_move_index_;
+  }
+
+  // The air count of the chain of the piece at the index, capped by the max,
+  // which is cheaper to count if it is small.
+  piece_structure::AirCount ChainAirCount(PositionIndex indx,
+      piece_structure::AirCount max_air_count = BoardLenSquare<BOARD_LEN>())
+      const {
+    return chain_set_.GetAirCount(indx, max_air_count);
+  }
+  // Identifies the chain of the piece at the index until it changes.
+  PositionIndex ChainHead(PositionIndex indx) const {
+    return chain_set_.GetChainHead(indx);
+  }
+  // Tells in O(1) whether the chain of the piece at the index has one air,
+  // which is cheaper than counting its airs.
+  bool IsChainInAtari(PositionIndex indx) const {
+    return chain_set_.IsInAtari(indx);
+  }
+  // The only air of the chain of the piece at the index, which should be in
+  // atari.
+  PositionIndex ChainLastAir(PositionIndex indx) const {
+    return chain_set_.GetLastAir(indx);
+  }
+
+  // The states around the point, which are kept up to date by every change
+  // of points.
+  PatternCode GetPatternCode(PositionIndex indx) const {
+    return pattern_codes_[indx];
+  }
+
+  const BitSet<BOARD_LEN> &PointBitSet(PointState point_state) const {
+    return point_bitsets_[point_state];
+  }
+
+  // Pieces and real eyes of the force, which are maintained by moves, thus
+  // are cheap to count at the end of a playout. It equals the area of the
+  // force when every empty point is a real eye.
+  PositionIndex Region(Force force) const {
+    return point_bitsets_[force].count()
+        + eye_states_array_[force].RealCount();
+  }
   PositionIndex BlackRegion() const {
     return black_pieces_count_ + eye_states_array_[BLACK_FORCE].RealCount();
   }
+  // Real eyes of the force, which are maintained by moves.
+  const BitSet<BOARD_LEN> &RealEyeBitSet(Force force) const {
+    return eye_states_array_[force].RealEyeBitSet();
+  }
+  // The area by Chinese rules: pieces of the force, and empty points
+  // reaching no pieces but the force's. Dead pieces are not removed.
+  PositionIndex Area(Force force) const;
 
   foolgo::HashKey HashKey() const {
     return hash_key_;
   }
+  // Returns the hash key of the board after the move, which should not be a
+  // suicide, without playing it.
+  foolgo::HashKey ChildHashKey(const Move &move) const;
+
+  // Keeps the keys of all the symmetries up to date with each move, so that
+  // the canonical key costs only comparisons. Otherwise they are computed
+  // from the board when asked for. Copy does not change the setting.
+  void SetKeepsSymmetricHashKeys(bool keeps_symmetric_hash_keys);
+  // The key of the board moved by the symmetry, which is HashKey() for the
+  // identity.
+  foolgo::HashKey SymmetricHashKey(int symmetry) const;
+  // The least key of the symmetries, which is the same for all symmetric
+  // boards, and the symmetry giving it.
+  foolgo::HashKey CanonicalHashKey() const;
+  int CanonicalSymmetry() const;
+  // Returns the canonical key of the board after the move, which should not
+  // be a suicide, without playing it.
+  foolgo::HashKey ChildCanonicalHashKey(const Move &move) const;
 
   int MoveCount() const {
     return move_count_;
@@ -92,7 +168,21 @@ class FullBoard : private Board<BOARD_LEN> {
   void PlayMove(const Move &move);
   void Pass(Force force);
 
+  // Plays like PlayMove and Pass, and records what is changed, so that the
+  // board can be reverted by Undo. The cost of recording is proportional to
+  // the changes of the move rather than the size of the board.
+  void PlayMoveWithUndo(const Move &move);
+  void PassWithUndo(Force force);
+  // Reverts the last move played with undo.
+  void Undo();
+
   std::vector<PositionIndex> PlayableIndexes(Force force) const;
+  // Playable points of the force, without the ko point, which are kept up to
+  // date by moves, so that asking for them, iterating over them or testing
+  // their emptiness copies nothing.
+  const BitSet<BOARD_LEN> &PlayableIndexBitSet(Force force) const {
+    return playable_index_bitsets_[force];
+  }
   bool IsEnd() const;
 
   void SetAsEnd() {
@@ -109,26 +199,76 @@ class FullBoard : private Board<BOARD_LEN> {
   std::string ToString(bool board_only) const;
 
  private:
-  typedef std::vector<PositionIndex> PointIndxVector;
-
-  piece_structure::ChainSet<BOARD_LEN> chain_sets_[2];
+  // Temporaries of a move, bounded by the area, which stay on the stack.
+  typedef util::FixedVector<PositionIndex, BoardLenSquare<BOARD_LEN>()>
+      PointIndxVector;
+
+  piece_structure::ChainSet<BOARD_LEN> chain_set_;
+  // Points of each point state, indexed by PointState.
+  std::array<BitSet<BOARD_LEN>, 3> point_bitsets_;
+  std::array<PatternCode, BoardLenSquare<BOARD_LEN>()> pattern_codes_;
   std::array<BitSet<BOARD_LEN>, 2> playable_states_array_;
+  // Playable states without the ko point, refreshed by each move.
+  std::array<BitSet<BOARD_LEN>, 2> playable_index_bitsets_;
   std::array<piece_structure::EyeSet<BOARD_LEN>, 2> eye_states_array_;
   PositionIndex ko_indx_;
   Force last_force_;
+  PositionIndex last_move_index_ = POSITION_INDEX_PASS;
   PositionIndex black_pieces_count_;
   foolgo::HashKey hash_key_;
+  // Keys of the symmetries other than the identity, which are kept only if
+  // keeps_symmetric_hash_keys_ is true.
+  std::array<foolgo::HashKey, SYMMETRY_COUNT> symmetric_hash_keys_;
+  bool keeps_symmetric_hash_keys_ = false;
   int move_count_ = 0;
   bool is_end_ = false;
 
+  // Small states saved before a move played with undo, and where changes of
+  // the move begin in the journals.
+  struct UndoRecord {
+    PositionIndex ko_indx;
+    Force last_force;
+    PositionIndex last_move_index;
+    PositionIndex black_pieces_count;
+    foolgo::HashKey hash_key;
+    std::array<foolgo::HashKey, SYMMETRY_COUNT> symmetric_hash_keys;
+    int move_count;
+    bool is_end;
+    std::array<BitSet<BOARD_LEN>, 2> playable_states_array;
+    std::array<piece_structure::EyeSet<BOARD_LEN>, 2> eye_states_array;
+    std::size_t point_change_begin;
+    std::size_t chain_change_begin;
+  };
+
+  // Journals are not copied by Copy, and keep their capacities among moves.
+  std::vector<UndoRecord> undo_records_;
+  std::vector<BoardDifference::DifferenceWithIndex> point_changes_;
+  std::vector<typename piece_structure::ChainSet<BOARD_LEN>::Change>
+      chain_changes_;
+  bool is_recording_undo_ = false;
+
+  // Where real eyes may change their playable states during a move: pieces
+  // of chains which get into or out of atari, and points whose real eye
+  // states are modified. Only real eyes around them are recomputed.
+  std::vector<PositionIndex> atari_changed_pieces_;
+  BitSet<BOARD_LEN> eye_changed_points_;
+
+  void PushUndoRecord();
+  void ComputeSymmetricHashKeys();
+  // Sets the keys of the first count symmetries of the board after the move,
+  // which should not be a suicide.
+  void GetChildSymmetricHashKeys(const Move &move, int symmetry_count,
+                                 foolgo::HashKey *hash_keys) const;
+
+  // Sets the point on the board, keeping point_bitsets_ in step with it.
+  void SetPointState(PositionIndex indx, PointState point);
+
   void SetSpecifiedAirForAdjacentChains(PositionIndex indx, bool v);
 
   bool IsSelfPieceOrEye(const Move &force_and_position_index) const;
 
   bool IsEmptySingly(PositionIndex indx) const;
 
-  BitSet<BOARD_LEN> PlayableIndexBitSet(Force force) const;
-
   /**
    * Execute basic operations for the move. The basic operations area as below:
    * 1) Modify the Board object to complete the move.
@@ -136,7 +276,7 @@ class FullBoard : private Board<BOARD_LEN> {
    */
   void PlayBasicMove(const Move &move, PointIndxVector *ate_piecies_indexes,
                      PointIndxVector *suicided_pieces_indexes);
-  PointIndxVector RemoveChain(const Move &move);
+  void RemoveChain(const Move &move, PointIndxVector *removed_pieces_indexes);
 
   void ModifyEyesStateAndObliqueRealEyesState(
       const ForceAndPositionIndex &force_and_position_index);
@@ -146,6 +286,7 @@ class FullBoard : private Board<BOARD_LEN> {
   void ModifyAtePiecesAdjacentChains(const PointIndxVector &ate_pieces,
                                      Force ate_force);
   void ModifyRealEyesPlayableState();
+  void RefreshPlayableIndexBitSets();
   void SetRealEyeAsTrue(const ForceAndPositionIndex &force_and_index);
 
   friend std::ostream &operator <<(std::ostream &os,
@@ -172,6 +313,30 @@ void Play(FullBoard<BOARD_LEN> *full_board, PositionIndex position_index) {
   }
 }
 
+template<BoardLen BOARD_LEN>
+void PlayWithUndo(FullBoard<BOARD_LEN> *full_board,
+                  PositionIndex position_index) {
+  Force force = NextForce(*full_board);
+  if (position_index == POSITION_INDEX_PASS) {
+    full_board->PassWithUndo(force);
+  } else {
+    full_board->PlayMoveWithUndo(Move(force, position_index));
+  }
+}
+
+template<BoardLen BOARD_LEN>
+PositionIndex FullBoard<BOARD_LEN>::Area(Force force) const {
+  const BitSet<BOARD_LEN> &empty_points = point_bitsets_[EMPTY_POINT];
+  // Pieces of a force, and empty points reached by them through empty
+  // points.
+  BitSet<BOARD_LEN> reached = point_bitsets_[force].FloodFill(
+      empty_points | point_bitsets_[force]);
+  BitSet<BOARD_LEN> opposite_reached =
+      point_bitsets_[OppositeForce(force)].FloodFill(
+          empty_points | point_bitsets_[OppositeForce(force)]);
+  return reached.AndNot(opposite_reached).count();
+}
+
 template<BoardLen BOARD_LEN>
 bool FullBoard<BOARD_LEN>::IsEnd() const {
   return is_end_ || (PlayableIndexBitSet(Force::BLACK_FORCE).none()
@@ -184,26 +349,18 @@ bool FullBoard<BOARD_LEN>::IsSuicide(const Move &move) const {
 
   auto &pc = PstionAndIndxCcltr<BOARD_LEN>::Ins();
   PositionIndex indx = move.position_index;
-  const Position &pos = pc.GetPosition(indx);
   Force color = move.force;
-  Force oc = OppositeForce(color);
 
-  for (int i = 0; i < 4; ++i) {
-    Position adj_pos = AdjacentPosition(pos, i);
-    if (!pc.IsInBoard(adj_pos)) {
-      continue;
-    }
-
-    PointState point = GetPointState(adj_pos);
-    PositionIndex adj_indx = pc.GetIndex(adj_pos);
+  for (PositionIndex adj_indx : pc.AdjacentIndexes(indx)) {
+    PointState point = GetPointState(adj_indx);
     if (point == EMPTY_POINT) {
       return false;
     } else if (point == color) {
-      if (chain_sets_[color].GetAirCount(adj_indx) > 1) {
+      if (!chain_set_.IsInAtari(adj_indx)) {
         return false;
       }
     } else {
-      if (chain_sets_[oc].GetAirCount(adj_indx) == 1) {
+      if (chain_set_.IsInAtari(adj_indx)) {
         return false;
       }
     }
@@ -212,13 +369,151 @@ bool FullBoard<BOARD_LEN>::IsSuicide(const Move &move) const {
   return true;
 }
 
+template<BoardLen BOARD_LEN>
+foolgo::HashKey FullBoard<BOARD_LEN>::ChildHashKey(const Move &move) const {
+  FOOLGO_TRACE_SCOPE("FullBoard::ChildHashKey");
+  foolgo::HashKey hash_key;
+  GetChildSymmetricHashKeys(move, 1, &hash_key);
+  return hash_key;
+}
+
+template<BoardLen BOARD_LEN>
+foolgo::HashKey FullBoard<BOARD_LEN>::ChildCanonicalHashKey(
+    const Move &move) const {
+  FOOLGO_TRACE_SCOPE("FullBoard::ChildCanonicalHashKey");
+  std::array<foolgo::HashKey, SYMMETRY_COUNT> hash_keys;
+  GetChildSymmetricHashKeys(move, SYMMETRY_COUNT, hash_keys.data());
+  return *std::min_element(hash_keys.begin(), hash_keys.end());
+}
+
+template<BoardLen BOARD_LEN>
+void FullBoard<BOARD_LEN>::GetChildSymmetricHashKeys(
+    const Move &move, int symmetry_count, foolgo::HashKey *hash_keys) const {
+  assert(!IsSuicide(move));
+  const ZobHasher<BOARD_LEN> &hasher = *ZobHasher<BOARD_LEN>::InstancePtr();
+  Force force = move.force;
+  Force opposite_force = OppositeForce(force);
+  PositionIndex move_index = move.position_index;
+
+  for (int s = 0; s < symmetry_count; ++s) {
+    hash_keys[s] = SymmetricHashKey(s)
+        ^ hasher.PointHash(move_index, EMPTY_POINT, s)
+        ^ hasher.PointHash(move_index, force, s)
+        ^ hasher.PlayerHash(last_force_) ^ hasher.PlayerHash(force);
+  }
+  PositionIndex ate_chain_indexes[4];
+  int ate_chain_count = 0;
+  int ate_adjacent_count = 0;
+  bool has_own_or_empty_adjacent = false;
+
+  for (PositionIndex adj_indx :
+      PstionAndIndxCcltr<BOARD_LEN>::Ins().AdjacentIndexes(move_index)) {
+    PointState point = GetPointState(adj_indx);
+    if (point != opposite_force) {
+      has_own_or_empty_adjacent = true;
+      continue;
+    }
+    if (!chain_set_.IsInAtari(adj_indx)) {
+      continue;
+    }
+
+    ++ate_adjacent_count;
+    bool is_counted = false;
+    for (int i = 0; i < ate_chain_count; ++i) {
+      is_counted |= chain_set_.IsInSameChain(ate_chain_indexes[i], adj_indx);
+    }
+    if (is_counted) {
+      continue;
+    }
+
+    ate_chain_indexes[ate_chain_count++] = adj_indx;
+    chain_set_.ForEachPiece(adj_indx,
+        [hash_keys, symmetry_count, &hasher, opposite_force](
+            PositionIndex piece_index) {
+          for (int s = 0; s < symmetry_count; ++s) {
+            hash_keys[s] ^= hasher.PointHash(piece_index, opposite_force, s)
+                ^ hasher.PointHash(piece_index, EMPTY_POINT, s);
+          }
+        });
+  }
+
+  // As in PlayMove, a single piece which ate a single piece and has only the
+  // air of the ate one makes a ko.
+  PositionIndex ko_index = FullBoard<BOARD_LEN>::NONE;
+  if (!has_own_or_empty_adjacent && ate_adjacent_count == 1
+      && chain_set_.GetPieceCount(ate_chain_indexes[0]) == 1) {
+    ko_index = ate_chain_indexes[0];
+  }
+
+  for (int s = 0; s < symmetry_count; ++s) {
+    hash_keys[s] ^= hasher.KoHash(ko_indx_, s) ^ hasher.KoHash(ko_index, s);
+  }
+}
+
+template<BoardLen BOARD_LEN>
+void FullBoard<BOARD_LEN>::SetKeepsSymmetricHashKeys(
+    bool keeps_symmetric_hash_keys) {
+  if (keeps_symmetric_hash_keys && !keeps_symmetric_hash_keys_) {
+    ComputeSymmetricHashKeys();
+  }
+  keeps_symmetric_hash_keys_ = keeps_symmetric_hash_keys;
+}
+
+template<BoardLen BOARD_LEN>
+foolgo::HashKey FullBoard<BOARD_LEN>::SymmetricHashKey(int symmetry) const {
+  if (symmetry == IDENTITY_SYMMETRY) {
+    return hash_key_;
+  }
+  return keeps_symmetric_hash_keys_ ? symmetric_hash_keys_[symmetry] :
+      ZobHasher<BOARD_LEN>::InstancePtr()->GetHash(*this, symmetry);
+}
+
+template<BoardLen BOARD_LEN>
+foolgo::HashKey FullBoard<BOARD_LEN>::CanonicalHashKey() const {
+  return SymmetricHashKey(CanonicalSymmetry());
+}
+
+template<BoardLen BOARD_LEN>
+int FullBoard<BOARD_LEN>::CanonicalSymmetry() const {
+  int canonical_symmetry = IDENTITY_SYMMETRY;
+  foolgo::HashKey canonical_hash_key = hash_key_;
+  for (int s = 1; s < SYMMETRY_COUNT; ++s) {
+    foolgo::HashKey hash_key = SymmetricHashKey(s);
+    if (hash_key < canonical_hash_key) {
+      canonical_hash_key = hash_key;
+      canonical_symmetry = s;
+    }
+  }
+  return canonical_symmetry;
+}
+
+template<BoardLen BOARD_LEN>
+void FullBoard<BOARD_LEN>::ComputeSymmetricHashKeys() {
+  for (int s = 1; s < SYMMETRY_COUNT; ++s) {
+    symmetric_hash_keys_[s] =
+        ZobHasher<BOARD_LEN>::InstancePtr()->GetHash(*this, s);
+  }
+}
+
 template<BoardLen BOARD_LEN>
 void FullBoard<BOARD_LEN>::Init() {
   Board<BOARD_LEN>::Init();
+  for (auto &point_bitset : point_bitsets_) {
+    point_bitset.reset();
+  }
+  point_bitsets_[EMPTY_POINT].set();
+  auto &calculator = PstionAndIndxCcltr<BOARD_LEN>::Ins();
+  for (PositionIndex i = 0; i < BoardLenSquare<BOARD_LEN>(); ++i) {
+    pattern_codes_[i] = calculator.EmptyBoardPatternCode(i);
+  }
   for (int i = 0; i < 2; ++i) {
     playable_states_array_[i].set();
   }
+  RefreshPlayableIndexBitSets();
   hash_key_ = ZobHasher<BOARD_LEN>::InstancePtr()->GetHash(*this);
+  if (keeps_symmetric_hash_keys_) {
+    ComputeSymmetricHashKeys();
+  }
 }
 
 template<BoardLen BOARD_LEN>
@@ -227,15 +522,27 @@ void FullBoard<BOARD_LEN>::Copy(const FullBoard &b) {
 
   ko_indx_ = b.ko_indx_;
   last_force_ = b.last_force_;
+  last_move_index_ = b.last_move_index_;
   black_pieces_count_ = b.black_pieces_count_;
   hash_key_ = b.hash_key_;
   move_count_ = b.move_count_;
   is_end_ = b.is_end_;
+  point_bitsets_ = b.point_bitsets_;
+  pattern_codes_ = b.pattern_codes_;
 
   for (int i = 0; i < 2; ++i) {
     playable_states_array_[i] = b.playable_states_array_[i];
+    playable_index_bitsets_[i] = b.playable_index_bitsets_[i];
     eye_states_array_[i].Copy(b.eye_states_array_[i]);
-    chain_sets_[i].Copy(b.chain_sets_[i]);
+  }
+  chain_set_.Copy(b.chain_set_);
+
+  if (keeps_symmetric_hash_keys_) {
+    if (b.keeps_symmetric_hash_keys_) {
+      symmetric_hash_keys_ = b.symmetric_hash_keys_;
+    } else {
+      ComputeSymmetricHashKeys();
+    }
   }
 }
 
@@ -253,6 +560,8 @@ void FullBoard<BOARD_LEN>::PlayMove(const Move &move) {
     abort();
   }
 
+  // The time of eye states is that not in the nested scopes.
+  FOOLGO_TRACE_SCOPE("FullBoard::PlayMove");
   BoardDifference board_difference;
   board_difference.Init(LastForce(), KoIndex());
   black_pieces_count_ += OppositeForce(move_force);
@@ -265,11 +574,13 @@ void FullBoard<BOARD_LEN>::PlayMove(const Move &move) {
 
   Force opposite_force = OppositeForce(move_force);
   auto &calculator = PstionAndIndxCcltr<BOARD_LEN>::Ins();
-  const Position &move_position = calculator.GetPosition(move_index);
   typename FullBoard<BOARD_LEN>::PointIndxVector ate_piece_indexes_array[4],
       suisided_piece_indexes;
 
-  PlayBasicMove(move, ate_piece_indexes_array, &suisided_piece_indexes);
+  {
+    FOOLGO_TRACE_SCOPE("FullBoard::PlayBasicMove");
+    PlayBasicMove(move, ate_piece_indexes_array, &suisided_piece_indexes);
+  }
 
   for (PositionIndex indx : suisided_piece_indexes) {
     for (auto &playable_states : playable_states_array_) {
@@ -284,33 +595,26 @@ void FullBoard<BOARD_LEN>::PlayMove(const Move &move) {
       eye_states_array_[i].SetRealEye(move_index, false);
     }
 
+    const NeighborIndexes &adjacent_indexes = calculator.AdjacentIndexes(
+        move_index);
+
     // Modify adjacent eyes state.
     // Modify eyes state which is oblique to adjacent eyes.
-    for (int i = 0; i < 4; ++i) {
-      Position adjacent_position = AdjacentPosition(move_position, i);
-      if (!calculator.IsInBoard(adjacent_position)) {
-        continue;
-      }
-      if (GetPointState(adjacent_position) != EMPTY_POINT) {
+    for (PositionIndex adjacent_index : adjacent_indexes) {
+      if (GetPointState(adjacent_index) != EMPTY_POINT) {
         continue;
       }
 
-      PositionIndex adjacent_index = calculator.GetIndex(adjacent_position);
       ModifyEyesStateAndObliqueRealEyesState(
           ForceAndPositionIndex(move_force, adjacent_index));
     }
 
     // Modify adjacent real eyes state.
-    for (int i = 0; i < 4; ++i) {
-      Position adjacent_position = AdjacentPosition(move_position, i);
-      if (!calculator.IsInBoard(adjacent_position)) {
-        continue;
-      }
-      if (GetPointState(adjacent_position) != EMPTY_POINT) {
+    for (PositionIndex adjacent_indx : adjacent_indexes) {
+      if (GetPointState(adjacent_indx) != EMPTY_POINT) {
         continue;
       }
 
-      PositionIndex adjacent_indx = calculator.GetIndex(adjacent_position);
       ForceAndPositionIndex adjcnt_frce_and_indx(move_force, adjacent_indx);
       ModifyRealEyesState(adjcnt_frce_and_indx);
 //      if (IsFakeEye(eye_states_array_[adjcnt_frce_and_indx.force],
@@ -321,16 +625,11 @@ void FullBoard<BOARD_LEN>::PlayMove(const Move &move) {
     }
 
     // Modify Oblique real eyes state.
-    for (int i = 0; i < 4; ++i) {
-      Position oblq_pos = ObliquePosition(move_position, i);
-      if (!calculator.IsInBoard(oblq_pos)) {
-        continue;
-      }
-      if (GetPointState(oblq_pos) != EMPTY_POINT) {
+    for (PositionIndex oblq_indx : calculator.ObliqueIndexes(move_index)) {
+      if (GetPointState(oblq_indx) != EMPTY_POINT) {
         continue;
       }
 
-      PositionIndex oblq_indx = calculator.GetIndex(oblq_pos);
       for (int j = 0; j < 2; ++j) {
         Force force = static_cast<Force>(j);
         ForceAndPositionIndex oblq_force_and_index(force, oblq_indx);
@@ -356,8 +655,8 @@ void FullBoard<BOARD_LEN>::PlayMove(const Move &move) {
 
     if (single_ate_piece_index != FullBoard<BOARD_LEN>::NONE
         && GetPointState(move_index) == move_force
-        && chain_sets_[move_force].GetAirCount(move_index) == 1
-        && chain_sets_[move_force].GetPieces(move_index).size() == 1) {
+        && chain_set_.IsInAtari(move_index)
+        && chain_set_.GetPieceCount(move_index) == 1) {
       ko_indx_ = single_ate_piece_index;
     }
   } else if (suisided_piece_indexes.size() == 1) {
@@ -365,36 +664,148 @@ void FullBoard<BOARD_LEN>::PlayMove(const Move &move) {
   }
 
   ModifyRealEyesPlayableState();
+  RefreshPlayableIndexBitSets();
 
+  FOOLGO_TRACE_SCOPE("FullBoard::ModifyHashKeys");
   last_force_ = move_force;
+  last_move_index_ = move_index;
 
   if (GetPointState(move_index) == EMPTY_POINT) {
     board_difference.ModifyToCurrentState(ko_indx_, move_index, true,
                                           suisided_piece_indexes);
   } else {
-    auto ates = util::ConcatVectors(ate_piece_indexes_array);
+    PointIndxVector ates;
+    for (const auto &ate_piece_indexes : ate_piece_indexes_array) {
+      ates.Append(ate_piece_indexes);
+    }
     board_difference.ModifyToCurrentState(ko_indx_, move_index, false, ates);
   }
 
+  if (is_recording_undo_) {
+    const auto &points_change = board_difference.PointsChng();
+    point_changes_.insert(point_changes_.end(), points_change.begin(),
+                          points_change.end());
+  }
+
   hash_key_ = ZobHasher<BOARD_LEN>::InstancePtr()->GetHash(hash_key_,
       board_difference);
+  if (keeps_symmetric_hash_keys_) {
+    for (int s = 1; s < SYMMETRY_COUNT; ++s) {
+      symmetric_hash_keys_[s] = ZobHasher<BOARD_LEN>::InstancePtr()->GetHash(
+          symmetric_hash_keys_[s], board_difference, s);
+    }
+  }
   ++move_count_;
 }
 
+template<BoardLen BOARD_LEN>
+void FullBoard<BOARD_LEN>::PushUndoRecord() {
+  undo_records_.push_back(UndoRecord());
+  UndoRecord &record = undo_records_.back();
+  record.ko_indx = ko_indx_;
+  record.last_force = last_force_;
+  record.last_move_index = last_move_index_;
+  record.black_pieces_count = black_pieces_count_;
+  record.hash_key = hash_key_;
+  record.symmetric_hash_keys = symmetric_hash_keys_;
+  record.move_count = move_count_;
+  record.is_end = is_end_;
+  record.playable_states_array = playable_states_array_;
+  record.point_change_begin = point_changes_.size();
+  record.chain_change_begin = chain_changes_.size();
+
+  for (int i = 0; i < 2; ++i) {
+    record.eye_states_array[i].Copy(eye_states_array_[i]);
+  }
+}
+
+template<BoardLen BOARD_LEN>
+inline void FullBoard<BOARD_LEN>::SetPointState(PositionIndex indx,
+                                                PointState point) {
+  point_bitsets_[GetPointState(indx)].reset(indx);
+  Board<BOARD_LEN>::SetPoint(indx, point);
+  point_bitsets_[point].set(indx);
+
+  const PatternNeighbors &pattern_neighbors =
+      PstionAndIndxCcltr<BOARD_LEN>::Ins().PatternNeighborsOf(indx);
+  for (int i = 0; i < pattern_neighbors.count; ++i) {
+    PatternCode &code = pattern_codes_[pattern_neighbors.indexes[i]];
+    code = SetPatternNeighborState(code, pattern_neighbors.shifts[i], point);
+  }
+}
+
+template<BoardLen BOARD_LEN>
+void FullBoard<BOARD_LEN>::PlayMoveWithUndo(const Move &move) {
+  PushUndoRecord();
+  chain_set_.SetJournal(&chain_changes_);
+  is_recording_undo_ = true;
+
+  PlayMove(move);
+
+  is_recording_undo_ = false;
+  chain_set_.SetJournal(nullptr);
+}
+
+template<BoardLen BOARD_LEN>
+void FullBoard<BOARD_LEN>::PassWithUndo(Force force) {
+  PushUndoRecord();
+  Pass(force);
+}
+
+template<BoardLen BOARD_LEN>
+void FullBoard<BOARD_LEN>::Undo() {
+  assert(!undo_records_.empty());
+  const UndoRecord &record = undo_records_.back();
+
+  // Removed pieces are listed before the move itself, so that replaying the
+  // old states in order leaves a suicided move point empty.
+  for (std::size_t i = record.point_change_begin; i < point_changes_.size();
+      ++i) {
+    const auto &point_change = point_changes_[i];
+    SetPointState(point_change.position_index,
+                  point_change.difference.old_state);
+  }
+  point_changes_.resize(record.point_change_begin);
+
+  while (chain_changes_.size() > record.chain_change_begin) {
+    chain_set_.Revert(chain_changes_.back());
+    chain_changes_.pop_back();
+  }
+
+  for (int i = 0; i < 2; ++i) {
+    eye_states_array_[i].Copy(record.eye_states_array[i]);
+  }
+
+  playable_states_array_ = record.playable_states_array;
+  ko_indx_ = record.ko_indx;
+  last_force_ = record.last_force;
+  last_move_index_ = record.last_move_index;
+  black_pieces_count_ = record.black_pieces_count;
+  hash_key_ = record.hash_key;
+  symmetric_hash_keys_ = record.symmetric_hash_keys;
+  move_count_ = record.move_count;
+  is_end_ = record.is_end;
+  RefreshPlayableIndexBitSets();
+  undo_records_.pop_back();
+}
+
 template<BoardLen BOARD_LEN>
 void FullBoard<BOARD_LEN>::Pass(Force force) {
   last_force_ = force;
+  last_move_index_ = POSITION_INDEX_PASS;
   ko_indx_ = FullBoard<BOARD_LEN>::NONE;
+  RefreshPlayableIndexBitSets();
   hash_key_ = ZobHasher<BOARD_LEN>::InstancePtr()->GetHash(*this);
+  if (keeps_symmetric_hash_keys_) {
+    ComputeSymmetricHashKeys();
+  }
   ++move_count_;
 }
 
 template<BoardLen BOARD_LEN>
 std::vector<PositionIndex> FullBoard<BOARD_LEN>::PlayableIndexes(
     Force force) const {
-  auto index_bitset = PlayableIndexBitSet(force);
-  return util::GetOnePositionIndexes<BoardLenSquare<BOARD_LEN>()>(
-      index_bitset);
+  return PlayableIndexBitSet(force).Indexes();
 }
 
 template<BoardLen BOARD_LEN>
@@ -437,21 +848,38 @@ template<BoardLen BOARD_LEN>
 void FullBoard<BOARD_LEN>::SetSpecifiedAirForAdjacentChains(PositionIndex indx,
                                                             bool v) {
   auto &ins = PstionAndIndxCcltr<BOARD_LEN>::Ins();
-  const Position &pos = ins.GetPosition(indx);
-
-  for (int i = 0; i < 4; ++i) {
-    Position adj_pos = AdjacentPosition(pos, i);
-    if (!ins.IsInBoard(adj_pos)) {
-      continue;
-    }
+  PositionIndex modified_pieces[4];
+  bool were_in_atari[4];
+  int modified_count = 0;
 
-    PositionIndex adj_i = ins.GetIndex(adj_pos);
+  // Each adjacent piece gains or loses a pseudo air, while the atari state
+  // is compared once per chain.
+  for (PositionIndex adj_i : ins.AdjacentIndexes(indx)) {
     PointState pnt = GetPointState(adj_i);
     if (pnt == EMPTY_POINT) {
       continue;
     }
 
-    chain_sets_[pnt].SetAir(adj_i, indx, v);
+    bool is_modified = false;
+    for (int i = 0; i < modified_count; ++i) {
+      is_modified |= chain_set_.IsInSameChain(modified_pieces[i], adj_i);
+    }
+    if (!is_modified) {
+      modified_pieces[modified_count] = adj_i;
+      were_in_atari[modified_count++] = chain_set_.IsInAtari(adj_i);
+    }
+
+    if (v) {
+      chain_set_.AddPseudoAir(adj_i, indx);
+    } else {
+      chain_set_.RemovePseudoAir(adj_i, indx);
+    }
+  }
+
+  for (int i = 0; i < modified_count; ++i) {
+    if (chain_set_.IsInAtari(modified_pieces[i]) != were_in_atari[i]) {
+      atari_changed_pieces_.push_back(modified_pieces[i]);
+    }
   }
 }
 
@@ -465,16 +893,10 @@ bool FullBoard<BOARD_LEN>::IsSelfPieceOrEye(
 
 template<BoardLen BOARD_LEN>
 bool FullBoard<BOARD_LEN>::IsEmptySingly(PositionIndex indx) const {
-  auto &ins = this->GetPosClcltr();
-  const Position &pos = ins.GetPos(indx);
-
-  for (int i = 0; i < 4; ++i) {
-    Position adj_pos = AdjacentPosition(pos, i);
-    if (!ins.IsInBoard(adj_pos)) {
-      continue;
-    }
+  auto &ins = PstionAndIndxCcltr<BOARD_LEN>::Ins();
 
-    if (GetPointState(adj_pos) == EMPTY_POINT) {
+  for (PositionIndex adj_indx : ins.AdjacentIndexes(indx)) {
+    if (GetPointState(adj_indx) == EMPTY_POINT) {
       return false;
     }
   }
@@ -483,15 +905,12 @@ bool FullBoard<BOARD_LEN>::IsEmptySingly(PositionIndex indx) const {
 }
 
 template<BoardLen BOARD_LEN>
-BitSet<BOARD_LEN> FullBoard<BOARD_LEN>::PlayableIndexBitSet(
-    Force force) const {
-  if (KoIndex() == FullBoard<BOARD_LEN>::NONE) {
-    return playable_states_array_.at(force);
-  } else {
-    BitSet<BOARD_LEN> kobits;
-    kobits.set();
-    kobits.reset(KoIndex());
-    return kobits & playable_states_array_.at(force);
+void FullBoard<BOARD_LEN>::RefreshPlayableIndexBitSets() {
+  playable_index_bitsets_ = playable_states_array_;
+  if (KoIndex() != FullBoard<BOARD_LEN>::NONE) {
+    for (auto &playable_index_bitset : playable_index_bitsets_) {
+      playable_index_bitset.reset(KoIndex());
+    }
   }
 }
 
@@ -505,45 +924,46 @@ void FullBoard<BOARD_LEN>::PlayBasicMove(
   PositionIndex move_index = move.position_index;
   assert(GetPointState(move_index) == EMPTY_POINT);
 
-  std::bitset<BoardLenSquare<BOARD_LEN>()> air_set;
   Force opposite_force = OppositeForce(move_force);
   auto &calculator = PstionAndIndxCcltr<BOARD_LEN>::Ins();
-  const Position &move_position = calculator.GetPosition(move_index);
+  const NeighborIndexes &adjacent_indexes = calculator.AdjacentIndexes(
+      move_index);
 
-  for (int i = 0; i < 4; ++i) {
-    Position adj_pos = AdjacentPosition(move_position, i);
-    if (!calculator.IsInBoard(adj_pos)) {
-      continue;
-    }
-
-    PositionIndex adjacent_index = calculator.GetIndex(adj_pos);
+  for (int i = 0; i < adjacent_indexes.count; ++i) {
+    PositionIndex adjacent_index = adjacent_indexes.indexes[i];
     if (GetPointState(adjacent_index) == opposite_force
-        && chain_sets_[opposite_force].GetAirCount(adjacent_index) == 1) {
-      ate_piecies_indexes[i] = RemoveChain(Move(opposite_force, adjacent_index));
-      air_set.set(adjacent_index);
-    } else if (GetPointState(adj_pos) == EMPTY_POINT) {
-      air_set.set(adjacent_index);
+        && chain_set_.IsInAtari(adjacent_index)) {
+      RemoveChain(Move(opposite_force, adjacent_index),
+                  ate_piecies_indexes + i);
     }
   }
 
-  Board<BOARD_LEN>::SetPoint(move_index, move_force);
+  SetPointState(move_index, move_force);
   SetSpecifiedAirForAdjacentChains(move_index, false);
-  chain_sets_[move_force].AddPiece(move_index, air_set);
+  chain_set_.AddPiece(move_index, move_force);
+  if (chain_set_.IsInAtari(move_index)) {
+    atari_changed_pieces_.push_back(move_index);
+  }
 
-  if (chain_sets_[move_force].GetAirCount(move_index) == 0) {
-    *suicided_pieces_indexes = RemoveChain(move);
+  if (!chain_set_.HasAir(move_index)) {
+    RemoveChain(move, suicided_pieces_indexes);
   }
 }
 
 template<BoardLen BOARD_LEN>
-typename FullBoard<BOARD_LEN>::PointIndxVector FullBoard<BOARD_LEN>::RemoveChain(
-    const Move &move) {
-  auto chain_set_ptr = chain_sets_ + move.force;
-  auto chain_set_pieces = chain_set_ptr->GetPieces(move.position_index);
-  chain_sets_[move.force].RemoveListByPiece(move.position_index);
+void FullBoard<BOARD_LEN>::RemoveChain(
+    const Move &move,
+    typename FullBoard<BOARD_LEN>::PointIndxVector *removed_pieces_indexes) {
+  PointIndxVector &chain_set_pieces = *removed_pieces_indexes;
+  chain_set_pieces.clear();
+  chain_set_.ForEachPiece(move.position_index,
+                          [&chain_set_pieces](PositionIndex index) {
+    chain_set_pieces.push_back(index);
+  });
+  chain_set_.RemoveListByPiece(move.position_index);
 
   for (PositionIndex indx : chain_set_pieces) {
-    Board<BOARD_LEN>::SetPoint(indx, EMPTY_POINT);
+    SetPointState(indx, EMPTY_POINT);
     for (int i = 0; i < 2; ++i) {
       playable_states_array_[i].set(indx);
     }
@@ -556,7 +976,6 @@ typename FullBoard<BOARD_LEN>::PointIndxVector FullBoard<BOARD_LEN>::RemoveChain
   if (move.force == Force::BLACK_FORCE) {
     black_pieces_count_ -= chain_set_pieces.size();
   }
-  return chain_set_pieces;
 }
 
 template<BoardLen BOARD_LEN>
@@ -565,15 +984,10 @@ void FullBoard<BOARD_LEN>::ModifyEyesStateAndObliqueRealEyesState(
   assert(GetPointState(force_and_position_index.position_index) == EMPTY_POINT);
   const auto &calculator = PstionAndIndxCcltr<BOARD_LEN>::Ins();
   PositionIndex indx = force_and_position_index.position_index;
-  const Position &position = calculator.GetPosition(indx);
   Force force = force_and_position_index.force;
 
-  for (int i = 0; i < 4; ++i) {
-    const Position adjacent_position = AdjacentPosition(position, i);
-    if (!calculator.IsInBoard(adjacent_position)) {
-      continue;
-    } else if (GetPointState(AdjacentPosition(position, i))
-        != force) {
+  for (PositionIndex adjacent_indx : calculator.AdjacentIndexes(indx)) {
+    if (GetPointState(adjacent_indx) != force) {
       eye_states_array_[force].SetEye(indx, false);
       return;
     }
@@ -581,13 +995,7 @@ void FullBoard<BOARD_LEN>::ModifyEyesStateAndObliqueRealEyesState(
 
   eye_states_array_[force].SetEye(indx, true);
 
-  for (int i = 0; i < 4; ++i) {
-    const Position oblq_position = ObliquePosition(position, i);
-    if (!calculator.IsInBoard(oblq_position)) {
-      continue;
-    }
-
-    PositionIndex oblq_indx = calculator.GetIndex(oblq_position);
+  for (PositionIndex oblq_indx : calculator.ObliqueIndexes(indx)) {
     if (GetPointState(oblq_indx) == EMPTY_POINT) {
       ModifyRealEyesState(ForceAndPositionIndex(force, oblq_indx));
     }
@@ -602,6 +1010,7 @@ void FullBoard<BOARD_LEN>::ModifyRealEyesState(
   Force force = force_and_position_index.force;
   PositionIndex indx = force_and_position_index.position_index;
   bool is_eye = eye_states_array_[force].IsEye(indx);
+  eye_changed_points_.set(indx);
 
   if (!is_eye) {
     eye_states_array_[force].SetRealEye(indx, false);
@@ -612,14 +1021,7 @@ void FullBoard<BOARD_LEN>::ModifyRealEyesState(
   const Position &position = calculator.GetPosition(indx);
   PositionIndex piece_or_eye_count = 0;
 
-  for (int i = 0; i < 4; ++i) {
-    Position oblq_pos = ObliquePosition(position, i);
-    if (!calculator.IsInBoard(oblq_pos)) {
-      continue;
-    }
-
-    PositionIndex oblq_indx = calculator.GetIndex(oblq_pos);
-
+  for (PositionIndex oblq_indx : calculator.ObliqueIndexes(indx)) {
     if (IsSelfPieceOrEye(ForceAndPositionIndex(force, oblq_indx))) {
       ++piece_or_eye_count;
     }
@@ -641,15 +1043,8 @@ void FullBoard<BOARD_LEN>::ModifyAtePiecesAdjacentChains(
   auto &calculator = PstionAndIndxCcltr<BOARD_LEN>::Ins();
 
   for (PositionIndex indx : ate_pieces) {
-    const Position &pos = calculator.GetPosition(indx);
-    for (int i = 0; i < 4; ++i) {
-      Position adj_pos = AdjacentPosition(pos, i);
-      if (!calculator.IsInBoard(adj_pos)) {
-        continue;
-      }
-
-      if (GetPointState(adj_pos) == OppositeForce(ate_force)) {
-        PositionIndex adj_indx = calculator.GetIndex(adj_pos);
+    for (PositionIndex adj_indx : calculator.AdjacentIndexes(indx)) {
+      if (GetPointState(adj_indx) == OppositeForce(ate_force)) {
       }
     }
   }
@@ -658,27 +1053,40 @@ void FullBoard<BOARD_LEN>::ModifyAtePiecesAdjacentChains(
 template<BoardLen BOARD_LEN>
 void FullBoard<BOARD_LEN>::ModifyRealEyesPlayableState() {
   auto &calculator = PstionAndIndxCcltr<BOARD_LEN>::Ins();
+  BitSet<BOARD_LEN> changed_points = eye_changed_points_;
+  BitSet<BOARD_LEN> visited_pieces;
+
+  // A chain may be captured after getting into atari.
+  for (PositionIndex piece : atari_changed_pieces_) {
+    if (GetPointState(piece) == EMPTY_POINT || visited_pieces[piece]) {
+      continue;
+    }
+    BitSet<BOARD_LEN> chain;
+    chain_set_.ForEachPiece(piece, [&chain](PositionIndex index) {
+      chain.set(index);
+    });
+    visited_pieces |= chain;
+    changed_points |= chain.Adjacent();
+  }
+
+  atari_changed_pieces_.clear();
+  eye_changed_points_.reset();
 
   for (int i=0; i<2; ++i) {
     const auto &eye_states = eye_states_array_.at(i);
-    std::vector<PositionIndex> real_eyes = eye_states.GetRealEyes();
-
-    for (PositionIndex eye_index : real_eyes) {
-      const Position &eye_position = calculator.GetPosition(eye_index);
-
-      for (int j=0; j<4; ++j) {
-        Position adjacent_position = AdjacentPosition(eye_position, j);
-        if (calculator.IsInBoard(adjacent_position)) {
-          PositionIndex adjacent_index = calculator.GetIndex(adjacent_position);
-          Force force = static_cast<Force>(i);
-          Force opposite_force = OppositeForce(force);
-          if (chain_sets_[i].GetAirCount(adjacent_index) == 1) {
-            playable_states_array_.at(opposite_force).set(eye_index);
-          } else {
-            playable_states_array_.at(opposite_force).reset(eye_index);
-          }
-          break;
-        }
+
+    for (PositionIndex eye_index :
+        eye_states.RealEyeBitSet() & changed_points) {
+      // Pieces around a real eye are all in one chain, so any of them tells
+      // whether the eye is the last air.
+      PositionIndex adjacent_index =
+          calculator.AdjacentIndexes(eye_index).indexes[0];
+      Force force = static_cast<Force>(i);
+      Force opposite_force = OppositeForce(force);
+      if (chain_set_.IsInAtari(adjacent_index)) {
+        playable_states_array_.at(opposite_force).set(eye_index);
+      } else {
+        playable_states_array_.at(opposite_force).reset(eye_index);
       }
     }
   }
@@ -0,0 +1,44 @@
+#ifndef FOOLGO_SRC_BOARD_PATTERN_H_
+#define FOOLGO_SRC_BOARD_PATTERN_H_
+
+#include <cstdint>
+
+#include "../def.h"
+
+namespace foolgo {
+
+// The states of the 8 points around a point, 2 bits each, of which the kth
+// neighbour takes bits 2k and 2k + 1. States are PointState, or
+// OFF_BOARD_PATTERN_STATE beyond the edges.
+typedef uint16_t PatternCode;
+
+const int PATTERN_NEIGHBOR_COUNT = 8;
+const int PATTERN_CODE_COUNT = 1 << (2 * PATTERN_NEIGHBOR_COUNT);
+const PointState OFF_BOARD_PATTERN_STATE = 3;
+
+// The offsets of the neighbours, in rows from the top left, so that the
+// neighbour opposite to the kth is the (7 - k)th.
+const int PATTERN_NEIGHBOR_OFFSETS[PATTERN_NEIGHBOR_COUNT][2] = {
+    { -1, -1 }, { 0, -1 }, { 1, -1 }, { -1, 0 }, { 1, 0 }, { -1, 1 },
+    { 0, 1 }, { 1, 1 } };
+
+inline PointState PatternNeighborState(PatternCode code, int k) {
+  return (code >> (2 * k)) & 3;
+}
+
+inline PatternCode SetPatternNeighborState(PatternCode code, int shift,
+                                           PointState state) {
+  return (code & ~(3 << shift)) | (state << shift);
+}
+
+// Swaps black and white points of the code, so that a pattern seen by white
+// reads as the one seen by black.
+inline PatternCode SwapPatternColors(PatternCode code) {
+  // A state of the low bit only is a white point, and of neither bit is a
+  // black one.
+  return code ^ (~code >> 1 & 0x5555);
+}
+
+}
+
+#endif
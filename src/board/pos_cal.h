@@ -4,10 +4,33 @@
 #include <cassert>
 
 #include "../def.h"
+#include "pattern.h"
 #include "position.h"
 
 namespace foolgo {
 
+// Indexes of the in board neighbours of a position, in the order of
+// Position::STRAIGHT_ORNTTIONS or Position::OBLIQUE_ORNTTIONS.
+struct NeighborIndexes {
+  PositionIndex count;
+  PositionIndex indexes[4];
+
+  const PositionIndex *begin() const {
+    return indexes;
+  }
+  const PositionIndex *end() const {
+    return indexes + count;
+  }
+};
+
+// Points of the 3x3 neighbourhood of a position in board, each with the shift
+// of the state of the position in the pattern code of the point.
+struct PatternNeighbors {
+  PositionIndex count;
+  PositionIndex indexes[PATTERN_NEIGHBOR_COUNT];
+  int8_t shifts[PATTERN_NEIGHBOR_COUNT];
+};
+
 template<BoardLen BOARD_LEN>
 class PstionAndIndxCcltr {
  public:
@@ -36,9 +59,35 @@ class PstionAndIndxCcltr {
   }
   CentralEdgeCorner CentralOrEdgeOrCorner(const Position &pos);
 
+  // Neighbour tables precomputed at construction, so that iterating
+  // neighbours needs neither bound checks nor conversions between positions
+  // and indexes.
+  const NeighborIndexes &AdjacentIndexes(PositionIndex index) const {
+    assert(IsInBoard(index));
+    return adjacent_indexes_[index];
+  }
+  const NeighborIndexes &ObliqueIndexes(PositionIndex index) const {
+    assert(IsInBoard(index));
+    return oblique_indexes_[index];
+  }
+  const PatternNeighbors &PatternNeighborsOf(PositionIndex index) const {
+    assert(IsInBoard(index));
+    return pattern_neighbors_[index];
+  }
+  // The code of the point on the empty board, of which only neighbours
+  // beyond the edges are not empty.
+  PatternCode EmptyBoardPatternCode(PositionIndex index) const {
+    assert(IsInBoard(index));
+    return empty_board_pattern_codes_[index];
+  }
+
  private:
   Position position_[BoardLenSquare<BOARD_LEN>()];
   PositionIndex indexes_[BOARD_LEN][BOARD_LEN];
+  NeighborIndexes adjacent_indexes_[BoardLenSquare<BOARD_LEN>()];
+  NeighborIndexes oblique_indexes_[BoardLenSquare<BOARD_LEN>()];
+  PatternNeighbors pattern_neighbors_[BoardLenSquare<BOARD_LEN>()];
+  PatternCode empty_board_pattern_codes_[BoardLenSquare<BOARD_LEN>()];
 
   PstionAndIndxCcltr();
   ~PstionAndIndxCcltr() = default;
@@ -79,6 +128,46 @@ PstionAndIndxCcltr<BOARD_LEN>::PstionAndIndxCcltr() {
       position_[index].Set(x, y);
     }
   }
+
+  for (PositionIndex index = 0; index < BoardLenSquare<BOARD_LEN>(); ++index) {
+    const Position &position = position_[index];
+    adjacent_indexes_[index].count = 0;
+    oblique_indexes_[index].count = 0;
+
+    for (int i = 0; i < 4; ++i) {
+      Position adjacent_position = AdjacentPosition(position, i);
+      if (IsInBoard(adjacent_position)) {
+        NeighborIndexes &adjacent = adjacent_indexes_[index];
+        adjacent.indexes[adjacent.count++] = GetIndex(adjacent_position);
+      }
+
+      Position oblique_position = ObliquePosition(position, i);
+      if (IsInBoard(oblique_position)) {
+        NeighborIndexes &oblique = oblique_indexes_[index];
+        oblique.indexes[oblique.count++] = GetIndex(oblique_position);
+      }
+    }
+
+    PatternNeighbors &pattern_neighbors = pattern_neighbors_[index];
+    pattern_neighbors.count = 0;
+    empty_board_pattern_codes_[index] = 0;
+    for (int k = 0; k < PATTERN_NEIGHBOR_COUNT; ++k) {
+      Position neighbor_position(
+          position.x + PATTERN_NEIGHBOR_OFFSETS[k][0],
+          position.y + PATTERN_NEIGHBOR_OFFSETS[k][1]);
+      bool is_in_board = IsInBoard(neighbor_position);
+      empty_board_pattern_codes_[index] = SetPatternNeighborState(
+          empty_board_pattern_codes_[index], 2 * k,
+          is_in_board ? EMPTY_POINT : OFF_BOARD_PATTERN_STATE);
+      if (is_in_board) {
+        // The position is the opposite neighbour of the neighbour.
+        int count = pattern_neighbors.count++;
+        pattern_neighbors.indexes[count] = GetIndex(neighbor_position);
+        pattern_neighbors.shifts[count] =
+            2 * (PATTERN_NEIGHBOR_COUNT - 1 - k);
+      }
+    }
+  }
 }
 
 }
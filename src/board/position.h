@@ -2,7 +2,6 @@
 #define FOOLGO_SRC_BOARD_POSITION_H_
 
 #include <stdint.h>
-#include <bitset>
 #include <iostream>
 
 namespace foolgo {
@@ -37,8 +36,8 @@ constexpr PositionIndex BoardLenSquare() {
   return BOARD_LEN * BOARD_LEN;
 }
 
-template<BoardLen BOARD_LEN>
-using BitSet = std::bitset<BoardLenSquare<BOARD_LEN>()>;
+// The largest board length, which bounds temporaries shared by all lengths.
+constexpr BoardLen MAX_BOARD_LEN = 19;
 
 template<BoardLen BOARD_LEN>
 constexpr BoardLen BoardLenMinusOne() {
@@ -0,0 +1,66 @@
+#ifndef FOOLGO_SRC_BOARD_SYMMETRY_H_
+#define FOOLGO_SRC_BOARD_SYMMETRY_H_
+
+#include <cassert>
+
+#include "../def.h"
+#include "position.h"
+
+namespace foolgo {
+
+// The 8 rotations and reflections of the board, of which the first is the
+// identity.
+const int SYMMETRY_COUNT = 8;
+const int IDENTITY_SYMMETRY = 0;
+
+// Returns the index of the point which the symmetry moves the point of the
+// index to. Symmetries are numbered as: the identity, rotations by 90, 180
+// and 270 degrees, reflections of x and of y, and reflections about the
+// diagonal and the anti diagonal.
+template<BoardLen BOARD_LEN>
+PositionIndex SymmetricIndex(int symmetry, PositionIndex index) {
+  assert(index >= 0 && index < BoardLenSquare<BOARD_LEN>());
+  if (symmetry == IDENTITY_SYMMETRY) {
+    return index;
+  }
+  int x = index % BOARD_LEN;
+  int y = index / BOARD_LEN;
+  int n = BOARD_LEN - 1;
+  int symmetric_x, symmetric_y;
+
+  switch (symmetry) {
+    case 1:
+      symmetric_x = n - y, symmetric_y = x;
+      break;
+    case 2:
+      symmetric_x = n - x, symmetric_y = n - y;
+      break;
+    case 3:
+      symmetric_x = y, symmetric_y = n - x;
+      break;
+    case 4:
+      symmetric_x = n - x, symmetric_y = y;
+      break;
+    case 5:
+      symmetric_x = x, symmetric_y = n - y;
+      break;
+    case 6:
+      symmetric_x = y, symmetric_y = x;
+      break;
+    default:
+      assert(symmetry == 7);
+      symmetric_x = n - y, symmetric_y = n - x;
+      break;
+  }
+
+  return symmetric_y * BOARD_LEN + symmetric_x;
+}
+
+// Only the rotations by 90 and 270 degrees are not their own inverses.
+inline int InverseSymmetry(int symmetry) {
+  return symmetry == 1 ? 3 : (symmetry == 3 ? 1 : symmetry);
+}
+
+}
+
+#endif
@@ -2,12 +2,14 @@
 #define FOOLGO_SRC_BOARD_ZOB_HASHER_H_
 
 #include <functional>
+#include <random>
 
 #include "def.h"
-#include "util/rand.h"
 #include "board_difference.h"
 #include "full_board_hasher.h"
 #include "position.h"
+#include "symmetry.h"
+#include "../util/rand.h"
 
 namespace foolgo {
 
@@ -26,6 +28,32 @@ class ZobHasher : public FullBoardHasher<BOARD_LEN> {
   HashKey GetHash(const FullBoard<BOARD_LEN> &b) const;
   HashKey GetHash(HashKey hash, const BoardDifference &chng) const;
 
+  HashKey PointHash(PositionIndex index, PointState point) const {
+    return board_hash_[index][point];
+  }
+  HashKey PlayerHash(Force last_force) const {
+    return player_hash_[last_force];
+  }
+  HashKey KoHash(PositionIndex ko_index) const {
+    return ko_index == FullBoard<BOARD_LEN>::NONE ?
+        noko_hash_ : ko_hash_[ko_index];
+  }
+
+  // Keys of the board which the symmetry moves the board to, so that keys
+  // of the 8 symmetries of a board are the same set as those of any of its
+  // symmetric boards.
+  HashKey GetHash(const FullBoard<BOARD_LEN> &b, int symmetry) const;
+  HashKey GetHash(HashKey hash, const BoardDifference &chng,
+                  int symmetry) const;
+  HashKey PointHash(PositionIndex index, PointState point,
+                    int symmetry) const {
+    return board_hash_[SymmetricIndex<BOARD_LEN>(symmetry, index)][point];
+  }
+  HashKey KoHash(PositionIndex ko_index, int symmetry) const {
+    return ko_index == FullBoard<BOARD_LEN>::NONE ?
+        noko_hash_ : ko_hash_[SymmetricIndex<BOARD_LEN>(symmetry, ko_index)];
+  }
+
  private:
   HashKey board_hash_[BoardLenSquare<BOARD_LEN>()][3];
   HashKey player_hash_[2];
@@ -49,23 +77,25 @@ void ZobHasher<BOARD_LEN>::Init(uint32_t seed) {
 
 template<BoardLen BOARD_LEN>
 ZobHasher<BOARD_LEN>::ZobHasher(uint32_t seed) {
-  uint32_t max = ~0 - 1;
+  // Every bit of the keys should be random, which rand() can not supply.
+  RandomEngine engine(seed);
+  std::uniform_int_distribution<HashKey> distribution;
 
   for (int i = 0; i < BoardLenSquare<BOARD_LEN>(); ++i) {
     for (int j = 0; j < 3; ++j) {
-      board_hash_[i][j] = Rand(max, seed);
+      board_hash_[i][j] = distribution(engine);
     }
   }
 
   for (int i = 0; i < 2; ++i) {
-    player_hash_[i] = Rand(max, seed);
+    player_hash_[i] = distribution(engine);
   }
 
   for (int i = 0; i < BoardLenSquare<BOARD_LEN>(); ++i) {
-    ko_hash_[i] = Rand(max, seed);
+    ko_hash_[i] = distribution(engine);
   }
 
-  noko_hash_ = Rand(max, seed);
+  noko_hash_ = distribution(engine);
 }
 
 template<typename T, typename GetHash>
@@ -116,6 +146,36 @@ HashKey ZobHasher<BOARD_LEN>::GetHash(HashKey hash,
   return r;
 }
 
+template<BoardLen BOARD_LEN>
+HashKey ZobHasher<BOARD_LEN>::GetHash(const FullBoard<BOARD_LEN> &b,
+                                      int symmetry) const {
+  HashKey result = player_hash_[b.LastForce()] ^ KoHash(b.KoIndex(), symmetry);
+
+  for (int i = 0; i < BoardLenSquare<BOARD_LEN>(); ++i) {
+    result ^= PointHash(i, b.GetPointState(i), symmetry);
+  }
+
+  return result;
+}
+
+template<BoardLen BOARD_LEN>
+HashKey ZobHasher<BOARD_LEN>::GetHash(HashKey hash,
+                                      const BoardDifference &chng,
+                                      int symmetry) const {
+  HashKey r = hash ^ KoHash(chng.KoChng().old_state, symmetry)
+      ^ KoHash(chng.KoChng().current_state, symmetry)
+      ^ player_hash_[chng.LastForceChng().old_state]
+      ^ player_hash_[chng.LastForceChng().current_state];
+
+  for (const auto &pair : chng.PointsChng()) {
+    r ^= PointHash(pair.position_index, pair.difference.old_state, symmetry)
+        ^ PointHash(pair.position_index, pair.difference.current_state,
+                    symmetry);
+  }
+
+  return r;
+}
+
 }
 
 #endif
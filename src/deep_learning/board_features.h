@@ -0,0 +1,154 @@
+#ifndef FOOLGO_SRC_DEEP_LEARNING_BOARD_FEATURES_H_
+#define FOOLGO_SRC_DEEP_LEARNING_BOARD_FEATURES_H_
+
+#include <algorithm>
+#include <array>
+#include <initializer_list>
+#include <vector>
+
+#include "../board/bit_board.h"
+#include "../board/full_board.h"
+#include "../def.h"
+#include "sample.h"
+
+namespace foolgo {
+
+// Planes of the features of a board, seen by the force to move. Liberty
+// planes mark pieces of both forces by the air count of their chains.
+enum FeaturePlane {
+  OWN_PIECE_PLANE = 0,
+  OPPONENT_PIECE_PLANE,
+  // The last force on every point.
+  SIDE_PLANE,
+  BORDER_PLANE,
+  KO_PLANE,
+  ONE_LIBERTY_PLANE,
+  TWO_LIBERTIES_PLANE,
+  MORE_LIBERTIES_PLANE,
+  FEATURE_PLANE_COUNT
+};
+
+// Planes cover the board padded by a border of one point on each side.
+template<BoardLen BOARD_LEN>
+constexpr int FeaturePlaneLen() {
+  return BOARD_LEN + 2;
+}
+
+template<BoardLen BOARD_LEN>
+constexpr int FeatureSize() {
+  return FEATURE_PLANE_COUNT * FeaturePlaneLen<BOARD_LEN>()
+      * FeaturePlaneLen<BOARD_LEN>();
+}
+
+// Writes the planes to FeatureSize() floats in CHW order, given the air
+// count of the chain of each piece. Only pieces are visited, by the bits of
+// the bitsets, so that nothing is allocated and empty points cost nothing but
+// the initial fill.
+template<BoardLen BOARD_LEN, typename AirCountOf>
+void EncodeFeatures(const BitSet<BOARD_LEN> &black_pieces,
+                    const BitSet<BOARD_LEN> &white_pieces, Force last_force,
+                    PositionIndex ko_index, const AirCountOf &air_count_of,
+                    float *features) {
+  const int plane_len = FeaturePlaneLen<BOARD_LEN>();
+  const int plane_size = plane_len * plane_len;
+  std::fill(features, features + FeatureSize<BOARD_LEN>(), 0.0f);
+
+  std::fill(features + SIDE_PLANE * plane_size,
+            features + (SIDE_PLANE + 1) * plane_size,
+            static_cast<float>(last_force));
+  float *border_plane = features + BORDER_PLANE * plane_size;
+  for (int i = 0; i < plane_len; ++i) {
+    border_plane[i] = 1.0f;
+    border_plane[plane_size - plane_len + i] = 1.0f;
+    border_plane[i * plane_len] = 1.0f;
+    border_plane[i * plane_len + plane_len - 1] = 1.0f;
+  }
+
+  // The padded index of the point.
+  auto padded_index = [plane_len](PositionIndex index) {
+    return (index / BOARD_LEN + 1) * plane_len + index % BOARD_LEN + 1;
+  };
+
+  for (Force force : {BLACK_FORCE, WHITE_FORCE}) {
+    float *piece_plane = features + (force == last_force ?
+        OPPONENT_PIECE_PLANE : OWN_PIECE_PLANE) * plane_size;
+    for (PositionIndex index : force == BLACK_FORCE ?
+        black_pieces : white_pieces) {
+      int feature_index = padded_index(index);
+      piece_plane[feature_index] = 1.0f;
+      int liberty_plane = std::min<int>(air_count_of(index), 3) - 1
+          + ONE_LIBERTY_PLANE;
+      features[liberty_plane * plane_size + feature_index] = 1.0f;
+    }
+  }
+
+  if (ko_index >= 0) {
+    features[KO_PLANE * plane_size + padded_index(ko_index)] = 1.0f;
+  }
+}
+
+// Air counts are counted once per chain, up to the 3 the planes tell apart.
+template<BoardLen BOARD_LEN>
+void EncodeBoardFeatures(const FullBoard<BOARD_LEN> &full_board,
+                         float *features) {
+  std::array<piece_structure::AirCount, BoardLenSquare<BOARD_LEN>()>
+      head_air_counts;
+  head_air_counts.fill(0);
+  EncodeFeatures<BOARD_LEN>(full_board.PointBitSet(BLACK_POINT),
+      full_board.PointBitSet(WHITE_POINT), full_board.LastForce(),
+      full_board.KoIndex(),
+      [&full_board, &head_air_counts](PositionIndex index) {
+        piece_structure::AirCount &air_count =
+            head_air_counts[full_board.ChainHead(index)];
+        if (air_count == 0) {
+          air_count = full_board.ChainAirCount(index, 3);
+        }
+        return air_count;
+      }, features);
+}
+
+// Samples keep no chains, so the air count of each chain is counted from the
+// bitsets, by flood filling it from one of its pieces.
+template<BoardLen BOARD_LEN>
+void EncodeSampleFeatures(const Sample<BOARD_LEN> &sample, float *features) {
+  BitSet<BOARD_LEN> black_pieces = sample.PieceBitSet(BLACK_FORCE);
+  BitSet<BOARD_LEN> white_pieces = sample.PieceBitSet(WHITE_FORCE);
+  BitSet<BOARD_LEN> empty_points = ~(black_pieces | white_pieces);
+  std::array<piece_structure::AirCount, BoardLenSquare<BOARD_LEN>()>
+      air_counts;
+
+  for (const BitSet<BOARD_LEN> &pieces : {black_pieces, white_pieces}) {
+    BitSet<BOARD_LEN> remaining_pieces = pieces;
+    while (!remaining_pieces.none()) {
+      BitSet<BOARD_LEN> chain;
+      chain.set(*remaining_pieces.begin());
+      chain = chain.FloodFill(pieces);
+      piece_structure::AirCount air_count =
+          (chain.Adjacent() & empty_points).count();
+      for (PositionIndex index : chain) {
+        air_counts[index] = air_count;
+      }
+      remaining_pieces.AndNot(chain);
+    }
+  }
+
+  EncodeFeatures<BOARD_LEN>(black_pieces, white_pieces, sample.LastForce(),
+      sample.ko_index, [&air_counts](PositionIndex index) {
+        return air_counts[index];
+      }, features);
+}
+
+// Writes the features of the boards one after another, in NCHW order.
+template<BoardLen BOARD_LEN>
+void EncodeBoardFeatures(
+    const std::vector<const FullBoard<BOARD_LEN>*> &full_boards,
+    float *features) {
+  for (const FullBoard<BOARD_LEN> *full_board : full_boards) {
+    EncodeBoardFeatures(*full_board, features);
+    features += FeatureSize<BOARD_LEN>();
+  }
+}
+
+}
+
+#endif
@@ -0,0 +1,120 @@
+#include "checkpoint.h"
+
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+
+namespace foolgo {
+
+using std::string;
+using std::unique_ptr;
+using std::vector;
+
+namespace {
+
+uint64_t AlignUp(uint64_t offset) {
+  return (offset + CHECKPOINT_ALIGNMENT - 1) / CHECKPOINT_ALIGNMENT
+      * CHECKPOINT_ALIGNMENT;
+}
+
+}
+
+void CheckpointWriter::AddTensor(const string &name, int rows, int cols,
+                                 const float *data) {
+  assert(static_cast<int>(name.size()) < CHECKPOINT_NAME_LEN);
+  assert(rows > 0 && cols > 0);
+  Tensor tensor = {name, rows, cols, data};
+  tensors_.push_back(tensor);
+}
+
+bool CheckpointWriter::Write(const string &path) const {
+  CheckpointHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic));
+  header.version = CHECKPOINT_VERSION;
+  header.tensor_count = tensors_.size();
+
+  vector<CheckpointEntry> entries(tensors_.size());
+  uint64_t offset = sizeof(header) + entries.size() * sizeof(CheckpointEntry);
+  for (size_t i = 0; i < tensors_.size(); ++i) {
+    std::memset(&entries[i], 0, sizeof(entries[i]));
+    std::memcpy(entries[i].name, tensors_[i].name.data(),
+                tensors_[i].name.size());
+    entries[i].rows = tensors_[i].rows;
+    entries[i].cols = tensors_[i].cols;
+    offset = AlignUp(offset);
+    entries[i].offset = offset;
+    offset += sizeof(float) * tensors_[i].rows * tensors_[i].cols;
+  }
+  header.file_size = offset;
+
+  string temp_path = path + ".tmp";
+  std::FILE *file = std::fopen(temp_path.c_str(), "wb");
+  if (file == nullptr) {
+    return false;
+  }
+  bool is_written = std::fwrite(&header, sizeof(header), 1, file) == 1
+      && (entries.empty() || std::fwrite(entries.data(),
+          sizeof(CheckpointEntry), entries.size(), file) == entries.size());
+  const char padding[CHECKPOINT_ALIGNMENT] = {};
+  for (size_t i = 0; i < tensors_.size() && is_written; ++i) {
+    long padding_size = entries[i].offset - std::ftell(file);
+    size_t float_count = tensors_[i].rows * tensors_[i].cols;
+    is_written = (padding_size == 0
+        || std::fwrite(padding, padding_size, 1, file) == 1)
+        && std::fwrite(tensors_[i].data, sizeof(float), float_count, file)
+            == float_count;
+  }
+  is_written = std::fclose(file) == 0 && is_written;
+  if (!is_written || std::rename(temp_path.c_str(), path.c_str()) != 0) {
+    std::remove(temp_path.c_str());
+    return false;
+  }
+  return true;
+}
+
+unique_ptr<Checkpoint> Checkpoint::Open(const string &path) {
+  unique_ptr<util::MappedFile> mapped_file = util::MappedFile::Open(path);
+  if (mapped_file == nullptr
+      || mapped_file->Size() < sizeof(CheckpointHeader)) {
+    return nullptr;
+  }
+  const char *data = static_cast<const char *>(mapped_file->Data());
+  const CheckpointHeader *header =
+      reinterpret_cast<const CheckpointHeader *>(data);
+  uint64_t size = mapped_file->Size();
+  if (std::memcmp(header->magic, CHECKPOINT_MAGIC, sizeof(header->magic)) != 0
+      || header->version != CHECKPOINT_VERSION || header->file_size != size
+      || sizeof(CheckpointHeader)
+          + header->tensor_count * sizeof(CheckpointEntry) > size) {
+    return nullptr;
+  }
+
+  unique_ptr<Checkpoint> checkpoint(new Checkpoint(std::move(mapped_file)));
+  const CheckpointEntry *entries = reinterpret_cast<const CheckpointEntry *>(
+      data + sizeof(CheckpointHeader));
+  for (uint32_t i = 0; i < header->tensor_count; ++i) {
+    const CheckpointEntry &entry = entries[i];
+    uint64_t tensor_size = sizeof(float) * entry.rows * entry.cols;
+    if (entry.name[CHECKPOINT_NAME_LEN - 1] != '\0'
+        || entry.offset % CHECKPOINT_ALIGNMENT != 0
+        || entry.offset > size || tensor_size > size - entry.offset) {
+      return nullptr;
+    }
+    checkpoint->entries_[entry.name] = &entry;
+  }
+  return checkpoint;
+}
+
+const float *Checkpoint::Tensor(const string &name, int rows,
+                                int cols) const {
+  auto it = entries_.find(name);
+  if (it == entries_.end() || static_cast<int>(it->second->rows) != rows
+      || static_cast<int>(it->second->cols) != cols) {
+    return nullptr;
+  }
+  const char *data = static_cast<const char *>(mapped_file_->Data());
+  return reinterpret_cast<const float *>(data + it->second->offset);
+}
+
+}
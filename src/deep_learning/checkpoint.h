@@ -0,0 +1,94 @@
+#ifndef FOOLGO_SRC_DEEP_LEARNING_CHECKPOINT_H_
+#define FOOLGO_SRC_DEEP_LEARNING_CHECKPOINT_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../def.h"
+#include "../util/mapped_file.h"
+
+namespace foolgo {
+
+const char CHECKPOINT_MAGIC[8] = {'F', 'G', 'M', 'O', 'D', 'E', 'L', '\0'};
+const uint32_t CHECKPOINT_VERSION = 1;
+// Tensors begin at multiples of it in the file, so that they are aligned for
+// SIMD loads in the mapping.
+const uint64_t CHECKPOINT_ALIGNMENT = 64;
+const int CHECKPOINT_NAME_LEN = 48;
+
+// The header of a checkpoint file, which is followed by tensor_count entries
+// and then by the float data of the tensors.
+struct CheckpointHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t tensor_count;
+  uint64_t file_size;
+  char reserved[40];
+};
+
+struct CheckpointEntry {
+  char name[CHECKPOINT_NAME_LEN];
+  uint32_t rows;
+  uint32_t cols;
+  // From the beginning of the file.
+  uint64_t offset;
+};
+
+/**
+ * Collects named float tensors and writes them to a checkpoint.
+ */
+class CheckpointWriter {
+ public:
+  CheckpointWriter() = default;
+  DISALLOW_COPY_AND_ASSIGN_AND_MOVE(CheckpointWriter)
+
+  // The data should live until Write, and the name should be shorter than
+  // CHECKPOINT_NAME_LEN.
+  void AddTensor(const std::string &name, int rows, int cols,
+                 const float *data);
+  // Writes to a temporary file renamed to the path when done, so that a
+  // checkpoint taken during training never leaves a partial file. Returns
+  // false if the file can not be written.
+  bool Write(const std::string &path) const;
+
+ private:
+  struct Tensor {
+    std::string name;
+    int rows;
+    int cols;
+    const float *data;
+  };
+
+  std::vector<Tensor> tensors_;
+};
+
+/**
+ * A checkpoint mapped into memory, whose tensors are read in place, so that
+ * opening it costs only the check of the entries.
+ */
+class Checkpoint {
+ public:
+  DISALLOW_COPY_AND_ASSIGN_AND_MOVE(Checkpoint)
+
+  // Returns nullptr if the file can not be mapped or is malformed.
+  static std::unique_ptr<Checkpoint> Open(const std::string &path);
+
+  // The data of the tensor in the mapping, or nullptr if there is no tensor
+  // of the name and the shape.
+  const float *Tensor(const std::string &name, int rows, int cols) const;
+
+ private:
+  explicit Checkpoint(std::unique_ptr<util::MappedFile> mapped_file)
+      : mapped_file_(std::move(mapped_file)) {}
+
+  std::unique_ptr<util::MappedFile> mapped_file_;
+  std::unordered_map<std::string, const CheckpointEntry *> entries_;
+};
+
+}
+
+#endif
@@ -0,0 +1,167 @@
+#ifndef FOOLGO_SRC_DEEP_LEARNING_CNN_CONV_LAYER_H
+#define FOOLGO_SRC_DEEP_LEARNING_CNN_CONV_LAYER_H
+
+#include <Eigen/Dense>
+
+#include <cmath>
+
+namespace foolgo {
+
+typedef Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
+    ConvMatrix;
+typedef Eigen::VectorXf ConvVector;
+
+// Gradients of the kernel of a convolution.
+struct ConvGrad {
+  ConvMatrix weight;
+  ConvVector bias;
+
+  void Clear(int in_channels, int out_channels) {
+    weight = ConvMatrix::Zero(out_channels, in_channels * 9);
+    bias = ConvVector::Zero(out_channels);
+  }
+};
+
+// The kernel of a 3x3 convolution, trained by AdaGrad. Columns of the weight
+// are ordered by input channel, then kernel y, then kernel x.
+struct ConvParams {
+  ConvMatrix weight;
+  ConvVector bias;
+  ConvGrad grad;
+  ConvMatrix weight_grad_square_sum;
+  ConvVector bias_grad_square_sum;
+
+  int InChannels() const {
+    return weight.cols() / 9;
+  }
+  int OutChannels() const {
+    return weight.rows();
+  }
+
+  // Weights are uniform in the Glorot range, as those of N3LDG.
+  void Init(int in_channels, int out_channels) {
+    float bound = std::sqrt(6.0f / (in_channels * 9 + out_channels));
+    weight = ConvMatrix::Random(out_channels, in_channels * 9) * bound;
+    bias = ConvVector::Zero(out_channels);
+    weight_grad_square_sum = ConvMatrix::Zero(out_channels, in_channels * 9);
+    bias_grad_square_sum = ConvVector::Zero(out_channels);
+    grad.Clear(in_channels, out_channels);
+  }
+
+  // Applies the gradients summed since the last update, and clears them.
+  void Update(float alpha, float reg, float eps) {
+    grad.weight += reg * weight;
+    weight_grad_square_sum += grad.weight.cwiseAbs2();
+    weight.array() -= alpha * grad.weight.array()
+        / (weight_grad_square_sum.array() + eps).sqrt();
+    grad.bias += reg * bias;
+    bias_grad_square_sum += grad.bias.cwiseAbs2();
+    bias.array() -= alpha * grad.bias.array()
+        / (bias_grad_square_sum.array() + eps).sqrt();
+    grad.Clear(InChannels(), OutChannels());
+  }
+};
+
+/**
+ * A 3x3 convolution without padding followed by ReLU, over a batch of square
+ * maps of in_len, which become maps of in_len - 2. Maps of a batch are
+ * contiguous in NCHW order. Each sample is unfolded into a matrix of the 3x3
+ * patch of each output point (im2col), so that the convolution is one matrix
+ * product. The layer keeps only this scratch, which is why a layer is used by
+ * one thread at a time.
+ */
+class ConvLayer {
+ public:
+  void Forward(const ConvParams &params, int in_len, const float *input,
+               int batch_size, float *output) {
+    int out_len = in_len - 2;
+    int in_size = params.InChannels() * in_len * in_len;
+    int out_size = params.OutChannels() * out_len * out_len;
+
+    for (int n = 0; n < batch_size; ++n) {
+      Unfold(input + n * in_size, params.InChannels(), in_len);
+      Eigen::Map<ConvMatrix> output_map(output + n * out_size,
+                                        params.OutChannels(),
+                                        out_len * out_len);
+      output_map.noalias() = params.weight * columns_;
+      output_map.colwise() += params.bias;
+      output_map = output_map.cwiseMax(0.0f);
+    }
+  }
+
+  // Adds the gradients of the kernel to grad, and sets input_grad to the
+  // gradient of the input unless it is nullptr. Input and output are those of
+  // Forward.
+  void Backward(const ConvParams &params, int in_len, const float *input,
+                const float *output, const float *output_grad, int batch_size,
+                ConvGrad *grad, float *input_grad) {
+    int out_len = in_len - 2;
+    int in_size = params.InChannels() * in_len * in_len;
+    int out_size = params.OutChannels() * out_len * out_len;
+
+    for (int n = 0; n < batch_size; ++n) {
+      Eigen::Map<const ConvMatrix> output_map(output + n * out_size,
+                                              params.OutChannels(),
+                                              out_len * out_len);
+      Eigen::Map<const ConvMatrix> output_grad_map(output_grad + n * out_size,
+                                                   params.OutChannels(),
+                                                   out_len * out_len);
+      pre_activation_grad_ = (output_map.array() > 0.0f).select(
+          output_grad_map.array(), 0.0f).matrix();
+      Unfold(input + n * in_size, params.InChannels(), in_len);
+      grad->weight.noalias() += pre_activation_grad_ * columns_.transpose();
+      grad->bias += pre_activation_grad_.rowwise().sum();
+
+      if (input_grad != nullptr) {
+        column_grad_.noalias() = params.weight.transpose()
+            * pre_activation_grad_;
+        Fold(params.InChannels(), in_len, input_grad + n * in_size);
+      }
+    }
+  }
+
+ private:
+  ConvMatrix columns_;
+  ConvMatrix pre_activation_grad_;
+  ConvMatrix column_grad_;
+
+  void Unfold(const float *maps, int channels, int in_len) {
+    int out_len = in_len - 2;
+    columns_.resize(channels * 9, out_len * out_len);
+    for (int c = 0; c < channels; ++c) {
+      const float *map = maps + c * in_len * in_len;
+      for (int k = 0; k < 9; ++k) {
+        float *row = columns_.row(c * 9 + k).data();
+        const float *patch_origin = map + (k / 3) * in_len + k % 3;
+        for (int y = 0; y < out_len; ++y) {
+          for (int x = 0; x < out_len; ++x) {
+            *row++ = patch_origin[y * in_len + x];
+          }
+        }
+      }
+    }
+  }
+
+  // Sums the patch gradients back into the maps, which is the reverse of
+  // Unfold.
+  void Fold(int channels, int in_len, float *maps) {
+    int out_len = in_len - 2;
+    Eigen::Map<ConvVector>(maps, channels * in_len * in_len).setZero();
+    for (int c = 0; c < channels; ++c) {
+      float *map = maps + c * in_len * in_len;
+      for (int k = 0; k < 9; ++k) {
+        const float *row = column_grad_.row(c * 9 + k).data();
+        float *patch_origin = map + (k / 3) * in_len + k % 3;
+        for (int y = 0; y < out_len; ++y) {
+          for (int x = 0; x < out_len; ++x) {
+            patch_origin[y * in_len + x] += *row++;
+          }
+        }
+      }
+    }
+  }
+};
+
+}
+
+#endif
@@ -0,0 +1,123 @@
+#ifndef FOOLGO_SRC_DEEP_LEARNING_CNN_CONV_TOWER_H
+#define FOOLGO_SRC_DEEP_LEARNING_CNN_CONV_TOWER_H
+
+#include <cassert>
+#include <utility>
+#include <vector>
+
+#include "../../def.h"
+#include "conv_layer.h"
+
+namespace foolgo {
+
+/**
+ * The convolutions of a sequence of kernels over a batch, each shrinking the
+ * maps by 2, with the activations and the gradients of its own, so that
+ * towers over shards of a batch run on their own threads. The gradients are
+ * summed into the kernels by AddGrads.
+ */
+class ConvTower {
+ public:
+  // The kernels, of layer_count, should outlive the tower.
+  ConvTower(const ConvParams *params, int layer_count, int in_len)
+      : params_(params), activations_(layer_count + 1), grads_(layer_count),
+        in_len_(in_len) {
+    assert(in_len - 2 * layer_count > 0);
+    ClearGrads();
+  }
+  DISALLOW_COPY_AND_ASSIGN_AND_MOVE(ConvTower)
+
+  int LayerCount() const {
+    return grads_.size();
+  }
+  int InputSize() const {
+    return params_[0].InChannels() * in_len_ * in_len_;
+  }
+  int OutputSize() const {
+    int out_len = in_len_ - 2 * LayerCount();
+    return params_[LayerCount() - 1].OutChannels() * out_len * out_len;
+  }
+
+  // The input of the batch, to be written before Forward.
+  float *MutableInput(int batch_size) {
+    batch_size_ = batch_size;
+    activations_.front().resize(batch_size * InputSize());
+    return activations_.front().data();
+  }
+  void Forward() {
+    int in_len = in_len_;
+    for (int i = 0; i < LayerCount(); ++i) {
+      int out_len = in_len - 2;
+      activations_.at(i + 1).resize(
+          batch_size_ * params_[i].OutChannels() * out_len * out_len);
+      conv_layer_.Forward(params_[i], in_len, activations_.at(i).data(),
+                          batch_size_, activations_.at(i + 1).data());
+      in_len = out_len;
+    }
+  }
+  const float *Output(int sample_index) const {
+    return activations_.back().data() + sample_index * OutputSize();
+  }
+
+  // The gradient of the output of the batch, to be written before Backward.
+  float *MutableOutputGrad() {
+    output_grad_.resize(batch_size_ * OutputSize());
+    return output_grad_.data();
+  }
+  // Adds the gradients of the kernels since the last ClearGrads.
+  void Backward() {
+    int in_len = in_len_ - 2 * LayerCount() + 2;
+    for (int i = LayerCount() - 1; i >= 0; --i) {
+      input_grad_.resize(activations_.at(i).size());
+      conv_layer_.Backward(params_[i], in_len, activations_.at(i).data(),
+          activations_.at(i + 1).data(), output_grad_.data(), batch_size_,
+          &grads_.at(i), i == 0 ? nullptr : input_grad_.data());
+      std::swap(output_grad_, input_grad_);
+      in_len += 2;
+    }
+  }
+
+  const ConvGrad &Grad(int layer_index) const {
+    return grads_.at(layer_index);
+  }
+  ConvGrad *MutableGrad(int layer_index) {
+    return &grads_.at(layer_index);
+  }
+  void ClearGrads() {
+    for (int i = 0; i < LayerCount(); ++i) {
+      grads_.at(i).Clear(params_[i].InChannels(), params_[i].OutChannels());
+    }
+  }
+
+ private:
+  const ConvParams *params_;
+  ConvLayer conv_layer_;
+  // The input and the outputs of each convolution, of the batch.
+  std::vector<std::vector<float>> activations_;
+  std::vector<float> output_grad_;
+  std::vector<float> input_grad_;
+  std::vector<ConvGrad> grads_;
+  int in_len_;
+  int batch_size_ = 0;
+};
+
+// Sums the gradients of the layer of the towers into its kernel by pairs in
+// rounds, which leaves the gradients of the towers changed.
+inline void ReduceConvGrads(const std::vector<ConvTower *> &towers,
+                            int layer_index, ConvParams *params) {
+  int tower_count = towers.size();
+  for (int stride = 1; stride < tower_count; stride *= 2) {
+    for (int i = 0; i + stride < tower_count; i += 2 * stride) {
+      ConvGrad *grad = towers.at(i)->MutableGrad(layer_index);
+      const ConvGrad &other = towers.at(i + stride)->Grad(layer_index);
+      grad->weight += other.weight;
+      grad->bias += other.bias;
+    }
+  }
+  params->grad.weight += towers.front()->Grad(layer_index).weight;
+  params->grad.bias += towers.front()->Grad(layer_index).bias;
+}
+
+}
+
+#endif
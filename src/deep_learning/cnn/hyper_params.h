@@ -2,8 +2,11 @@
 #define FOOLGO_SRC_DEEP_LEARNING_RESNET_HYPER_PARAMS_H
 
 struct HyperParams {
-  int input_dim = 5;
+  // FEATURE_PLANE_COUNT of board_features.h.
+  int input_dim = 8;
   int batch = 1;
+  // Threads each running the graph of a shard of the batch.
+  int thread_count = 1;
   int hidden_dim = 200;
   float learning_rate = 0.001f;
   float ada_eps = 1e-8;
@@ -1,31 +1,157 @@
 #ifndef FOOLGO_SRC_DEEP_LEARNING_RESNET_MODEL_PARAMS_H
 #define FOOLGO_SRC_DEEP_LEARNING_RESNET_MODEL_PARAMS_H
 
+#include <array>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <boost/format.hpp>
+
 #include "N3LDG.h"
+#include "../checkpoint.h"
+#include "conv_layer.h"
 #include "hyper_params.h"
 
 namespace foolgo {
 
+// Convolutions shrinking the 21x21 input to 1x1.
+const int CONV_LAYER_COUNT = 10;
+
 struct ModelParams {
-  std::array<UniParams, 9> uni_params_arr;
+  std::array<ConvParams, CONV_LAYER_COUNT> conv_params_arr;
   UniParams output_param;
 
   void Init(const HyperParams &hyper_params) {
-    for (int i = 0; i < 9; ++i) {
-      int len = 19 - i * 2;
-      uni_params_arr.at(i).initial(hyper_params.hidden_dim, (i == 0?
-            hyper_params.input_dim : hyper_params.hidden_dim)* 9, true);
+    for (int i = 0; i < CONV_LAYER_COUNT; ++i) {
+      conv_params_arr.at(i).Init(i == 0 ? hyper_params.input_dim :
+          hyper_params.hidden_dim, hyper_params.hidden_dim);
     }
 
     output_param.initial(362, hyper_params.hidden_dim, true);
   }
 
+  // Convolutions are updated by UpdateConvParams instead, for N3LDG does not
+  // know them.
   void ExportModelParams(ModelUpdate &update) {
-    for (UniParams &param : uni_params_arr) {
-      param.exportAdaParams(update);
+    output_param.exportAdaParams(update);
+  }
+
+  // Writes the weights and the AdaGrad sums of their squared gradients, so
+  // that training resumes where it stopped.
+  bool Save(const std::string &path) const {
+    CheckpointWriter writer;
+    for (int i = 0; i < CONV_LAYER_COUNT; ++i) {
+      const ConvParams &params = conv_params_arr.at(i);
+      std::string prefix = (boost::format("conv%1%/") % i).str();
+      writer.AddTensor(prefix + "weight", params.weight.rows(),
+                       params.weight.cols(), params.weight.data());
+      writer.AddTensor(prefix + "bias", params.bias.size(), 1,
+                       params.bias.data());
+      writer.AddTensor(prefix + "weight_square",
+                       params.weight_grad_square_sum.rows(),
+                       params.weight_grad_square_sum.cols(),
+                       params.weight_grad_square_sum.data());
+      writer.AddTensor(prefix + "bias_square",
+                       params.bias_grad_square_sum.size(), 1,
+                       params.bias_grad_square_sum.data());
+    }
+    AddParam("output/weight", output_param.W, &writer);
+    if (output_param.bUseB) {
+      AddParam("output/bias", output_param.b, &writer);
     }
+    return writer.Write(path);
+  }
 
-    output_param.exportAdaParams(update);
+  // Loads a checkpoint into params initialized by the same hyper params.
+  // Returns false, leaving the params as they are, if the checkpoint can not
+  // be opened or any of its tensors is missing or of another shape.
+  // Tensors are copied from the mapping, for the Eigen matrices of the
+  // kernels and the N3LDG params own their buffers, which training updates
+  // and N3LDG nodes point to. The mapping only spares reading the file into
+  // a buffer first, and is closed once loaded.
+  bool Load(const std::string &path) {
+    std::unique_ptr<Checkpoint> checkpoint = Checkpoint::Open(path);
+    if (checkpoint == nullptr) {
+      return false;
+    }
+    std::vector<TensorCopy> copies;
+    for (int i = 0; i < CONV_LAYER_COUNT; ++i) {
+      ConvParams &params = conv_params_arr.at(i);
+      std::string prefix = (boost::format("conv%1%/") % i).str();
+      if (!AddCopy(*checkpoint, prefix + "weight", params.weight.rows(),
+                   params.weight.cols(), params.weight.data(), &copies)
+          || !AddCopy(*checkpoint, prefix + "bias", params.bias.size(), 1,
+                      params.bias.data(), &copies)
+          || !AddCopy(*checkpoint, prefix + "weight_square",
+                      params.weight_grad_square_sum.rows(),
+                      params.weight_grad_square_sum.cols(),
+                      params.weight_grad_square_sum.data(), &copies)
+          || !AddCopy(*checkpoint, prefix + "bias_square",
+                      params.bias_grad_square_sum.size(), 1,
+                      params.bias_grad_square_sum.data(), &copies)) {
+        return false;
+      }
+    }
+    if (!AddParamCopies(*checkpoint, "output/weight", &output_param.W,
+                        &copies)
+        || (output_param.bUseB && !AddParamCopies(*checkpoint, "output/bias",
+                                                  &output_param.b, &copies))) {
+      return false;
+    }
+
+    for (const TensorCopy &copy : copies) {
+      std::memcpy(copy.destination, copy.source,
+                  sizeof(float) * copy.float_count);
+    }
+    return true;
+  }
+
+  void UpdateConvParams(const HyperParams &hyper_params) {
+    for (ConvParams &params : conv_params_arr) {
+      params.Update(hyper_params.learning_rate, hyper_params.reg,
+                    hyper_params.ada_eps);
+    }
+  }
+
+ private:
+  static_assert(std::is_same<dtype, float>::value,
+                "checkpoints hold float tensors");
+
+  struct TensorCopy {
+    float *destination;
+    const float *source;
+    int float_count;
+  };
+
+  static void AddParam(const std::string &name, const Param &param,
+                       CheckpointWriter *writer) {
+    writer->AddTensor(name, param.val.row, param.val.col, param.val.v);
+    writer->AddTensor(name + "_square", param.aux_square.row,
+                      param.aux_square.col, param.aux_square.v);
+  }
+
+  static bool AddCopy(const Checkpoint &checkpoint, const std::string &name,
+                      int rows, int cols, float *destination,
+                      std::vector<TensorCopy> *copies) {
+    const float *source = checkpoint.Tensor(name, rows, cols);
+    if (source == nullptr) {
+      return false;
+    }
+    TensorCopy copy = {destination, source, rows * cols};
+    copies->push_back(copy);
+    return true;
+  }
+
+  static bool AddParamCopies(const Checkpoint &checkpoint,
+                             const std::string &name, Param *param,
+                             std::vector<TensorCopy> *copies) {
+    return AddCopy(checkpoint, name, param->val.row, param->val.col,
+                   param->val.v, copies)
+        && AddCopy(checkpoint, name + "_square", param->aux_square.row,
+                   param->aux_square.col, param->aux_square.v, copies);
   }
 };
 
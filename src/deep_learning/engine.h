@@ -2,24 +2,42 @@
 #define FOOLGO_SRC_DEEP_LEARNING_ENGINE_H
 
 #include "N3LDG.h"
+#include "board_features.h"
+#include "cnn/conv_tower.h"
 #include "cnn/graph_builder.h"
+#include "evaluation_queue.h"
 #include "sample.h"
+#include "../util/thread_pool.h"
 
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
 #include <vector>
 
 namespace foolgo {
 
-std::vector<dtype> PositionIndexToVector(PositionIndex index) {
+inline std::vector<dtype> PositionIndexToVector(PositionIndex index) {
   std::vector<dtype> result;
   result.resize(362);
-  PositionIndex clean_index = index ==
-    (POSITION_INDEX_PASS || index == POSITION_INDEX_END) ? 361 : index;
+  PositionIndex clean_index =
+    (index == POSITION_INDEX_PASS || index == POSITION_INDEX_END) ? 361 : index;
   for (int i = 0; i < 362; ++i) {
     result.at(i) = clean_index == i;
   }
   return result;
 }
 
+/**
+ * Trains and evaluates the network over batches split into shards, one per
+ * worker. Each worker owns a graph of its shard and the convolutions of it,
+ * which run on a thread of the pool, and the gradients of the workers are
+ * summed into the model params before one update.
+ */
 class Engine {
  public:
   Engine() = default;
@@ -28,51 +46,232 @@ class Engine {
     hyper_params_(hyper_params) {}
 
   void Init() {
+    assert(hyper_params_.input_dim == FEATURE_PLANE_COUNT);
     model_params_.Init(hyper_params_);
     model_params_.ExportModelParams(model_updater_);
-    builders_.resize(hyper_params_.batch);
 
-    for (GraphBuilder &builder : builders_) {
-      builder.CreateNodes();
-      builder.Init(graph_, hyper_params_, model_params_);
+    int worker_count = hyper_params_.thread_count;
+    int shard_size = (hyper_params_.batch + worker_count - 1) / worker_count;
+    for (int i = 0; i < worker_count; ++i) {
+      std::unique_ptr<Worker> worker(new Worker);
+      worker->builders.resize(shard_size);
+      for (GraphBuilder &builder : worker->builders) {
+        builder.CreateNodes();
+        builder.Init(worker->graph, hyper_params_, model_params_);
+      }
+      worker->conv_tower.reset(new ConvTower(
+          model_params_.conv_params_arr.data(), CONV_LAYER_COUNT,
+          FeaturePlaneLen<19>()));
+      workers_.push_back(std::move(worker));
     }
-    
+    if (worker_count > 1) {
+      thread_pool_.reset(new util::ThreadPool(worker_count));
+    }
+
     model_updater_._alpha = hyper_params_.learning_rate;
     model_updater_._eps = hyper_params_.ada_eps;
     model_updater_._reg = hyper_params_.reg;
   }
 
+  // Returns an initialized engine of the checkpoint, which should be of the
+  // same hyper params, such as one written by the trainer, or nullptr if it
+  // can not be loaded.
+  static std::unique_ptr<Engine> Open(const std::string &path,
+                                      const HyperParams &hyper_params) {
+    std::unique_ptr<Engine> engine(new Engine(hyper_params));
+    engine->Init();
+    if (!engine->LoadModel(path)) {
+      return nullptr;
+    }
+    return engine;
+  }
+
+  // Both return false if the checkpoint can not be written or loaded, and
+  // are called after Init.
+  bool SaveModel(const std::string &path) const {
+    return model_params_.Save(path);
+  }
+  bool LoadModel(const std::string &path) {
+    return model_params_.Load(path);
+  }
+
   dtype Train(const std::vector<Sample<19>> &samples) {
-    metric_.reset();
-    graph_.clearValue();
-    graph_.train = true;
+    RunShards(samples.size(), [this, &samples](Worker *worker, int begin,
+                                               int end) {
+      worker->conv_tower->ClearGrads();
+      worker->cost = 0.0f;
+      if (begin == end) {
+        return;
+      }
+      float *input = worker->conv_tower->MutableInput(end - begin);
+      for (int n = begin; n < end; ++n) {
+        EncodeSampleFeatures(samples.at(n),
+                             input + (n - begin) * FeatureSize<19>());
+      }
+      Forward(worker, end - begin, true);
 
-    int i = 0;
-    for (const Sample<19> &sample : samples) {
-      builders_.at(i++).forward(sample.full_board);
-    }
+      // softMaxLoss only writes the losses of the output nodes and the
+      // metric, which are of the worker, so it runs unlocked.
+      worker->metric.reset();
+      for (int n = begin; n < end; ++n) {
+        PositionIndex index = samples.at(n).position_index;
+        worker->cost += softMaxLoss(&worker->builders.at(n - begin).output_node,
+            PositionIndexToVector(index), worker->metric,
+            hyper_params_.batch);
+      }
+      {
+        // The graphs share the output params, whose gradients backward adds.
+        std::lock_guard<std::mutex> lock(backward_mutex_);
+        worker->graph.backward();
+      }
+      BackwardConvolutions(worker, end - begin);
+    });
 
-    graph_.compute();
+    ReduceConvGrads();
+    model_updater_.update();
+    model_params_.UpdateConvParams(hyper_params_);
 
     dtype cost = 0.0f;
-    i = 0;
-    for (const Sample<19> &sample : samples) {
-      PositionIndex index = sample.position_index;
-      cost += softMaxLoss(&builders_.at(i++).output_node,
-          PositionIndexToVector(index), metric_, hyper_params_.batch);
+    for (const std::unique_ptr<Worker> &worker : workers_) {
+      cost += worker->cost;
     }
-
-    graph_.backward();
     return cost;
   }
 
+  // Runs one forward pass over at most a batch of boards, which fits
+  // EvaluationQueue<19>::BatchEvaluator. The policy is the softmax of the
+  // output, and the value stays even, for the graph has no value head.
+  void Evaluate(const std::vector<const FullBoard<19>*> &full_boards,
+                std::vector<Evaluation> *evaluations) {
+    assert(static_cast<int>(full_boards.size()) <= hyper_params_.batch);
+    evaluations->resize(full_boards.size());
+    RunShards(full_boards.size(), [this, &full_boards, evaluations](
+        Worker *worker, int begin, int end) {
+      if (begin == end) {
+        return;
+      }
+      float *input = worker->conv_tower->MutableInput(end - begin);
+      for (int n = begin; n < end; ++n) {
+        EncodeBoardFeatures(*full_boards.at(n),
+                            input + (n - begin) * FeatureSize<19>());
+      }
+      Forward(worker, end - begin, false);
+
+      for (int n = begin; n < end; ++n) {
+        const auto &output = worker->builders.at(n - begin).output_node.val;
+        std::vector<float> &policy = evaluations->at(n).policy;
+        policy.resize(362);
+        dtype max_output = output[0];
+        for (int j = 1; j < 362; ++j) {
+          max_output = std::max(max_output, output[j]);
+        }
+        float sum = 0.0f;
+        for (int j = 0; j < 362; ++j) {
+          policy.at(j) = std::exp(output[j] - max_output);
+          sum += policy.at(j);
+        }
+        for (float &probability : policy) {
+          probability /= sum;
+        }
+        evaluations->at(n).value = 0.5f;
+      }
+    });
+  }
+
  private:
-  Graph graph_;
-  std::vector<GraphBuilder> builders_;
+  // The graph and the convolutions of a shard of the batch.
+  struct Worker {
+    Graph graph;
+    std::vector<GraphBuilder> builders;
+    std::unique_ptr<ConvTower> conv_tower;
+    std::vector<std::vector<dtype>> hidden_values;
+    Metric metric;
+    dtype cost = 0.0f;
+  };
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  // Null if there is one worker, which runs on the calling thread.
+  std::unique_ptr<util::ThreadPool> thread_pool_;
+  std::mutex backward_mutex_;
   ModelParams model_params_;
   HyperParams hyper_params_;
-  Metric metric_;
   ModelUpdate model_updater_;
+
+  // Runs the contiguous shards of the samples, one per worker, and returns
+  // when all are done.
+  void RunShards(int sample_count,
+                 const std::function<void(Worker*, int, int)> &run) {
+    int worker_count = workers_.size();
+    for (int i = 0; i < worker_count; ++i) {
+      Worker *worker = workers_.at(i).get();
+      int begin = sample_count * i / worker_count;
+      int end = sample_count * (i + 1) / worker_count;
+      if (thread_pool_ == nullptr) {
+        run(worker, begin, end);
+      } else {
+        thread_pool_->Submit(i, [&run, worker, begin, end](int) {
+          run(worker, begin, end);
+        });
+      }
+    }
+    if (thread_pool_ != nullptr) {
+      thread_pool_->Wait();
+    }
+  }
+
+  // Runs the convolutions over the input of the shard, and feeds their
+  // outputs to the graph of each board.
+  void Forward(Worker *worker, int shard_size, bool is_training) {
+    assert(shard_size <= static_cast<int>(worker->builders.size()));
+    worker->graph.clearValue();
+    worker->graph.train = is_training;
+    worker->conv_tower->Forward();
+
+    int hidden_dim = hyper_params_.hidden_dim;
+    worker->hidden_values.resize(shard_size);
+    for (int n = 0; n < shard_size; ++n) {
+      const float *hidden = worker->conv_tower->Output(n);
+      worker->hidden_values.at(n).assign(hidden, hidden + hidden_dim);
+      worker->builders.at(n).forward(worker->hidden_values.at(n).data());
+    }
+    worker->graph.compute();
+  }
+
+  // Backs the losses of the hidden nodes up through the convolutions, adding
+  // the gradients of their kernels to those of the worker.
+  void BackwardConvolutions(Worker *worker, int shard_size) {
+    int hidden_dim = hyper_params_.hidden_dim;
+    float *output_grad = worker->conv_tower->MutableOutputGrad();
+    for (int n = 0; n < shard_size; ++n) {
+      for (int j = 0; j < hidden_dim; ++j) {
+        output_grad[n * hidden_dim + j] =
+            worker->builders.at(n).hidden_node.loss[j];
+      }
+    }
+    worker->conv_tower->Backward();
+  }
+
+  // Sums the gradients of the workers into the model params, one layer per
+  // task.
+  void ReduceConvGrads() {
+    std::vector<ConvTower*> towers;
+    for (const std::unique_ptr<Worker> &worker : workers_) {
+      towers.push_back(worker->conv_tower.get());
+    }
+    for (int i = 0; i < CONV_LAYER_COUNT; ++i) {
+      ConvParams *params = &model_params_.conv_params_arr.at(i);
+      if (thread_pool_ == nullptr) {
+        foolgo::ReduceConvGrads(towers, i, params);
+      } else {
+        thread_pool_->Submit([&towers, i, params](int) {
+          foolgo::ReduceConvGrads(towers, i, params);
+        });
+      }
+    }
+    if (thread_pool_ != nullptr) {
+      thread_pool_->Wait();
+    }
+  }
 };
 
 }
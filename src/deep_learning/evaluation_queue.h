@@ -0,0 +1,184 @@
+#ifndef FOOLGO_SRC_DEEP_LEARNING_EVALUATION_QUEUE_H_
+#define FOOLGO_SRC_DEEP_LEARNING_EVALUATION_QUEUE_H_
+
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../board/full_board.h"
+#include "../def.h"
+
+namespace foolgo {
+
+// The policy has a probability per position index and one more for passing,
+// and the value is the winning probability of the force to move.
+struct Evaluation {
+  std::vector<float> policy;
+  float value = 0.5f;
+};
+
+/**
+ * Evaluates boards submitted by search threads in batches, by one dispatcher
+ * thread. A batch is evaluated once it is full, or once its first board has
+ * waited for the deadline, so that the overhead of each evaluation is shared
+ * by the batch while few submitters block on a partial batch for long.
+ */
+template<BoardLen BOARD_LEN>
+class EvaluationQueue {
+ public:
+  // Sets an evaluation per board of the batch, in the same order.
+  typedef std::function<void(const std::vector<const FullBoard<BOARD_LEN>*>&,
+                             std::vector<Evaluation>*)> BatchEvaluator;
+
+  EvaluationQueue(const BatchEvaluator &batch_evaluator, int batch_size,
+                  std::chrono::microseconds deadline);
+  // Evaluates the boards still queued before the dispatcher stops.
+  ~EvaluationQueue();
+  DISALLOW_COPY_AND_ASSIGN_AND_MOVE(EvaluationQueue)
+
+  // The board is copied, so that it may be changed once this returns. The
+  // future throws what the evaluator throws.
+  std::future<Evaluation> Submit(const FullBoard<BOARD_LEN> &full_board);
+
+  int64_t BatchCount() const;
+  int64_t EvaluatedCount() const;
+
+ private:
+  typedef std::chrono::steady_clock Clock;
+
+  struct Request {
+    FullBoard<BOARD_LEN> full_board;
+    std::promise<Evaluation> promise;
+    Clock::time_point submitted_time;
+  };
+
+  BatchEvaluator batch_evaluator_;
+  int batch_size_;
+  std::chrono::microseconds deadline_;
+
+  // Guards the requests, the counts and the stopping flag.
+  mutable std::mutex mutex_;
+  std::condition_variable request_condition_;
+  std::deque<std::unique_ptr<Request>> requests_;
+  int64_t batch_count_ = 0;
+  int64_t evaluated_count_ = 0;
+  bool is_stopping_ = false;
+  std::thread dispatcher_;
+
+  void Dispatch();
+};
+
+template<BoardLen BOARD_LEN>
+EvaluationQueue<BOARD_LEN>::EvaluationQueue(
+    const BatchEvaluator &batch_evaluator, int batch_size,
+    std::chrono::microseconds deadline)
+    : batch_evaluator_(batch_evaluator),
+      batch_size_(batch_size),
+      deadline_(deadline) {
+  assert(batch_size > 0);
+  dispatcher_ = std::thread(&EvaluationQueue::Dispatch, this);
+}
+
+template<BoardLen BOARD_LEN>
+EvaluationQueue<BOARD_LEN>::~EvaluationQueue() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_stopping_ = true;
+  }
+  request_condition_.notify_all();
+  dispatcher_.join();
+}
+
+template<BoardLen BOARD_LEN>
+std::future<Evaluation> EvaluationQueue<BOARD_LEN>::Submit(
+    const FullBoard<BOARD_LEN> &full_board) {
+  std::unique_ptr<Request> request(new Request);
+  request->full_board.Copy(full_board);
+  request->submitted_time = Clock::now();
+  std::future<Evaluation> future = request->promise.get_future();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    requests_.push_back(std::move(request));
+  }
+  request_condition_.notify_one();
+  return future;
+}
+
+template<BoardLen BOARD_LEN>
+int64_t EvaluationQueue<BOARD_LEN>::BatchCount() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return batch_count_;
+}
+
+template<BoardLen BOARD_LEN>
+int64_t EvaluationQueue<BOARD_LEN>::EvaluatedCount() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return evaluated_count_;
+}
+
+template<BoardLen BOARD_LEN>
+void EvaluationQueue<BOARD_LEN>::Dispatch() {
+  std::vector<std::unique_ptr<Request>> batch;
+  std::vector<const FullBoard<BOARD_LEN>*> boards;
+  std::vector<Evaluation> evaluations;
+
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      request_condition_.wait(lock, [this]() {
+        return is_stopping_ || !requests_.empty();
+      });
+      if (requests_.empty()) {
+        return;
+      }
+      Clock::time_point deadline_time =
+          requests_.front()->submitted_time + deadline_;
+      request_condition_.wait_until(lock, deadline_time, [this]() {
+        return is_stopping_
+            || requests_.size() >= static_cast<size_t>(batch_size_);
+      });
+
+      while (!requests_.empty() && batch.size() < static_cast<size_t>(
+          batch_size_)) {
+        batch.push_back(std::move(requests_.front()));
+        requests_.pop_front();
+      }
+      ++batch_count_;
+      evaluated_count_ += batch.size();
+    }
+
+    boards.clear();
+    for (const auto &request : batch) {
+      boards.push_back(&request->full_board);
+    }
+    evaluations.clear();
+    evaluations.resize(batch.size());
+    std::exception_ptr exception;
+    try {
+      batch_evaluator_(boards, &evaluations);
+    } catch (...) {
+      exception = std::current_exception();
+    }
+    for (size_t i = 0; i < batch.size(); ++i) {
+      if (exception == nullptr) {
+        batch[i]->promise.set_value(std::move(evaluations[i]));
+      } else {
+        batch[i]->promise.set_exception(exception);
+      }
+    }
+    batch.clear();
+  }
+}
+
+}
+
+#endif
@@ -1,19 +1,78 @@
 #ifndef FOOLGO_SRC_DEEP_LEARNING
 #define FOOLGO_SRC_DEEP_LEARNING
 
+#include <algorithm>
+#include <cstdint>
+
+#include "board/bit_board.h"
 #include "board/full_board.h"
 
 namespace foolgo {
 
+// A training position packed into a bit plane of pieces per force, the force
+// to move, the ko point, and the targets: the move played and the result of
+// the game. It is about 100 bytes for the 19x19 board, and has neither
+// pointers nor padding that depends on the build, so samples are copied as
+// bytes.
 template<BoardLen BOARD_LEN>
 struct Sample {
-  FullBoard<BOARD_LEN> full_board;
+  static const int WORD_COUNT = BitSet<BOARD_LEN>::WORD_COUNT;
+  // Tells the sample types in shard headers.
+  static const uint32_t KIND = 0;
+
+  // Indexed by force.
+  uint64_t piece_words[2][WORD_COUNT];
+  PositionIndex ko_index;
+  // The move played, which may be POSITION_INDEX_PASS.
   PositionIndex position_index;
+  uint8_t last_force;
+  // 1 if the force to move wins the game, -1 if it loses, 0 if unknown.
+  int8_t value;
+
+  void Pack(const FullBoard<BOARD_LEN> &full_board,
+            PositionIndex played_index, int8_t game_value = 0) {
+    for (Force force : {BLACK_FORCE, WHITE_FORCE}) {
+      const uint64_t *words = full_board.PointBitSet(
+          ForceToPointState(force)).Words();
+      for (int i = 0; i < WORD_COUNT; ++i) {
+        piece_words[force][i] = words[i];
+      }
+    }
+    ko_index = full_board.KoIndex();
+    position_index = played_index;
+    last_force = full_board.LastForce();
+    value = game_value;
+  }
+
+  BitSet<BOARD_LEN> PieceBitSet(Force force) const {
+    return BitSet<BOARD_LEN>(piece_words[force]);
+  }
+  Force LastForce() const {
+    return static_cast<Force>(last_force);
+  }
+};
+
+// A position of self-play with the visits of the search choosing its move,
+// which are the policy target rather than the move played.
+template<BoardLen BOARD_LEN>
+struct SearchSample {
+  static const uint32_t KIND = 1;
+  static const int VISIT_COUNT_SIZE = BoardLenSquare<BOARD_LEN>() + 1;
 
-  Sample() = default;
+  Sample<BOARD_LEN> sample;
+  // Visits of each position index, then of passing, scaled so that the most
+  // visited move has 65535.
+  uint16_t visit_counts[VISIT_COUNT_SIZE];
 
-  Sample(const Sample &sample) : position_index(sample.position_index) {
-    full_board.Copy(sample.full_board);
+  void SetVisitCounts(const int32_t *visited_times) {
+    int32_t max_visited_time = 1;
+    for (int i = 0; i < VISIT_COUNT_SIZE; ++i) {
+      max_visited_time = std::max(max_visited_time, visited_times[i]);
+    }
+    for (int i = 0; i < VISIT_COUNT_SIZE; ++i) {
+      visit_counts[i] = static_cast<uint16_t>(
+          static_cast<int64_t>(visited_times[i]) * 65535 / max_visited_time);
+    }
   }
 };
 
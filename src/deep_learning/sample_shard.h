@@ -0,0 +1,201 @@
+#ifndef FOOLGO_SRC_DEEP_LEARNING_SAMPLE_SHARD_H_
+#define FOOLGO_SRC_DEEP_LEARNING_SAMPLE_SHARD_H_
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/format.hpp>
+
+#include "../def.h"
+#include "../util/mapped_file.h"
+#include "../util/rand.h"
+#include "sample.h"
+
+namespace foolgo {
+
+const char SAMPLE_SHARD_MAGIC[8] = {'F', 'G', 'S', 'A', 'M', 'P', 'L', 'E'};
+const uint32_t SAMPLE_SHARD_VERSION = 1;
+
+// The header of a shard file, which is followed by sample_count samples
+// copied as bytes. Its size keeps the samples aligned to 8 bytes in the
+// mapping.
+struct SampleShardHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t board_len;
+  uint32_t sample_size;
+  // The KIND of the sample type, which was reserved as 0 before there were
+  // other kinds.
+  uint32_t sample_kind;
+  uint64_t sample_count;
+};
+
+/**
+ * Writes samples to shard files of at most the count of samples each, named
+ * by the prefix and the number of the shard. Samples are written in the order
+ * added, and the count of each shard is written to its header when it is
+ * closed. Samples are of Sample or SearchSample.
+ */
+template<BoardLen BOARD_LEN, typename SampleType = Sample<BOARD_LEN>>
+class SampleShardWriter {
+ public:
+  SampleShardWriter(const std::string &path_prefix, int64_t samples_per_shard)
+      : path_prefix_(path_prefix), samples_per_shard_(samples_per_shard) {
+    assert(samples_per_shard > 0);
+  }
+  ~SampleShardWriter() {
+    Close();
+  }
+  DISALLOW_COPY_AND_ASSIGN_AND_MOVE(SampleShardWriter)
+
+  // Both return false if the shard can not be written.
+  bool Add(const SampleType &sample);
+  bool Close();
+
+  const std::vector<std::string> &ShardPaths() const {
+    return shard_paths_;
+  }
+
+ private:
+  std::string path_prefix_;
+  int64_t samples_per_shard_;
+  std::FILE *file_ = nullptr;
+  SampleShardHeader header_;
+  std::vector<std::string> shard_paths_;
+
+  bool WriteHeader();
+};
+
+/**
+ * Samples of shard files mapped into memory, so that opening a dataset reads
+ * only the headers, and a sample is found by its offset in its shard.
+ */
+template<BoardLen BOARD_LEN, typename SampleType = Sample<BOARD_LEN>>
+class SampleDataset {
+ public:
+  SampleDataset() = default;
+  DISALLOW_COPY_AND_ASSIGN_AND_MOVE(SampleDataset)
+
+  // Returns false if the shard can not be mapped, is malformed, or is of
+  // another board length or sample format.
+  bool AddShard(const std::string &path);
+
+  int64_t SampleCount() const {
+    return shard_ends_.empty() ? 0 : shard_ends_.back();
+  }
+  const SampleType &At(int64_t index) const;
+  // A sample chosen uniformly from all shards.
+  const SampleType &RandomSample(RandomEngine *random_engine) const {
+    assert(SampleCount() > 0);
+    std::uniform_int_distribution<int64_t> distribution(0,
+                                                        SampleCount() - 1);
+    return At(distribution(*random_engine));
+  }
+
+ private:
+  std::vector<std::unique_ptr<util::MappedFile>> mapped_files_;
+  std::vector<const SampleType *> shard_samples_;
+  // The sum of the sample counts of the shards up to each.
+  std::vector<int64_t> shard_ends_;
+};
+
+template<BoardLen BOARD_LEN, typename SampleType>
+bool SampleShardWriter<BOARD_LEN, SampleType>::Add(const SampleType &sample) {
+  if (file_ != nullptr
+      && static_cast<int64_t>(header_.sample_count) == samples_per_shard_
+      && !Close()) {
+    return false;
+  }
+
+  if (file_ == nullptr) {
+    std::string path = (boost::format("%1%-%2$05d.samples") % path_prefix_
+        % shard_paths_.size()).str();
+    file_ = std::fopen(path.c_str(), "wb");
+    if (file_ == nullptr) {
+      return false;
+    }
+    shard_paths_.push_back(path);
+    std::memcpy(header_.magic, SAMPLE_SHARD_MAGIC, sizeof(header_.magic));
+    header_.version = SAMPLE_SHARD_VERSION;
+    header_.board_len = BOARD_LEN;
+    header_.sample_size = sizeof(SampleType);
+    header_.sample_kind = SampleType::KIND;
+    header_.sample_count = 0;
+    // Rewritten with the count when the shard is closed.
+    if (!WriteHeader()) {
+      return false;
+    }
+  }
+
+  if (std::fwrite(&sample, sizeof(sample), 1, file_) != 1) {
+    return false;
+  }
+  ++header_.sample_count;
+  return true;
+}
+
+template<BoardLen BOARD_LEN, typename SampleType>
+bool SampleShardWriter<BOARD_LEN, SampleType>::Close() {
+  if (file_ == nullptr) {
+    return true;
+  }
+  bool is_written = std::fseek(file_, 0, SEEK_SET) == 0 && WriteHeader();
+  is_written = std::fclose(file_) == 0 && is_written;
+  file_ = nullptr;
+  return is_written;
+}
+
+template<BoardLen BOARD_LEN, typename SampleType>
+bool SampleShardWriter<BOARD_LEN, SampleType>::WriteHeader() {
+  return std::fwrite(&header_, sizeof(header_), 1, file_) == 1;
+}
+
+template<BoardLen BOARD_LEN, typename SampleType>
+bool SampleDataset<BOARD_LEN, SampleType>::AddShard(const std::string &path) {
+  std::unique_ptr<util::MappedFile> mapped_file = util::MappedFile::Open(path);
+  if (mapped_file == nullptr
+      || mapped_file->Size() < sizeof(SampleShardHeader)) {
+    return false;
+  }
+  const char *data = static_cast<const char *>(mapped_file->Data());
+  SampleShardHeader header;
+  std::memcpy(&header, data, sizeof(header));
+  if (std::memcmp(header.magic, SAMPLE_SHARD_MAGIC, sizeof(header.magic)) != 0
+      || header.version != SAMPLE_SHARD_VERSION
+      || header.board_len != static_cast<uint32_t>(BOARD_LEN)
+      || header.sample_size != sizeof(SampleType)
+      || header.sample_kind != SampleType::KIND
+      || mapped_file->Size() != sizeof(header)
+          + header.sample_count * sizeof(SampleType)) {
+    return false;
+  }
+
+  shard_samples_.push_back(
+      reinterpret_cast<const SampleType *>(data + sizeof(header)));
+  shard_ends_.push_back(SampleCount() + header.sample_count);
+  mapped_files_.push_back(std::move(mapped_file));
+  return true;
+}
+
+template<BoardLen BOARD_LEN, typename SampleType>
+const SampleType &SampleDataset<BOARD_LEN, SampleType>::At(
+    int64_t index) const {
+  assert(index >= 0 && index < SampleCount());
+  // Shards are few, so finding the shard costs next to nothing.
+  int shard_index = std::upper_bound(shard_ends_.begin(), shard_ends_.end(),
+                                     index) - shard_ends_.begin();
+  int64_t shard_begin = shard_index == 0 ? 0 : shard_ends_[shard_index - 1];
+  return shard_samples_[shard_index][index - shard_begin];
+}
+
+}
+
+#endif
@@ -0,0 +1,196 @@
+#ifndef FOOLGO_SRC_DEEP_LEARNING_TRAINING_PIPELINE_H_
+#define FOOLGO_SRC_DEEP_LEARNING_TRAINING_PIPELINE_H_
+
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "../def.h"
+#include "../game/game_info.h"
+#include "../game/sgf_game.h"
+#include "../util/rand.h"
+#include "../util/spsc_queue.h"
+#include "sample.h"
+
+namespace foolgo {
+
+/**
+ * Prepares training batches on background threads, so that preparing data
+ * overlaps with training. Producer threads call the source for chunks of
+ * samples, such as all the positions of a replayed game, and put them into a
+ * reservoir, from which a batching thread takes random samples once it is
+ * half full, so that samples of one game are spread over many batches. Ready
+ * batches are passed to the training thread by a lock-free queue.
+ */
+template<BoardLen BOARD_LEN>
+class TrainingPipeline {
+ public:
+  // Appends a chunk of samples, drawing randomness from the engine of the
+  // calling producer. It is called by several producers at the same time.
+  typedef std::function<void(RandomEngine*, std::vector<Sample<BOARD_LEN>>*)>
+      SampleSource;
+
+  TrainingPipeline(const SampleSource &sample_source, int producer_count,
+                   int reservoir_capacity, int batch_size,
+                   int ready_batch_count, uint32_t seed);
+  ~TrainingPipeline();
+  DISALLOW_COPY_AND_ASSIGN_AND_MOVE(TrainingPipeline)
+
+  // Blocks until a batch of batch_size samples is ready. It is called by one
+  // thread only.
+  void NextBatch(std::vector<Sample<BOARD_LEN>> *batch);
+
+ private:
+  SampleSource sample_source_;
+  int reservoir_capacity_;
+  int batch_size_;
+
+  // Guards the reservoir.
+  std::mutex mutex_;
+  std::condition_variable not_full_condition_;
+  std::condition_variable ready_condition_;
+  std::vector<Sample<BOARD_LEN>> reservoir_;
+  std::atomic<bool> is_stopping_;
+
+  util::SpscQueue<std::vector<Sample<BOARD_LEN>>> ready_batches_;
+  std::vector<std::thread> producers_;
+  std::thread batcher_;
+
+  void Produce(RandomEngine random_engine);
+  void Batch(RandomEngine random_engine);
+};
+
+// A source replaying a random game of the infos, which should outlive it,
+// and yielding all its positions.
+template<BoardLen BOARD_LEN>
+typename TrainingPipeline<BOARD_LEN>::SampleSource GameReplaySource(
+    const std::vector<GameInfo> &game_infos) {
+  assert(!game_infos.empty());
+  const std::vector<GameInfo> *game_infos_ptr = &game_infos;
+  return [game_infos_ptr](RandomEngine *random_engine,
+                          std::vector<Sample<BOARD_LEN>> *samples) {
+    const GameInfo &game_info = game_infos_ptr->at(
+        random_engine->Uniform(game_infos_ptr->size() - 1));
+    auto game = SgfGame<BOARD_LEN>::BuildSgfGame(game_info, samples);
+    game->Run();
+  };
+}
+
+template<BoardLen BOARD_LEN>
+TrainingPipeline<BOARD_LEN>::TrainingPipeline(
+    const SampleSource &sample_source, int producer_count,
+    int reservoir_capacity, int batch_size, int ready_batch_count,
+    uint32_t seed)
+    : sample_source_(sample_source),
+      reservoir_capacity_(reservoir_capacity),
+      batch_size_(batch_size),
+      is_stopping_(false),
+      ready_batches_(ready_batch_count) {
+  assert(producer_count > 0 && batch_size > 0);
+  assert(reservoir_capacity >= 2 * batch_size);
+  reservoir_.reserve(reservoir_capacity);
+
+  // Each thread draws from its own stream of the seed.
+  for (int i = 0; i < producer_count; ++i) {
+    producers_.push_back(std::thread(&TrainingPipeline::Produce, this,
+                                     RandomEngine(seed, i + 1)));
+  }
+  batcher_ = std::thread(&TrainingPipeline::Batch, this,
+                         RandomEngine(seed, 0));
+}
+
+template<BoardLen BOARD_LEN>
+TrainingPipeline<BOARD_LEN>::~TrainingPipeline() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_stopping_ = true;
+  }
+  not_full_condition_.notify_all();
+  ready_condition_.notify_all();
+  for (std::thread &producer : producers_) {
+    producer.join();
+  }
+  batcher_.join();
+}
+
+template<BoardLen BOARD_LEN>
+void TrainingPipeline<BOARD_LEN>::NextBatch(
+    std::vector<Sample<BOARD_LEN>> *batch) {
+  while (!ready_batches_.TryPop(batch)) {
+    std::this_thread::yield();
+  }
+}
+
+template<BoardLen BOARD_LEN>
+void TrainingPipeline<BOARD_LEN>::Produce(RandomEngine random_engine) {
+  std::vector<Sample<BOARD_LEN>> samples;
+
+  while (!is_stopping_) {
+    samples.clear();
+    sample_source_(&random_engine, &samples);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (const Sample<BOARD_LEN> &sample : samples) {
+      // A chunk larger than half the reservoir fills it before the chunk is
+      // put, so the batcher is woken here too, or else both would wait.
+      if (static_cast<int>(reservoir_.size()) >= reservoir_capacity_) {
+        ready_condition_.notify_one();
+      }
+      not_full_condition_.wait(lock, [this]() {
+        return is_stopping_
+            || static_cast<int>(reservoir_.size()) < reservoir_capacity_;
+      });
+      if (is_stopping_) {
+        return;
+      }
+      reservoir_.push_back(sample);
+    }
+    if (static_cast<int>(reservoir_.size()) >= reservoir_capacity_ / 2) {
+      ready_condition_.notify_one();
+    }
+  }
+}
+
+template<BoardLen BOARD_LEN>
+void TrainingPipeline<BOARD_LEN>::Batch(RandomEngine random_engine) {
+  while (true) {
+    std::vector<Sample<BOARD_LEN>> batch;
+    batch.reserve(batch_size_);
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      ready_condition_.wait(lock, [this]() {
+        return is_stopping_
+            || static_cast<int>(reservoir_.size()) >= reservoir_capacity_ / 2;
+      });
+      if (is_stopping_) {
+        return;
+      }
+      // Taking a random sample and moving the last one to its place keeps
+      // the reservoir shuffled.
+      for (int i = 0; i < batch_size_; ++i) {
+        int index = random_engine.Uniform(reservoir_.size() - 1);
+        batch.push_back(reservoir_[index]);
+        reservoir_[index] = reservoir_.back();
+        reservoir_.pop_back();
+      }
+    }
+    not_full_condition_.notify_all();
+
+    while (!ready_batches_.TryPush(std::move(batch))) {
+      if (is_stopping_) {
+        return;
+      }
+      std::this_thread::yield();
+    }
+  }
+}
+
+}
+
+#endif
@@ -19,7 +19,19 @@
 
 namespace foolgo {
 
+// The width of Zobrist keys, which could be set as 32 to halve the memory of
+// keys for small searches.
+#ifndef FOOLGO_HASH_KEY_BITS
+#define FOOLGO_HASH_KEY_BITS 64
+#endif
+
+#if FOOLGO_HASH_KEY_BITS == 32
 typedef uint32_t HashKey;
+#elif FOOLGO_HASH_KEY_BITS == 64
+typedef uint64_t HashKey;
+#else
+#error "FOOLGO_HASH_KEY_BITS should be 32 or 64."
+#endif
 
 typedef char PointState;
 const PointState BLACK_POINT = 0;
@@ -28,6 +40,9 @@ const PointState EMPTY_POINT = 2;
 
 constexpr int MAIN_BOARD_LEN = 17;
 
+// The komi of area scoring, which is given to white.
+const float DEFAULT_KOMI = 7.5f;
+
 }
 
 #endif
@@ -1,25 +1,99 @@
+#include <cstddef>
 #include <cstdint>
 #include <iostream>
+#include <memory>
+#include <string>
 
-#include "board/zob_hasher.h"
 #include "def.h"
+#include "game/board_len_dispatch.h"
 #include "game/fresh_game.h"
 #include "game/game.h"
+#include "game/multi_size_gtp_engine.h"
+#include "gtp_model_network.h"
+#include "util/cxxopts.hpp"
 #include "util/rand.h"
 
 using namespace foolgo;
 using std::cout;
 
-int main(int argc, const char *argv[]) {
-  uint32_t seed = GetTimeSeed();
-//  uint32_t seed = 2479583645;
-  cout << "seed:" << seed << std::endl;
+namespace {
 
-  ZobHasher<MAIN_BOARD_LEN>::Init(seed);
+template<BoardLen BOARD_LEN>
+struct RunHumanVsAiGame {
+  void operator()(const GtpPlayerConfig &config) const {
+    InitZobHasherOnce<BOARD_LEN>(
+        config.hash_seed != 0 ? config.hash_seed : config.seed);
+    auto game = FreshGame<BOARD_LEN>::BuildHumanVsAiGame(false, config.seed,
+        config.mc_game_count, config.thread_count, config.table_memory_bytes);
+    game->Run();
+  }
+};
 
-  auto game = FreshGame<MAIN_BOARD_LEN>::BuildHumanVsAiGame(false, seed, 10000,
-      4);
-  game->Run();
+}
+
+int main(int argc, char *argv[]) {
+  cxxopts::Options options("foolgo", "A montecarlo Go A.I.");
+  options.add_options()
+    ("board-len", "board length of 9, 13, 17 or 19, which GTP boardsize "
+     "changes", cxxopts::value<int>()->default_value(
+         std::to_string(MAIN_BOARD_LEN)))
+    ("tt-memory", "transposition table memory in MiB",
+     cxxopts::value<std::size_t>()->default_value("128"))
+    ("gtp", "speak GTP on the standard input and output")
+    ("playouts", "most playouts per move",
+     cxxopts::value<int>()->default_value("10000"))
+    ("threads", "search threads", cxxopts::value<int>()->default_value("4"))
+    ("no-ponder", "do not search between GTP commands")
+    ("fold-symmetries", "share records of symmetric boards")
+    ("hash-seed", "seed of the hashers, or of the search seed if zero",
+     cxxopts::value<uint32_t>()->default_value("0"))
+    ("book", "opening book of GTP players, written by lab of the same "
+     "hash seed",
+     cxxopts::value<std::string>()->default_value(""))
+    ("book-instant-visits", "book visits of a position played without "
+     "searching, or 0 to only seed the search",
+     cxxopts::value<int32_t>()->default_value("0"))
+    ("model", "checkpoint of the network written by trainer, by which GTP "
+     "players of 19x19 boards search",
+     cxxopts::value<std::string>()->default_value(""));
+  auto args = options.parse(argc, argv);
+  int board_len = args["board-len"].as<int>();
+  GtpPlayerConfig config;
+  config.table_memory_bytes = args["tt-memory"].as<std::size_t>() << 20;
+  config.mc_game_count = args["playouts"].as<int>();
+  config.thread_count = args["threads"].as<int>();
+  config.folds_symmetries = args.count("fold-symmetries") > 0;
+  config.is_pondering = args.count("no-ponder") == 0;
+  config.hash_seed = args["hash-seed"].as<uint32_t>();
+  config.opening_book_path = args["book"].as<std::string>();
+  config.book_instant_visited_time = args["book-instant-visits"].as<int32_t>();
+  std::string model_path = args["model"].as<std::string>();
+  if (!model_path.empty()) {
+    config.open_network = ModelNetworkOpener(model_path);
+  }
+
+  config.seed = GetTimeSeed();
+//  config.seed = 2479583645;
+
+  if (args.count("gtp") > 0) {
+    // The standard output is of GTP only.
+    std::cerr << "seed:" << config.seed << std::endl;
+    std::unique_ptr<MultiSizeGtpEngine> engine = MultiSizeGtpEngine::New(
+        board_len, config);
+    if (engine == nullptr) {
+      std::cerr << "unsupported board length: " << board_len << std::endl;
+      return 1;
+    }
+    engine->Run(std::cin, cout);
+    return 0;
+  }
+
+  cout << "seed:" << config.seed << std::endl;
+
+  if (!DispatchBoardLen<RunHumanVsAiGame>(board_len, config)) {
+    std::cerr << "unsupported board length: " << board_len << std::endl;
+    return 1;
+  }
 
   return 0;
 }
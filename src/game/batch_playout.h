@@ -0,0 +1,569 @@
+#ifndef FOOLGO_SRC_GAME_BATCH_PLAYOUT_H_
+#define FOOLGO_SRC_GAME_BATCH_PLAYOUT_H_
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "../board/bit_board.h"
+#include "../board/full_board.h"
+#include "../board/pos_cal.h"
+#include "../board/position.h"
+#include "../def.h"
+#include "../util/rand.h"
+#include "monte_carlo_game.h"
+
+namespace foolgo {
+
+/**
+ * Random playouts of many boards, called lanes, advanced in lockstep by one
+ * move of every lane per step. The points of the lanes are stored as a
+ * structure of arrays rather than as boards: word w of all lanes lies
+ * together, so that the masks of each step, such as empty points, eyes and
+ * points with liberties, are computed by loops over lanes which the compiler
+ * vectorizes.
+ * Only the move of each lane, and its captures when it touches a chain in
+ * atari, are found lane by lane.
+ *
+ * Rules are simpler than those of FullBoard, which keeps chains and real eyes
+ * by moves: a force never fills its eyes, which are empty points whose
+ * adjacent points are all of it, with at most one diagonal point of the
+ * opponent, or none on an edge. Suicides are not played, a ko point is not
+ * taken back at once, and a lane ends once both forces pass in turn, or
+ * after MoveCountUpperBoundPerGame moves, as the rules leave cycles possible.
+ * Lanes are scored by areas, as FullBoard::Area.
+ */
+template<BoardLen BOARD_LEN>
+class BatchPlayout {
+ public:
+  explicit BatchPlayout(int lane_count);
+  DISALLOW_COPY_AND_ASSIGN_AND_MOVE(BatchPlayout)
+
+  int LaneCount() const {
+    return lane_count_;
+  }
+
+  // Copies the pieces, the ko and the force to move of the board into the
+  // lane. Lanes are ended until loaded, and once run.
+  void Load(int lane_index, const FullBoard<BOARD_LEN> &full_board);
+  // Plays all lanes until each ends or a limit of the config is reached. The
+  // length is counted from the loading, and the mercy threshold is compared
+  // with the difference of pieces and eyes.
+  void Run(RandomEngine *random_engine,
+           const PlayoutConfig &playout_config = PlayoutConfig());
+
+  PointState GetPointState(int lane_index, PositionIndex index) const;
+  // The area of black minus that of white, when last run.
+  int AreaDifference(int lane_index) const {
+    return area_differences_.at(lane_index);
+  }
+
+ private:
+  static const int WORD_COUNT = BitSet<BOARD_LEN>::WORD_COUNT;
+
+  int lane_count_;
+  // Words of sets of points of all lanes, word by word, with a row of zero
+  // words before and after, so that shifts read no words beyond the board.
+  typedef std::vector<uint64_t> LaneWords;
+  LaneWords own_pieces_;
+  LaneWords opponent_pieces_;
+  LaneWords board_mask_;
+  LaneWords not_first_column_mask_;
+  LaneWords not_last_column_mask_;
+  LaneWords edge_mask_;
+  // Scratches of each step.
+  LaneWords empty_points_;
+  LaneWords candidates_;
+  LaneWords safe_candidates_;
+  LaneWords scratch_;
+  LaneWords other_scratch_;
+  LaneWords diagonal_scratch_;
+  // The force to move, whose pieces are own_pieces_, of each lane. Own and
+  // opponent pieces are swapped for all lanes after each step.
+  std::vector<Force> forces_;
+  std::vector<PositionIndex> ko_indexes_;
+  std::vector<int> pass_counts_;
+  std::vector<char> are_ended_;
+  std::vector<int> area_differences_;
+
+  uint64_t *Row(LaneWords *words, int word_index) const {
+    return words->data() + (word_index + 1) * lane_count_;
+  }
+  const uint64_t *Row(const LaneWords &words, int word_index) const {
+    return words.data() + (word_index + 1) * lane_count_;
+  }
+  BitSet<BOARD_LEN> Gather(const LaneWords &words, int lane_index) const;
+  void Scatter(const BitSet<BOARD_LEN> &bitset, int lane_index,
+               LaneWords *words) const;
+
+  // Sets the points adjacent to those of the set, of all lanes.
+  void Adjacent(const LaneWords &set, LaneWords *result) const;
+  // Sets the points of the set moved by the difference of indexes, which is
+  // of a step in each direction at most, of all lanes.
+  void Shift(const LaneWords &set, int index_difference,
+             LaneWords *result) const;
+  // Sets the eyes of the pieces against the opponent pieces, of all lanes.
+  // Empty points should be set.
+  void Eyes(const LaneWords &pieces, const LaneWords &opponent_pieces,
+            LaneWords *result);
+  // Points of the mask connected to the set through the mask, of all lanes.
+  void FloodFill(const LaneWords &mask, LaneWords *set);
+
+  void Step(RandomEngine *random_engine, int mercy_threshold);
+  // Whether the chain of the piece among the pieces has a liberty, which is
+  // found by flooding the chain until it reaches an empty point. The chain is
+  // set as far as flooded.
+  static bool HasLiberty(const BitSet<BOARD_LEN> &piece,
+                         const BitSet<BOARD_LEN> &pieces,
+                         const BitSet<BOARD_LEN> &empty_points,
+                         BitSet<BOARD_LEN> *chain);
+  // Plays the own piece at the empty point of a lane, removes the opponent
+  // chains it captures, and sets the ko it makes. Returns false, leaving the
+  // lane as it is, if it is a suicide, which it is not if the point is
+  // adjacent to an empty point.
+  static bool PlayMove(PositionIndex index, bool has_liberty,
+                       BitSet<BOARD_LEN> *own, BitSet<BOARD_LEN> *opponent,
+                       PositionIndex *ko_index);
+  void ComputeAreaDifferences();
+};
+
+template<BoardLen BOARD_LEN>
+BatchPlayout<BOARD_LEN>::BatchPlayout(int lane_count)
+    : lane_count_(lane_count),
+      own_pieces_((WORD_COUNT + 2) * lane_count),
+      opponent_pieces_((WORD_COUNT + 2) * lane_count),
+      board_mask_((WORD_COUNT + 2) * lane_count),
+      not_first_column_mask_((WORD_COUNT + 2) * lane_count),
+      not_last_column_mask_((WORD_COUNT + 2) * lane_count),
+      edge_mask_((WORD_COUNT + 2) * lane_count),
+      empty_points_((WORD_COUNT + 2) * lane_count),
+      candidates_((WORD_COUNT + 2) * lane_count),
+      safe_candidates_((WORD_COUNT + 2) * lane_count),
+      scratch_((WORD_COUNT + 2) * lane_count),
+      other_scratch_((WORD_COUNT + 2) * lane_count),
+      diagonal_scratch_((WORD_COUNT + 2) * lane_count),
+      forces_(lane_count, Force::BLACK_FORCE),
+      ko_indexes_(lane_count, FullBoard<BOARD_LEN>::NONE),
+      pass_counts_(lane_count, 0),
+      are_ended_(lane_count, true),
+      area_differences_(lane_count, 0) {
+  assert(lane_count > 0);
+  BitSet<BOARD_LEN> board_mask;
+  board_mask.set();
+  BitSet<BOARD_LEN> not_first_column_mask;
+  BitSet<BOARD_LEN> not_last_column_mask;
+  BitSet<BOARD_LEN> edge_mask;
+  for (PositionIndex i = 0; i < BoardLenSquare<BOARD_LEN>(); ++i) {
+    int x = i % BOARD_LEN;
+    int y = i / BOARD_LEN;
+    not_first_column_mask.set(i, x != 0);
+    not_last_column_mask.set(i, x != BOARD_LEN - 1);
+    edge_mask.set(i, x == 0 || x == BOARD_LEN - 1 || y == 0
+        || y == BOARD_LEN - 1);
+  }
+  for (int i = 0; i < lane_count; ++i) {
+    Scatter(board_mask, i, &board_mask_);
+    Scatter(not_first_column_mask, i, &not_first_column_mask_);
+    Scatter(not_last_column_mask, i, &not_last_column_mask_);
+    Scatter(edge_mask, i, &edge_mask_);
+  }
+}
+
+template<BoardLen BOARD_LEN>
+void BatchPlayout<BOARD_LEN>::Load(int lane_index,
+                                   const FullBoard<BOARD_LEN> &full_board) {
+  Force force = NextForce(full_board);
+  Scatter(full_board.PointBitSet(force), lane_index, &own_pieces_);
+  Scatter(full_board.PointBitSet(OppositeForce(force)), lane_index,
+          &opponent_pieces_);
+  forces_.at(lane_index) = force;
+  ko_indexes_.at(lane_index) = full_board.KoIndex();
+  pass_counts_.at(lane_index) = 0;
+  are_ended_.at(lane_index) = false;
+}
+
+template<BoardLen BOARD_LEN>
+void BatchPlayout<BOARD_LEN>::Run(RandomEngine *random_engine,
+                                  const PlayoutConfig &playout_config) {
+  int max_step_count = playout_config.max_length_factor > 0.0f ?
+      static_cast<int>(playout_config.max_length_factor
+          * BoardLenSquare<BOARD_LEN>()) : std::numeric_limits<int>::max();
+  max_step_count = std::min<int>(max_step_count,
+                                 MoveCountUpperBoundPerGame<BOARD_LEN>());
+
+  for (int step_count = 0; step_count < max_step_count; ++step_count) {
+    bool is_any_running = false;
+    for (int i = 0; i < lane_count_; ++i) {
+      is_any_running |= !are_ended_[i];
+    }
+    if (!is_any_running) {
+      break;
+    }
+    Step(random_engine, playout_config.mercy_threshold);
+  }
+
+  ComputeAreaDifferences();
+  are_ended_.assign(lane_count_, true);
+}
+
+template<BoardLen BOARD_LEN>
+PointState BatchPlayout<BOARD_LEN>::GetPointState(int lane_index,
+                                                  PositionIndex index) const {
+  Force force = forces_.at(lane_index);
+  if (Gather(own_pieces_, lane_index)[index]) {
+    return ForceToPointState(force);
+  } else if (Gather(opponent_pieces_, lane_index)[index]) {
+    return ForceToPointState(OppositeForce(force));
+  }
+  return EMPTY_POINT;
+}
+
+template<BoardLen BOARD_LEN>
+BitSet<BOARD_LEN> BatchPlayout<BOARD_LEN>::Gather(const LaneWords &words,
+                                                  int lane_index) const {
+  uint64_t lane_words[WORD_COUNT];
+  for (int w = 0; w < WORD_COUNT; ++w) {
+    lane_words[w] = Row(words, w)[lane_index];
+  }
+  return BitSet<BOARD_LEN>(lane_words);
+}
+
+template<BoardLen BOARD_LEN>
+void BatchPlayout<BOARD_LEN>::Scatter(const BitSet<BOARD_LEN> &bitset,
+                                      int lane_index, LaneWords *words) const {
+  for (int w = 0; w < WORD_COUNT; ++w) {
+    Row(words, w)[lane_index] = bitset.Words()[w];
+  }
+}
+
+// Shifts are those of BitBoard, with the words of the neighboring rows of the
+// same lane carried in.
+template<BoardLen BOARD_LEN>
+void BatchPlayout<BOARD_LEN>::Adjacent(const LaneWords &set,
+                                       LaneWords *result) const {
+  for (int w = 0; w < WORD_COUNT; ++w) {
+    const uint64_t *current = Row(set, w);
+    const uint64_t *lower = Row(set, w - 1);
+    const uint64_t *upper = Row(set, w + 1);
+    const uint64_t *board_mask = Row(board_mask_, w);
+    const uint64_t *not_first_column = Row(not_first_column_mask_, w);
+    const uint64_t *upper_not_first_column =
+        Row(not_first_column_mask_, w + 1);
+    uint64_t *result_row = Row(result, w);
+
+    for (int k = 0; k < lane_count_; ++k) {
+      uint64_t south = (current[k] << BOARD_LEN)
+          | (lower[k] >> (64 - BOARD_LEN));
+      uint64_t north = (current[k] >> BOARD_LEN)
+          | (upper[k] << (64 - BOARD_LEN));
+      uint64_t east = ((current[k] << 1) | (lower[k] >> 63))
+          & not_first_column[k];
+      uint64_t west = ((current[k] & not_first_column[k]) >> 1)
+          | ((upper[k] & upper_not_first_column[k]) << 63);
+      result_row[k] = (south | north | east | west) & board_mask[k];
+    }
+  }
+}
+
+template<BoardLen BOARD_LEN>
+void BatchPlayout<BOARD_LEN>::Shift(const LaneWords &set,
+                                    int index_difference,
+                                    LaneWords *result) const {
+  assert(index_difference != 0);
+  int shift = std::abs(index_difference);
+  int x_difference = (index_difference + BOARD_LEN + 1) % BOARD_LEN - 1;
+  const LaneWords &column_mask = x_difference > 0 ? not_first_column_mask_ :
+      (x_difference < 0 ? not_last_column_mask_ : board_mask_);
+
+  for (int w = 0; w < WORD_COUNT; ++w) {
+    const uint64_t *current = Row(set, w);
+    const uint64_t *lower = Row(set, w - 1);
+    const uint64_t *upper = Row(set, w + 1);
+    const uint64_t *board_mask = Row(board_mask_, w);
+    const uint64_t *column_mask_row = Row(column_mask, w);
+    uint64_t *result_row = Row(result, w);
+
+    if (index_difference > 0) {
+      for (int k = 0; k < lane_count_; ++k) {
+        result_row[k] = ((current[k] << shift) | (lower[k] >> (64 - shift)))
+            & board_mask[k] & column_mask_row[k];
+      }
+    } else {
+      for (int k = 0; k < lane_count_; ++k) {
+        result_row[k] = ((current[k] >> shift) | (upper[k] << (64 - shift)))
+            & column_mask_row[k];
+      }
+    }
+  }
+}
+
+template<BoardLen BOARD_LEN>
+void BatchPlayout<BOARD_LEN>::Eyes(const LaneWords &pieces,
+                                   const LaneWords &opponent_pieces,
+                                   LaneWords *result) {
+  for (int w = 0; w < WORD_COUNT; ++w) {
+    const uint64_t *pieces_row = Row(pieces, w);
+    const uint64_t *board_mask = Row(board_mask_, w);
+    uint64_t *other_points = Row(&other_scratch_, w);
+    for (int k = 0; k < lane_count_; ++k) {
+      other_points[k] = board_mask[k] & ~pieces_row[k];
+    }
+  }
+  Adjacent(other_scratch_, result);
+  for (int w = 0; w < WORD_COUNT; ++w) {
+    const uint64_t *empty_points = Row(empty_points_, w);
+    uint64_t *result_row = Row(result, w);
+    uint64_t *one_or_more = Row(&other_scratch_, w);
+    uint64_t *two_or_more = Row(&scratch_, w);
+    for (int k = 0; k < lane_count_; ++k) {
+      result_row[k] = empty_points[k] & ~result_row[k];
+      one_or_more[k] = 0;
+      two_or_more[k] = 0;
+    }
+  }
+
+  // Points with at least one and at least two opponent pieces diagonal are
+  // counted as two sets, so that the four diagonals are added by words.
+  const int diagonal_differences[4] = {BOARD_LEN + 1, BOARD_LEN - 1,
+                                       -BOARD_LEN + 1, -BOARD_LEN - 1};
+  for (int d = 0; d < 4; ++d) {
+    Shift(opponent_pieces, diagonal_differences[d], &diagonal_scratch_);
+    for (int w = 0; w < WORD_COUNT; ++w) {
+      const uint64_t *diagonal = Row(diagonal_scratch_, w);
+      uint64_t *one_or_more = Row(&other_scratch_, w);
+      uint64_t *two_or_more = Row(&scratch_, w);
+      for (int k = 0; k < lane_count_; ++k) {
+        two_or_more[k] |= one_or_more[k] & diagonal[k];
+        one_or_more[k] |= diagonal[k];
+      }
+    }
+  }
+  for (int w = 0; w < WORD_COUNT; ++w) {
+    const uint64_t *edge_mask = Row(edge_mask_, w);
+    const uint64_t *one_or_more = Row(other_scratch_, w);
+    const uint64_t *two_or_more = Row(scratch_, w);
+    uint64_t *result_row = Row(result, w);
+    for (int k = 0; k < lane_count_; ++k) {
+      result_row[k] &= ~(two_or_more[k] | (edge_mask[k] & one_or_more[k]));
+    }
+  }
+}
+
+template<BoardLen BOARD_LEN>
+void BatchPlayout<BOARD_LEN>::FloodFill(const LaneWords &mask,
+                                        LaneWords *set) {
+  bool is_changed = true;
+  while (is_changed) {
+    Adjacent(*set, &scratch_);
+    uint64_t changed = 0;
+    for (int w = 0; w < WORD_COUNT; ++w) {
+      const uint64_t *mask_row = Row(mask, w);
+      const uint64_t *adjacent = Row(scratch_, w);
+      uint64_t *set_row = Row(set, w);
+      for (int k = 0; k < lane_count_; ++k) {
+        uint64_t next = set_row[k] | (adjacent[k] & mask_row[k]);
+        changed |= next ^ set_row[k];
+        set_row[k] = next;
+      }
+    }
+    is_changed = changed != 0;
+  }
+}
+
+template<BoardLen BOARD_LEN>
+void BatchPlayout<BOARD_LEN>::Step(RandomEngine *random_engine,
+                                   int mercy_threshold) {
+  for (int w = 0; w < WORD_COUNT; ++w) {
+    const uint64_t *own = Row(own_pieces_, w);
+    const uint64_t *opponent = Row(opponent_pieces_, w);
+    const uint64_t *board_mask = Row(board_mask_, w);
+    uint64_t *empty_points = Row(&empty_points_, w);
+    for (int k = 0; k < lane_count_; ++k) {
+      empty_points[k] = board_mask[k] & ~(own[k] | opponent[k]);
+    }
+  }
+
+  // Candidates are empty points but eyes of the force to move, and are sure
+  // to be legal when adjacent to empty points.
+  Eyes(own_pieces_, opponent_pieces_, &candidates_);
+  if (mercy_threshold > 0) {
+    Eyes(opponent_pieces_, own_pieces_, &safe_candidates_);
+    for (int i = 0; i < lane_count_; ++i) {
+      int region_difference = Gather(own_pieces_, i).count()
+          + Gather(candidates_, i).count()
+          - Gather(opponent_pieces_, i).count()
+          - Gather(safe_candidates_, i).count();
+      if (std::abs(region_difference) >= mercy_threshold) {
+        are_ended_[i] = true;
+      }
+    }
+  }
+  Adjacent(empty_points_, &safe_candidates_);
+  for (int w = 0; w < WORD_COUNT; ++w) {
+    const uint64_t *empty_points = Row(empty_points_, w);
+    uint64_t *candidates = Row(&candidates_, w);
+    uint64_t *safe_candidates = Row(&safe_candidates_, w);
+    for (int k = 0; k < lane_count_; ++k) {
+      candidates[k] = empty_points[k] & ~candidates[k];
+      safe_candidates[k] &= candidates[k];
+    }
+  }
+
+  for (int i = 0; i < lane_count_; ++i) {
+    if (are_ended_[i]) {
+      continue;
+    }
+    BitSet<BOARD_LEN> candidates = Gather(candidates_, i);
+    if (ko_indexes_[i] != FullBoard<BOARD_LEN>::NONE) {
+      candidates.reset(ko_indexes_[i]);
+    }
+    BitSet<BOARD_LEN> safe_candidates = Gather(safe_candidates_, i);
+    BitSet<BOARD_LEN> own = Gather(own_pieces_, i);
+    BitSet<BOARD_LEN> opponent = Gather(opponent_pieces_, i);
+    bool is_played = false;
+
+    // Suicides are dropped from the candidates until a move is played.
+    for (int count = candidates.count(); count > 0 && !is_played; --count) {
+      PositionIndex index = candidates.Select(
+          random_engine->Uniform(count - 1));
+      is_played = PlayMove(index, safe_candidates[index], &own, &opponent,
+                           &ko_indexes_[i]);
+      candidates.reset(index);
+    }
+
+    if (is_played) {
+      pass_counts_[i] = 0;
+      Scatter(own, i, &own_pieces_);
+      Scatter(opponent, i, &opponent_pieces_);
+    } else {
+      ko_indexes_[i] = FullBoard<BOARD_LEN>::NONE;
+      if (++pass_counts_[i] == 2) {
+        are_ended_[i] = true;
+      }
+    }
+  }
+
+  std::swap(own_pieces_, opponent_pieces_);
+  for (int i = 0; i < lane_count_; ++i) {
+    forces_[i] = OppositeForce(forces_[i]);
+  }
+}
+
+template<BoardLen BOARD_LEN>
+bool BatchPlayout<BOARD_LEN>::HasLiberty(const BitSet<BOARD_LEN> &piece,
+                                         const BitSet<BOARD_LEN> &pieces,
+                                         const BitSet<BOARD_LEN> &empty_points,
+                                         BitSet<BOARD_LEN> *chain) {
+  *chain = piece;
+  while (true) {
+    BitSet<BOARD_LEN> dilated = chain->Dilate();
+    if ((dilated & empty_points).any()) {
+      return true;
+    }
+    BitSet<BOARD_LEN> next = dilated &= pieces;
+    if (next == *chain) {
+      return false;
+    }
+    *chain = next;
+  }
+}
+
+template<BoardLen BOARD_LEN>
+bool BatchPlayout<BOARD_LEN>::PlayMove(PositionIndex index, bool has_liberty,
+                                       BitSet<BOARD_LEN> *own,
+                                       BitSet<BOARD_LEN> *opponent,
+                                       PositionIndex *ko_index) {
+  auto &calculator = PstionAndIndxCcltr<BOARD_LEN>::Ins();
+  BitSet<BOARD_LEN> piece;
+  piece.set(index);
+  BitSet<BOARD_LEN> played_own = *own | piece;
+  BitSet<BOARD_LEN> empty_points = ~(played_own | *opponent);
+
+  // A chain adjacent to the move has no liberty only if none of the adjacent
+  // pieces has an empty point adjacent besides the move, before which chains
+  // are flooded.
+  auto has_adjacent_liberty = [&calculator, &empty_points](
+      PositionIndex piece_index) {
+    for (PositionIndex adjacent_index :
+        calculator.AdjacentIndexes(piece_index)) {
+      if (empty_points[adjacent_index]) {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  BitSet<BOARD_LEN> captured_pieces;
+  BitSet<BOARD_LEN> chain;
+  bool has_own_adjacent = false;
+  for (PositionIndex adjacent_index : calculator.AdjacentIndexes(index)) {
+    if (played_own[adjacent_index]) {
+      has_own_adjacent = true;
+      has_liberty = has_liberty || has_adjacent_liberty(adjacent_index);
+    } else if ((*opponent)[adjacent_index]
+        && !captured_pieces[adjacent_index]
+        && !has_adjacent_liberty(adjacent_index)) {
+      BitSet<BOARD_LEN> adjacent_piece;
+      adjacent_piece.set(adjacent_index);
+      if (!HasLiberty(adjacent_piece, *opponent, empty_points, &chain)) {
+        captured_pieces |= chain;
+      }
+    }
+  }
+
+  if (!has_liberty && captured_pieces.none() && (!has_own_adjacent
+      || !HasLiberty(piece, played_own, empty_points, &chain))) {
+    return false;
+  }
+
+  *own = played_own;
+  opponent->AndNot(captured_pieces);
+  // As in FullBoard, a single piece which captured a single piece and has
+  // only the liberty of the captured one makes a ko.
+  *ko_index = FullBoard<BOARD_LEN>::NONE;
+  if (!has_own_adjacent && captured_pieces.count() == 1
+      && (piece.Adjacent() & ~(*own | *opponent)).count() == 1) {
+    *ko_index = *captured_pieces.begin();
+  }
+  return true;
+}
+
+template<BoardLen BOARD_LEN>
+void BatchPlayout<BOARD_LEN>::ComputeAreaDifferences() {
+  // Pieces of either force, and empty points reached by them, are flooded for
+  // all lanes at once.
+  for (int w = 0; w < WORD_COUNT; ++w) {
+    const uint64_t *own = Row(own_pieces_, w);
+    const uint64_t *opponent = Row(opponent_pieces_, w);
+    const uint64_t *board_mask = Row(board_mask_, w);
+    uint64_t *empty_points = Row(&empty_points_, w);
+    uint64_t *own_mask = Row(&candidates_, w);
+    uint64_t *opponent_mask = Row(&safe_candidates_, w);
+    for (int k = 0; k < lane_count_; ++k) {
+      empty_points[k] = board_mask[k] & ~(own[k] | opponent[k]);
+      own_mask[k] = empty_points[k] | own[k];
+      opponent_mask[k] = empty_points[k] | opponent[k];
+    }
+  }
+  other_scratch_ = own_pieces_;
+  empty_points_ = opponent_pieces_;
+  FloodFill(candidates_, &other_scratch_);
+  FloodFill(safe_candidates_, &empty_points_);
+
+  for (int i = 0; i < lane_count_; ++i) {
+    BitSet<BOARD_LEN> own = Gather(other_scratch_, i);
+    BitSet<BOARD_LEN> opponent = Gather(empty_points_, i);
+    int difference = BitSet<BOARD_LEN>(own).AndNot(opponent).count()
+        - BitSet<BOARD_LEN>(opponent).AndNot(own).count();
+    area_differences_[i] = forces_[i] == Force::BLACK_FORCE ? difference :
+        -difference;
+  }
+}
+
+}
+
+#endif
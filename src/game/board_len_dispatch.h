@@ -0,0 +1,57 @@
+#ifndef FOOLGO_SRC_GAME_BOARD_LEN_DISPATCH_H_
+#define FOOLGO_SRC_GAME_BOARD_LEN_DISPATCH_H_
+
+#include <utility>
+
+#include "../board/position.h"
+#include "../board/zob_hasher.h"
+
+namespace foolgo {
+
+// The board lengths of which boards, players and hashers are instantiated,
+// so that they are chosen at runtime while each runs code specialized for
+// its length.
+const BoardLen SUPPORTED_BOARD_LENS[] = {9, 13, 17, 19};
+
+inline bool IsSupportedBoardLen(int board_len) {
+  for (BoardLen supported_board_len : SUPPORTED_BOARD_LENS) {
+    if (board_len == supported_board_len) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Initializes the hasher of the length with the seed, unless it has been.
+template<BoardLen BOARD_LEN>
+void InitZobHasherOnce(uint32_t seed) {
+  if (ZobHasher<BOARD_LEN>::InstancePtr() == nullptr) {
+    ZobHasher<BOARD_LEN>::Init(seed);
+  }
+}
+
+// Calls Functor<BOARD_LEN>()(args...) of the board length given at runtime.
+// Returns false, calling nothing, if the length is not supported.
+template<template<BoardLen> class Functor, typename... Args>
+bool DispatchBoardLen(int board_len, Args &&... args) {
+  switch (board_len) {
+    case 9:
+      Functor<9>()(std::forward<Args>(args)...);
+      return true;
+    case 13:
+      Functor<13>()(std::forward<Args>(args)...);
+      return true;
+    case 17:
+      Functor<17>()(std::forward<Args>(args)...);
+      return true;
+    case 19:
+      Functor<19>()(std::forward<Args>(args)...);
+      return true;
+    default:
+      return false;
+  }
+}
+
+}
+
+#endif
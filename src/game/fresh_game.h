@@ -1,8 +1,12 @@
 #ifndef FOOLGO_SRC_GAME_FRESH_GAME_H_
 #define FOOLGO_SRC_GAME_FRESH_GAME_H_
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <memory>
+#include <vector>
 
 #include "board/position.h"
 #include "board/full_board.h"
@@ -17,12 +21,19 @@ namespace foolgo {
 template<BoardLen BOARD_LEN>
 class FreshGame : public Game<BOARD_LEN> {
  public:
+  // Receives the board before each move of an AI player, with the move and
+  // the root children of the search choosing it.
+  typedef std::function<void(const FullBoard<BOARD_LEN>&, PositionIndex,
+                             const std::vector<RootChildStat>&)>
+      SearchObserver;
+
   static std::unique_ptr<FreshGame<BOARD_LEN>> BuildHumanVsAiGame(
       bool input_player_plays_black, uint32_t seed, int mc_game_count,
-      int thread_count) {
+      int thread_count, std::size_t table_memory_bytes =
+          TranspositionTable<BOARD_LEN>::DEFAULT_MEMORY_BYTES) {
     auto input_player = new InputPlayer<BOARD_LEN>;
     auto ai_player = new UctPlayer<BOARD_LEN>(seed, mc_game_count,
-        thread_count);
+        thread_count, table_memory_bytes);
 
     Player<BOARD_LEN> *black_player, *white_player;
     if (input_player_plays_black) {
@@ -48,42 +59,67 @@ class FreshGame : public Game<BOARD_LEN> {
     FullBoard<BOARD_LEN> full_board;
     full_board.Init();
 
-    return std::unique_ptr<FreshGame<BOARD_LEN>>(full_board, black_player,
-        white_player, only_log_board);
+    return std::unique_ptr<FreshGame<BOARD_LEN>>(new FreshGame<BOARD_LEN>(
+          full_board, black_player, white_player, only_log_board));
   }
 
+  // A game with an observer is not logged. Each player has a table of the
+  // memory, and players of one thread search on the thread running the game.
   static std::unique_ptr<FreshGame<BOARD_LEN>> BuildAiVsAiGame(
-      uint32_t seed, int mc_game_count, int thread_couunt,
-      bool only_log_board = true) {
+      uint32_t seed, int mc_game_count, int thread_count,
+      std::size_t table_memory_bytes, bool only_log_board = true,
+      const SearchObserver &search_observer = SearchObserver()) {
     auto black_player = new UctPlayer<BOARD_LEN>(seed, mc_game_count,
-        thread_couunt);
+        thread_count, table_memory_bytes);
     auto white_player = new UctPlayer<BOARD_LEN>(seed, mc_game_count,
-        thread_couunt);
+        thread_count, table_memory_bytes);
 
     FullBoard<BOARD_LEN> full_board;
     full_board.Init();
 
-    return new FreshGame(full_board, black_player, white_player,
-        only_log_board);
+    std::unique_ptr<FreshGame<BOARD_LEN>> game(new FreshGame<BOARD_LEN>(
+        full_board, black_player, white_player, only_log_board));
+    game->ai_players_ = {black_player, white_player};
+    game->search_observer_ = search_observer;
+    return game;
   }
 
   static std::unique_ptr<FreshGame<BOARD_LEN>> BuildFreshGame(
       Player<BOARD_LEN> *black_player,
-      Player<BOARD_LEN> *white_player) {
+      Player<BOARD_LEN> *white_player,
+      bool is_logged = true) {
     FullBoard<BOARD_LEN> full_board;
     full_board.Init();
-    return std::unique_ptr<FreshGame<BOARD_LEN>>(
+    std::unique_ptr<FreshGame<BOARD_LEN>> game(
         new FreshGame<BOARD_LEN>(full_board, black_player,
           white_player));
+    game->is_logged_ = is_logged;
+    return game;
   }
   ~FreshGame() = default;
   bool ShouldLog() const override {
-    return true;
+    return is_logged_ && !search_observer_;
   }
  protected:
   using Game<BOARD_LEN>::Game;
 
+  void BeforePlay(PositionIndex index) override {
+    const FullBoard<BOARD_LEN> &full_board = this->GetFullBoard();
+    const UctPlayer<BOARD_LEN> *ai_player =
+        ai_players_.at(NextForce(full_board));
+    if (search_observer_ && ai_player != nullptr) {
+      search_observer_(full_board, index,
+                       ai_player->RootChildStats(full_board));
+    }
+  }
+
  private:
+  // The players of the forces which are UctPlayers, owned by the game.
+  std::array<const UctPlayer<BOARD_LEN>*, 2> ai_players_ = {{nullptr,
+                                                             nullptr}};
+  SearchObserver search_observer_;
+  bool is_logged_ = true;
+
   DISALLOW_COPY_AND_ASSIGN_AND_MOVE(FreshGame)
 };
 
@@ -9,6 +9,9 @@ namespace foolgo {
 
 struct GameInfo {
   std::vector<Move> moves;
+  // The winner by the RE property, if the result is known.
+  bool has_winner = false;
+  Force winner = Force::BLACK_FORCE;
 };
 
 }
@@ -0,0 +1,396 @@
+#ifndef FOOLGO_SRC_GAME_GTP_ENGINE_H_
+#define FOOLGO_SRC_GAME_GTP_ENGINE_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../board/force.h"
+#include "../board/full_board.h"
+#include "../board/pos_cal.h"
+#include "../board/position.h"
+#include "../def.h"
+#include "../player/time_control.h"
+#include "../player/uct_player.h"
+
+namespace foolgo {
+
+/**
+ * A front end of the Go Text Protocol version 2. The player and its tables
+ * live as long as the engine, so that games and moves do not pay for
+ * startup, and the tree of each move is reused by the next one. Between
+ * commands, the player ponders on the current position, which is usually
+ * on the opponent's time, stopping as soon as the next command arrives.
+ */
+template<BoardLen BOARD_LEN>
+class GtpEngine {
+ public:
+  GtpEngine(UctPlayer<BOARD_LEN> *uct_player, bool is_pondering);
+  ~GtpEngine();
+  DISALLOW_COPY_AND_ASSIGN_AND_MOVE(GtpEngine)
+
+  // Reads commands until quit or the end of the input.
+  void Run(std::istream &is, std::ostream &os);
+  // Executes the command without the id, returning false with the error
+  // message as the response if it fails. Sets is_quit for quit.
+  bool Execute(const std::string &command, std::string *response,
+               bool *is_quit);
+  // Searches the current board on another thread, if pondering, until
+  // StopPondering.
+  void StartPondering();
+  void StopPondering();
+
+ private:
+  UctPlayer<BOARD_LEN> *uct_player_;
+  bool is_pondering_;
+  FullBoard<BOARD_LEN> empty_board_;
+  FullBoard<BOARD_LEN> full_board_;
+  // Moves from the empty board, in which a pass is POSITION_INDEX_PASS, for
+  // undo.
+  std::vector<PositionIndex> moves_;
+  float komi_ = DEFAULT_KOMI;
+  // The time settings, or null if moves are searched only by the playout
+  // count.
+  std::unique_ptr<TimeControl> time_control_;
+  std::thread ponder_thread_;
+  std::atomic<bool> is_ponder_stopped_;
+
+  void ClearBoard();
+  // Plays the move of the force, passing first if the other force is to
+  // play.
+  void PlayMove(Force force, PositionIndex index);
+  bool IsLegalMove(Force force, PositionIndex index) const;
+};
+
+namespace {
+
+const char GTP_COLUMN_LETTERS[] = "ABCDEFGHJKLMNOPQRST";
+
+const char *GTP_KNOWN_COMMANDS[] = {
+    "protocol_version", "name", "version", "known_command", "list_commands",
+    "quit", "boardsize", "clear_board", "komi", "play", "genmove", "undo",
+    "time_settings", "time_left", "final_score", "showboard"};
+
+std::string ToLower(std::string text) {
+  std::transform(text.begin(), text.end(), text.begin(), ::tolower);
+  return text;
+}
+
+bool ParseGtpColor(const std::string &text, Force *force) {
+  std::string color = ToLower(text);
+  if (color == "b" || color == "black") {
+    *force = Force::BLACK_FORCE;
+  } else if (color == "w" || color == "white") {
+    *force = Force::WHITE_FORCE;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// Rows are counted from the bottom, which is the last row of the board.
+template<BoardLen BOARD_LEN>
+bool ParseGtpVertex(const std::string &text, PositionIndex *index) {
+  std::string vertex = ToLower(text);
+  if (vertex == "pass") {
+    *index = POSITION_INDEX_PASS;
+    return true;
+  }
+  if (vertex.size() < 2) {
+    return false;
+  }
+
+  const char *letter = std::find(GTP_COLUMN_LETTERS,
+                                 GTP_COLUMN_LETTERS + BOARD_LEN,
+                                 ::toupper(vertex[0]));
+  int row = std::atoi(vertex.c_str() + 1);
+  if (letter == GTP_COLUMN_LETTERS + BOARD_LEN || row < 1 || row > BOARD_LEN
+      || vertex.find_first_not_of("0123456789", 1) != std::string::npos) {
+    return false;
+  }
+
+  Position position(letter - GTP_COLUMN_LETTERS, BOARD_LEN - row);
+  *index = PstionAndIndxCcltr<BOARD_LEN>::Ins().GetIndex(position);
+  return true;
+}
+
+template<BoardLen BOARD_LEN>
+std::string GtpVertex(PositionIndex index) {
+  if (index == POSITION_INDEX_PASS) {
+    return "pass";
+  }
+  const Position &position =
+      PstionAndIndxCcltr<BOARD_LEN>::Ins().GetPosition(index);
+  return GTP_COLUMN_LETTERS[static_cast<int>(position.x)]
+      + std::to_string(BOARD_LEN - position.y);
+}
+
+// Reads commands until quit or the end of the input, and writes responses,
+// for an engine of the interface of GtpEngine. The engine ponders between
+// commands.
+template<typename Engine>
+void RunGtpCommands(Engine *engine, std::istream &is, std::ostream &os) {
+  std::string line;
+  bool is_quit = false;
+
+  while (!is_quit && std::getline(is, line)) {
+    engine->StopPondering();
+
+    // Comments and control characters are removed, and tabs are spaces.
+    line = line.substr(0, line.find('#'));
+    std::string command;
+    for (char c : line) {
+      if (c == '\t') {
+        command += ' ';
+      } else if (!std::iscntrl(static_cast<unsigned char>(c))) {
+        command += c;
+      }
+    }
+    std::istringstream command_stream(command);
+    std::string id;
+    command_stream >> id;
+    if (id.empty()) {
+      continue;
+    }
+    if (id.find_first_not_of("0123456789") == std::string::npos) {
+      std::getline(command_stream, command);
+    } else {
+      id.clear();
+    }
+
+    std::string response;
+    bool is_success = engine->Execute(command, &response, &is_quit);
+    os << (is_success ? '=' : '?') << id << (response.empty() ? "" : " ")
+        << response << "\n\n" << std::flush;
+
+    if (!is_quit) {
+      engine->StartPondering();
+    }
+  }
+}
+
+}
+
+template<BoardLen BOARD_LEN>
+GtpEngine<BOARD_LEN>::GtpEngine(UctPlayer<BOARD_LEN> *uct_player,
+                                bool is_pondering)
+    : uct_player_(uct_player),
+      is_pondering_(is_pondering),
+      is_ponder_stopped_(false) {
+  empty_board_.Init();
+  ClearBoard();
+  uct_player_->SetKomi(komi_);
+}
+
+template<BoardLen BOARD_LEN>
+GtpEngine<BOARD_LEN>::~GtpEngine() {
+  StopPondering();
+}
+
+template<BoardLen BOARD_LEN>
+void GtpEngine<BOARD_LEN>::Run(std::istream &is, std::ostream &os) {
+  RunGtpCommands(this, is, os);
+}
+
+template<BoardLen BOARD_LEN>
+bool GtpEngine<BOARD_LEN>::Execute(const std::string &command,
+                                   std::string *response, bool *is_quit) {
+  std::istringstream command_stream(command);
+  std::string name;
+  command_stream >> name;
+  std::vector<std::string> args;
+  for (std::string arg; command_stream >> arg;) {
+    args.push_back(arg);
+  }
+  response->clear();
+  *is_quit = false;
+
+  if (name == "protocol_version") {
+    *response = "2";
+  } else if (name == "name") {
+    *response = "FoolGo";
+  } else if (name == "version") {
+    *response = "0.1";
+  } else if (name == "known_command") {
+    bool is_known = !args.empty() && std::find(
+        std::begin(GTP_KNOWN_COMMANDS), std::end(GTP_KNOWN_COMMANDS),
+        args[0]) != std::end(GTP_KNOWN_COMMANDS);
+    *response = is_known ? "true" : "false";
+  } else if (name == "list_commands") {
+    for (const char *known_command : GTP_KNOWN_COMMANDS) {
+      *response += (response->empty() ? "" : "\n") + std::string(known_command);
+    }
+  } else if (name == "quit") {
+    *is_quit = true;
+  } else if (name == "boardsize") {
+    if (args.empty() || std::atoi(args[0].c_str()) != BOARD_LEN) {
+      *response = "unacceptable size";
+      return false;
+    }
+    ClearBoard();
+  } else if (name == "clear_board") {
+    ClearBoard();
+  } else if (name == "komi") {
+    if (args.empty()) {
+      *response = "syntax error";
+      return false;
+    }
+    komi_ = std::atof(args[0].c_str());
+    uct_player_->SetKomi(komi_);
+  } else if (name == "play") {
+    Force force;
+    PositionIndex index;
+    if (args.size() < 2 || !ParseGtpColor(args[0], &force)
+        || !ParseGtpVertex<BOARD_LEN>(args[1], &index)) {
+      *response = "syntax error";
+      return false;
+    }
+    if (!IsLegalMove(force, index)) {
+      *response = "illegal move";
+      return false;
+    }
+    PlayMove(force, index);
+  } else if (name == "genmove") {
+    Force force;
+    if (args.empty() || !ParseGtpColor(args[0], &force)) {
+      *response = "syntax error";
+      return false;
+    }
+    if (NextForce(full_board_) != force) {
+      PlayMove(OppositeForce(force), POSITION_INDEX_PASS);
+    }
+    PositionIndex index = uct_player_->NextMove(full_board_);
+    if (index == POSITION_INDEX_END) {
+      *response = "resign";
+    } else {
+      PlayMove(force, index);
+      *response = GtpVertex<BOARD_LEN>(index);
+    }
+  } else if (name == "undo") {
+    if (moves_.empty()) {
+      *response = "cannot undo";
+      return false;
+    }
+    std::vector<PositionIndex> moves(moves_.begin(), moves_.end() - 1);
+    ClearBoard();
+    for (PositionIndex index : moves) {
+      PlayMove(NextForce(full_board_), index);
+    }
+  } else if (name == "time_settings") {
+    if (args.size() < 3) {
+      *response = "syntax error";
+      return false;
+    }
+    TimeControl::Duration main_time(1000 * std::atoi(args[0].c_str()));
+    TimeControl::Duration byo_yomi_time(1000 * std::atoi(args[1].c_str()));
+    int byo_yomi_stones = std::atoi(args[2].c_str());
+    if (byo_yomi_time.count() > 0 && byo_yomi_stones == 0) {
+      main_time = TimeControl::Duration(0);
+    }
+    if (main_time.count() == 0 && byo_yomi_time.count() == 0) {
+      time_control_.reset();
+      uct_player_->ClearTimeControl();
+    } else {
+      time_control_.reset(new TimeControl(main_time, TimeControl::Duration(0),
+                                          main_time + byo_yomi_time));
+      if (main_time.count() == 0) {
+        time_control_->remaining_time = byo_yomi_time;
+        time_control_->min_expected_move_count = byo_yomi_stones;
+      }
+      uct_player_->SetTimeControl(*time_control_);
+    }
+  } else if (name == "time_left") {
+    if (args.size() < 3) {
+      *response = "syntax error";
+      return false;
+    }
+    if (time_control_ != nullptr) {
+      // In a byo-yomi period, the time is of the stones left in it.
+      TimeControl time_control(*time_control_);
+      time_control.remaining_time =
+          TimeControl::Duration(1000 * std::atoi(args[1].c_str()));
+      int stones = std::atoi(args[2].c_str());
+      if (stones > 0) {
+        time_control.min_expected_move_count = stones;
+      }
+      uct_player_->SetTimeControl(time_control);
+    }
+  } else if (name == "final_score") {
+    float black_score = full_board_.Region(Force::BLACK_FORCE)
+        - full_board_.Region(Force::WHITE_FORCE) - komi_;
+    std::ostringstream score;
+    if (black_score == 0.0f) {
+      score << "0";
+    } else {
+      score << (black_score > 0.0f ? "B+" : "W+") << std::abs(black_score);
+    }
+    *response = score.str();
+  } else if (name == "showboard") {
+    *response = "\n" + full_board_.ToString(true);
+  } else {
+    *response = "unknown command";
+    return false;
+  }
+
+  return true;
+}
+
+template<BoardLen BOARD_LEN>
+void GtpEngine<BOARD_LEN>::StartPondering() {
+  if (!is_pondering_ || full_board_.IsEnd()) {
+    return;
+  }
+  is_ponder_stopped_ = false;
+  ponder_thread_ = std::thread([this]() {
+    uct_player_->Ponder(full_board_, &is_ponder_stopped_);
+  });
+}
+
+template<BoardLen BOARD_LEN>
+void GtpEngine<BOARD_LEN>::StopPondering() {
+  if (ponder_thread_.joinable()) {
+    is_ponder_stopped_ = true;
+    ponder_thread_.join();
+  }
+}
+
+template<BoardLen BOARD_LEN>
+void GtpEngine<BOARD_LEN>::ClearBoard() {
+  full_board_.Copy(empty_board_);
+  moves_.clear();
+}
+
+template<BoardLen BOARD_LEN>
+void GtpEngine<BOARD_LEN>::PlayMove(Force force, PositionIndex index) {
+  if (NextForce(full_board_) != force) {
+    Play(&full_board_, POSITION_INDEX_PASS);
+    moves_.push_back(POSITION_INDEX_PASS);
+  }
+  Play(&full_board_, index);
+  moves_.push_back(index);
+}
+
+template<BoardLen BOARD_LEN>
+bool GtpEngine<BOARD_LEN>::IsLegalMove(Force force,
+                                       PositionIndex index) const {
+  if (index == POSITION_INDEX_PASS) {
+    return true;
+  }
+  // The ko point is only forbidden to the force to play next.
+  return full_board_.GetPointState(index) == EMPTY_POINT
+      && (index != full_board_.KoIndex() || NextForce(full_board_) != force)
+      && !full_board_.IsSuicide(Move(force, index));
+}
+
+}
+
+#endif
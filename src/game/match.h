@@ -0,0 +1,163 @@
+#ifndef FOOLGO_SRC_GAME_MATCH_H_
+#define FOOLGO_SRC_GAME_MATCH_H_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+#include "../board/force.h"
+#include "../board/full_board.h"
+#include "../board/position.h"
+#include "../def.h"
+#include "../player/search_stats.h"
+#include "../player/transposition_table.h"
+#include "../player/uct_player.h"
+#include "../util/thread_pool.h"
+#include "fresh_game.h"
+#include "monte_carlo_game.h"
+#include "sprt.h"
+
+namespace foolgo {
+
+// Settings of the players of one side of a match.
+struct MatchPlayerConfig {
+  int mc_game_count = 1000;
+  int thread_count = 1;
+  std::size_t table_memory_bytes = 16 << 20;
+  ParallelMode parallel_mode = ParallelMode::TREE;
+  bool folds_symmetries = false;
+  PlayoutConfig playout_config;
+  int leaf_playout_count = 1;
+  bool uses_batch_playout = false;
+  float rave_equivalence = 0.0f;
+};
+
+template<BoardLen BOARD_LEN>
+UctPlayer<BOARD_LEN> *NewMatchPlayer(const MatchPlayerConfig &config,
+                                     uint32_t seed) {
+  auto player = new UctPlayer<BOARD_LEN>(seed, config.mc_game_count,
+      config.thread_count, config.table_memory_bytes, config.parallel_mode);
+  player->SetSymmetryFolding(config.folds_symmetries);
+  player->SetPlayoutConfig(config.playout_config);
+  player->SetLeafPlayoutCount(config.leaf_playout_count);
+  player->SetBatchPlayout(config.uses_batch_playout);
+  player->SetRaveEquivalence(config.rave_equivalence);
+  return player;
+}
+
+/**
+ * Plays games between players of two configs at the same time, until the
+ * SPRT of the first config against the second decides or the game count is
+ * reached. Side 0 plays black in even games and white in odd ones, and both
+ * games of a pair seed the players of each side alike, so that colours are
+ * balanced and a match is reproducible by the seed with one game at a time.
+ * ZobHasher should be initialized before.
+ */
+template<BoardLen BOARD_LEN>
+class Match {
+ public:
+  Match(const MatchPlayerConfig &config0, const MatchPlayerConfig &config1,
+        uint32_t seed, const SprtConfig &sprt_config)
+      : configs_({{config0, config1}}),
+        seed_(seed),
+        sprt_config_(sprt_config) {}
+  DISALLOW_COPY_AND_ASSIGN_AND_MOVE(Match)
+
+  // Plays a game per task of the pool. Games not started when the SPRT
+  // decides are skipped, while those being played are finished and counted.
+  void Play(int max_game_count, util::ThreadPool *thread_pool);
+
+  // The results of side 0.
+  MatchScore Score() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return score_;
+  }
+  SprtResult Result() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return TestSprt(score_, sprt_config_);
+  }
+  // The mean wall time of searched moves of the side, which times its thread
+  // count is the CPU time of a move when threads have cores of their own.
+  double SecondsPerMove(int side) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return move_counts_[side] == 0 ? 0.0 :
+        search_seconds_[side] / move_counts_[side];
+  }
+
+ private:
+  std::array<MatchPlayerConfig, 2> configs_;
+  uint32_t seed_;
+  SprtConfig sprt_config_;
+  std::atomic<bool> is_decided_{false};
+  // Guards the results.
+  mutable std::mutex mutex_;
+  MatchScore score_;
+  std::array<double, 2> search_seconds_ = {{0.0, 0.0}};
+  std::array<int64_t, 2> move_counts_ = {{0, 0}};
+
+  void PlayGame(int game_index);
+};
+
+template<BoardLen BOARD_LEN>
+void Match<BOARD_LEN>::Play(int max_game_count,
+                            util::ThreadPool *thread_pool) {
+  for (int i = 0; i < max_game_count; ++i) {
+    thread_pool->Submit([this, i](int) {
+      if (!is_decided_.load(std::memory_order_relaxed)) {
+        PlayGame(i);
+      }
+    });
+  }
+  thread_pool->Wait();
+}
+
+template<BoardLen BOARD_LEN>
+void Match<BOARD_LEN>::PlayGame(int game_index) {
+  int black_side = game_index % 2;
+  uint32_t pair_seed = seed_ + game_index / 2 * 2;
+  std::array<UctPlayer<BOARD_LEN>*, 2> players;
+  std::array<double, 2> search_seconds = {{0.0, 0.0}};
+  std::array<int64_t, 2> move_counts = {{0, 0}};
+  for (int side = 0; side < 2; ++side) {
+    players[side] = NewMatchPlayer<BOARD_LEN>(configs_[side], pair_seed + side);
+    double *side_search_seconds = &search_seconds[side];
+    int64_t *side_move_count = &move_counts[side];
+    players[side]->SetSearchStatsSink(
+        [side_search_seconds, side_move_count](const SearchStats &stats) {
+          *side_search_seconds += stats.wall_seconds;
+          ++*side_move_count;
+        });
+  }
+
+  // The game owns and deletes the players.
+  auto game = FreshGame<BOARD_LEN>::BuildFreshGame(
+      players[black_side], players[1 - black_side], false);
+  game->Run();
+
+  const FullBoard<BOARD_LEN> &end_board = game->GetFullBoard();
+  float black_score = end_board.Region(Force::BLACK_FORCE)
+      - end_board.Region(Force::WHITE_FORCE) - DEFAULT_KOMI;
+  float side0_score = black_side == 0 ? black_score : -black_score;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (side0_score > 0.0f) {
+    ++score_.win_count;
+  } else if (side0_score < 0.0f) {
+    ++score_.loss_count;
+  } else {
+    ++score_.draw_count;
+  }
+  for (int side = 0; side < 2; ++side) {
+    search_seconds_[side] += search_seconds[side];
+    move_counts_[side] += move_counts[side];
+  }
+  if (TestSprt(score_, sprt_config_) != SprtResult::CONTINUE) {
+    is_decided_.store(true, std::memory_order_relaxed);
+  }
+}
+
+}
+
+#endif
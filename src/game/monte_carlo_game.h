@@ -1,12 +1,21 @@
 #ifndef FOOLGO_SRC_GAME_MONTE_CARLO_GAME_H_
 #define FOOLGO_SRC_GAME_MONTE_CARLO_GAME_H_
 
+#include <array>
+#include <cstdlib>
+#include <limits>
+
+#include "../board/bit_board.h"
+#include "../board/full_board.h"
 #include "../board/position.h"
 #include "../player/random_player.h"
+#include "../util/rand.h"
 #include "game.h"
 
 namespace foolgo {
 
+class PatternWeights;
+
 template<BoardLen BOARD_LEN>
 class MonteCarloGame : public Game<BOARD_LEN> {
  public:
@@ -23,10 +32,73 @@ template<BoardLen BOARD_LEN>
 MonteCarloGame<BOARD_LEN>::MonteCarloGame(
     const FullBoard<BOARD_LEN> &full_board, uint32_t seed,
     bool only_log_board )
-    : Game<BOARD_LEN>(full_board, new RandomPlayer<BOARD_LEN>(seed),
-                      new RandomPlayer<BOARD_LEN>(seed),
+    : Game<BOARD_LEN>(full_board,
+                      new RandomPlayer<BOARD_LEN>(seed, BLACK_FORCE),
+                      new RandomPlayer<BOARD_LEN>(seed, WHITE_FORCE),
                       only_log_board) {}
 
+// Points played by each force, where the other force has not played before.
+template<BoardLen BOARD_LEN>
+using FirstMovePoints = std::array<BitSet<BOARD_LEN>, 2>;
+
+// Limits of random playouts, which by default run until the game ends. A
+// playout ended by a limit is scored by the regions at that point like an
+// ended game, which are mostly settled when the regions differ much.
+struct PlayoutConfig {
+  // The most moves of a playout as a multiple of the board area, or no limit
+  // if it is zero.
+  float max_length_factor = 0.0f;
+  // A playout ends once the regions of both forces differ by the threshold,
+  // which should exceed the komi so that the leader wins, or never if it is
+  // zero.
+  int mercy_threshold = 0;
+  // Moves are drawn by these weights, by RunPlayout, or uniformly if it is
+  // nullptr.
+  const PatternWeights *pattern_weights = nullptr;
+};
+
+// Plays random moves on the board until the game ends or a limit of the
+// config is reached. Unlike MonteCarloGame, it neither creates players nor
+// copies the board, and picks moves directly from the playable bitset, so a
+// playout allocates no vectors of indexes. Moves are added to
+// first_move_points if it is not nullptr.
+template<BoardLen BOARD_LEN>
+void RunRandomPlayout(FullBoard<BOARD_LEN> *full_board,
+                      RandomEngine *random_engine,
+                      FirstMovePoints<BOARD_LEN> *first_move_points = nullptr,
+                      const PlayoutConfig &playout_config = PlayoutConfig()) {
+  int max_move_count = playout_config.max_length_factor > 0.0f ?
+      static_cast<int>(playout_config.max_length_factor
+          * BoardLenSquare<BOARD_LEN>()) : std::numeric_limits<int>::max();
+  int mercy_threshold = playout_config.mercy_threshold;
+
+  for (int move_count = 0; !full_board->IsEnd() && move_count < max_move_count;
+      ++move_count) {
+    Force force = NextForce(*full_board);
+    const BitSet<BOARD_LEN> &playable_bitset =
+        full_board->PlayableIndexBitSet(force);
+    int playable_count = playable_bitset.count();
+
+    if (playable_count == 0) {
+      full_board->Pass(force);
+    } else {
+      int nth = random_engine->Uniform(playable_count - 1);
+      PositionIndex index = playable_bitset.Select(nth);
+      full_board->PlayMove(Move(force, index));
+      if (first_move_points != nullptr
+          && !(*first_move_points)[OppositeForce(force)][index]) {
+        (*first_move_points)[force].set(index);
+      }
+    }
+
+    if (mercy_threshold > 0
+        && std::abs(full_board->Region(Force::BLACK_FORCE)
+            - full_board->Region(Force::WHITE_FORCE)) >= mercy_threshold) {
+      break;
+    }
+  }
+}
+
 } /* namespace foolgo */
 
 #endif
@@ -0,0 +1,161 @@
+#include "multi_size_gtp_engine.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <utility>
+
+#include "../player/opening_book.h"
+#include "../player/uct_player.h"
+#include "board_len_dispatch.h"
+#include "gtp_engine.h"
+
+namespace foolgo {
+
+using std::string;
+using std::unique_ptr;
+
+namespace {
+
+// Players of other lengths than 19 search without the network, which is of
+// 19x19 boards.
+template<BoardLen BOARD_LEN>
+unique_ptr<PlayerNetwork> OpenNetwork(const GtpPlayerConfig &config,
+                                      UctPlayer<BOARD_LEN> *) {
+  if (config.open_network) {
+    std::cerr << "the network is of 19x19 boards, so players of board length "
+        << static_cast<int>(BOARD_LEN) << " search without it" << std::endl;
+  }
+  return nullptr;
+}
+
+template<>
+unique_ptr<PlayerNetwork> OpenNetwork<19>(const GtpPlayerConfig &config,
+                                          UctPlayer<19> *uct_player) {
+  if (!config.open_network) {
+    return nullptr;
+  }
+  return config.open_network(config, uct_player);
+}
+
+template<BoardLen BOARD_LEN>
+class SizedGtpEngineImpl : public SizedGtpEngine {
+ public:
+  explicit SizedGtpEngineImpl(const GtpPlayerConfig &config)
+      : uct_player_(config.seed, config.mc_game_count, config.thread_count,
+                    config.table_memory_bytes),
+        gtp_engine_(&uct_player_, config.is_pondering) {
+    uct_player_.SetSymmetryFolding(config.folds_symmetries);
+    if (!config.opening_book_path.empty()) {
+      std::shared_ptr<const OpeningBook> opening_book(OpeningBook::Open(
+          config.opening_book_path, BOARD_LEN, EmptyBoardHashKey<BOARD_LEN>()));
+      if (opening_book == nullptr) {
+        std::cerr << "no opening book of board length " << BOARD_LEN
+            << " and the hash seed in " << config.opening_book_path
+            << std::endl;
+      }
+      uct_player_.SetOpeningBook(opening_book,
+                                 config.book_instant_visited_time);
+    }
+    network_ = OpenNetwork(config, &uct_player_);
+  }
+  DISALLOW_COPY_AND_ASSIGN_AND_MOVE(SizedGtpEngineImpl)
+
+  int BoardLength() const override {
+    return BOARD_LEN;
+  }
+  bool Execute(const string &command, string *response,
+               bool *is_quit) override {
+    return gtp_engine_.Execute(command, response, is_quit);
+  }
+  void StartPondering() override {
+    gtp_engine_.StartPondering();
+  }
+  void StopPondering() override {
+    gtp_engine_.StopPondering();
+  }
+
+ private:
+  // Destroyed after the player, whose searches evaluate by it.
+  unique_ptr<PlayerNetwork> network_;
+  // Destroyed after the engine, which stops pondering of the player.
+  UctPlayer<BOARD_LEN> uct_player_;
+  GtpEngine<BOARD_LEN> gtp_engine_;
+};
+
+template<BoardLen BOARD_LEN>
+struct NewSizedGtpEngineOfLen {
+  void operator()(const GtpPlayerConfig &config,
+                  unique_ptr<SizedGtpEngine> *engine) const {
+    InitZobHasherOnce<BOARD_LEN>(
+        config.hash_seed != 0 ? config.hash_seed : config.seed);
+    engine->reset(new SizedGtpEngineImpl<BOARD_LEN>(config));
+  }
+};
+
+}
+
+unique_ptr<SizedGtpEngine> NewSizedGtpEngine(int board_len,
+                                             const GtpPlayerConfig &config) {
+  unique_ptr<SizedGtpEngine> engine;
+  DispatchBoardLen<NewSizedGtpEngineOfLen>(board_len, config, &engine);
+  return engine;
+}
+
+unique_ptr<MultiSizeGtpEngine> MultiSizeGtpEngine::New(
+    int board_len, const GtpPlayerConfig &config) {
+  unique_ptr<SizedGtpEngine> engine = NewSizedGtpEngine(board_len, config);
+  if (engine == nullptr) {
+    return nullptr;
+  }
+  return unique_ptr<MultiSizeGtpEngine>(
+      new MultiSizeGtpEngine(config, std::move(engine)));
+}
+
+MultiSizeGtpEngine::MultiSizeGtpEngine(const GtpPlayerConfig &config,
+                                       unique_ptr<SizedGtpEngine> engine)
+    : config_(config), engine_(std::move(engine)) {}
+
+void MultiSizeGtpEngine::Run(std::istream &is, std::ostream &os) {
+  RunGtpCommands(this, is, os);
+}
+
+bool MultiSizeGtpEngine::Execute(const string &command, string *response,
+                                 bool *is_quit) {
+  std::istringstream command_stream(command);
+  string name;
+  string first_arg;
+  command_stream >> name >> first_arg;
+
+  if (name == "boardsize") {
+    int board_len = std::atoi(first_arg.c_str());
+    if (!IsSupportedBoardLen(board_len)) {
+      *is_quit = false;
+      *response = "unacceptable size";
+      return false;
+    }
+    if (board_len != engine_->BoardLength()) {
+      engine_.reset();
+      engine_ = NewSizedGtpEngine(board_len, config_);
+      string ignored_response;
+      bool ignored_is_quit;
+      for (const string *setting_command :
+          {&komi_command_, &time_settings_command_}) {
+        if (!setting_command->empty()) {
+          engine_->Execute(*setting_command, &ignored_response,
+                           &ignored_is_quit);
+        }
+      }
+    }
+  }
+
+  bool is_success = engine_->Execute(command, response, is_quit);
+  if (is_success && name == "komi") {
+    komi_command_ = command;
+  } else if (is_success && name == "time_settings") {
+    time_settings_command_ = command;
+  }
+  return is_success;
+}
+
+}
@@ -0,0 +1,113 @@
+#ifndef FOOLGO_SRC_GAME_MULTI_SIZE_GTP_ENGINE_H_
+#define FOOLGO_SRC_GAME_MULTI_SIZE_GTP_ENGINE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "../board/position.h"
+#include "../def.h"
+
+namespace foolgo {
+
+template<BoardLen BOARD_LEN>
+class UctPlayer;
+
+// What a player searches by apart from its tables, such as a network, which
+// is kept until the player is destroyed.
+class PlayerNetwork {
+ public:
+  virtual ~PlayerNetwork() = default;
+};
+
+struct GtpPlayerConfig;
+
+// Sets the network of the 19x19 player and returns it, or nullptr if the
+// player searches by playouts alone.
+typedef std::function<std::unique_ptr<PlayerNetwork>(
+    const GtpPlayerConfig &config, UctPlayer<19> *uct_player)> NetworkOpener;
+
+// Settings of the players built for each board length.
+struct GtpPlayerConfig {
+  uint32_t seed = 1;
+  int mc_game_count = 10000;
+  int thread_count = 1;
+  std::size_t table_memory_bytes = 128 << 20;
+  bool folds_symmetries = false;
+  bool is_pondering = true;
+  // Seeds the hashers instead of the seed if it is not zero, so that keys
+  // are those of an opening book written with the same hash seed.
+  uint32_t hash_seed = 0;
+  // The opening book of players of its board length, or empty.
+  std::string opening_book_path;
+  int32_t book_instant_visited_time = 0;
+  // Opens the network of 19x19 players, or is empty to search by playouts
+  // alone. The network is not of the other lengths.
+  NetworkOpener open_network;
+};
+
+// A GtpEngine and its UctPlayer of one board length, behind an interface of
+// no length.
+class SizedGtpEngine {
+ public:
+  virtual ~SizedGtpEngine() = default;
+
+  virtual int BoardLength() const = 0;
+  virtual bool Execute(const std::string &command, std::string *response,
+                       bool *is_quit) = 0;
+  virtual void StartPondering() = 0;
+  virtual void StopPondering() = 0;
+};
+
+// Returns the engine of the length, whose hasher is initialized by the seed
+// of the config unless it has been, or nullptr if the length is not one of
+// SUPPORTED_BOARD_LENS.
+std::unique_ptr<SizedGtpEngine> NewSizedGtpEngine(
+    int board_len, const GtpPlayerConfig &config);
+
+/**
+ * A GTP front end of all supported board lengths, which replaces its engine
+ * with one of another length at the boardsize command, so that one build
+ * serves them all while searches run code specialized for the length. The
+ * engine of the old length, with its tables, is freed before the new one is
+ * built. The komi and the time settings are kept across lengths.
+ */
+class MultiSizeGtpEngine {
+ public:
+  // Returns nullptr if the initial length is not supported.
+  static std::unique_ptr<MultiSizeGtpEngine> New(
+      int board_len, const GtpPlayerConfig &config);
+  DISALLOW_COPY_AND_ASSIGN_AND_MOVE(MultiSizeGtpEngine)
+
+  int BoardLength() const {
+    return engine_->BoardLength();
+  }
+
+  // As those of GtpEngine.
+  void Run(std::istream &is, std::ostream &os);
+  bool Execute(const std::string &command, std::string *response,
+               bool *is_quit);
+  void StartPondering() {
+    engine_->StartPondering();
+  }
+  void StopPondering() {
+    engine_->StopPondering();
+  }
+
+ private:
+  GtpPlayerConfig config_;
+  std::unique_ptr<SizedGtpEngine> engine_;
+  // The last commands of the settings, which are replayed to a new engine.
+  std::string komi_command_;
+  std::string time_settings_command_;
+
+  MultiSizeGtpEngine(const GtpPlayerConfig &config,
+                     std::unique_ptr<SizedGtpEngine> engine);
+};
+
+}
+
+#endif
@@ -0,0 +1,175 @@
+#ifndef FOOLGO_SRC_GAME_PATTERN_PLAYOUT_H_
+#define FOOLGO_SRC_GAME_PATTERN_PLAYOUT_H_
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+
+#include "../board/bit_board.h"
+#include "../board/force.h"
+#include "../board/full_board.h"
+#include "../board/position.h"
+#include "../util/fenwick_tree.h"
+#include "../util/fixed_vector.h"
+#include "../util/rand.h"
+#include "monte_carlo_game.h"
+#include "pattern_weights.h"
+
+namespace foolgo {
+
+// Points of the 3x3 neighbourhoods of the points.
+template<BoardLen BOARD_LEN>
+inline BitSet<BOARD_LEN> PatternNeighborhood(const BitSet<BOARD_LEN> &points) {
+  BitSet<BOARD_LEN> rows = points | points.East() | points.West();
+  return rows | rows.North() | rows.South();
+}
+
+// Plays moves drawn by the pattern weights of the config, which should not
+// be nullptr, like RunRandomPlayout does uniformly. Each force keeps a tree
+// of the weights of its playable points, of which only points whose
+// playable states or patterns change since its last move are updated. Moves
+// capturing the chain of the last move, or extending chains it puts into
+// atari, are weighted up by the factors.
+template<BoardLen BOARD_LEN>
+void RunPatternPlayout(FullBoard<BOARD_LEN> *full_board,
+                       RandomEngine *random_engine,
+                       FirstMovePoints<BOARD_LEN> *first_move_points = nullptr,
+                       const PlayoutConfig &playout_config = PlayoutConfig()) {
+  assert(playout_config.pattern_weights != nullptr);
+  const PatternWeights &pattern_weights = *playout_config.pattern_weights;
+  int max_move_count = playout_config.max_length_factor > 0.0f ?
+      static_cast<int>(playout_config.max_length_factor
+          * BoardLenSquare<BOARD_LEN>()) : std::numeric_limits<int>::max();
+  int mercy_threshold = playout_config.mercy_threshold;
+  auto &calculator = PstionAndIndxCcltr<BOARD_LEN>::Ins();
+
+  typedef util::FenwickTree<int32_t, BoardLenSquare<BOARD_LEN>()> WeightTree;
+  std::array<WeightTree, 2> weight_trees;
+  std::array<std::array<int32_t, BoardLenSquare<BOARD_LEN>()>, 2> weights;
+  // The states of the last update of each tree.
+  std::array<BitSet<BOARD_LEN>, 2> updated_playable_points;
+  std::array<BitSet<BOARD_LEN>, 2> updated_empty_points;
+  std::array<bool, 2> is_tree_built = {{ false, false }};
+  for (int move_count = 0; !full_board->IsEnd() && move_count < max_move_count;
+      ++move_count) {
+    Force force = NextForce(*full_board);
+    const BitSet<BOARD_LEN> &playable_points =
+        full_board->PlayableIndexBitSet(force);
+    const BitSet<BOARD_LEN> &empty_points =
+        full_board->PointBitSet(EMPTY_POINT);
+    WeightTree &weight_tree = weight_trees[force];
+    auto &force_weights = weights[force];
+
+    if (!is_tree_built[force]) {
+      for (PositionIndex i = 0; i < BoardLenSquare<BOARD_LEN>(); ++i) {
+        force_weights[i] = playable_points[i] ? pattern_weights.Weight(
+            full_board->GetPatternCode(i), force) : 0;
+      }
+      weight_tree.Build(force_weights.data());
+      is_tree_built[force] = true;
+    } else {
+      BitSet<BOARD_LEN> changed_points =
+          (playable_points ^ updated_playable_points[force])
+          | PatternNeighborhood<BOARD_LEN>(
+              empty_points ^ updated_empty_points[force]);
+      for (PositionIndex i : changed_points) {
+        int32_t weight = playable_points[i] ? pattern_weights.Weight(
+            full_board->GetPatternCode(i), force) : 0;
+        if (weight != force_weights[i]) {
+          weight_tree.Add(i, weight - force_weights[i]);
+          force_weights[i] = weight;
+        }
+      }
+    }
+    updated_playable_points[force] = playable_points;
+    updated_empty_points[force] = empty_points;
+
+    // Airs of the chain of the last move and of the chains beside it, which
+    // are the last ones, are urgent.
+    util::FixedVector<PositionIndex, 5> urgent_indexes;
+    util::FixedVector<int32_t, 5> urgent_weights;
+    int32_t urgent_weight_sum = 0;
+    PositionIndex last_move_index = full_board->LastMoveIndex();
+    if (last_move_index != POSITION_INDEX_PASS
+        && full_board->GetPointState(last_move_index) != EMPTY_POINT) {
+      util::FixedVector<PositionIndex, 5> pieces;
+      // Of the opponent, to be captured, and of the mover, to be extended.
+      pieces.push_back(last_move_index);
+      for (PositionIndex adjacent_index :
+          calculator.AdjacentIndexes(last_move_index)) {
+        if (full_board->GetPointState(adjacent_index)
+            == ForceToPointState(force)) {
+          pieces.push_back(adjacent_index);
+        }
+      }
+      for (PositionIndex piece : pieces) {
+        if (!full_board->IsChainInAtari(piece)) {
+          continue;
+        }
+        PositionIndex air = full_board->ChainLastAir(piece);
+        if (!playable_points[air] || std::find(urgent_indexes.begin(),
+            urgent_indexes.end(), air) != urgent_indexes.end()) {
+          continue;
+        }
+        uint32_t factor = piece == last_move_index ?
+            pattern_weights.CaptureFactor() :
+            pattern_weights.AtariEscapeFactor();
+        // The weight in the tree is drawn as well.
+        int32_t weight = force_weights[air] * (factor - 1);
+        urgent_indexes.push_back(air);
+        urgent_weights.push_back(weight);
+        urgent_weight_sum += weight;
+      }
+    }
+
+    int32_t weight_sum = weight_tree.Total() + urgent_weight_sum;
+    if (weight_sum == 0) {
+      full_board->Pass(force);
+    } else {
+      int32_t target = random_engine->Uniform(weight_sum - 1);
+      PositionIndex index = POSITION_INDEX_PASS;
+      for (std::size_t i = 0; i < urgent_indexes.size(); ++i) {
+        if (target < urgent_weights[i]) {
+          index = urgent_indexes[i];
+          break;
+        }
+        target -= urgent_weights[i];
+      }
+      if (index == POSITION_INDEX_PASS) {
+        index = weight_tree.Find(target);
+      }
+      full_board->PlayMove(Move(force, index));
+      if (first_move_points != nullptr
+          && !(*first_move_points)[OppositeForce(force)][index]) {
+        (*first_move_points)[force].set(index);
+      }
+    }
+
+    if (mercy_threshold > 0
+        && std::abs(full_board->Region(Force::BLACK_FORCE)
+            - full_board->Region(Force::WHITE_FORCE)) >= mercy_threshold) {
+      break;
+    }
+  }
+}
+
+// Runs the playout of the policy of the config.
+template<BoardLen BOARD_LEN>
+void RunPlayout(FullBoard<BOARD_LEN> *full_board, RandomEngine *random_engine,
+                FirstMovePoints<BOARD_LEN> *first_move_points,
+                const PlayoutConfig &playout_config) {
+  if (playout_config.pattern_weights == nullptr) {
+    RunRandomPlayout(full_board, random_engine, first_move_points,
+                     playout_config);
+  } else {
+    RunPatternPlayout(full_board, random_engine, first_move_points,
+                      playout_config);
+  }
+}
+
+}
+
+#endif
@@ -0,0 +1,65 @@
+#include "pattern_weights.h"
+
+#include <cassert>
+#include <utility>
+
+namespace foolgo {
+
+using std::vector;
+
+namespace {
+
+// Neighbours of the kth order which are adjacent to the center, and which
+// are oblique to it.
+const int ADJACENT_NEIGHBORS[4] = { 1, 3, 4, 6 };
+const int OBLIQUE_NEIGHBORS[4] = { 0, 2, 5, 7 };
+
+uint16_t DefaultWeight(PatternCode code) {
+  int state_counts[2][4] = { { 0 } };
+  for (int i = 0; i < 4; ++i) {
+    ++state_counts[0][PatternNeighborState(code, ADJACENT_NEIGHBORS[i])];
+    ++state_counts[1][PatternNeighborState(code, OBLIQUE_NEIGHBORS[i])];
+  }
+  const int *adjacent_counts = state_counts[0];
+  const int *oblique_counts = state_counts[1];
+
+  if (adjacent_counts[BLACK_POINT] + adjacent_counts[OFF_BOARD_PATTERN_STATE]
+      == 4) {
+    return 1;
+  }
+  if (adjacent_counts[BLACK_POINT] + adjacent_counts[WHITE_POINT] == 0) {
+    if (oblique_counts[BLACK_POINT] + oblique_counts[WHITE_POINT] > 0) {
+      return 24;
+    }
+    return adjacent_counts[OFF_BOARD_PATTERN_STATE] > 0 ? 4 : 16;
+  }
+  if (adjacent_counts[WHITE_POINT] > 0
+      && adjacent_counts[BLACK_POINT] + oblique_counts[BLACK_POINT] > 0) {
+    return 96;
+  }
+  return 48;
+}
+
+}
+
+PatternWeights::PatternWeights(vector<uint16_t> weights,
+                               uint32_t capture_factor,
+                               uint32_t atari_escape_factor)
+    : weights_(std::move(weights)),
+      capture_factor_(capture_factor),
+      atari_escape_factor_(atari_escape_factor) {
+  assert(weights_.size() == PATTERN_CODE_COUNT);
+}
+
+const PatternWeights &PatternWeights::Default() {
+  static const PatternWeights pattern_weights([]() {
+    vector<uint16_t> weights(PATTERN_CODE_COUNT);
+    for (int code = 0; code < PATTERN_CODE_COUNT; ++code) {
+      weights[code] = DefaultWeight(code);
+    }
+    return weights;
+  }());
+  return pattern_weights;
+}
+
+}
@@ -0,0 +1,50 @@
+#ifndef FOOLGO_SRC_GAME_PATTERN_WEIGHTS_H_
+#define FOOLGO_SRC_GAME_PATTERN_WEIGHTS_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "../board/force.h"
+#include "../board/pattern.h"
+#include "../def.h"
+
+namespace foolgo {
+
+/**
+ * Weights of the moves of a pattern playout. A move is drawn with the weight
+ * of its 3x3 pattern, multiplied by a factor if it captures a chain in
+ * atari, or extends a chain of the mover out of atari, next to the last
+ * move. Every weight is positive, so that every playable move may be drawn.
+ */
+class PatternWeights {
+ public:
+  // Takes the weights of the codes seen by black, each at least one.
+  explicit PatternWeights(std::vector<uint16_t> weights,
+                          uint32_t capture_factor = 32,
+                          uint32_t atari_escape_factor = 16);
+  DISALLOW_COPY_AND_ASSIGN_AND_MOVE(PatternWeights)
+
+  // Weights by hand: few for the eye-like points of the mover, fewer on the
+  // edges away from pieces than in the center, and more for contact moves,
+  // most when they also touch pieces of the mover, like hanes and cuts.
+  static const PatternWeights &Default();
+
+  uint32_t Weight(PatternCode code, Force force) const {
+    return weights_[force == BLACK_FORCE ? code : SwapPatternColors(code)];
+  }
+  uint32_t CaptureFactor() const {
+    return capture_factor_;
+  }
+  uint32_t AtariEscapeFactor() const {
+    return atari_escape_factor_;
+  }
+
+ private:
+  std::vector<uint16_t> weights_;
+  uint32_t capture_factor_;
+  uint32_t atari_escape_factor_;
+};
+
+}
+
+#endif
@@ -0,0 +1,133 @@
+#ifndef FOOLGO_SRC_GAME_SELF_PLAY_H_
+#define FOOLGO_SRC_GAME_SELF_PLAY_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "../board/force.h"
+#include "../board/full_board.h"
+#include "../board/position.h"
+#include "../deep_learning/sample.h"
+#include "../deep_learning/sample_shard.h"
+#include "../def.h"
+#include "../player/remote_search_protocol.h"
+#include "../util/thread_pool.h"
+#include "fresh_game.h"
+
+namespace foolgo {
+
+/**
+ * Plays AI vs AI games at the same time and writes a sample of each move,
+ * with the visits of the search choosing it and the result of the game, to
+ * shards. ZobHasher should be initialized before, and is only read by the
+ * games. A game is written once it ends, so that the result is known, and
+ * games share the writer under a lock.
+ */
+template<BoardLen BOARD_LEN>
+class SelfPlay {
+ public:
+  typedef SampleShardWriter<BOARD_LEN, SearchSample<BOARD_LEN>> Writer;
+
+  // The writer should outlive the self-play. Players of each game are seeded
+  // by the seed and the index of the game, and each has a table of the
+  // memory, so that games at once take twice as many tables.
+  SelfPlay(int mc_game_count, std::size_t table_memory_bytes, uint32_t seed,
+           Writer *writer)
+      : mc_game_count_(mc_game_count),
+        table_memory_bytes_(table_memory_bytes),
+        seed_(seed),
+        writer_(writer) {}
+  DISALLOW_COPY_AND_ASSIGN_AND_MOVE(SelfPlay)
+
+  // Plays a game per task of the pool, so that as many games run at once as
+  // the pool has workers, and players search on the worker of their game.
+  // Returns false if a sample can not be written.
+  bool Play(int game_count, util::ThreadPool *thread_pool);
+
+  int64_t GameCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return game_count_;
+  }
+  int64_t SampleCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sample_count_;
+  }
+
+ private:
+  int mc_game_count_;
+  std::size_t table_memory_bytes_;
+  uint32_t seed_;
+  // Guards the writer and the counts.
+  mutable std::mutex mutex_;
+  Writer *writer_;
+  int64_t game_count_ = 0;
+  int64_t sample_count_ = 0;
+  bool is_written_ = true;
+
+  void PlayGame(int game_index);
+};
+
+template<BoardLen BOARD_LEN>
+bool SelfPlay<BOARD_LEN>::Play(int game_count,
+                               util::ThreadPool *thread_pool) {
+  for (int i = 0; i < game_count; ++i) {
+    thread_pool->Submit([this, i](int) {
+      PlayGame(i);
+    });
+  }
+  thread_pool->Wait();
+  std::lock_guard<std::mutex> lock(mutex_);
+  return is_written_;
+}
+
+template<BoardLen BOARD_LEN>
+void SelfPlay<BOARD_LEN>::PlayGame(int game_index) {
+  const int pass_index = BoardLenSquare<BOARD_LEN>();
+  std::vector<SearchSample<BOARD_LEN>> samples;
+  std::array<int32_t, SearchSample<BOARD_LEN>::VISIT_COUNT_SIZE>
+      visited_times;
+
+  auto game = FreshGame<BOARD_LEN>::BuildAiVsAiGame(seed_ + game_index,
+      mc_game_count_, 1, table_memory_bytes_, true,
+      [&samples, &visited_times, pass_index](
+          const FullBoard<BOARD_LEN> &full_board, PositionIndex index,
+          const std::vector<RootChildStat> &root_child_stats) {
+        SearchSample<BOARD_LEN> sample;
+        sample.sample.Pack(full_board, index);
+        visited_times.fill(0);
+        // A pass is chosen without searching the children.
+        if (index == POSITION_INDEX_PASS) {
+          visited_times[pass_index] = 1;
+        } else {
+          for (const RootChildStat &stat : root_child_stats) {
+            visited_times[stat.position_index] = stat.visited_time;
+          }
+        }
+        sample.SetVisitCounts(visited_times.data());
+        samples.push_back(sample);
+      });
+  game->Run();
+
+  const FullBoard<BOARD_LEN> &end_board = game->GetFullBoard();
+  float black_score = end_board.Region(Force::BLACK_FORCE)
+      - end_board.Region(Force::WHITE_FORCE) - DEFAULT_KOMI;
+  for (SearchSample<BOARD_LEN> &sample : samples) {
+    bool is_black_to_move =
+        OppositeForce(sample.sample.LastForce()) == Force::BLACK_FORCE;
+    sample.sample.value = (black_score > 0) == is_black_to_move ? 1 : -1;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const SearchSample<BOARD_LEN> &sample : samples) {
+    is_written_ = is_written_ && writer_->Add(sample);
+  }
+  ++game_count_;
+  sample_count_ += samples.size();
+}
+
+}
+
+#endif
@@ -51,9 +51,13 @@ class SgfGame : public Game<BOARD_LEN> {
 
   void BeforePlay (PositionIndex index) override {
     if (samples_ != nullptr) {
+      const FullBoard<BOARD_LEN> &full_board = this->GetFullBoard();
+      int8_t value = 0;
+      if (game_info_.has_winner) {
+        value = game_info_.winner == NextForce(full_board) ? 1 : -1;
+      }
       Sample<BOARD_LEN> sample;
-      sample.full_board.Copy(this->GetFullBoard());
-      sample.position_index = index;
+      sample.Pack(full_board, index, value);
       samples_->push_back(sample);
     }
   }
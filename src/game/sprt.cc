@@ -0,0 +1,87 @@
+#include "sprt.h"
+
+#include <cmath>
+#include <limits>
+
+namespace foolgo {
+
+namespace {
+
+// The z of the two sided 95% confidence interval.
+const double CONFIDENCE_Z = 1.959964;
+
+double EloOfScore(double mean_score) {
+  if (mean_score <= 0.0) {
+    return -std::numeric_limits<double>::infinity();
+  }
+  if (mean_score >= 1.0) {
+    return std::numeric_limits<double>::infinity();
+  }
+  return -400.0 * std::log10(1.0 / mean_score - 1.0);
+}
+
+double ScoreOfElo(double elo) {
+  return 1.0 / (1.0 + std::pow(10.0, -elo / 400.0));
+}
+
+// The variance of the score of one game, of the counts of results.
+double ScoreVariance(double win_count, double draw_count, double loss_count) {
+  double game_count = win_count + draw_count + loss_count;
+  double mean_score = (win_count + 0.5 * draw_count) / game_count;
+  return (win_count * (1.0 - mean_score) * (1.0 - mean_score)
+      + draw_count * (0.5 - mean_score) * (0.5 - mean_score)
+      + loss_count * mean_score * mean_score) / game_count;
+}
+
+// The variance of the score of one game of the results, with half a win and
+// half a loss added while either is missing, so that the variance of a one
+// sided match is not zero.
+double RegularizedScoreVariance(const MatchScore &score) {
+  double pseudo_count =
+      score.win_count == 0 || score.loss_count == 0 ? 0.5 : 0.0;
+  return ScoreVariance(score.win_count + pseudo_count, score.draw_count,
+                       score.loss_count + pseudo_count);
+}
+
+}
+
+double MatchScore::MeanScore() const {
+  int64_t game_count = GameCount();
+  return game_count == 0 ? 0.5 : (win_count + 0.5 * draw_count) / game_count;
+}
+
+EloEstimate EstimateElo(const MatchScore &score) {
+  double mean_score = score.MeanScore();
+  double margin = score.GameCount() == 0 ? 0.5 :
+      CONFIDENCE_Z * std::sqrt(RegularizedScoreVariance(score)
+          / score.GameCount());
+  EloEstimate estimate;
+  estimate.elo = EloOfScore(mean_score);
+  estimate.lower = EloOfScore(mean_score - margin);
+  estimate.upper = EloOfScore(mean_score + margin);
+  return estimate;
+}
+
+double SprtLogLikelihoodRatio(const MatchScore &score,
+                              const SprtConfig &config) {
+  if (score.GameCount() == 0) {
+    return 0.0;
+  }
+  double score0 = ScoreOfElo(config.elo0);
+  double score1 = ScoreOfElo(config.elo1);
+  return (score1 - score0) * (2.0 * score.MeanScore() - score0 - score1)
+      * score.GameCount() / (2.0 * RegularizedScoreVariance(score));
+}
+
+SprtResult TestSprt(const MatchScore &score, const SprtConfig &config) {
+  double ratio = SprtLogLikelihoodRatio(score, config);
+  if (ratio >= std::log((1.0 - config.beta) / config.alpha)) {
+    return SprtResult::ACCEPT_ELO1;
+  }
+  if (ratio <= std::log(config.beta / (1.0 - config.alpha))) {
+    return SprtResult::ACCEPT_ELO0;
+  }
+  return SprtResult::CONTINUE;
+}
+
+}
@@ -0,0 +1,59 @@
+#ifndef FOOLGO_SRC_GAME_SPRT_H_
+#define FOOLGO_SRC_GAME_SPRT_H_
+
+#include <cstdint>
+
+namespace foolgo {
+
+// Results of games of one side of a match.
+struct MatchScore {
+  int64_t win_count = 0;
+  int64_t draw_count = 0;
+  int64_t loss_count = 0;
+
+  int64_t GameCount() const {
+    return win_count + draw_count + loss_count;
+  }
+  // The mean score of a game, counting a draw as half a win.
+  double MeanScore() const;
+};
+
+// The Elo difference of the side, and the bounds of its 95% confidence
+// interval by the normal approximation of the mean score. A bound is
+// infinite when it reaches a score of all wins or all losses.
+struct EloEstimate {
+  double elo;
+  double lower;
+  double upper;
+};
+
+EloEstimate EstimateElo(const MatchScore &score);
+
+/**
+ * A sequential probability ratio test of the hypotheses that the side is
+ * elo0 or elo1 stronger, with the false positive and false negative rates
+ * alpha and beta, which stops a match as soon as the results tell them
+ * apart.
+ */
+struct SprtConfig {
+  double elo0 = 0.0;
+  double elo1 = 10.0;
+  double alpha = 0.05;
+  double beta = 0.05;
+};
+
+enum class SprtResult {
+  CONTINUE,
+  ACCEPT_ELO0,
+  ACCEPT_ELO1
+};
+
+// The log likelihood ratio of elo1 to elo0, by the normal approximation of
+// the trinomial distribution of results, or 0 before any game.
+double SprtLogLikelihoodRatio(const MatchScore &score,
+                              const SprtConfig &config);
+SprtResult TestSprt(const MatchScore &score, const SprtConfig &config);
+
+}
+
+#endif
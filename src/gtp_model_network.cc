@@ -0,0 +1,71 @@
+#include "gtp_model_network.h"
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "board/full_board.h"
+#include "deep_learning/engine.h"
+#include "deep_learning/evaluation_queue.h"
+#include "player/uct_player.h"
+
+namespace foolgo {
+
+namespace {
+
+// Evaluations cached by each player with a network.
+const std::size_t EVALUATION_CACHE_CAPACITY = 1 << 16;
+
+// The engine of the model and the queue batching evaluations of the search
+// threads for it.
+class ModelNetwork : public PlayerNetwork {
+ public:
+  ModelNetwork(std::unique_ptr<Engine> engine, int thread_count)
+      : engine_(std::move(engine)) {
+    Engine *engine_ptr = engine_.get();
+    evaluation_queue_.reset(new EvaluationQueue<19>(
+        [engine_ptr](const std::vector<const FullBoard<19>*> &full_boards,
+                     std::vector<Evaluation> *evaluations) {
+          engine_ptr->Evaluate(full_boards, evaluations);
+        }, thread_count, std::chrono::milliseconds(1)));
+  }
+
+  EvaluationQueue<19> *GetEvaluationQueue() {
+    return evaluation_queue_.get();
+  }
+
+ private:
+  std::unique_ptr<Engine> engine_;
+  // Destroyed first, for its dispatcher evaluates by the engine.
+  std::unique_ptr<EvaluationQueue<19>> evaluation_queue_;
+};
+
+}
+
+NetworkOpener ModelNetworkOpener(const std::string &model_path) {
+  return [model_path](const GtpPlayerConfig &config, UctPlayer<19> *uct_player)
+      -> std::unique_ptr<PlayerNetwork> {
+    // Each search thread waits for one evaluation at a time.
+    HyperParams hyper_params;
+    hyper_params.batch = config.thread_count;
+    std::unique_ptr<Engine> engine = Engine::Open(model_path, hyper_params);
+    if (engine == nullptr) {
+      std::cerr << "bad checkpoint: " << model_path << std::endl;
+      return nullptr;
+    }
+    std::unique_ptr<ModelNetwork> network(
+        new ModelNetwork(std::move(engine), config.thread_count));
+    // The network has no value head, so leaves are valued by playouts, and
+    // the network gives the priors only.
+    EvaluationQueue<19> *evaluation_queue = network->GetEvaluationQueue();
+    uct_player->SetNetworkEvaluator(
+        [evaluation_queue](const FullBoard<19> &full_board) {
+          return evaluation_queue->Submit(full_board).get();
+        }, EVALUATION_CACHE_CAPACITY, 1.5f, 0.0f);
+    return std::move(network);
+  };
+}
+
+}
@@ -0,0 +1,17 @@
+#ifndef FOOLGO_SRC_GTP_MODEL_NETWORK_H_
+#define FOOLGO_SRC_GTP_MODEL_NETWORK_H_
+
+#include <string>
+
+#include "game/multi_size_gtp_engine.h"
+
+namespace foolgo {
+
+// Returns the opener of GTP players of 19x19 boards, which search by the
+// network of the checkpoint written by the trainer. It is built into foolgo
+// alone, so that other binaries do not compile the network.
+NetworkOpener ModelNetworkOpener(const std::string &model_path);
+
+}
+
+#endif
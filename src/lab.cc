@@ -1,37 +1,309 @@
+#include <sys/resource.h>
+
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
 
+#include "board/full_board.h"
 #include "board/zob_hasher.h"
 #include "def.h"
-#include "game/fresh_game.h"
-#include "game/game.h"
-#include "util/rand.h"
-#include "player/random_player.h"
+#include "game/monte_carlo_game.h"
+#include "game/pattern_weights.h"
+#include "player/opening_book.h"
+#include "player/search_stats.h"
 #include "player/uct_player.h"
+#include "util/cxxopts.hpp"
+#include "util/trace.h"
 
 using namespace foolgo;
-using namespace std;
+using std::cerr;
+using std::cout;
+using std::string;
+using std::vector;
+
+namespace {
+
+struct LabConfig {
+  uint32_t seed;
+  int move_count;
+  std::size_t table_memory_bytes;
+  bool folds_symmetries;
+  PlayoutConfig playout_config;
+  int leaf_playout_count;
+  bool uses_batch_playout;
+  // Hosts and ports of remote search workers.
+  vector<std::pair<string, uint16_t>> remote_workers;
+  // The book consulted, and the path the books of the searches are written
+  // to, if they are not empty.
+  string book_path;
+  int32_t book_instant_visited_time;
+  string book_output_path;
+  int32_t book_min_visited_time;
+};
+
+struct LabResult {
+  // Moves played, fewer than the move count if the game ends first.
+  int move_count = 0;
+  int64_t playout_count = 0;
+  int64_t created_node_count = 0;
+  double wall_seconds = 0.0;
+};
+
+vector<int> ParseIntList(const string &text) {
+  vector<int> values;
+  std::istringstream stream(text);
+  string value;
+  while (std::getline(stream, value, ',')) {
+    values.push_back(std::atoi(value.c_str()));
+  }
+  return values;
+}
+
+// The peak resident set size of the process in KiB, which never decreases
+// between runs.
+long PeakRssKib() {
+  rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+  return usage.ru_maxrss / 1024;
+#else
+  return usage.ru_maxrss;
+#endif
+}
+
+vector<std::pair<string, uint16_t>> ParseHostPortList(const string &text) {
+  vector<std::pair<string, uint16_t>> host_ports;
+  std::istringstream stream(text);
+  string host_port;
+  while (std::getline(stream, host_port, ',')) {
+    std::size_t colon = host_port.rfind(':');
+    if (colon == string::npos) {
+      cerr << "remote worker without port: " << host_port << std::endl;
+      exit(1);
+    }
+    host_ports.push_back(std::make_pair(host_port.substr(0, colon),
+        std::atoi(host_port.substr(colon + 1).c_str())));
+  }
+  return host_ports;
+}
+
+// Plays moves of a self play game from the empty board, and sums the stats of
+// their searches, in which playouts of remote workers are counted. Searched
+// positions are added to the book writer of the board length unless it is
+// nullptr, which is created by the first run.
+template<BoardLen BOARD_LEN>
+LabResult RunSelfPlay(const LabConfig &config, int mc_game_count,
+                      int thread_count,
+                      std::unique_ptr<OpeningBookWriter> *book_writer) {
+  static bool is_hasher_initialized = false;
+  if (!is_hasher_initialized) {
+    ZobHasher<BOARD_LEN>::Init(config.seed);
+    is_hasher_initialized = true;
+  }
+
+  UctPlayer<BOARD_LEN> player(config.seed, mc_game_count, thread_count,
+                              config.table_memory_bytes);
+  player.SetSymmetryFolding(config.folds_symmetries);
+  player.SetPlayoutConfig(config.playout_config);
+  player.SetLeafPlayoutCount(config.leaf_playout_count);
+  player.SetBatchPlayout(config.uses_batch_playout);
+  for (const auto &host_port : config.remote_workers) {
+    player.AddRemoteWorker(host_port.first, host_port.second);
+  }
+  if (!config.book_path.empty()) {
+    std::shared_ptr<const OpeningBook> opening_book(OpeningBook::Open(
+        config.book_path, BOARD_LEN, EmptyBoardHashKey<BOARD_LEN>()));
+    if (opening_book == nullptr) {
+      cerr << "no opening book of board length " << BOARD_LEN
+          << " and the seed in " << config.book_path << std::endl;
+    }
+    player.SetOpeningBook(opening_book, config.book_instant_visited_time);
+  }
+  if (book_writer != nullptr && *book_writer == nullptr) {
+    book_writer->reset(new OpeningBookWriter(BOARD_LEN,
+                                             config.folds_symmetries,
+                                             EmptyBoardHashKey<BOARD_LEN>()));
+  }
+  FullBoard<BOARD_LEN> full_board;
+  full_board.Init();
+  LabResult result;
+
+  for (int i = 0; i < config.move_count && !full_board.IsEnd(); ++i) {
+    PositionIndex next_index = player.NextMove(full_board);
+    const SearchStats &stats = player.LastSearchStats();
+    result.playout_count += stats.playout_count + stats.remote_playout_count;
+    result.created_node_count += stats.created_node_count;
+    result.wall_seconds += stats.wall_seconds;
+    if (book_writer != nullptr) {
+      player.AddToOpeningBook(config.book_min_visited_time,
+                              book_writer->get());
+    }
+    if (next_index == POSITION_INDEX_END) {
+      break;
+    }
+    Play(&full_board, next_index);
+    ++result.move_count;
+  }
+
+  return result;
+}
+
+LabResult RunSelfPlay(BoardLen board_len, const LabConfig &config,
+                      int mc_game_count, int thread_count,
+                      std::unique_ptr<OpeningBookWriter> *book_writer) {
+  switch (board_len) {
+    case 9:
+      return RunSelfPlay<9>(config, mc_game_count, thread_count,
+                            book_writer);
+    case 13:
+      return RunSelfPlay<13>(config, mc_game_count, thread_count,
+                             book_writer);
+    case 19:
+      return RunSelfPlay<19>(config, mc_game_count, thread_count,
+                             book_writer);
+    default:
+      cerr << "unsupported board length: " << static_cast<int>(board_len)
+          << std::endl;
+      exit(1);
+  }
+}
+
+}
+
+// Measures the search throughput of self play games for each combination of
+// the board lengths, playout counts per move and thread counts, and prints a
+// line of CSV per combination. The scaling efficiency is the speedup over the
+// first thread count divided by the ratio of thread counts. Searches are
+// reproducible by the seed with one thread.
+int main(int argc, char *argv[]) {
+  cxxopts::Options options("lab", "Search throughput of self play games.");
+  options.add_options()
+    ("seed", "random seed", cxxopts::value<uint32_t>()->default_value("1"))
+    ("board-len", "comma separated board lengths of 9, 13 or 19",
+     cxxopts::value<string>()->default_value("9"))
+    ("playouts", "comma separated playout counts per move",
+     cxxopts::value<string>()->default_value("10000"))
+    ("threads", "comma separated thread counts",
+     cxxopts::value<string>()->default_value("1,2,4"))
+    ("moves", "moves of the self play game of each run",
+     cxxopts::value<int>()->default_value("20"))
+    ("tt-memory", "transposition table memory in MiB",
+     cxxopts::value<std::size_t>()->default_value("128"))
+    ("remote-workers", "comma separated host:port of search workers",
+     cxxopts::value<string>()->default_value(""))
+    ("fold-symmetries", "share records of symmetric boards")
+    ("playout-length-factor", "most playout moves per board point, or 0",
+     cxxopts::value<float>()->default_value("0"))
+    ("mercy-threshold", "region lead ending a playout early, or 0",
+     cxxopts::value<int>()->default_value("0"))
+    ("leaf-playouts", "playouts run at once from each leaf",
+     cxxopts::value<int>()->default_value("1"))
+    ("batch-playout", "run the playouts of each leaf in lockstep")
+    ("pattern-playout", "draw playout moves by 3x3 pattern weights")
+    ("book", "opening book consulted at each move",
+     cxxopts::value<string>()->default_value(""))
+    ("book-instant-visits", "book visits of a position played without "
+     "searching, or 0 to only seed the search",
+     cxxopts::value<int32_t>()->default_value("0"))
+    ("book-output", "path of the opening book of the searches of all runs, "
+     "suffixed by the board length if there are several",
+     cxxopts::value<string>()->default_value(""))
+    ("book-min-visits", "visits of a position written to the book",
+     cxxopts::value<int32_t>()->default_value("1000"))
+    ("trace-output", "path of the Chrome trace, of builds with FOOLGO_TRACE",
+     cxxopts::value<string>()->default_value(""));
+  auto args = options.parse(argc, argv);
+
+  LabConfig config;
+  config.seed = args["seed"].as<uint32_t>();
+  config.move_count = args["moves"].as<int>();
+  config.table_memory_bytes = args["tt-memory"].as<std::size_t>() << 20;
+  config.folds_symmetries = args.count("fold-symmetries") > 0;
+  config.playout_config.max_length_factor =
+      args["playout-length-factor"].as<float>();
+  config.playout_config.mercy_threshold = args["mercy-threshold"].as<int>();
+  config.leaf_playout_count = args["leaf-playouts"].as<int>();
+  config.uses_batch_playout = args.count("batch-playout") > 0;
+  if (args.count("pattern-playout") > 0) {
+    config.playout_config.pattern_weights = &PatternWeights::Default();
+  }
+  config.book_path = args["book"].as<string>();
+  config.book_instant_visited_time = args["book-instant-visits"].as<int32_t>();
+  config.book_output_path = args["book-output"].as<string>();
+  config.book_min_visited_time = args["book-min-visits"].as<int32_t>();
+  config.remote_workers = ParseHostPortList(
+      args["remote-workers"].as<string>());
+  vector<int> board_lens = ParseIntList(args["board-len"].as<string>());
+  vector<int> mc_game_counts = ParseIntList(args["playouts"].as<string>());
+  vector<int> thread_counts = ParseIntList(args["threads"].as<string>());
 
-int main(int argc, const char *argv[]) {
-  uint32_t seed = GetTimeSeed();
-//  uint32_t seed = 2479583645;
-  cout << "seed:" << seed << std::endl;
-  srand(seed);
+  // Books of all runs of each board length.
+  std::map<int, std::unique_ptr<OpeningBookWriter>> book_writers;
+  cout << "board_len,playouts_per_move,threads,moves,playouts,wall_seconds,"
+      "playouts_per_second,nodes_per_second,peak_rss_kib,scaling_efficiency"
+      << std::endl;
 
-  ZobHasher<MAIN_BOARD_LEN>::Init(seed);
+  for (int board_len : board_lens) {
+    for (int mc_game_count : mc_game_counts) {
+      double base_playouts_per_second = 0.0;
 
-  //Player<MAIN_BOARD_LEN> *black_player = new RandomPlayer<MAIN_BOARD_LEN>(seed);
+      for (std::size_t i = 0; i < thread_counts.size(); ++i) {
+        int thread_count = thread_counts[i];
+        LabResult result = RunSelfPlay(board_len, config, mc_game_count,
+            thread_count, config.book_output_path.empty() ? nullptr :
+                &book_writers[board_len]);
+        double playouts_per_second = result.wall_seconds > 0.0 ?
+            result.playout_count / result.wall_seconds : 0.0;
+        double nodes_per_second = result.wall_seconds > 0.0 ?
+            result.created_node_count / result.wall_seconds : 0.0;
+        if (i == 0) {
+          base_playouts_per_second = playouts_per_second;
+        }
+        double scaling_efficiency = base_playouts_per_second > 0.0 ?
+            playouts_per_second / base_playouts_per_second
+                * thread_counts[0] / thread_count : 0.0;
 
-  Player<MAIN_BOARD_LEN> *black_player =
-      new UctPlayer<MAIN_BOARD_LEN>(seed, 1000, 1);
+        cout << board_len << ',' << mc_game_count << ',' << thread_count
+            << ',' << result.move_count << ',' << result.playout_count << ','
+            << result.wall_seconds << ',' << playouts_per_second << ','
+            << nodes_per_second << ',' << PeakRssKib() << ','
+            << scaling_efficiency << std::endl;
+      }
+    }
+  }
 
-  Player<MAIN_BOARD_LEN> *white_player =
-      new UctPlayer<MAIN_BOARD_LEN>(seed, 1000, 1);
+  for (const auto &board_len_writer : book_writers) {
+    string book_output_path = config.book_output_path;
+    if (board_lens.size() > 1) {
+      book_output_path += "." + std::to_string(board_len_writer.first);
+    }
+    if (!board_len_writer.second->Write(book_output_path)) {
+      cerr << "cannot write " << book_output_path << std::endl;
+      return 1;
+    }
+  }
 
-  auto game =
-      FreshGame<MAIN_BOARD_LEN>::BuildFreshGame(black_player, white_player);
-  game->Run();
+  string trace_path = args["trace-output"].as<string>();
+  if (!trace_path.empty()) {
+#ifndef FOOLGO_TRACE
+    cerr << "built without FOOLGO_TRACE, so the trace is empty"
+        << std::endl;
+#endif
+    std::ofstream trace_stream(trace_path);
+    util::WriteChromeTrace(trace_stream);
+    if (!trace_stream) {
+      cerr << "cannot write " << trace_path << std::endl;
+      return 1;
+    }
+  }
 
   return 0;
 }
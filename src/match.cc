@@ -0,0 +1,153 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+#include "game/board_len_dispatch.h"
+#include "game/match.h"
+#include "game/pattern_weights.h"
+#include "game/sprt.h"
+#include "util/cxxopts.hpp"
+#include "util/thread_pool.h"
+
+using namespace foolgo;
+using std::cerr;
+using std::cout;
+using std::endl;
+using std::string;
+
+namespace {
+
+struct MatchConfig {
+  std::array<MatchPlayerConfig, 2> player_configs;
+  SprtConfig sprt_config;
+  int max_game_count;
+  int concurrent_game_count;
+  uint32_t seed;
+};
+
+const char *SprtResultName(SprtResult result) {
+  switch (result) {
+    case SprtResult::ACCEPT_ELO0:
+      return "elo0";
+    case SprtResult::ACCEPT_ELO1:
+      return "elo1";
+    default:
+      return "undecided";
+  }
+}
+
+template<BoardLen BOARD_LEN>
+struct PlayMatch {
+  void operator()(const MatchConfig &config) const {
+    InitZobHasherOnce<BOARD_LEN>(config.seed);
+    Match<BOARD_LEN> match(config.player_configs[0], config.player_configs[1],
+                           config.seed, config.sprt_config);
+    util::ThreadPool thread_pool(config.concurrent_game_count);
+    match.Play(config.max_game_count, &thread_pool);
+
+    MatchScore score = match.Score();
+    EloEstimate estimate = EstimateElo(score);
+    cout << "games:" << score.GameCount() << " wins:" << score.win_count
+        << " draws:" << score.draw_count << " losses:" << score.loss_count
+        << " elo:" << estimate.elo << " elo_lower:" << estimate.lower
+        << " elo_upper:" << estimate.upper << " llr:"
+        << SprtLogLikelihoodRatio(score, config.sprt_config) << " sprt:"
+        << SprtResultName(match.Result()) << endl;
+    for (int side = 0; side < 2; ++side) {
+      double seconds_per_move = match.SecondsPerMove(side);
+      cout << (side == 0 ? "a" : "b") << " seconds_per_move:"
+          << seconds_per_move << " cpu_seconds_per_move:"
+          << seconds_per_move * config.player_configs[side].thread_count
+          << endl;
+    }
+  }
+};
+
+void AddPlayerOptions(const string &side, cxxopts::Options *options) {
+  options->add_options(side)
+    (side + "-playouts", "playouts per move",
+     cxxopts::value<int>()->default_value("1000"))
+    (side + "-threads", "search threads",
+     cxxopts::value<int>()->default_value("1"))
+    (side + "-root-parallel", "search a tree per thread")
+    (side + "-tt-memory", "transposition table memory in MiB",
+     cxxopts::value<std::size_t>()->default_value("16"))
+    (side + "-fold-symmetries", "share records of symmetric boards")
+    (side + "-leaf-playouts", "playouts run at once from each leaf",
+     cxxopts::value<int>()->default_value("1"))
+    (side + "-batch-playout", "run the playouts of each leaf in lockstep")
+    (side + "-pattern-playout", "draw playout moves by 3x3 pattern weights")
+    (side + "-rave", "RAVE equivalence, or 0",
+     cxxopts::value<float>()->default_value("0"));
+}
+
+MatchPlayerConfig ParsePlayerConfig(const string &side,
+                                    const cxxopts::ParseResult &args) {
+  MatchPlayerConfig config;
+  config.mc_game_count = args[side + "-playouts"].as<int>();
+  config.thread_count = args[side + "-threads"].as<int>();
+  if (args.count(side + "-root-parallel") > 0) {
+    config.parallel_mode = ParallelMode::ROOT;
+  }
+  config.table_memory_bytes = args[side + "-tt-memory"].as<std::size_t>()
+      << 20;
+  config.folds_symmetries = args.count(side + "-fold-symmetries") > 0;
+  config.leaf_playout_count = args[side + "-leaf-playouts"].as<int>();
+  config.uses_batch_playout = args.count(side + "-batch-playout") > 0;
+  if (args.count(side + "-pattern-playout") > 0) {
+    config.playout_config.pattern_weights = &PatternWeights::Default();
+  }
+  config.rave_equivalence = args[side + "-rave"].as<float>();
+  return config;
+}
+
+}
+
+// Plays games between players of the a and b configs, alternating colours,
+// until the SPRT of a being elo1 rather than elo0 stronger than b decides,
+// and prints the Elo difference of a with its 95% interval, besides the
+// time per move of each side, so that a faster config is judged by its
+// strength at its cost.
+int main(int argc, char *argv[]) {
+  cxxopts::Options options("match", "Plays two player configs by SPRT.");
+  options.add_options()
+    ("board-len", "board length of 9, 13, 17 or 19",
+     cxxopts::value<int>()->default_value("9"))
+    ("games", "most games to play",
+     cxxopts::value<int>()->default_value("1000"))
+    ("concurrent-games", "games played at once",
+     cxxopts::value<int>()->default_value("4"))
+    ("seed", "seed of the games",
+     cxxopts::value<uint32_t>()->default_value("1"))
+    ("elo0", "Elo difference of the null hypothesis",
+     cxxopts::value<double>()->default_value("0"))
+    ("elo1", "Elo difference of the alternative hypothesis",
+     cxxopts::value<double>()->default_value("10"))
+    ("alpha", "false positive rate",
+     cxxopts::value<double>()->default_value("0.05"))
+    ("beta", "false negative rate",
+     cxxopts::value<double>()->default_value("0.05"));
+  AddPlayerOptions("a", &options);
+  AddPlayerOptions("b", &options);
+  auto args = options.parse(argc, argv);
+
+  MatchConfig config;
+  config.player_configs[0] = ParsePlayerConfig("a", args);
+  config.player_configs[1] = ParsePlayerConfig("b", args);
+  config.sprt_config.elo0 = args["elo0"].as<double>();
+  config.sprt_config.elo1 = args["elo1"].as<double>();
+  config.sprt_config.alpha = args["alpha"].as<double>();
+  config.sprt_config.beta = args["beta"].as<double>();
+  config.max_game_count = args["games"].as<int>();
+  config.concurrent_game_count = args["concurrent-games"].as<int>();
+  config.seed = args["seed"].as<uint32_t>();
+
+  int board_len = args["board-len"].as<int>();
+  if (!DispatchBoardLen<PlayMatch>(board_len, config)) {
+    cerr << "unsupported board length: " << board_len << endl;
+    return 1;
+  }
+  return 0;
+}
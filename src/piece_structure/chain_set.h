@@ -1,38 +1,93 @@
 #ifndef FOOLGO_SRC_PIECE_STRUCTURE_CHAIN_SET_H_
 #define FOOLGO_SRC_PIECE_STRUCTURE_CHAIN_SET_H_
 
+#include <algorithm>
 #include <boost/format.hpp>
-#include <bitset>
 #include <cassert>
+#include <cstdint>
 #include <cstring>
 #include <iostream>
 #include <type_traits>
 #include <vector>
 
+#include "../board/bit_board.h"
+#include "../board/force.h"
 #include "../board/pos_cal.h"
 #include "../board/position.h"
 #include "../def.h"
+#include "../util/fixed_vector.h"
 
 namespace foolgo {
 namespace piece_structure {
 
-typedef char AirCount;
-
+typedef int16_t AirCount;
+
+/**
+ * Chains of both forces. Each piece links to the next piece of its chain and
+ * to the head of the chain, and only the record at the head of a chain holds
+ * its length, force and pseudo airs. A pseudo air is a pair of a piece and an
+ * adjacent empty point, so that an air shared by several pieces is counted
+ * by each of them, and each is added or removed in O(1) without looking at
+ * the other pieces. Besides their count, the sum and the sum of squares of
+ * the indexes of pseudo airs tell whether they are all one point, which is
+ * the atari test. Exact air counts are counted only when asked for.
+ */
 template<BoardLen BOARD_LEN>
 class ChainSet {
+ private:
+  struct Node;
+  struct List;
+
  public:
+  // The node and list at an index before they are modified.
+  struct Change;
+  typedef util::FixedVector<PositionIndex, BoardLenSquare<BOARD_LEN>()>
+      PieceVector;
+
   ChainSet() = default;
   ~ChainSet() = default;
   void Copy(const ChainSet &c);
 
-  BitSet<BOARD_LEN> GetAirSetByPiece(PositionIndex piece_i) const;
-  AirCount GetAirCount(PositionIndex piece_i) const;
-  std::vector<PositionIndex> GetPieces(
-      PositionIndex piece_i) const;
-
-  void SetAir(PositionIndex indx, PositionIndex air_i, bool v);
-  void AddPiece(PositionIndex indx,
-                const BitSet<BOARD_LEN> &air_set);
+  // While a journal is set, every modified node and list is saved to it
+  // beforehand, so that modifications can be reverted in reverse order.
+  void SetJournal(std::vector<Change> *journal) {
+    journal_ = journal;
+  }
+  void Revert(const Change &change);
+
+  // The exact air count, which is counted from the pieces unless the chain
+  // has at most one air or two pseudo airs. It is capped by the max, at
+  // which counting stops, so that a small max walks few pieces.
+  AirCount GetAirCount(PositionIndex piece_i,
+                       AirCount max_air_count = BoardLenSquare<BOARD_LEN>())
+      const;
+  bool HasAir(PositionIndex piece_i) const {
+    return lists_[GetListHead(piece_i)].pseudo_air_count_ > 0;
+  }
+  bool IsInAtari(PositionIndex piece_i) const;
+  // The only air of a chain in atari.
+  PositionIndex GetLastAir(PositionIndex piece_i) const;
+  PieceVector GetPieces(PositionIndex piece_i) const;
+  PositionIndex GetPieceCount(PositionIndex piece_i) const;
+  bool IsInSameChain(PositionIndex piece_a, PositionIndex piece_b) const {
+    return GetListHead(piece_a) == GetListHead(piece_b);
+  }
+  // A piece of the chain, the same for all its pieces, which identifies it
+  // until the chain changes.
+  PositionIndex GetChainHead(PositionIndex piece_i) const {
+    return GetListHead(piece_i);
+  }
+  // Calls visit on each piece of the chain, without building a vector.
+  template<typename Visit>
+  void ForEachPiece(PositionIndex piece_i, const Visit &visit) const;
+
+  // Adds or removes the pseudo air of the piece at the adjacent point air,
+  // which has just been emptied or taken.
+  void AddPseudoAir(PositionIndex piece_i, PositionIndex air);
+  void RemovePseudoAir(PositionIndex piece_i, PositionIndex air);
+  // Adds a piece and merges it with adjacent chains of the same force. The
+  // piece gets a pseudo air for each adjacent point without a piece.
+  void AddPiece(PositionIndex indx, Force force);
   void RemoveListByPiece(PositionIndex piece_i);
 
  private:
@@ -45,12 +100,18 @@ class ChainSet {
     }
   } nodes_[BoardLenSquare<BOARD_LEN>()];
 
+  // An index squared times the most pseudo airs of a chain fits in int32_t.
   struct List {
     PositionIndex tail_, len_;
-    BitSet<BOARD_LEN> air_set_;
-    AirCount air_count_;
+    AirCount pseudo_air_count_;
+    int8_t force_;
+    int32_t air_index_sum_, air_index_square_sum_;
   } lists_[BoardLenSquare<BOARD_LEN>()];
 
+  std::vector<Change> *journal_ = nullptr;
+
+  void Save(PositionIndex index);
+
   inline PstionAndIndxCcltr<BOARD_LEN> &GetPosClcltr() const {
     return PstionAndIndxCcltr<BOARD_LEN>::Ins();
   }
@@ -58,88 +119,143 @@ class ChainSet {
   inline PositionIndex GetListHead(PositionIndex node_i) const {
     return nodes_[node_i].list_head_;
   }
-  void CreateList(PositionIndex node_i,
-                  const BitSet<BOARD_LEN> &air_set);
+  void CreateList(PositionIndex node_i, Force force);
 
   PositionIndex MergeLists(PositionIndex head_a,
                                PositionIndex head_b);
 
   void RemoveList(PositionIndex head);
 
-  BitSet<BOARD_LEN> GetAirSetOfChain(PositionIndex head) const;
-  AirCount GetAirCountOfChain(PositionIndex list_i) const;
-  std::vector<PositionIndex> GetPiecesOfChain(
-      PositionIndex list_i) const;
+  void ModifyPseudoAir(PositionIndex piece_i, PositionIndex air,
+                       AirCount delta);
+  AirCount CountAirOfChain(PositionIndex head, AirCount max_air_count) const;
+  bool IsChainInAtari(PositionIndex list_i) const;
+  PieceVector GetPiecesOfChain(PositionIndex list_i) const;
+
+  template<BoardLen LEN>
+  friend std::ostream &operator <<(std::ostream &os,
+                                   const ChainSet<LEN> &chain_set);
+};
+
+template<BoardLen BOARD_LEN>
+struct ChainSet<BOARD_LEN>::Change {
+  PositionIndex index;
+  Node node;
+  List list;
 };
 
 #define IS_POINT_NOT_EMPTY(piece_i) \
     (GetListHead(piece_i) != ChainSet<BOARD_LEN>::NONE_LIST)
 
+template<BoardLen BOARD_LEN>
+inline void ChainSet<BOARD_LEN>::Save(PositionIndex index) {
+  if (journal_ != nullptr) {
+    Change change = {index, nodes_[index], lists_[index]};
+    journal_->push_back(change);
+  }
+}
+
+template<BoardLen BOARD_LEN>
+inline void ChainSet<BOARD_LEN>::Revert(const Change &change) {
+  nodes_[change.index] = change.node;
+  lists_[change.index] = change.list;
+}
+
 template<BoardLen BOARD_LEN>
 void ChainSet<BOARD_LEN>::Copy(const ChainSet<BOARD_LEN> &c) {
-  for (int i = 0; i < BoardLenSquare<BOARD_LEN>(); ++i) {
-    lists_[i] = c.lists_[i];
-    nodes_[i] = c.nodes_[i];
+  memcpy(nodes_, c.nodes_, sizeof(nodes_));
+  memcpy(lists_, c.lists_, sizeof(lists_));
+}
+
+template<BoardLen BOARD_LEN>
+inline AirCount ChainSet<BOARD_LEN>::GetAirCount(
+    PositionIndex piece_i, AirCount max_air_count) const {
+  assert(IS_POINT_NOT_EMPTY(piece_i));
+  assert(max_air_count > 0);
+  PositionIndex head = GetListHead(piece_i);
+  AirCount pseudo_air_count = lists_[head].pseudo_air_count_;
+  if (pseudo_air_count == 0 || IsChainInAtari(head)) {
+    return std::min<AirCount>(pseudo_air_count, 1);
   }
+  // A chain not in atari has two airs at least.
+  if (pseudo_air_count == 2 || max_air_count <= 2) {
+    return std::min<AirCount>(max_air_count, 2);
+  }
+  return CountAirOfChain(head, max_air_count);
 }
 
 template<BoardLen BOARD_LEN>
-BitSet<BOARD_LEN> ChainSet<BOARD_LEN>::GetAirSetByPiece(
+inline bool ChainSet<BOARD_LEN>::IsInAtari(PositionIndex piece_i) const {
+  assert(IS_POINT_NOT_EMPTY(piece_i));
+  return IsChainInAtari(GetListHead(piece_i));
+}
+
+template<BoardLen BOARD_LEN>
+inline PositionIndex ChainSet<BOARD_LEN>::GetLastAir(
     PositionIndex piece_i) const {
-  return GetAirSetOfChain(nodes_[piece_i].list_head_);
+  assert(IsInAtari(piece_i));
+  const List &list = lists_[GetListHead(piece_i)];
+  return list.air_index_sum_ / list.pseudo_air_count_;
 }
 
 template<BoardLen BOARD_LEN>
-inline AirCount ChainSet<BOARD_LEN>::GetAirCount(
+typename ChainSet<BOARD_LEN>::PieceVector ChainSet<BOARD_LEN>::GetPieces(
     PositionIndex piece_i) const {
   assert(IS_POINT_NOT_EMPTY(piece_i));
-  return GetAirCountOfChain(GetListHead(piece_i));
+  return GetPiecesOfChain(GetListHead(piece_i));
 }
 
 template<BoardLen BOARD_LEN>
-std::vector<PositionIndex> ChainSet<BOARD_LEN>::GetPieces(
+inline PositionIndex ChainSet<BOARD_LEN>::GetPieceCount(
     PositionIndex piece_i) const {
   assert(IS_POINT_NOT_EMPTY(piece_i));
-  return GetPiecesOfChain(GetListHead(piece_i));
+  return lists_[GetListHead(piece_i)].len_;
 }
 
 template<BoardLen BOARD_LEN>
-void ChainSet<BOARD_LEN>::SetAir(PositionIndex indx,
-                                 PositionIndex air_i, bool v) {
-  BitSet<BOARD_LEN> air_set;
-  if (!v)
-    air_set.set();
-  air_set[air_i] = v;
-  PositionIndex head = GetListHead(indx);
-  assert(head != ChainSet<BOARD_LEN>::NONE_LIST);
-  List *pl = lists_ + head;
-  const BitSet<BOARD_LEN> &r_as = pl->air_set_;
-  pl->air_set_ = v ? (r_as | air_set) : (r_as & air_set);
-  pl->air_count_ = pl->air_set_.count();
+template<typename Visit>
+void ChainSet<BOARD_LEN>::ForEachPiece(PositionIndex piece_i,
+                                       const Visit &visit) const {
+  assert(IS_POINT_NOT_EMPTY(piece_i));
+  PositionIndex head = GetListHead(piece_i);
+
+  for (PositionIndex i = head;; i = nodes_[i].next_) {
+    visit(i);
+    if (i == lists_[head].tail_) {
+      break;
+    }
+  }
+}
+
+template<BoardLen BOARD_LEN>
+inline void ChainSet<BOARD_LEN>::AddPseudoAir(PositionIndex piece_i,
+                                              PositionIndex air) {
+  ModifyPseudoAir(piece_i, air, 1);
+}
+
+template<BoardLen BOARD_LEN>
+inline void ChainSet<BOARD_LEN>::RemovePseudoAir(PositionIndex piece_i,
+                                                 PositionIndex air) {
+  ModifyPseudoAir(piece_i, air, -1);
 }
 
 template<BoardLen BOARD_LEN>
-void ChainSet<BOARD_LEN>::AddPiece(PositionIndex indx,
-                                   const BitSet<BOARD_LEN> &air_set) {
+void ChainSet<BOARD_LEN>::AddPiece(PositionIndex indx, Force force) {
   const PstionAndIndxCcltr<BOARD_LEN> &ins = GetPosClcltr();
-  CreateList(indx, air_set);
+  CreateList(indx, force);
   PositionIndex list_i = indx;
-  const Position &pos = ins.GetPosition(indx);
-
-  for (int i = 0; i < 4; ++i) {
-    Position adj_pos = AdjacentPosition(pos, i);
-    if (ins.IsInBoard(adj_pos)) {
-      PositionIndex adj_i = ins.GetIndex(adj_pos);
-      PositionIndex adj_list = GetListHead(adj_i);
-      if (adj_list == ChainSet<BOARD_LEN>::NONE_LIST) {
-        continue;
-      }
-      if (adj_list == list_i) {
-        continue;
-      }
 
-      list_i = MergeLists(list_i, adj_list);
+  for (PositionIndex adj_i : ins.AdjacentIndexes(indx)) {
+    PositionIndex adj_list = GetListHead(adj_i);
+    if (adj_list == ChainSet<BOARD_LEN>::NONE_LIST) {
+      ModifyPseudoAir(indx, adj_i, 1);
+      continue;
     }
+    if (adj_list == list_i || lists_[adj_list].force_ != force) {
+      continue;
+    }
+
+    list_i = MergeLists(list_i, adj_list);
   }
 }
 
@@ -151,14 +267,16 @@ void ChainSet<BOARD_LEN>::RemoveListByPiece(PositionIndex piece_i) {
 }
 
 template<BoardLen BOARD_LEN>
-void ChainSet<BOARD_LEN>::CreateList(
-    PositionIndex node_i, const BitSet<BOARD_LEN> &air_set) {
+void ChainSet<BOARD_LEN>::CreateList(PositionIndex node_i, Force force) {
+  Save(node_i);
   nodes_[node_i].list_head_ = node_i;
   List *list = lists_ + node_i;
   list->tail_ = node_i;
   list->len_ = 1;
-  list->air_set_ = air_set;
-  list->air_count_ = air_set.count();
+  list->pseudo_air_count_ = 0;
+  list->force_ = force;
+  list->air_index_sum_ = 0;
+  list->air_index_square_sum_ = 0;
 }
 
 template<BoardLen BOARD_LEN>
@@ -169,6 +287,7 @@ PositionIndex ChainSet<BOARD_LEN>::MergeLists(PositionIndex head_a,
     std::swap(head_a, head_b);
 
   for (int i = head_a;; i = nodes_[i].next_) {
+    Save(i);
     nodes_[i].list_head_ = head_b;
     if (i == lists_[head_a].tail_) {
       break;
@@ -177,17 +296,22 @@ PositionIndex ChainSet<BOARD_LEN>::MergeLists(PositionIndex head_a,
   }
 
   List *list_b = lists_ + head_b;
+  Save(list_b->tail_);
   nodes_[list_b->tail_].next_ = head_a;
-  list_b->tail_ = lists_[head_a].tail_;
-  list_b->len_ += lists_[head_a].len_;
-  list_b->air_set_ |= lists_[head_a].air_set_;
-  list_b->air_count_ = list_b->air_set_.count();
+  Save(head_b);
+  const List &list_a = lists_[head_a];
+  list_b->tail_ = list_a.tail_;
+  list_b->len_ += list_a.len_;
+  list_b->pseudo_air_count_ += list_a.pseudo_air_count_;
+  list_b->air_index_sum_ += list_a.air_index_sum_;
+  list_b->air_index_square_sum_ += list_a.air_index_square_sum_;
   return head_b;
 }
 
 template<BoardLen BOARD_LEN>
 void ChainSet<BOARD_LEN>::RemoveList(PositionIndex head) {
   for (int i = head;; i = nodes_[i].next_) {
+    Save(i);
     nodes_[i].list_head_ = ChainSet<BOARD_LEN>::NONE_LIST;
     if (i == lists_[head].tail_)
       break;
@@ -195,32 +319,69 @@ void ChainSet<BOARD_LEN>::RemoveList(PositionIndex head) {
 }
 
 template<BoardLen BOARD_LEN>
-BitSet<BOARD_LEN> ChainSet<BOARD_LEN>::GetAirSetOfChain(
-    PositionIndex head) const {
-  return lists_[head].air_set_;
+inline void ChainSet<BOARD_LEN>::ModifyPseudoAir(PositionIndex piece_i,
+                                                 PositionIndex air,
+                                                 AirCount delta) {
+  PositionIndex head = GetListHead(piece_i);
+  assert(head != ChainSet<BOARD_LEN>::NONE_LIST);
+  Save(head);
+  List &list = lists_[head];
+  list.pseudo_air_count_ += delta;
+  list.air_index_sum_ += delta * air;
+  list.air_index_square_sum_ += delta * air * air;
+  assert(list.pseudo_air_count_ >= 0);
+}
+
+template<BoardLen BOARD_LEN>
+AirCount ChainSet<BOARD_LEN>::CountAirOfChain(PositionIndex head,
+                                              AirCount max_air_count) const {
+  const PstionAndIndxCcltr<BOARD_LEN> &ins = GetPosClcltr();
+  BitSet<BOARD_LEN> airs;
+  AirCount air_count = 0;
+
+  for (PositionIndex i = head;; i = nodes_[i].next_) {
+    for (PositionIndex adj_i : ins.AdjacentIndexes(i)) {
+      if (GetListHead(adj_i) == ChainSet<BOARD_LEN>::NONE_LIST
+          && !airs[adj_i]) {
+        airs.set(adj_i);
+        if (++air_count == max_air_count) {
+          return air_count;
+        }
+      }
+    }
+    if (i == lists_[head].tail_) {
+      break;
+    }
+  }
+
+  return air_count;
 }
 
+// The pseudo airs are all one point if and only if the square of their sum
+// is their count times the sum of their squares.
 template<BoardLen BOARD_LEN>
-inline AirCount ChainSet<BOARD_LEN>::GetAirCountOfChain(
-    PositionIndex list_i) const {
-  return lists_[list_i].air_count_;
+inline bool ChainSet<BOARD_LEN>::IsChainInAtari(PositionIndex list_i) const {
+  const List &list = lists_[list_i];
+  int64_t sum = list.air_index_sum_;
+  return list.pseudo_air_count_ > 0
+      && sum * sum == int64_t(list.pseudo_air_count_)
+          * list.air_index_square_sum_;
 }
 
 template<BoardLen BOARD_LEN>
-std::vector<PositionIndex> ChainSet<BOARD_LEN>::GetPiecesOfChain(
-    PositionIndex list_i) const {
+typename ChainSet<BOARD_LEN>::PieceVector
+ChainSet<BOARD_LEN>::GetPiecesOfChain(PositionIndex list_i) const {
   auto pl = lists_ + list_i;
-  std::vector<PositionIndex> v(pl->len_);
-  int vi = 0;
+  PieceVector v;
 
   for (int i = list_i;; i = nodes_[i].next_) {
-    v[vi++] = i;
+    v.push_back(i);
     if (i == pl->tail_) {
       break;
     }
   }
 
-  return move(v);
+  return v;
 }
 
 template<BoardLen BOARD_LEN>
@@ -234,7 +395,7 @@ std::ostream &operator <<(std::ostream &os,
     for (int x = 0; x < BOARD_LEN; ++x) {
       int index = ins.GetIndex(Position(x, y));
       int n = chain_set.nodes_[index].next_;
-      const Position &np = ins.GetPos(n);
+      const Position &np = ins.GetPosition(n);
       int nx = np.x;
       int ny = np.y;
       os << boost::format("{n=%1%,%2% ") % nx % ny;
@@ -243,7 +404,7 @@ std::ostream &operator <<(std::ostream &os,
         os << "h=x,x} ";
       } else {
         lists_exist[h] = true;
-        const Position &hp = ins.GetPos(h);
+        const Position &hp = ins.GetPosition(h);
         int hx = hp.x;
         int hy = hp.y;
         os << boost::format("h=%1%,%2%}") % hx % hy;
@@ -255,13 +416,14 @@ std::ostream &operator <<(std::ostream &os,
 
   for (int i = 0; i < BoardLenSquare<BOARD_LEN>(); ++i) {
     if (lists_exist[i]) {
-      const Position &pos = ins.GetPos(i);
-      const Position &tp = ins.GetPos(chain_set.lists_[i].tail_);
+      const Position &pos = ins.GetPosition(i);
+      const Position &tp = ins.GetPosition(chain_set.lists_[i].tail_);
       os
           << boost::format(
-              "(%1%, %2%): tail_ = (%3%, %4%), len_ = %5%, air_count - %6%\n")
-              % pos.x % pos.y % tp.x % tp.y % chain_set.lists_[i].len_
-              % chain_set.lists_[i].air_set_.count();
+              "(%1%, %2%): tail_ = (%3%, %4%), len_ = %5%, pseudo_air_count - %6%\n")
+              % static_cast<int>(pos.x) % static_cast<int>(pos.y)
+              % static_cast<int>(tp.x) % static_cast<int>(tp.y)
+              % chain_set.lists_[i].len_ % chain_set.lists_[i].pseudo_air_count_;
     }
   }
 
@@ -1,10 +1,10 @@
 #ifndef FOOLGO_SRC_PIECE_STRUCTRUE_EYE_SET_H_
 #define FOOLGO_SRC_PIECE_STRUCTRUE_EYE_SET_H_
 
-#include <bitset>
-
+#include "../board/bit_board.h"
 #include "../board/position.h"
 #include "../def.h"
+#include "../util/fixed_vector.h"
 
 namespace foolgo {
 namespace piece_structure {
@@ -17,10 +17,10 @@ class EyeSet {
   void Copy(const EyeSet &es);
 
   void SetEye(PositionIndex indx, bool v) {
-    eyes_[indx] = v;
+    eyes_.set(indx, v);
   }
   void SetRealEye(PositionIndex indx, bool v) {
-    real_eyes_[indx] = v;
+    real_eyes_.set(indx, v);
   }
   bool IsEye(PositionIndex indx) const {
     return eyes_[indx];
@@ -32,9 +32,16 @@ class EyeSet {
     return real_eyes_.count();
   }
 
-  std::vector<PositionIndex> GetRealEyes() const {
-    return util::GetOnePositionIndexes<BoardLenSquare<BOARD_LEN>()>(
-        real_eyes_);
+  util::FixedVector<PositionIndex, BoardLenSquare<BOARD_LEN>()>
+  GetRealEyes() const {
+    util::FixedVector<PositionIndex, BoardLenSquare<BOARD_LEN>()> real_eyes;
+    for (PositionIndex index : real_eyes_) {
+      real_eyes.push_back(index);
+    }
+    return real_eyes;
+  }
+  const BitSet<BOARD_LEN> &RealEyeBitSet() const {
+    return real_eyes_;
   }
 
  private:
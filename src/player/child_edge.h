@@ -0,0 +1,131 @@
+#ifndef FOOLGO_SRC_PLAYER_CHILD_EDGE_H_
+#define FOOLGO_SRC_PLAYER_CHILD_EDGE_H_
+
+#include <atomic>
+#include <cstdint>
+
+#include "../board/position.h"
+#include "../def.h"
+
+namespace foolgo {
+
+/**
+ * An edge from a node to one of its children, which holds the move, the hash
+ * key of the child and the statistics of searches passing through the edge,
+ * besides the all moves as first (AMAF) statistics of playouts below the node
+ * in which the move is played first by the force of the node.
+ * Edges of a node are stored contiguously, so choosing a child scans a few
+ * cache lines without looking any child up in the transposition table.
+ */
+class ChildEdge {
+ public:
+  ChildEdge() : ChildEdge(0, 0) {}
+  ChildEdge(PositionIndex position_index, HashKey hash_key, float prior = 0.0f)
+      : hash_key_(hash_key),
+        profit_sum_(0.0f),
+        visited_time_(0),
+        rave_profit_sum_(0.0f),
+        rave_visited_time_(0),
+        prior_(prior),
+        virtual_loss_count_(0),
+        position_index_(position_index) {}
+  ChildEdge(const ChildEdge &child_edge) {
+    *this = child_edge;
+  }
+  ChildEdge &operator =(const ChildEdge &child_edge) {
+    hash_key_ = child_edge.hash_key_;
+    profit_sum_.store(child_edge.profit_sum_.load(std::memory_order_relaxed),
+                      std::memory_order_relaxed);
+    visited_time_.store(child_edge.GetVisitedTime(), std::memory_order_relaxed);
+    rave_profit_sum_.store(
+        child_edge.rave_profit_sum_.load(std::memory_order_relaxed),
+        std::memory_order_relaxed);
+    rave_visited_time_.store(child_edge.GetRaveVisitedTime(),
+                             std::memory_order_relaxed);
+    prior_ = child_edge.prior_;
+    virtual_loss_count_.store(
+        child_edge.virtual_loss_count_.load(std::memory_order_relaxed),
+        std::memory_order_relaxed);
+    position_index_ = child_edge.position_index_;
+    return *this;
+  }
+
+  PositionIndex GetPositionIndex() const {
+    return position_index_;
+  }
+  HashKey GetHashKey() const {
+    return hash_key_;
+  }
+  // The prior of the move in [0, 1], by which edges of a node are ordered.
+  float GetPrior() const {
+    return prior_;
+  }
+
+  int32_t GetVisitedTime() const {
+    return visited_time_.load(std::memory_order_relaxed);
+  }
+  float GetAverageProfit() const {
+    int32_t visited_time = GetVisitedTime();
+    return visited_time == 0 ? 0.0f :
+        profit_sum_.load(std::memory_order_relaxed) / visited_time;
+  }
+
+  int32_t GetRaveVisitedTime() const {
+    return rave_visited_time_.load(std::memory_order_relaxed);
+  }
+  float GetRaveAverageProfit() const {
+    int32_t visited_time = GetRaveVisitedTime();
+    return visited_time == 0 ? 0.0f :
+        rave_profit_sum_.load(std::memory_order_relaxed) / visited_time;
+  }
+
+  // Visited time and average profit, with virtual losses counted in.
+  int32_t GetVisitedTimeWithVirtualLoss() const {
+    return GetVisitedTime()
+        + virtual_loss_count_.load(std::memory_order_relaxed);
+  }
+  float GetAverageProfitWithVirtualLoss() const {
+    int32_t visited_time = GetVisitedTimeWithVirtualLoss();
+    return visited_time == 0 ? 0.0f :
+        profit_sum_.load(std::memory_order_relaxed) / visited_time;
+  }
+
+  void AddVirtualLoss() {
+    virtual_loss_count_.fetch_add(1, std::memory_order_relaxed);
+  }
+  void RevertVirtualLoss() {
+    virtual_loss_count_.fetch_sub(1, std::memory_order_relaxed);
+  }
+  // Adds visits of the average profit.
+  void AddProfit(float profit, int32_t visited_time = 1) {
+    float profit_sum = profit_sum_.load(std::memory_order_relaxed);
+    float added_profit = profit * visited_time;
+    while (!profit_sum_.compare_exchange_weak(profit_sum,
+                                              profit_sum + added_profit,
+                                              std::memory_order_relaxed)) {
+    }
+    visited_time_.fetch_add(visited_time, std::memory_order_relaxed);
+  }
+  void AddRaveProfit(float profit_sum, int32_t visited_time) {
+    float old_profit_sum = rave_profit_sum_.load(std::memory_order_relaxed);
+    while (!rave_profit_sum_.compare_exchange_weak(
+        old_profit_sum, old_profit_sum + profit_sum,
+        std::memory_order_relaxed)) {
+    }
+    rave_visited_time_.fetch_add(visited_time, std::memory_order_relaxed);
+  }
+
+ private:
+  HashKey hash_key_;
+  std::atomic<float> profit_sum_;
+  std::atomic<int32_t> visited_time_;
+  std::atomic<float> rave_profit_sum_;
+  std::atomic<int32_t> rave_visited_time_;
+  float prior_;
+  std::atomic<int16_t> virtual_loss_count_;
+  PositionIndex position_index_;
+};
+
+}
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef FOOLGO_SRC_PLAYER_EDGE_ARENA_H_
+#define FOOLGO_SRC_PLAYER_EDGE_ARENA_H_
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+
+#include "../def.h"
+#include "../util/memory_util.h"
+#include "child_edge.h"
+
+namespace foolgo {
+
+/**
+ * A contiguous preallocated array of child edges, from which edges of each
+ * expanded node are allocated at once by bumping a cursor. Edges are never
+ * freed one by one, but compacted in bulk by the owner between searches.
+ */
+class EdgeArena {
+ public:
+  explicit EdgeArena(std::size_t capacity,
+                     int numa_node = util::ANY_NUMA_NODE)
+      : capacity_(capacity), size_(0) {
+    void *memory = util::AllocateAligned(sizeof(ChildEdge) * capacity_,
+                                         util::CACHE_LINE_SIZE, numa_node);
+    if (memory == nullptr) {
+      throw std::bad_alloc();
+    }
+    edges_ = static_cast<ChildEdge *>(memory);
+    for (std::size_t i = 0; i < capacity_; ++i) {
+      new (edges_ + i) ChildEdge;
+    }
+  }
+
+  ~EdgeArena() {
+    for (std::size_t i = 0; i < capacity_; ++i) {
+      edges_[i].~ChildEdge();
+    }
+    util::FreeAligned(edges_);
+  }
+
+  DISALLOW_COPY_AND_ASSIGN_AND_MOVE(EdgeArena)
+
+  // Returns nullptr if the arena is exhausted.
+  ChildEdge *Allocate(std::size_t count) {
+    std::size_t begin = size_.fetch_add(count, std::memory_order_relaxed);
+    if (begin + count > capacity_) {
+      return nullptr;
+    }
+    return edges_ + begin;
+  }
+
+  ChildEdge *Data() const {
+    return edges_;
+  }
+  std::size_t Size() const {
+    std::size_t size = size_.load(std::memory_order_relaxed);
+    return size < capacity_ ? size : capacity_;
+  }
+  void Resize(std::size_t size) {
+    size_.store(size, std::memory_order_relaxed);
+  }
+  std::size_t Capacity() const {
+    return capacity_;
+  }
+
+ private:
+  ChildEdge *edges_;
+  std::size_t capacity_;
+  std::atomic<std::size_t> size_;
+};
+
+}
+
+#endif
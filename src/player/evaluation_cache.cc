@@ -0,0 +1,34 @@
+#include "evaluation_cache.h"
+
+#include <cassert>
+
+namespace foolgo {
+
+EvaluationCache::EvaluationCache(std::size_t capacity)
+    : entries_(capacity), hit_count_(0), miss_count_(0) {
+  assert(capacity > 0);
+}
+
+bool EvaluationCache::Get(HashKey hash_key, Evaluation *evaluation) const {
+  std::size_t index = hash_key % entries_.size();
+  std::lock_guard<std::mutex> lock(mutexes_[index % LOCK_COUNT]);
+  const Entry &entry = entries_[index];
+  if (!entry.is_occupied || entry.hash_key != hash_key) {
+    miss_count_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  *evaluation = entry.evaluation;
+  hit_count_.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+void EvaluationCache::Put(HashKey hash_key, const Evaluation &evaluation) {
+  std::size_t index = hash_key % entries_.size();
+  std::lock_guard<std::mutex> lock(mutexes_[index % LOCK_COUNT]);
+  Entry &entry = entries_[index];
+  entry.is_occupied = true;
+  entry.hash_key = hash_key;
+  entry.evaluation = evaluation;
+}
+
+}
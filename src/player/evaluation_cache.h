@@ -0,0 +1,61 @@
+#ifndef FOOLGO_SRC_PLAYER_EVALUATION_CACHE_H_
+#define FOOLGO_SRC_PLAYER_EVALUATION_CACHE_H_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "../def.h"
+#include "../deep_learning/evaluation_queue.h"
+
+namespace foolgo {
+
+/**
+ * Evaluations of the network keyed by hash keys of boards, so that a board
+ * reached again, by a transposition or by the search of a later move, is not
+ * evaluated twice. Each key has one slot, taken by the latest evaluation put,
+ * and slots are guarded by a few striped locks, which are held for the copy
+ * of an evaluation only.
+ */
+class EvaluationCache {
+ public:
+  explicit EvaluationCache(std::size_t capacity);
+  DISALLOW_COPY_AND_ASSIGN_AND_MOVE(EvaluationCache)
+
+  // Returns false if the key is not cached.
+  bool Get(HashKey hash_key, Evaluation *evaluation) const;
+  void Put(HashKey hash_key, const Evaluation &evaluation);
+
+  std::size_t Capacity() const {
+    return entries_.size();
+  }
+  int64_t HitCount() const {
+    return hit_count_.load(std::memory_order_relaxed);
+  }
+  int64_t MissCount() const {
+    return miss_count_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  struct Entry {
+    bool is_occupied = false;
+    HashKey hash_key = 0;
+    Evaluation evaluation;
+  };
+
+  static const int LOCK_COUNT = 64;
+
+  std::vector<Entry> entries_;
+  // The entry of an index is guarded by the lock of the index modulo the
+  // count.
+  mutable std::array<std::mutex, LOCK_COUNT> mutexes_;
+  mutable std::atomic<int64_t> hit_count_;
+  mutable std::atomic<int64_t> miss_count_;
+};
+
+}
+
+#endif
@@ -14,16 +14,10 @@ namespace {
 template<BoardLen BOARD_LEN>
 bool IsPostionIndexLegalMove(const Position &position,
                              const FullBoard<BOARD_LEN> &full_board) {
-  auto index_vector = full_board.PlayableIndexes(NextForce(full_board));
-  PositionIndex index = PstionAndIndxCcltr<BOARD_LEN>::Ins()
-      .GetIndex(position);
-  for (PositionIndex indx : index_vector) {
-    if (indx == index) {
-      return true;
-    }
-  }
-
-  return false;
+  auto &calculator = PstionAndIndxCcltr<BOARD_LEN>::Ins();
+  return calculator.IsInBoard(position)
+      && full_board.PlayableIndexBitSet(NextForce(full_board))[
+          calculator.GetIndex(position)];
 }
 }
 
@@ -0,0 +1,56 @@
+#ifndef FOOLGO_SRC_PLAYER_MOVE_PRIOR_H_
+#define FOOLGO_SRC_PLAYER_MOVE_PRIOR_H_
+
+#include <algorithm>
+
+#include "../board/force.h"
+#include "../board/full_board.h"
+#include "../board/pos_cal.h"
+#include "../board/position.h"
+#include "../def.h"
+
+namespace foolgo {
+
+// Returns a cheap heuristic prior of the move in [0, 1], which ranks
+// captures and escapes from atari first, then ataris and moves in contact
+// with pieces, and moves on the first line last. It looks at adjacent points
+// only, without playing the move.
+template<BoardLen BOARD_LEN>
+float MovePrior(const FullBoard<BOARD_LEN> &full_board, const Move &move) {
+  const auto &calculator = PstionAndIndxCcltr<BOARD_LEN>::Ins();
+  float score = 0.0f;
+  bool is_in_contact = false;
+
+  for (PositionIndex adj_i : calculator.AdjacentIndexes(move.position_index)) {
+    PointState point = full_board.GetPointState(adj_i);
+    if (point == EMPTY_POINT) {
+      continue;
+    }
+    is_in_contact = true;
+    if (full_board.IsChainInAtari(adj_i)) {
+      score = std::max(score,
+                       point == ForceToPointState(move.force) ? 0.8f : 1.0f);
+    } else if (point != ForceToPointState(move.force) && score < 0.6f
+        && full_board.ChainAirCount(adj_i, 3) == 2) {
+      // Airs are counted up to 3, and only while nothing scores more.
+      score = 0.6f;
+    }
+  }
+
+  if (is_in_contact) {
+    score = std::max(score, 0.4f);
+  }
+
+  const Position &position = calculator.GetPosition(move.position_index);
+  int line = std::min(std::min<int>(position.x, position.y),
+                      std::min<int>(BOARD_LEN - 1 - position.x,
+                                    BOARD_LEN - 1 - position.y));
+  if (score == 0.0f) {
+    score = line == 0 ? 0.0f : (line == 1 ? 0.1f : 0.2f);
+  }
+  return score;
+}
+
+}
+
+#endif
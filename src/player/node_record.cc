@@ -1,45 +1,98 @@
 #include "node_record.h"
 
 #include <boost/format.hpp>
-#include <utility>
+#include <thread>
 
 namespace foolgo {
 
-using std::make_pair;
-using std::lock_guard;
-using std::mutex;
+using std::memory_order_acq_rel;
+using std::memory_order_acquire;
+using std::memory_order_relaxed;
+using std::memory_order_release;
 using std::ostream;
 using boost::format;
 
-NodeRecord::NodeRecord() : NodeRecord(0, 0.0f, false) {}
+NodeRecord::NodeRecord() : NodeRecord(0, 0.0f) {}
 
-NodeRecord::NodeRecord(const NodeRecord &node_record)
-    : child_hash_keys_(node_record.child_hash_keys_) {
-  visited_time_ = node_record.visited_time_;
-  average_profit_ = node_record.average_profit_;
-  is_in_search_ = node_record.is_in_search_;
+NodeRecord::NodeRecord(int32_t visited_time, float average_profit)
+    : visited_time_(visited_time),
+      edge_count_(0),
+      profit_sum_(static_cast<double>(average_profit) * visited_time),
+      edges_(nullptr),
+      expansion_(UNEXPANDED) {}
+
+NodeRecord::NodeRecord(const NodeRecord &node_record) : NodeRecord() {
+  *this = node_record;
+}
+
+NodeRecord& NodeRecord::operator =(const NodeRecord &node_record) {
+  visited_time_.store(node_record.GetVisitedTime(), memory_order_relaxed);
+  profit_sum_.store(node_record.profit_sum_.load(memory_order_relaxed),
+                    memory_order_relaxed);
+  edges_ = node_record.edges_;
+  edge_count_ = node_record.edge_count_;
+  expansion_.store(node_record.expansion_.load(memory_order_acquire),
+                   memory_order_release);
+  return *this;
 }
 
-const HashKey* NodeRecord::GetChildHashKeyPtr(
-    PositionIndex position_index) const {
-  mutex_.lock();
-  auto it = child_hash_keys_.find(position_index);
-  mutex_.unlock();
-  return it == child_hash_keys_.end() ? nullptr : &(it->second);
+float NodeRecord::GetAverageProfit() const {
+  int32_t visited_time = GetVisitedTime();
+  return visited_time == 0 ? 0.0f :
+      profit_sum_.load(memory_order_relaxed) / visited_time;
 }
 
-void NodeRecord::InsertChildHashKey(PositionIndex position_index,
-                                    HashKey hash_key) {
-  lock_guard<mutex> lock(mutex_);
-  if (child_hash_keys_.find(position_index) == child_hash_keys_.end()) {
-    child_hash_keys_.insert(make_pair(position_index, hash_key));
+void NodeRecord::AddProfit(float profit, int32_t visited_time) {
+  double profit_sum = profit_sum_.load(memory_order_relaxed);
+  double added_profit = static_cast<double>(profit) * visited_time;
+  while (!profit_sum_.compare_exchange_weak(profit_sum,
+                                            profit_sum + added_profit,
+                                            memory_order_relaxed)) {
   }
+  visited_time_.fetch_add(visited_time, memory_order_relaxed);
+}
+
+bool NodeRecord::TryStartExpansion(uint32_t generation) {
+  uint64_t expansion = expansion_.load(memory_order_acquire);
+  uint64_t expanding = ExpansionState(generation, EXPANDING);
+
+  while (expansion != expanding
+      && expansion != ExpansionState(generation, EXPANDED)) {
+    if (expansion_.compare_exchange_weak(expansion, expanding,
+                                         memory_order_acq_rel)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void NodeRecord::FinishExpansion(uint32_t generation, ChildEdge *edges,
+                                 int16_t edge_count) {
+  edges_ = edges;
+  edge_count_ = edge_count;
+  expansion_.store(ExpansionState(generation, EXPANDED), memory_order_release);
+}
+
+void NodeRecord::AbortExpansion() {
+  expansion_.store(UNEXPANDED, memory_order_release);
+}
+
+bool NodeRecord::WaitForExpansion(uint32_t generation) const {
+  uint64_t expanding = ExpansionState(generation, EXPANDING);
+  uint64_t expansion;
+
+  while ((expansion = expansion_.load(memory_order_acquire)) == expanding) {
+    std::this_thread::yield();
+  }
+
+  return expansion == ExpansionState(generation, EXPANDED);
 }
 
 ostream& operator <<(ostream &os, const NodeRecord &node_record) {
-  os << (format("{visited_time_:%1%, average_profit_:%2%, is_in_search_:%3%")
-      % node_record.visited_time_ % node_record.average_profit_ %
-      node_record.is_in_search_);
+  os << (format("{visited_time_:%1%, average_profit_:%2%, edge_count_:%3%}")
+      % node_record.GetVisitedTime() % node_record.GetAverageProfit()
+      % node_record.edge_count_);
   return os;
 }
 
@@ -3,52 +3,72 @@
 
 #include <atomic>
 #include <cstdint>
-#include <map>
-#include <mutex>
 #include <ostream>
 
 #include "../board/position.h"
 #include "../def.h"
+#include "child_edge.h"
 
 namespace foolgo {
 
+/**
+ * Statistics of a node are atomic, so they are modified by search threads
+ * without a lock. A node is expanded once, when its child edges are allocated
+ * all together in an EdgeArena. An expansion only stays valid in the
+ * generation of the transposition table, in which it is done, because the arena
+ * is compacted when a new generation starts.
+ */
 class NodeRecord {
  public:
   NodeRecord();
-  NodeRecord(int32_t visited_time, float average_profit, bool is_in_search)
-      : visited_time_(visited_time),
-        average_profit_(average_profit),
-        is_in_search_(is_in_search) {}
+  NodeRecord(int32_t visited_time, float average_profit);
   NodeRecord(const NodeRecord &node_record);
-  NodeRecord& operator =(const NodeRecord &node_record) = default;
+  NodeRecord& operator =(const NodeRecord &node_record);
   int32_t GetVisitedTime() const {
-    return visited_time_;
+    return visited_time_.load(std::memory_order_relaxed);
   }
-  void SetVisitedTimes(int32_t visited_times) {
-    visited_time_ = visited_times;
-  }
-  float GetAverageProfit() const {
-    return average_profit_;
-  }
-  void SetAverageProfit(float average_profit) {
-    average_profit_ = average_profit;
+  float GetAverageProfit() const;
+  // Adds visits of the average profit.
+  void AddProfit(float profit, int32_t visited_time = 1);
+
+  bool IsExpanded(uint32_t generation) const {
+    return expansion_.load(std::memory_order_acquire)
+        == ExpansionState(generation, EXPANDED);
   }
-  bool IsInSearch() const {
-    return is_in_search_;
+  // Returns true if the calling thread should expand the node, or false if it
+  // has been or is being expanded by another thread.
+  bool TryStartExpansion(uint32_t generation);
+  void FinishExpansion(uint32_t generation, ChildEdge *edges,
+                       int16_t edge_count);
+  // Gives up an expansion started by TryStartExpansion.
+  void AbortExpansion();
+  // Returns false if the expansion is aborted.
+  bool WaitForExpansion(uint32_t generation) const;
+
+  ChildEdge *Edges() const {
+    return edges_;
   }
-  void SetIsInSearch(bool is_in_search) {
-    is_in_search_ = is_in_search;
+  int16_t EdgeCount() const {
+    return edge_count_;
   }
-  const HashKey* GetChildHashKeyPtr(PositionIndex position_index) const;
-  void InsertChildHashKey(PositionIndex position_index,
-                          HashKey hash_key);
 
  private:
-  int32_t visited_time_;
-  float average_profit_;
-  bool is_in_search_;
-  std::map<PositionIndex, HashKey> child_hash_keys_;
-  mutable std::mutex mutex_;
+  enum ExpansionPhase {
+    UNEXPANDED = 0,
+    EXPANDING = 1,
+    EXPANDED = 2
+  };
+
+  std::atomic<int32_t> visited_time_;
+  int16_t edge_count_;
+  std::atomic<double> profit_sum_;
+  ChildEdge *edges_;
+  // The phase in the lower bits, with the generation in the higher bits.
+  std::atomic<uint64_t> expansion_;
+
+  static uint64_t ExpansionState(uint32_t generation, ExpansionPhase phase) {
+    return (static_cast<uint64_t>(generation) << 2) | phase;
+  }
 
   friend std::ostream& operator <<(std::ostream &os,
                                    const NodeRecord &node_record);
@@ -0,0 +1,129 @@
+#include "opening_book.h"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace foolgo {
+
+using std::string;
+using std::unique_ptr;
+using std::vector;
+
+void FillOpeningBookEntry(HashKey hash_key, const NodeRecord &node_record,
+                          OpeningBookEntry *entry) {
+  std::memset(entry, 0, sizeof(*entry));
+  entry->hash_key = hash_key;
+  entry->visited_time = node_record.GetVisitedTime();
+  entry->average_profit = node_record.GetAverageProfit();
+
+  // Kept in descending order of visits by insertion.
+  int child_count = 0;
+  const ChildEdge *edges = node_record.Edges();
+  for (int i = 0; i < node_record.EdgeCount(); ++i) {
+    int32_t visited_time = edges[i].GetVisitedTime();
+    if (visited_time == 0 || (child_count == OPENING_BOOK_CHILD_COUNT
+        && visited_time <= entry->children[child_count - 1].visited_time)) {
+      continue;
+    }
+    int j = std::min(child_count, OPENING_BOOK_CHILD_COUNT - 1);
+    for (; j > 0 && entry->children[j - 1].visited_time < visited_time; --j) {
+      entry->children[j] = entry->children[j - 1];
+    }
+    entry->children[j].position_index = edges[i].GetPositionIndex();
+    entry->children[j].visited_time = visited_time;
+    entry->children[j].average_profit = edges[i].GetAverageProfit();
+    child_count = std::min(child_count + 1, OPENING_BOOK_CHILD_COUNT);
+  }
+}
+
+void OpeningBookWriter::Add(const OpeningBookEntry &entry) {
+  auto it = entries_.find(entry.hash_key);
+  if (it == entries_.end()) {
+    entries_.insert(std::make_pair(entry.hash_key, entry));
+  } else if (it->second.visited_time < entry.visited_time) {
+    it->second = entry;
+  }
+}
+
+bool OpeningBookWriter::Write(const string &path) const {
+  vector<OpeningBookEntry> entries;
+  entries.reserve(entries_.size());
+  for (const auto &key_entry : entries_) {
+    entries.push_back(key_entry.second);
+  }
+  std::sort(entries.begin(), entries.end(),
+            [](const OpeningBookEntry &a, const OpeningBookEntry &b) {
+              return a.hash_key < b.hash_key;
+            });
+
+  OpeningBookHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, OPENING_BOOK_MAGIC, sizeof(header.magic));
+  header.version = OPENING_BOOK_VERSION;
+  header.board_len = board_len_;
+  header.entry_count = entries.size();
+  header.file_size =
+      sizeof(header) + entries.size() * sizeof(OpeningBookEntry);
+  header.empty_board_key = empty_board_key_;
+  header.folds_symmetries = folds_symmetries_;
+
+  string temp_path = path + ".tmp";
+  std::FILE *file = std::fopen(temp_path.c_str(), "wb");
+  if (file == nullptr) {
+    return false;
+  }
+  bool is_written = std::fwrite(&header, sizeof(header), 1, file) == 1
+      && (entries.empty() || std::fwrite(entries.data(),
+          sizeof(OpeningBookEntry), entries.size(), file) == entries.size());
+  is_written = std::fclose(file) == 0 && is_written;
+  if (!is_written || std::rename(temp_path.c_str(), path.c_str()) != 0) {
+    std::remove(temp_path.c_str());
+    return false;
+  }
+  return true;
+}
+
+unique_ptr<OpeningBook> OpeningBook::Open(const string &path,
+                                          BoardLen board_len,
+                                          HashKey empty_board_key) {
+  unique_ptr<util::MappedFile> mapped_file = util::MappedFile::Open(path);
+  if (mapped_file == nullptr
+      || mapped_file->Size() < sizeof(OpeningBookHeader)) {
+    return nullptr;
+  }
+  const char *data = static_cast<const char *>(mapped_file->Data());
+  const OpeningBookHeader *header =
+      reinterpret_cast<const OpeningBookHeader *>(data);
+  uint64_t size = mapped_file->Size();
+  if (std::memcmp(header->magic, OPENING_BOOK_MAGIC,
+                  sizeof(header->magic)) != 0
+      || header->version != OPENING_BOOK_VERSION
+      || header->board_len != static_cast<uint32_t>(board_len)
+      || header->empty_board_key != empty_board_key
+      || header->file_size != size
+      || (size - sizeof(OpeningBookHeader)) % sizeof(OpeningBookEntry) != 0
+      || header->entry_count
+          != (size - sizeof(OpeningBookHeader)) / sizeof(OpeningBookEntry)) {
+    return nullptr;
+  }
+
+  const OpeningBookEntry *entries = reinterpret_cast<const OpeningBookEntry *>(
+      data + sizeof(OpeningBookHeader));
+  std::size_t entry_count = header->entry_count;
+  bool folds_symmetries = header->folds_symmetries != 0;
+  return unique_ptr<OpeningBook>(new OpeningBook(
+      std::move(mapped_file), entries, entry_count, folds_symmetries));
+}
+
+const OpeningBookEntry *OpeningBook::Find(HashKey hash_key) const {
+  const OpeningBookEntry *end = entries_ + entry_count_;
+  const OpeningBookEntry *it = std::lower_bound(
+      entries_, end, hash_key,
+      [](const OpeningBookEntry &entry, HashKey key) {
+        return entry.hash_key < key;
+      });
+  return it != end && it->hash_key == hash_key ? it : nullptr;
+}
+
+}
@@ -0,0 +1,159 @@
+#ifndef FOOLGO_SRC_PLAYER_OPENING_BOOK_H_
+#define FOOLGO_SRC_PLAYER_OPENING_BOOK_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "../board/full_board.h"
+#include "../board/position.h"
+#include "../board/symmetry.h"
+#include "../def.h"
+#include "../util/mapped_file.h"
+#include "node_record.h"
+
+namespace foolgo {
+
+const char OPENING_BOOK_MAGIC[8] = {'F', 'G', 'B', 'O', 'O', 'K', '\0', '\0'};
+const uint32_t OPENING_BOOK_VERSION = 1;
+// The most visited children kept by each entry.
+const int OPENING_BOOK_CHILD_COUNT = 4;
+
+// The header of a book file, which is followed by entry_count entries in
+// ascending order of their keys.
+struct OpeningBookHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t board_len;
+  uint64_t entry_count;
+  uint64_t file_size;
+  // Keys of the book are only meaningful to players hashing by the same
+  // ZobHasher seed, which gives the same key of the empty board.
+  uint64_t empty_board_key;
+  uint32_t folds_symmetries;
+  char reserved[20];
+};
+
+// A child of no visits is absent.
+struct OpeningBookChild {
+  int16_t position_index;
+  int16_t reserved;
+  int32_t visited_time;
+  float average_profit;
+};
+
+// Keys and position indexes of children are those of canonical boards if
+// the book folds symmetries, or else those of the boards themselves.
+// Children are in descending order of their visits.
+struct OpeningBookEntry {
+  uint64_t hash_key;
+  int32_t visited_time;
+  float average_profit;
+  OpeningBookChild children[OPENING_BOOK_CHILD_COUNT];
+};
+
+template<BoardLen BOARD_LEN>
+HashKey EmptyBoardHashKey() {
+  FullBoard<BOARD_LEN> full_board;
+  full_board.Init();
+  return full_board.HashKey();
+}
+
+// Fills the entry by the record and its most visited edges, which should be
+// valid.
+void FillOpeningBookEntry(HashKey hash_key, const NodeRecord &node_record,
+                          OpeningBookEntry *entry);
+
+/**
+ * Collects entries of searched positions and writes them to a book.
+ */
+class OpeningBookWriter {
+ public:
+  OpeningBookWriter(BoardLen board_len, bool folds_symmetries,
+                    HashKey empty_board_key)
+      : board_len_(board_len),
+        folds_symmetries_(folds_symmetries),
+        empty_board_key_(empty_board_key) {}
+  DISALLOW_COPY_AND_ASSIGN_AND_MOVE(OpeningBookWriter)
+
+  bool FoldsSymmetries() const {
+    return folds_symmetries_;
+  }
+  std::size_t EntryCount() const {
+    return entries_.size();
+  }
+
+  // Of entries of the same key, such as those of one position searched in
+  // several moves or tables, the most visited one is kept.
+  void Add(const OpeningBookEntry &entry);
+  // Writes to a temporary file renamed to the path when done. Returns false
+  // if the file can not be written.
+  bool Write(const std::string &path) const;
+
+ private:
+  BoardLen board_len_;
+  bool folds_symmetries_;
+  HashKey empty_board_key_;
+  std::unordered_map<uint64_t, OpeningBookEntry> entries_;
+};
+
+/**
+ * A book mapped into memory, whose entries are found by binary search in
+ * place, so that opening it reads only the header.
+ */
+class OpeningBook {
+ public:
+  DISALLOW_COPY_AND_ASSIGN_AND_MOVE(OpeningBook)
+
+  // Returns nullptr if the file can not be mapped, is malformed, or is of
+  // another board length or key of the empty board.
+  static std::unique_ptr<OpeningBook> Open(const std::string &path,
+                                           BoardLen board_len,
+                                           HashKey empty_board_key);
+
+  bool FoldsSymmetries() const {
+    return folds_symmetries_;
+  }
+  std::size_t EntryCount() const {
+    return entry_count_;
+  }
+  // Returns nullptr if there is no entry of the key.
+  const OpeningBookEntry *Find(HashKey hash_key) const;
+
+  // The entry of the board, or nullptr if there is none.
+  template<BoardLen BOARD_LEN>
+  const OpeningBookEntry *Find(const FullBoard<BOARD_LEN> &full_board) const {
+    return Find(folds_symmetries_ ? full_board.CanonicalHashKey() :
+        full_board.HashKey());
+  }
+  // Moves a position index of a child in the entry of the board to the
+  // position index of the board.
+  template<BoardLen BOARD_LEN>
+  PositionIndex BoardIndex(const FullBoard<BOARD_LEN> &full_board,
+                           PositionIndex book_index) const {
+    return folds_symmetries_ ? SymmetricIndex<BOARD_LEN>(
+        InverseSymmetry(full_board.CanonicalSymmetry()), book_index) :
+        book_index;
+  }
+
+ private:
+  OpeningBook(std::unique_ptr<util::MappedFile> mapped_file,
+              const OpeningBookEntry *entries, std::size_t entry_count,
+              bool folds_symmetries)
+      : mapped_file_(std::move(mapped_file)),
+        entries_(entries),
+        entry_count_(entry_count),
+        folds_symmetries_(folds_symmetries) {}
+
+  std::unique_ptr<util::MappedFile> mapped_file_;
+  const OpeningBookEntry *entries_;
+  std::size_t entry_count_;
+  bool folds_symmetries_;
+};
+
+}
+
+#endif
@@ -23,8 +23,7 @@ template<BoardLen BOARD_LEN>
 PositionIndex PassablePlayer<BOARD_LEN>::NextMove(
     const FullBoard<BOARD_LEN> &full_board) {
   Force current_force = NextForce(full_board);
-  auto playable_indexes = full_board.PlayableIndexes(current_force);
-  if (playable_indexes.empty()) {
+  if (full_board.PlayableIndexBitSet(current_force).none()) {
     return POSITION_INDEX_PASS;
   } else {
     return NextMoveWithPlayableBoard(full_board);
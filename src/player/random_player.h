@@ -18,24 +18,26 @@ struct Move;
 template <BoardLen BOARD_LEN>
 class RandomPlayer : public PassablePlayer<BOARD_LEN> {
  public:
-  explicit RandomPlayer(uint32_t seed) : seed_(seed) {}
+  explicit RandomPlayer(uint32_t seed, uint64_t stream = 0)
+      : random_engine_(seed, stream) {}
 
  protected:
   PositionIndex NextMoveWithPlayableBoard(
       const FullBoard<BOARD_LEN> &full_board);
 
  private:
-  uint32_t seed_;
+  RandomEngine random_engine_;
 };
 
 template<BoardLen BOARD_LEN>
 PositionIndex RandomPlayer<BOARD_LEN>::NextMoveWithPlayableBoard(
     const FullBoard<BOARD_LEN>& full_board) {
-  auto playable_indexes = full_board.PlayableIndexes(NextForce(full_board));
-  assert(!playable_indexes.empty());
+  const BitSet<BOARD_LEN> &playable_indexes =
+      full_board.PlayableIndexBitSet(NextForce(full_board));
+  assert(playable_indexes.any());
 
-  PositionIndex rand = Rand(playable_indexes.size() - 1, seed_);
-  return playable_indexes.at(rand);
+  int rand = random_engine_.Uniform(playable_indexes.count() - 1);
+  return playable_indexes.Select(rand);
 }
 
 } /* namespace foolgo */
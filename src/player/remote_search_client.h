@@ -0,0 +1,195 @@
+#ifndef FOOLGO_SRC_PLAYER_REMOTE_SEARCH_CLIENT_H_
+#define FOOLGO_SRC_PLAYER_REMOTE_SEARCH_CLIENT_H_
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../board/force.h"
+#include "../board/full_board.h"
+#include "../board/position.h"
+#include "../def.h"
+#include "../util/socket.h"
+#include "remote_search_protocol.h"
+
+namespace foolgo {
+
+/**
+ * The coordinator side of searches on remote workers. A search is sent to
+ * all workers before the local search starts, and their responses are
+ * received after it, so workers search meanwhile and a move waits for them
+ * only as long as the budget lasts. A worker not responding by the budget and
+ * a margin is dropped, and reconnected at the next search.
+ * Workers are sent the moves of the game, which are followed from the
+ * boards searched: the point newly taken by each force is its move, or it
+ * passes if there is none.
+ */
+template<BoardLen BOARD_LEN>
+class RemoteSearchClient {
+ public:
+  RemoteSearchClient() = default;
+  ~RemoteSearchClient() = default;
+  DISALLOW_COPY_AND_ASSIGN_AND_MOVE(RemoteSearchClient)
+
+  // The worker is connected at the next search, and reconnected at the
+  // search after its connection fails.
+  void AddWorker(const std::string &host, uint16_t port);
+
+  // Sends the search of the board to the workers, and returns false if no
+  // worker is sent to, such as when the moves to the board are unknown.
+  bool StartSearch(const FullBoard<BOARD_LEN> &full_board, float komi,
+                   int mc_game_count, int think_milliseconds);
+  // Receives the responses of workers to the started search. A search of
+  // no think time may take as long again as the local search.
+  std::vector<SearchResponse> FinishSearch();
+
+ private:
+  static const int RESPONSE_MARGIN_MILLISECONDS = 1000;
+
+  struct Worker {
+    std::string host;
+    uint16_t port;
+    std::unique_ptr<util::Socket> socket;
+    bool is_searching;
+  };
+
+  std::vector<Worker> workers_;
+  // The board replayed by the moves, or nullptr if the moves are unknown.
+  std::unique_ptr<FullBoard<BOARD_LEN>> history_board_;
+  std::vector<PositionIndex> moves_;
+  // Whether the moves were lost, which is reported once until they are
+  // followed again, from the empty board of the next game.
+  bool is_history_lost_ = false;
+  std::chrono::steady_clock::time_point search_start_time_;
+  int think_milliseconds_ = 0;
+
+  // Follows moves from the last board to the board, from the empty board if
+  // it is of an earlier move. Returns false if they can not be told.
+  bool FollowMoves(const FullBoard<BOARD_LEN> &full_board);
+};
+
+template<BoardLen BOARD_LEN>
+void RemoteSearchClient<BOARD_LEN>::AddWorker(const std::string &host,
+                                              uint16_t port) {
+  Worker worker;
+  worker.host = host;
+  worker.port = port;
+  worker.is_searching = false;
+  workers_.push_back(std::move(worker));
+}
+
+template<BoardLen BOARD_LEN>
+bool RemoteSearchClient<BOARD_LEN>::FollowMoves(
+    const FullBoard<BOARD_LEN> &full_board) {
+  if (history_board_ == nullptr
+      || full_board.MoveCount() < history_board_->MoveCount()) {
+    history_board_.reset(new FullBoard<BOARD_LEN>);
+    history_board_->Init();
+    moves_.clear();
+  }
+
+  while (history_board_->MoveCount() < full_board.MoveCount()) {
+    Force force = NextForce(*history_board_);
+    BitSet<BOARD_LEN> new_points =
+        full_board.PointBitSet(ForceToPointState(force))
+        & history_board_->PointBitSet(EMPTY_POINT);
+    if (new_points.count() > 1) {
+      history_board_.reset();
+      return false;
+    }
+    PositionIndex index = new_points.none() ? POSITION_INDEX_PASS :
+        new_points.Select(0);
+    Play(history_board_.get(), index);
+    moves_.push_back(index);
+  }
+
+  if (history_board_->HashKey() != full_board.HashKey()) {
+    history_board_.reset();
+    return false;
+  }
+  return true;
+}
+
+template<BoardLen BOARD_LEN>
+bool RemoteSearchClient<BOARD_LEN>::StartSearch(
+    const FullBoard<BOARD_LEN> &full_board, float komi, int mc_game_count,
+    int think_milliseconds) {
+  if (workers_.empty()) {
+    return false;
+  }
+  if (!FollowMoves(full_board)) {
+    if (!is_history_lost_) {
+      std::cerr << "remote search stops until the next game, for the moves to "
+          "move " << full_board.MoveCount() << " can not be told" << std::endl;
+      is_history_lost_ = true;
+    }
+    return false;
+  }
+  is_history_lost_ = false;
+  search_start_time_ = std::chrono::steady_clock::now();
+  think_milliseconds_ = think_milliseconds;
+
+  SearchRequest request;
+  request.board_len = BOARD_LEN;
+  request.komi = komi;
+  request.mc_game_count = mc_game_count;
+  request.think_milliseconds = think_milliseconds;
+  request.moves = moves_;
+  std::vector<uint8_t> message = EncodeSearchRequest(request);
+  bool is_sent = false;
+
+  for (Worker &worker : workers_) {
+    if (worker.socket == nullptr) {
+      worker.socket = util::Socket::Connect(worker.host, worker.port);
+    }
+    worker.is_searching = worker.socket != nullptr
+        && SendMessage(message, worker.socket.get());
+    if (!worker.is_searching) {
+      worker.socket.reset();
+    }
+    is_sent = is_sent || worker.is_searching;
+  }
+
+  return is_sent;
+}
+
+template<BoardLen BOARD_LEN>
+std::vector<SearchResponse> RemoteSearchClient<BOARD_LEN>::FinishSearch() {
+  std::vector<SearchResponse> responses;
+  std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+  std::chrono::steady_clock::time_point deadline =
+      (think_milliseconds_ > 0 ?
+          search_start_time_ + std::chrono::milliseconds(think_milliseconds_) :
+          now + (now - search_start_time_))
+      + std::chrono::milliseconds(RESPONSE_MARGIN_MILLISECONDS);
+
+  for (Worker &worker : workers_) {
+    if (!worker.is_searching) {
+      continue;
+    }
+    worker.is_searching = false;
+    // The timeout is at least 1 millisecond, for 0 waits forever.
+    int timeout_milliseconds = std::max<int64_t>(1,
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now()).count());
+    std::vector<uint8_t> message;
+    SearchResponse response;
+    if (worker.socket->SetReceiveTimeout(timeout_milliseconds)
+        && ReceiveMessage(worker.socket.get(), &message)
+        && DecodeSearchResponse(message, &response)) {
+      responses.push_back(std::move(response));
+    } else {
+      worker.socket.reset();
+    }
+  }
+
+  return responses;
+}
+
+}
+
+#endif
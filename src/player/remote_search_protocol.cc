@@ -0,0 +1,170 @@
+#include "remote_search_protocol.h"
+
+#include <cstring>
+
+namespace foolgo {
+
+using std::vector;
+
+namespace {
+
+const uint8_t SEARCH_REQUEST_TYPE = 1;
+const uint8_t SEARCH_RESPONSE_TYPE = 2;
+// No message of boards up to 19x19 comes near the limit.
+const uint32_t MAX_MESSAGE_SIZE = 1 << 20;
+
+class Writer {
+ public:
+  void PutUint(uint64_t value, int size) {
+    for (int i = 0; i < size; ++i) {
+      bytes_.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+  }
+  void PutFloat(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    PutUint(bits, 4);
+  }
+
+  vector<uint8_t> &Bytes() {
+    return bytes_;
+  }
+
+ private:
+  vector<uint8_t> bytes_;
+};
+
+// Reads fields in turn, and fails all reads after reading past the end.
+class Reader {
+ public:
+  explicit Reader(const vector<uint8_t> &bytes) : bytes_(bytes) {}
+
+  uint64_t GetUint(int size) {
+    if (offset_ + size > bytes_.size()) {
+      is_valid_ = false;
+      return 0;
+    }
+    uint64_t value = 0;
+    for (int i = 0; i < size; ++i) {
+      value |= static_cast<uint64_t>(bytes_[offset_ + i]) << (8 * i);
+    }
+    offset_ += size;
+    return value;
+  }
+  int32_t GetInt32() {
+    return static_cast<int32_t>(GetUint(4));
+  }
+  float GetFloat() {
+    uint32_t bits = GetUint(4);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+
+  // Whether all bytes are read, and no read has failed.
+  bool IsAtValidEnd() const {
+    return is_valid_ && offset_ == bytes_.size();
+  }
+
+ private:
+  const vector<uint8_t> &bytes_;
+  std::size_t offset_ = 0;
+  bool is_valid_ = true;
+};
+
+}
+
+vector<uint8_t> EncodeSearchRequest(const SearchRequest &request) {
+  Writer writer;
+  writer.PutUint(SEARCH_REQUEST_TYPE, 1);
+  writer.PutUint(request.board_len, 1);
+  writer.PutFloat(request.komi);
+  writer.PutUint(request.mc_game_count, 4);
+  writer.PutUint(request.think_milliseconds, 4);
+  writer.PutUint(request.moves.size(), 4);
+  for (PositionIndex move : request.moves) {
+    writer.PutUint(static_cast<uint16_t>(move), 2);
+  }
+  return std::move(writer.Bytes());
+}
+
+bool DecodeSearchRequest(const vector<uint8_t> &message,
+                         SearchRequest *request) {
+  Reader reader(message);
+  if (reader.GetUint(1) != SEARCH_REQUEST_TYPE) {
+    return false;
+  }
+  request->board_len = reader.GetUint(1);
+  request->komi = reader.GetFloat();
+  request->mc_game_count = reader.GetInt32();
+  request->think_milliseconds = reader.GetInt32();
+  uint32_t move_count = reader.GetUint(4);
+  if (move_count > MAX_MESSAGE_SIZE) {
+    return false;
+  }
+  request->moves.resize(move_count);
+  for (PositionIndex &move : request->moves) {
+    move = static_cast<int16_t>(reader.GetUint(2));
+  }
+  return reader.IsAtValidEnd();
+}
+
+vector<uint8_t> EncodeSearchResponse(const SearchResponse &response) {
+  Writer writer;
+  writer.PutUint(SEARCH_RESPONSE_TYPE, 1);
+  writer.PutUint(response.playout_count, 4);
+  writer.PutUint(response.root_child_stats.size(), 4);
+  for (const RootChildStat &stat : response.root_child_stats) {
+    writer.PutUint(static_cast<uint16_t>(stat.position_index), 2);
+    writer.PutUint(stat.visited_time, 4);
+    writer.PutFloat(stat.average_profit);
+  }
+  return std::move(writer.Bytes());
+}
+
+bool DecodeSearchResponse(const vector<uint8_t> &message,
+                          SearchResponse *response) {
+  Reader reader(message);
+  if (reader.GetUint(1) != SEARCH_RESPONSE_TYPE) {
+    return false;
+  }
+  response->playout_count = reader.GetInt32();
+  uint32_t stat_count = reader.GetUint(4);
+  if (stat_count > MAX_MESSAGE_SIZE) {
+    return false;
+  }
+  response->root_child_stats.resize(stat_count);
+  for (RootChildStat &stat : response->root_child_stats) {
+    stat.position_index = static_cast<int16_t>(reader.GetUint(2));
+    stat.visited_time = reader.GetInt32();
+    stat.average_profit = reader.GetFloat();
+  }
+  return reader.IsAtValidEnd();
+}
+
+bool SendMessage(const vector<uint8_t> &message, util::Socket *socket) {
+  uint8_t size_bytes[4];
+  for (int i = 0; i < 4; ++i) {
+    size_bytes[i] = static_cast<uint8_t>(message.size() >> (8 * i));
+  }
+  return socket->SendAll(size_bytes, sizeof(size_bytes))
+      && socket->SendAll(message.data(), message.size());
+}
+
+bool ReceiveMessage(util::Socket *socket, vector<uint8_t> *message) {
+  uint8_t size_bytes[4];
+  if (!socket->ReceiveAll(size_bytes, sizeof(size_bytes))) {
+    return false;
+  }
+  uint32_t size = 0;
+  for (int i = 0; i < 4; ++i) {
+    size |= static_cast<uint32_t>(size_bytes[i]) << (8 * i);
+  }
+  if (size > MAX_MESSAGE_SIZE) {
+    return false;
+  }
+  message->resize(size);
+  return socket->ReceiveAll(message->data(), size);
+}
+
+}
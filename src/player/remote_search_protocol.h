@@ -0,0 +1,57 @@
+#ifndef FOOLGO_SRC_PLAYER_REMOTE_SEARCH_PROTOCOL_H_
+#define FOOLGO_SRC_PLAYER_REMOTE_SEARCH_PROTOCOL_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "../board/position.h"
+#include "../util/socket.h"
+
+namespace foolgo {
+
+/**
+ * Messages between a coordinator and remote search workers. Each message is
+ * framed by its size in 4 bytes, and all integers and floats are little
+ * endian. A request is answered by one response on the same connection, and
+ * a connection carries the requests of successive moves, so that a worker
+ * reuses its tree.
+ */
+
+// Statistics of a root child, summed over tables or workers.
+struct RootChildStat {
+  PositionIndex position_index;
+  int32_t visited_time;
+  float average_profit;
+};
+
+// Searches the position reached by the moves from the empty board, in which
+// a pass is POSITION_INDEX_PASS, by the playout count, or for the think time
+// if it is positive.
+struct SearchRequest {
+  BoardLen board_len;
+  float komi;
+  int32_t mc_game_count;
+  int32_t think_milliseconds;
+  std::vector<PositionIndex> moves;
+};
+
+struct SearchResponse {
+  int32_t playout_count;
+  std::vector<RootChildStat> root_child_stats;
+};
+
+std::vector<uint8_t> EncodeSearchRequest(const SearchRequest &request);
+// Returns false if the message is not a well formed request.
+bool DecodeSearchRequest(const std::vector<uint8_t> &message,
+                         SearchRequest *request);
+std::vector<uint8_t> EncodeSearchResponse(const SearchResponse &response);
+bool DecodeSearchResponse(const std::vector<uint8_t> &message,
+                          SearchResponse *response);
+
+bool SendMessage(const std::vector<uint8_t> &message, util::Socket *socket);
+// Returns false if the connection is closed, or the message is too large.
+bool ReceiveMessage(util::Socket *socket, std::vector<uint8_t> *message);
+
+}
+
+#endif
@@ -0,0 +1,109 @@
+#ifndef FOOLGO_SRC_PLAYER_SEARCH_SERVER_H_
+#define FOOLGO_SRC_PLAYER_SEARCH_SERVER_H_
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "../board/full_board.h"
+#include "../board/position.h"
+#include "../def.h"
+#include "../util/socket.h"
+#include "remote_search_protocol.h"
+#include "time_control.h"
+#include "uct_player.h"
+
+namespace foolgo {
+
+/**
+ * The worker side of remote searches, which answers each request by the
+ * root child statistics of the search of its position by the player. The
+ * tree of the player is kept between requests, so that the search of the
+ * next move of the same game reuses it.
+ */
+template<BoardLen BOARD_LEN>
+class SearchServer {
+ public:
+  explicit SearchServer(UctPlayer<BOARD_LEN> *uct_player)
+      : uct_player_(uct_player) {
+    empty_board_.Init();
+  }
+  DISALLOW_COPY_AND_ASSIGN_AND_MOVE(SearchServer)
+
+  // Serves connections one at a time, and returns false only if the port
+  // can not be listened on.
+  bool Serve(uint16_t port);
+  // Returns false if the request is not of a valid position of this board
+  // length.
+  bool Search(const SearchRequest &request, SearchResponse *response);
+
+ private:
+  UctPlayer<BOARD_LEN> *uct_player_;
+  FullBoard<BOARD_LEN> empty_board_;
+};
+
+template<BoardLen BOARD_LEN>
+bool SearchServer<BOARD_LEN>::Serve(uint16_t port) {
+  util::ServerSocket server_socket;
+  if (!server_socket.Listen(port)) {
+    return false;
+  }
+
+  while (true) {
+    std::unique_ptr<util::Socket> socket = server_socket.Accept();
+    if (socket == nullptr) {
+      continue;
+    }
+
+    std::vector<uint8_t> message;
+    while (ReceiveMessage(socket.get(), &message)) {
+      SearchRequest request;
+      SearchResponse response;
+      if (!DecodeSearchRequest(message, &request)
+          || !Search(request, &response)
+          || !SendMessage(EncodeSearchResponse(response), socket.get())) {
+        break;
+      }
+    }
+  }
+}
+
+template<BoardLen BOARD_LEN>
+bool SearchServer<BOARD_LEN>::Search(const SearchRequest &request,
+                                     SearchResponse *response) {
+  if (request.board_len != BOARD_LEN || request.mc_game_count <= 0) {
+    return false;
+  }
+
+  FullBoard<BOARD_LEN> full_board;
+  full_board.Copy(empty_board_);
+  for (PositionIndex index : request.moves) {
+    if (index != POSITION_INDEX_PASS
+        && (index < 0 || index >= BoardLenSquare<BOARD_LEN>()
+            || !full_board.PlayableIndexBitSet(NextForce(full_board))[index])) {
+      return false;
+    }
+    Play(&full_board, index);
+  }
+
+  uct_player_->SetKomi(request.komi);
+  uct_player_->SetMcGameCountPerMove(request.mc_game_count);
+  if (request.think_milliseconds > 0) {
+    // Every request searches for its own think time.
+    TimeControl::Duration think_time(request.think_milliseconds);
+    uct_player_->SetTimeControl(
+        TimeControl(think_time * 1000, think_time, think_time));
+  } else {
+    uct_player_->ClearTimeControl();
+  }
+
+  uct_player_->NextMove(full_board);
+  response->playout_count = uct_player_->LastSearchStats().playout_count;
+  response->root_child_stats = uct_player_->RootChildStats(full_board);
+  return true;
+}
+
+}
+
+#endif
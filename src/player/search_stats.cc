@@ -0,0 +1,81 @@
+#include "search_stats.h"
+
+#include <boost/format.hpp>
+#include <sstream>
+
+namespace foolgo {
+
+using std::ostream;
+using std::string;
+using std::vector;
+using boost::format;
+
+namespace {
+
+ostream &WriteJsonArray(ostream &os, const vector<int64_t> &values) {
+  os << '[';
+  for (std::size_t i = 0; i < values.size(); ++i) {
+    os << (i == 0 ? "" : ",") << values[i];
+  }
+  return os << ']';
+}
+
+}
+
+void SearchStats::Add(const SearchStats &stats) {
+  playout_count += stats.playout_count;
+  created_node_count += stats.created_node_count;
+  table_hit_count += stats.table_hit_count;
+  table_miss_count += stats.table_miss_count;
+  table_collision_count += stats.table_collision_count;
+  descent_count += stats.descent_count;
+  depth_sum += stats.depth_sum;
+  if (stats.max_depth > max_depth) {
+    max_depth = stats.max_depth;
+  }
+  if (depth_histogram.size() < stats.depth_histogram.size()) {
+    depth_histogram.resize(stats.depth_histogram.size(), 0);
+  }
+  for (std::size_t i = 0; i < stats.depth_histogram.size(); ++i) {
+    depth_histogram[i] += stats.depth_histogram[i];
+  }
+  lock_wait_seconds += stats.lock_wait_seconds;
+  remote_playout_count += stats.remote_playout_count;
+  network_evaluation_count += stats.network_evaluation_count;
+  evaluation_cache_hit_count += stats.evaluation_cache_hit_count;
+}
+
+ostream &operator <<(ostream &os, const SearchStats &stats) {
+  os << (format("{\"playout_count\":%1%,\"wall_seconds\":%2$.6f,"
+      "\"playouts_per_second\":%3$.1f,\"created_node_count\":%4%,"
+      "\"table_hit_count\":%5%,\"table_miss_count\":%6%,"
+      "\"table_collision_count\":%7%,\"descent_count\":%8%,"
+      "\"average_depth\":%9$.3f,\"max_depth\":%10%,"
+      "\"lock_wait_seconds\":%11$.6f,\"remote_playout_count\":%12%,"
+      "\"network_evaluation_count\":%13%,\"evaluation_cache_hit_count\":%14%,")
+      % stats.playout_count % stats.wall_seconds % stats.PlayoutsPerSecond()
+      % stats.created_node_count % stats.table_hit_count
+      % stats.table_miss_count % stats.table_collision_count
+      % stats.descent_count % stats.AverageDepth() % stats.max_depth
+      % stats.lock_wait_seconds % stats.remote_playout_count
+      % stats.network_evaluation_count % stats.evaluation_cache_hit_count);
+  os << "\"depth_histogram\":";
+  WriteJsonArray(os, stats.depth_histogram);
+  os << ",\"thread_playout_counts\":";
+  WriteJsonArray(os, stats.thread_playout_counts);
+  return os << '}';
+}
+
+string ToJsonLine(const SearchStats &stats) {
+  std::ostringstream os;
+  os << stats;
+  return os.str();
+}
+
+SearchStatsSink JsonLineSink(ostream *os) {
+  return [os](const SearchStats &stats) {
+    *os << stats << std::endl;
+  };
+}
+
+}
@@ -0,0 +1,85 @@
+#ifndef FOOLGO_SRC_PLAYER_SEARCH_STATS_H_
+#define FOOLGO_SRC_PLAYER_SEARCH_STATS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace foolgo {
+
+/**
+ * Statistics of the search of one move. Each search task counts into its own
+ * stats, which are added up after the search, so that counting costs no
+ * synchronization.
+ */
+struct SearchStats {
+  // Playouts, counting each leaf evaluated by the network alone as one.
+  int64_t playout_count = 0;
+  double wall_seconds = 0.0;
+  // Records inserted into the transposition table.
+  int64_t created_node_count = 0;
+  // Lookups of nodes of descents, which miss at the leaves.
+  int64_t table_hit_count = 0;
+  int64_t table_miss_count = 0;
+  // Records of other positions evicted, and insertions failed because
+  // buckets were full.
+  int64_t table_collision_count = 0;
+  int64_t descent_count = 0;
+  // Moves from the root to the leaves of descents, summed over descents.
+  int64_t depth_sum = 0;
+  int max_depth = 0;
+  // Descents counted by the depth of their leaves.
+  std::vector<int64_t> depth_histogram;
+  // Time spent by threads waiting for other threads to expand nodes, which is
+  // the only waiting of the search.
+  double lock_wait_seconds = 0.0;
+  // Playouts run by each worker of the thread pool.
+  std::vector<int64_t> thread_playout_counts;
+  // Playouts run by remote workers, which are not in the playout count.
+  int64_t remote_playout_count = 0;
+  // Boards evaluated by the network, and evaluations found in the cache
+  // instead, when searching by PUCT.
+  int64_t network_evaluation_count = 0;
+  int64_t evaluation_cache_hit_count = 0;
+
+  double PlayoutsPerSecond() const {
+    return wall_seconds > 0.0 ? playout_count / wall_seconds : 0.0;
+  }
+  double AverageDepth() const {
+    return descent_count > 0 ?
+        static_cast<double>(depth_sum) / descent_count : 0.0;
+  }
+
+  void AddDescent(int depth) {
+    ++descent_count;
+    depth_sum += depth;
+    if (depth > max_depth) {
+      max_depth = depth;
+    }
+    if (depth_histogram.size() <= static_cast<std::size_t>(depth)) {
+      depth_histogram.resize(depth + 1, 0);
+    }
+    ++depth_histogram[depth];
+  }
+  // Adds the counts of a search task, excluding the wall time and the
+  // counts of threads.
+  void Add(const SearchStats &stats);
+};
+
+// Writes the stats as one line of JSON, without the line break.
+std::ostream &operator <<(std::ostream &os, const SearchStats &stats);
+std::string ToJsonLine(const SearchStats &stats);
+
+// Receives the stats after the search of each move.
+typedef std::function<void(const SearchStats&)> SearchStatsSink;
+
+// Returns a sink writing each stats to the stream as a line of JSON. The
+// stream should outlive the sink.
+SearchStatsSink JsonLineSink(std::ostream *os);
+
+}
+
+#endif
@@ -29,9 +29,7 @@ class SgfPlayer : public PassablePlayer<BOARD_LEN> {
 template<BoardLen BOARD_LEN>
 PositionIndex SgfPlayer<BOARD_LEN>::NextMoveWithPlayableBoard(
     const FullBoard<BOARD_LEN>& full_board) {
-  auto playable_indexes =
-    full_board.PlayableIndexes(NextForce(full_board));
-  assert(!playable_indexes.empty());
+  assert(full_board.PlayableIndexBitSet(NextForce(full_board)).any());
 
   int index = full_board.MoveCount();
   assert(index <= game_info_->moves.size());
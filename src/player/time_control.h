@@ -0,0 +1,59 @@
+#ifndef FOOLGO_SRC_PLAYER_TIME_CONTROL_H_
+#define FOOLGO_SRC_PLAYER_TIME_CONTROL_H_
+
+#include <algorithm>
+#include <chrono>
+
+#include "../board/full_board.h"
+#include "../board/position.h"
+#include "../def.h"
+
+namespace foolgo {
+
+/**
+ * The wall clock budget of a player. The time left for the game is divided
+ * among the moves the player is expected to play, and each share is bounded
+ * by the minimum and the maximum think time of a move.
+ */
+struct TimeControl {
+  typedef std::chrono::milliseconds Duration;
+
+  Duration remaining_time;
+  Duration min_think_time;
+  Duration max_think_time;
+  // The share of the time of a move, kept against the latency of returning
+  // the move, which is never spent on searching.
+  Duration safety_margin = Duration(50);
+  // The least count of moves the remaining time is divided among, so that
+  // time is kept for the end of a game lasting longer than expected.
+  int min_expected_move_count = 10;
+
+  TimeControl(Duration remaining_time, Duration min_think_time,
+              Duration max_think_time)
+      : remaining_time(remaining_time),
+        min_think_time(min_think_time),
+        max_think_time(max_think_time) {}
+};
+
+// Returns the think time for the next move. A player is expected to play on
+// half of the empty points before the game ends.
+template<BoardLen BOARD_LEN>
+TimeControl::Duration ThinkTime(const TimeControl &time_control,
+                                const FullBoard<BOARD_LEN> &full_board) {
+  int expected_move_count = std::max(
+      time_control.min_expected_move_count,
+      full_board.PointBitSet(EMPTY_POINT).count() / 2);
+  TimeControl::Duration think_time = std::min(
+      std::max(time_control.remaining_time / expected_move_count,
+               time_control.min_think_time),
+      time_control.max_think_time);
+  // Never more than what is left on the clock.
+  TimeControl::Duration usable_time = std::max(
+      time_control.remaining_time - time_control.safety_margin,
+      TimeControl::Duration(0));
+  return std::min(think_time, usable_time);
+}
+
+}
+
+#endif
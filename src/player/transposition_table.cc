@@ -0,0 +1,23 @@
+#include "transposition_table.h"
+
+#include <boost/format.hpp>
+
+namespace foolgo {
+
+using std::ostream;
+using boost::format;
+
+ostream &operator <<(ostream &os, const TranspositionTableStats &stats) {
+  double occupancy = stats.capacity == 0 ? 0.0 :
+      static_cast<double>(stats.occupied_count) / stats.capacity;
+  os << (format("{capacity:%1%, occupied_count:%2%, occupancy:%3$.3f, "
+      "eviction_count:%4%, failed_insertion_count:%5%, edge_capacity:%6%, "
+      "edge_count:%7%, failed_expansion_count:%8%, "
+      "expansion_wait_nanoseconds:%9%}") % stats.capacity
+      % stats.occupied_count % occupancy % stats.eviction_count
+      % stats.failed_insertion_count % stats.edge_capacity % stats.edge_count
+      % stats.failed_expansion_count % stats.expansion_wait_nanoseconds);
+  return os;
+}
+
+}
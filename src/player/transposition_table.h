@@ -1,108 +1,554 @@
 #ifndef FOOLGO_SRC_PLAYER_TRANSPOSITION_TABLE_H_
 #define FOOLGO_SRC_PLAYER_TRANSPOSITION_TABLE_H_
 
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
 #include <cstddef>
-#include <mutex>
-#include <unordered_map>
+#include <cstdint>
+#include <new>
+#include <ostream>
+#include <thread>
+#include <vector>
 
 #include "../board/full_board.h"
 #include "../board/position.h"
+#include "../board/symmetry.h"
 #include "../def.h"
+#include "../util/memory_util.h"
+#include "../util/trace.h"
+#include "child_edge.h"
+#include "edge_arena.h"
+#include "move_prior.h"
 #include "node_record.h"
 
 namespace foolgo {
 
-namespace {
-struct StaySelfHasher {
-  std::size_t operator ()(HashKey hash_key) const {
-    return hash_key;
-  }
+struct TranspositionTableStats {
+  std::size_t capacity;
+  std::size_t occupied_count;
+  std::size_t eviction_count;
+  std::size_t failed_insertion_count;
+  std::size_t edge_capacity;
+  std::size_t edge_count;
+  std::size_t failed_expansion_count;
+  // Time spent by threads waiting for other threads to expand nodes.
+  std::size_t expansion_wait_nanoseconds;
 };
-}
 
+std::ostream &operator <<(std::ostream &os,
+                          const TranspositionTableStats &stats);
+
+/**
+ * A fixed capacity open addressing hash table, whose slots are all allocated
+ * within a memory budget when it is constructed. A slot is claimed by CAS on
+ * its key, thus neither lookup nor insertion takes a lock.
+ *
+ * Keys are grouped into cache line sized buckets and a key is only stored in
+ * the bucket it hashes to, so a lookup reads one line of keys. When a bucket
+ * is full, the least visited record of an older generation is replaced.
+ * Records of the current generation, i.e. those retained or touched during the
+ * current search, are never replaced, so a returned NodeRecord pointer stays
+ * valid until the next RetainSubtree.
+ *
+ * Child edges of expanded nodes are allocated from an EdgeArena, which takes
+ * most of the memory budget. RetainSubtree slides edges of retained nodes to the
+ * front of the arena, and all the other edges are freed at once.
+ */
 template<BoardLen BOARD_LEN>
 class TranspositionTable {
  public:
+  static const std::size_t DEFAULT_MEMORY_BYTES = 128 << 20;
+
+  // The memory is placed on the NUMA node, or interleaved among nodes if it
+  // is INTERLEAVED_NUMA_NODES.
+  explicit TranspositionTable(std::size_t memory_bytes = DEFAULT_MEMORY_BYTES,
+                              int numa_node = util::ANY_NUMA_NODE);
+  ~TranspositionTable();
+  DISALLOW_COPY_AND_ASSIGN_AND_MOVE(TranspositionTable)
+
   NodeRecord *Get(const FullBoard<BOARD_LEN> &full_board) const;
   NodeRecord *GetChild(const FullBoard<BOARD_LEN> &full_board,
                        PositionIndex next_position_index);
-  void Insert(const FullBoard<BOARD_LEN> &full_board,
-              const NodeRecord &node_record);
+  // Returns the record stored for the board, which is the previous one if the
+  // board has been inserted, or nullptr if no slot is available.
+  NodeRecord *Insert(const FullBoard<BOARD_LEN> &full_board,
+                     const NodeRecord &node_record);
+
+  // Allocates edges to all children of the node which are not suicides, if the
+  // node has not been expanded, in descending order of their priors. Priors
+  // are the probabilities of the policy, indexed by position indexes of the
+  // board, if it is not nullptr, or else those of MovePrior. Returns false if
+  // the edge arena is exhausted.
+  bool Expand(const FullBoard<BOARD_LEN> &full_board, NodeRecord *node_record,
+              const std::vector<float> *policy = nullptr);
+  bool IsExpanded(const NodeRecord &node_record) const {
+    return node_record.IsExpanded(generation_);
+  }
+
+  // Starts a new generation, in which only records reachable from the root
+  // through child edges are kept, while all the others become replaceable.
+  // Returns the count of kept records. It should not be called when other
+  // threads are accessing the table.
+  std::size_t RetainSubtree(const FullBoard<BOARD_LEN> &root);
+
+  // Stores symmetric boards as one record, keyed by their canonical keys,
+  // whose edges are of the position indexes moved by the canonical symmetry
+  // of the board expanding it. It should be set while the table is empty.
+  // Boards searched should keep their symmetric keys, or the keys are
+  // computed from the board at each access.
+  void SetFoldsSymmetries(bool folds_symmetries) {
+    folds_symmetries_ = folds_symmetries;
+  }
+  // The symmetry moving position indexes of the board to those of edges of
+  // its record, which is the identity if symmetries are not folded.
+  int EdgeSymmetry(const FullBoard<BOARD_LEN> &full_board) const {
+    return folds_symmetries_ ? full_board.CanonicalSymmetry() :
+        IDENTITY_SYMMETRY;
+  }
+
+  bool FoldsSymmetries() const {
+    return folds_symmetries_;
+  }
+
+  std::size_t Capacity() const {
+    return capacity_;
+  }
+  TranspositionTableStats Stats() const;
+
+  // Calls visit(hash_key, node_record, is_expanded) for each readable record,
+  // whose edges are valid only if it is expanded in the current generation.
+  // The record of the zero key is visited by ZERO_KEY_SUBSTITUTE. It should
+  // not be called when other threads are accessing the table.
+  template<typename Visit>
+  void ForEachRecord(const Visit &visit) const {
+    for (std::size_t i = 0; i < capacity_; ++i) {
+      HashKey stored_key = buckets_[i / BUCKET_SIZE].keys[i % BUCKET_SIZE].load(
+          std::memory_order_relaxed);
+      if (stored_key == EMPTY_KEY || slots_[i].generation.load(
+          std::memory_order_relaxed) == BUSY_GENERATION) {
+        continue;
+      }
+      const NodeRecord &node_record = slots_[i].node_record;
+      visit(stored_key, node_record, node_record.IsExpanded(generation_));
+    }
+  }
 
  private:
-  std::unordered_map<HashKey, NodeRecord, StaySelfHasher> node_record_map_;
-  mutable std::mutex mutex_;
+  static const HashKey EMPTY_KEY = 0;
+  static const HashKey ZERO_KEY_SUBSTITUTE = 1;
+  static const int BUCKET_SIZE = util::CACHE_LINE_SIZE / sizeof(HashKey);
+  // The share of the memory budget for slots, and the rest is for edges.
+  static const int SLOT_MEMORY_DIVISOR = 8;
+  // The generation of a slot, whose record is not readable because it is empty
+  // or being written.
+  static const uint32_t BUSY_GENERATION = UINT32_MAX;
+
+  struct alignas(util::CACHE_LINE_SIZE) Bucket {
+    std::atomic<HashKey> keys[BUCKET_SIZE];
+  };
+
+  struct Slot {
+    std::atomic<uint32_t> generation;
+    NodeRecord node_record;
+
+    Slot() : generation(BUSY_GENERATION) {}
+  };
+
+  Bucket *buckets_;
+  Slot *slots_;
+  EdgeArena edge_arena_;
+  std::size_t capacity_;
+  std::size_t bucket_mask_;
+  uint32_t generation_ = 0;
+  bool folds_symmetries_ = false;
+  std::atomic<std::size_t> occupied_count_;
+  std::atomic<std::size_t> eviction_count_;
+  std::atomic<std::size_t> failed_insertion_count_;
+  std::atomic<std::size_t> failed_expansion_count_;
+  std::atomic<std::size_t> expansion_wait_nanoseconds_;
+
+  HashKey BoardKey(const FullBoard<BOARD_LEN> &full_board) const {
+    return folds_symmetries_ ? full_board.CanonicalHashKey() :
+        full_board.HashKey();
+  }
+  static HashKey StoredKey(HashKey hash_key) {
+    return hash_key == EMPTY_KEY ? ZERO_KEY_SUBSTITUTE : hash_key;
+  }
+  Bucket &GetBucket(HashKey stored_key) const {
+    return buckets_[stored_key & bucket_mask_];
+  }
+  Slot &GetSlot(HashKey stored_key, int key_index) const {
+    return slots_[(stored_key & bucket_mask_) * BUCKET_SIZE + key_index];
+  }
 
+  Slot *FindSlot(HashKey hash_key) const;
+  NodeRecord *WaitForRecord(HashKey stored_key, int key_index) const;
+  NodeRecord *WriteRecord(HashKey stored_key, int key_index,
+                          const NodeRecord &node_record);
   NodeRecord *Get(HashKey hash_key) const;
-  HashKey ChildHashKey(const FullBoard<BOARD_LEN> &full_board,
-                       PositionIndex position_index);
+  NodeRecord *Insert(HashKey hash_key, const NodeRecord &node_record);
+  void CompactEdges(std::vector<NodeRecord *> *expanded_node_records);
 };
 
+template<BoardLen BOARD_LEN>
+TranspositionTable<BOARD_LEN>::TranspositionTable(std::size_t memory_bytes,
+                                                  int numa_node)
+    : edge_arena_((memory_bytes - memory_bytes / SLOT_MEMORY_DIVISOR)
+          / sizeof(ChildEdge), numa_node),
+      occupied_count_(0),
+      eviction_count_(0),
+      failed_insertion_count_(0),
+      failed_expansion_count_(0),
+      expansion_wait_nanoseconds_(0) {
+  std::size_t bytes_per_bucket = sizeof(Bucket) + sizeof(Slot) * BUCKET_SIZE;
+  std::size_t bucket_count = 1;
+  while (bucket_count * 2 * bytes_per_bucket
+      <= memory_bytes / SLOT_MEMORY_DIVISOR) {
+    bucket_count *= 2;
+  }
+  capacity_ = bucket_count * BUCKET_SIZE;
+  bucket_mask_ = bucket_count - 1;
+
+  void *bucket_memory = util::AllocateAligned(
+      sizeof(Bucket) * bucket_count, util::CACHE_LINE_SIZE, numa_node);
+  void *slot_memory = util::AllocateAligned(
+      sizeof(Slot) * capacity_, util::CACHE_LINE_SIZE, numa_node);
+  if (bucket_memory == nullptr || slot_memory == nullptr) {
+    util::FreeAligned(bucket_memory);
+    util::FreeAligned(slot_memory);
+    throw std::bad_alloc();
+  }
+
+  buckets_ = static_cast<Bucket *>(bucket_memory);
+  for (std::size_t i = 0; i < bucket_count; ++i) {
+    for (int j = 0; j < BUCKET_SIZE; ++j) {
+      new (buckets_[i].keys + j) std::atomic<HashKey>(EMPTY_KEY);
+    }
+  }
+
+  slots_ = static_cast<Slot *>(slot_memory);
+  for (std::size_t i = 0; i < capacity_; ++i) {
+    new (slots_ + i) Slot;
+  }
+}
+
+template<BoardLen BOARD_LEN>
+TranspositionTable<BOARD_LEN>::~TranspositionTable() {
+  for (std::size_t i = 0; i < capacity_; ++i) {
+    slots_[i].~Slot();
+  }
+  util::FreeAligned(slots_);
+  util::FreeAligned(buckets_);
+}
+
 template<BoardLen BOARD_LEN>
 NodeRecord *TranspositionTable<BOARD_LEN>::Get(
     const FullBoard<BOARD_LEN> &full_board) const {
-  HashKey hash_key = full_board.HashKey();
-  return Get(hash_key);
+  return Get(BoardKey(full_board));
 }
 
 template<BoardLen BOARD_LEN>
 NodeRecord *TranspositionTable<BOARD_LEN>::GetChild(
     const FullBoard<BOARD_LEN> &full_board,
     PositionIndex position_index) {
-  HashKey hash_key = ChildHashKey(full_board, position_index);
-  return Get(hash_key);
+  NodeRecord *node_record_ptr = Get(full_board);
+  if (node_record_ptr != nullptr && node_record_ptr->IsExpanded(generation_)
+      && position_index >= 0) {
+    PositionIndex edge_index = SymmetricIndex<BOARD_LEN>(
+        EdgeSymmetry(full_board), position_index);
+    ChildEdge *edges = node_record_ptr->Edges();
+    for (int i = 0; i < node_record_ptr->EdgeCount(); ++i) {
+      if (edges[i].GetPositionIndex() == edge_index) {
+        return Get(edges[i].GetHashKey());
+      }
+    }
+  }
+
+  FullBoard<BOARD_LEN> child_node;
+  child_node.Copy(full_board);
+  Play(&child_node, position_index);
+  return Get(child_node);
 }
 
 template<BoardLen BOARD_LEN>
-void TranspositionTable<BOARD_LEN>::Insert(
+NodeRecord *TranspositionTable<BOARD_LEN>::Insert(
     const FullBoard<BOARD_LEN> &full_board,
     const NodeRecord &node_record) {
-  std::lock_guard<std::mutex> lock(mutex_);
-  if (node_record_map_.find(full_board.HashKey()) == node_record_map_.end()) {
-    node_record_map_.insert(std::make_pair(full_board.HashKey(), node_record));
+  return Insert(BoardKey(full_board), node_record);
+}
+
+template<BoardLen BOARD_LEN>
+bool TranspositionTable<BOARD_LEN>::Expand(
+    const FullBoard<BOARD_LEN> &full_board, NodeRecord *node_record,
+    const std::vector<float> *policy) {
+  if (node_record->IsExpanded(generation_)) {
+    return true;
+  }
+  if (!node_record->TryStartExpansion(generation_)) {
+    FOOLGO_TRACE_SCOPE("TranspositionTable::WaitForExpansion");
+    auto wait_start_time = std::chrono::steady_clock::now();
+    bool is_expanded = node_record->WaitForExpansion(generation_);
+    expansion_wait_nanoseconds_.fetch_add(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - wait_start_time).count(),
+        std::memory_order_relaxed);
+    return is_expanded;
   }
+
+  Force force = NextForce(full_board);
+  std::vector<PositionIndex> child_indexes;
+
+  for (PositionIndex index : full_board.PlayableIndexBitSet(force)) {
+    if (!full_board.IsSuicide(Move(force, index))) {
+      child_indexes.push_back(index);
+    }
+  }
+
+  ChildEdge *edges = edge_arena_.Allocate(child_indexes.size());
+  if (edges == nullptr) {
+    node_record->AbortExpansion();
+    failed_expansion_count_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  int symmetry = EdgeSymmetry(full_board);
+  for (int i = 0; i < child_indexes.size(); ++i) {
+    Move move(force, child_indexes.at(i));
+    edges[i] = ChildEdge(
+        SymmetricIndex<BOARD_LEN>(symmetry, move.position_index),
+        folds_symmetries_ ? full_board.ChildCanonicalHashKey(move) :
+            full_board.ChildHashKey(move),
+        policy == nullptr ? MovePrior(full_board, move) :
+            policy->at(move.position_index));
+  }
+  // Children of higher priors come first, which are searched first and kept
+  // by progressive widening.
+  std::stable_sort(edges, edges + child_indexes.size(),
+                   [](const ChildEdge &a, const ChildEdge &b) {
+                     return a.GetPrior() > b.GetPrior();
+                   });
+
+  node_record->FinishExpansion(generation_, edges, child_indexes.size());
+  return true;
+}
+
+template<BoardLen BOARD_LEN>
+std::size_t TranspositionTable<BOARD_LEN>::RetainSubtree(
+    const FullBoard<BOARD_LEN> &root) {
+  uint32_t previous_generation = generation_;
+  // Skips BUSY_GENERATION when wrapping around.
+  generation_ = (generation_ + 1) % BUSY_GENERATION;
+  std::vector<HashKey> keys_to_visit(1, BoardKey(root));
+  std::vector<NodeRecord *> expanded_node_records;
+  std::size_t retained_count = 0;
+
+  while (!keys_to_visit.empty()) {
+    HashKey hash_key = keys_to_visit.back();
+    keys_to_visit.pop_back();
+    HashKey stored_key = StoredKey(hash_key);
+    Bucket &bucket = GetBucket(stored_key);
+
+    for (int i = 0; i < BUCKET_SIZE; ++i) {
+      if (bucket.keys[i].load(std::memory_order_relaxed) != stored_key) {
+        continue;
+      }
+      Slot &slot = GetSlot(stored_key, i);
+      uint32_t generation = slot.generation.load(std::memory_order_relaxed);
+      if (generation == generation_ || generation == BUSY_GENERATION) {
+        break;
+      }
+
+      slot.generation.store(generation_, std::memory_order_relaxed);
+      ++retained_count;
+      NodeRecord &node_record = slot.node_record;
+      // Edges allocated before the previous generation have been overwritten.
+      if (node_record.IsExpanded(previous_generation)) {
+        expanded_node_records.push_back(&node_record);
+        for (int j = 0; j < node_record.EdgeCount(); ++j) {
+          keys_to_visit.push_back(node_record.Edges()[j].GetHashKey());
+        }
+      }
+      break;
+    }
+  }
+
+  CompactEdges(&expanded_node_records);
+  return retained_count;
+}
+
+template<BoardLen BOARD_LEN>
+TranspositionTableStats TranspositionTable<BOARD_LEN>::Stats() const {
+  TranspositionTableStats stats;
+  stats.capacity = capacity_;
+  stats.occupied_count = occupied_count_.load(std::memory_order_relaxed);
+  stats.eviction_count = eviction_count_.load(std::memory_order_relaxed);
+  stats.failed_insertion_count =
+      failed_insertion_count_.load(std::memory_order_relaxed);
+  stats.edge_capacity = edge_arena_.Capacity();
+  stats.edge_count = edge_arena_.Size();
+  stats.failed_expansion_count =
+      failed_expansion_count_.load(std::memory_order_relaxed);
+  stats.expansion_wait_nanoseconds =
+      expansion_wait_nanoseconds_.load(std::memory_order_relaxed);
+  return stats;
+}
+
+template<BoardLen BOARD_LEN>
+typename TranspositionTable<BOARD_LEN>::Slot *
+TranspositionTable<BOARD_LEN>::FindSlot(HashKey hash_key) const {
+  HashKey stored_key = StoredKey(hash_key);
+  Bucket &bucket = GetBucket(stored_key);
+
+  for (int i = 0; i < BUCKET_SIZE; ++i) {
+    if (bucket.keys[i].load(std::memory_order_acquire) != stored_key) {
+      continue;
+    }
+
+    Slot &slot = GetSlot(stored_key, i);
+    uint32_t generation = slot.generation.load(std::memory_order_acquire);
+    // A record which is being written is treated as absent, rather than
+    // waiting for its writer.
+    if (generation == BUSY_GENERATION) {
+      return nullptr;
+    }
+    // A record of an older generation is touched before it is read, which
+    // either keeps it from being replaced, or fails if it is being replaced.
+    if (generation != generation_ && !slot.generation.compare_exchange_strong(
+        generation, generation_, std::memory_order_acq_rel)
+        && generation != generation_) {
+      return nullptr;
+    }
+    // The record might have been replaced between reading the key and
+    // reading the generation.
+    return bucket.keys[i].load(std::memory_order_acquire) == stored_key ?
+        &slot : nullptr;
+  }
+
+  return nullptr;
+}
+
+template<BoardLen BOARD_LEN>
+NodeRecord *TranspositionTable<BOARD_LEN>::WaitForRecord(
+    HashKey stored_key, int key_index) const {
+  Slot &slot = GetSlot(stored_key, key_index);
+  while (slot.generation.load(std::memory_order_acquire) == BUSY_GENERATION) {
+    std::this_thread::yield();
+  }
+  return GetBucket(stored_key).keys[key_index].load(std::memory_order_acquire)
+      == stored_key ? &slot.node_record : nullptr;
+}
+
+template<BoardLen BOARD_LEN>
+NodeRecord *TranspositionTable<BOARD_LEN>::WriteRecord(
+    HashKey stored_key, int key_index, const NodeRecord &node_record) {
+  Slot &slot = GetSlot(stored_key, key_index);
+  slot.node_record = node_record;
+  slot.generation.store(generation_, std::memory_order_release);
+  return &slot.node_record;
 }
 
 template<BoardLen BOARD_LEN>
 NodeRecord *TranspositionTable<BOARD_LEN>::Get(HashKey hash_key) const {
-  mutex_.lock();
-  auto it = node_record_map_.find(hash_key);
-  mutex_.unlock();
-  NodeRecord *result;
-  if (it == node_record_map_.end()) {
-    result = nullptr;
-  } else {
-    result = const_cast<NodeRecord*>(&(it->second));
-  }
-  return result;
+  Slot *slot = FindSlot(hash_key);
+  return slot == nullptr ? nullptr : &slot->node_record;
 }
 
 template<BoardLen BOARD_LEN>
-HashKey TranspositionTable<BOARD_LEN>::ChildHashKey(
-    const FullBoard<BOARD_LEN> &full_board,
-    PositionIndex position_index) {
-  HashKey result;
-  NodeRecord *node_record_ptr = Get(full_board);
+NodeRecord *TranspositionTable<BOARD_LEN>::Insert(
+    HashKey hash_key, const NodeRecord &node_record) {
+  HashKey stored_key = StoredKey(hash_key);
+  Bucket &bucket = GetBucket(stored_key);
 
-  if (node_record_ptr == nullptr) {
-    NodeRecord node_record(0, 0.0f, false);
-    Insert(full_board, node_record);
-    node_record_ptr = Get(full_board);
+  for (int i = 0; i < BUCKET_SIZE; ++i) {
+    if (bucket.keys[i].load(std::memory_order_acquire) == stored_key) {
+      NodeRecord *result = WaitForRecord(stored_key, i);
+      if (result != nullptr) {
+        return result;
+      }
+    }
   }
 
-  const HashKey *hash_key_ptr = node_record_ptr->GetChildHashKeyPtr(
-      position_index);
-  if (hash_key_ptr == nullptr) {
-    FullBoard<BOARD_LEN> child_node;
-    child_node.Copy(full_board);
-    Play(&child_node, position_index);
-    node_record_ptr->InsertChildHashKey(position_index, child_node.HashKey());
-    result = child_node.HashKey();
-  } else {
-    result = *hash_key_ptr;
+  for (int i = 0; i < BUCKET_SIZE; ++i) {
+    HashKey slot_key = bucket.keys[i].load(std::memory_order_acquire);
+
+    if (slot_key == EMPTY_KEY) {
+      if (bucket.keys[i].compare_exchange_strong(slot_key, stored_key,
+                                                 std::memory_order_acq_rel)) {
+        occupied_count_.fetch_add(1, std::memory_order_relaxed);
+        return WriteRecord(stored_key, i, node_record);
+      }
+      // slot_key now holds the key of the thread which won this slot.
+    }
+
+    if (slot_key == stored_key) {
+      return WaitForRecord(stored_key, i);
+    }
+  }
+
+  // The bucket is full, so the least visited record of older generations is
+  // replaced. Two threads inserting the same key at once might both replace a
+  // record, leaving a duplicate which is never found and will be replaced
+  // later.
+  for (;;) {
+    int victim_index = -1;
+    uint32_t victim_generation = BUSY_GENERATION;
+    int32_t min_visited_time = INT32_MAX;
+
+    for (int i = 0; i < BUCKET_SIZE; ++i) {
+      Slot &slot = GetSlot(stored_key, i);
+      uint32_t generation = slot.generation.load(std::memory_order_acquire);
+      if (generation == generation_ || generation == BUSY_GENERATION) {
+        continue;
+      }
+      int32_t visited_time = slot.node_record.GetVisitedTime();
+      if (visited_time < min_visited_time) {
+        min_visited_time = visited_time;
+        victim_index = i;
+        victim_generation = generation;
+      }
+    }
+
+    if (victim_index == -1) {
+      failed_insertion_count_.fetch_add(1, std::memory_order_relaxed);
+      return nullptr;
+    }
+
+    Slot &victim = GetSlot(stored_key, victim_index);
+    if (victim.generation.compare_exchange_strong(victim_generation,
+                                                  BUSY_GENERATION,
+                                                  std::memory_order_acq_rel)) {
+      bucket.keys[victim_index].store(stored_key, std::memory_order_release);
+      eviction_count_.fetch_add(1, std::memory_order_relaxed);
+      return WriteRecord(stored_key, victim_index, node_record);
+    }
+  }
+}
+
+template<BoardLen BOARD_LEN>
+void TranspositionTable<BOARD_LEN>::CompactEdges(
+    std::vector<NodeRecord *> *expanded_node_records) {
+  // Edges are moved towards the front in order of their addresses, so no edge
+  // is overwritten before it is moved.
+  std::sort(expanded_node_records->begin(), expanded_node_records->end(),
+            [](const NodeRecord *a, const NodeRecord *b) {
+              return a->Edges() < b->Edges();
+            });
+  ChildEdge *edges = edge_arena_.Data();
+  std::size_t size = 0;
+
+  for (NodeRecord *node_record : *expanded_node_records) {
+    ChildEdge *old_edges = node_record->Edges();
+    int16_t edge_count = node_record->EdgeCount();
+    for (int i = 0; i < edge_count; ++i) {
+      edges[size + i] = old_edges[i];
+    }
+    node_record->FinishExpansion(generation_, edges + size, edge_count);
+    size += edge_count;
   }
 
-  return result;
+  edge_arena_.Resize(size);
 }
 
 }
@@ -2,279 +2,1168 @@
 
 #define FOOLGO_SRC_PLAYER_UCT_PLAYER_H_
 
+#include <algorithm>
+#include <array>
 #include <atomic>
-#include <boost/lexical_cast.hpp>
 #include <cassert>
+#include <chrono>
 #include <condition_variable>
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
-#include <future>
-#include <mutex>
+#include <functional>
+#include <limits>
 #include <memory>
+#include <string>
 #include <thread>
+#include <vector>
 
 #include "../board/force.h"
 #include "../board/full_board.h"
 #include "../board/position.h"
+#include "../deep_learning/evaluation_queue.h"
+#include "../def.h"
+#include "../game/batch_playout.h"
 #include "../game/monte_carlo_game.h"
+#include "../game/pattern_playout.h"
+#include "../util/rand.h"
+#include "../util/thread_pool.h"
+#include "../util/trace.h"
+#include "evaluation_cache.h"
 #include "node_record.h"
+#include "opening_book.h"
 #include "passable_player.h"
+#include "remote_search_client.h"
+#include "remote_search_protocol.h"
+#include "search_stats.h"
+#include "time_control.h"
 #include "transposition_table.h"
 
 namespace foolgo {
 
+enum class ParallelMode {
+  // Threads search one shared tree.
+  TREE,
+  // Each thread searches its own tree in its own table, sharing nothing, and
+  // visits of the root children are summed at the end.
+  ROOT
+};
+
 template<BoardLen BOARD_LEN>
 class UctPlayer : public PassablePlayer<BOARD_LEN> {
  public:
-  UctPlayer(uint32_t seed, int mc_game_count_per_move, int thread_count);
+  // Evaluates the board by the network, such as by submitting it to an
+  // EvaluationQueue and waiting for the future. It is called by search
+  // threads at the same time.
+  typedef std::function<Evaluation(const FullBoard<BOARD_LEN>&)>
+      NetworkEvaluator;
+
+  // In the root parallel mode, the memory is divided among tables of threads.
+  // A player of one thread and no affinity searches on the calling thread,
+  // and others create a pool. Threads of the pool are pinned by the affinity,
+  // and then the shared table is interleaved among NUMA nodes, while the
+  // table of each thread in the root parallel mode is placed on its node.
+  UctPlayer(uint32_t seed, int mc_game_count_per_move, int thread_count,
+            std::size_t table_memory_bytes =
+                TranspositionTable<BOARD_LEN>::DEFAULT_MEMORY_BYTES,
+            ParallelMode parallel_mode = ParallelMode::TREE,
+            util::ThreadAffinity thread_affinity = util::ThreadAffinity::NONE);
+
+  // Stats summed over all tables.
+  TranspositionTableStats TableStats() const;
+
+  void SetKomi(float komi) {
+    komi_ = komi;
+  }
+  void SetMcGameCountPerMove(int mc_game_count_per_move) {
+    mc_game_count_per_move_ = mc_game_count_per_move;
+  }
+  // Runs the count of playouts at once from each leaf, and backs their
+  // average up as that many visits. It is one by default. A larger count
+  // trades tree reuse for fewer descents and table accesses per playout, and
+  // works together with the threads searching the tree in parallel.
+  void SetLeafPlayoutCount(int leaf_playout_count) {
+    assert(leaf_playout_count > 0);
+    leaf_playout_count_ = leaf_playout_count;
+  }
+  // Runs the playouts of each leaf in lockstep, as the lanes of a
+  // BatchPlayout, when the leaf playout count is above one, no AMAF
+  // statistics are recorded and moves are drawn uniformly. Batch playouts
+  // play by simpler rules than FullBoard, and are scored by areas. It is off
+  // by default.
+  void SetBatchPlayout(bool uses_batch_playout) {
+    uses_batch_playout_ = uses_batch_playout;
+  }
+  // Blends AMAF (RAVE) profits of children into their UCT profits, with the
+  // weight sqrt(k / (3 * visited_time + k)) of the equivalence k, which is
+  // the visited time where both profits weigh the same. AMAF statistics are
+  // neither recorded nor used if k is zero, which is the default.
+  void SetRaveEquivalence(float rave_equivalence) {
+    assert(rave_equivalence >= 0.0f);
+    rave_equivalence_ = rave_equivalence;
+  }
+  // Considers only the children of the highest priors in each node, which
+  // are initially the count of them, and one more each time the visited time
+  // of the node grows by the factor: k more at count * factor^k visits.
+  // Every child is considered if the count is zero, which is the default.
+  void SetProgressiveWidening(int initial_child_count, float growth_factor) {
+    assert(initial_child_count >= 0 && growth_factor > 1.0f);
+    widening_initial_child_count_ = initial_child_count;
+    widening_log_growth_factor_ = std::log(growth_factor);
+  }
+  // Limits the length of random playouts, and ends them early once one
+  // force leads by the mercy threshold. Playouts run until the game ends by
+  // default. Moves are drawn by the pattern weights of the config if any.
+  void SetPlayoutConfig(const PlayoutConfig &playout_config) {
+    playout_config_ = playout_config;
+  }
+  // Searches by PUCT: children are chosen by the largest
+  // Q + c * P * sqrt(N) / (1 + n), where the priors P are the policy of the
+  // network, and unvisited children are valued as their parent. Leaves are
+  // evaluated by the value of the network, blended with random playouts by
+  // the weight of the value, so that no playout runs if it is one.
+  // Evaluations are cached by hash keys of boards, in a cache of the capacity
+  // apart from the tables. It should be set before the first search.
+  void SetNetworkEvaluator(const NetworkEvaluator &network_evaluator,
+                           std::size_t cache_capacity,
+                           float puct_constant = 1.5f,
+                           float value_weight = 1.0f) {
+    assert(puct_constant > 0.0f);
+    assert(value_weight >= 0.0f && value_weight <= 1.0f);
+    network_evaluator_ = network_evaluator;
+    evaluation_cache_.reset(new EvaluationCache(cache_capacity));
+    puct_constant_ = puct_constant;
+    value_weight_ = value_weight;
+  }
+  // Folds the 8 rotations and reflections of each board into one record of
+  // the tables, so that symmetric lines share statistics, which is mostly
+  // worthwhile early in a game. Searched boards keep the keys of all the
+  // symmetries, which costs hashing every move of the tree 8 times, while
+  // playouts hash as usual. It should be set before the first search.
+  void SetSymmetryFolding(bool folds_symmetries);
+  // Searches with threads of the pool, which may be shared by players of the
+  // process, instead of the pool created for this player, or on the calling
+  // thread if it is nullptr. Searches of players sharing a pool should not
+  // overlap. Tables are not moved to the NUMA nodes of workers of the pool.
+  void SetThreadPool(const std::shared_ptr<util::ThreadPool> &thread_pool);
+  // Searches each move for a share of the remaining time, which is reduced by
+  // the time of each move, while the playout count per move still caps the
+  // search. The search also stops early, once the most visited root child
+  // can not be overtaken at the current playout rate.
+  void SetTimeControl(const TimeControl &time_control) {
+    time_control_.reset(new TimeControl(time_control));
+  }
+  void ClearTimeControl() {
+    time_control_.reset();
+  }
+  // Stats of the search of the last move.
+  const SearchStats &LastSearchStats() const {
+    return last_search_stats_;
+  }
+  // Calls the sink with the stats after the search of each move.
+  void SetSearchStatsSink(const SearchStatsSink &search_stats_sink) {
+    search_stats_sink_ = search_stats_sink;
+  }
+  // Synchronizes the remaining time with an external clock.
+  void SetRemainingTime(TimeControl::Duration remaining_time) {
+    assert(time_control_ != nullptr);
+    time_control_->remaining_time = remaining_time;
+  }
+  // Searches each move on the worker too, which runs a SearchServer of the
+  // same board length, for the same playout count or think time as the local
+  // search and at the same time, and adds the visits of its root children to
+  // those of the local tables. A worker failing to respond is left out of
+  // the move.
+  void AddRemoteWorker(const std::string &host, uint16_t port);
+  // Searches the board until the flag is set, by neither the playout count
+  // nor the time control, so that the search of the next move reuses the
+  // tree, which is pondering when the board is of the opponent to move. It
+  // blocks until the search stops, so it is called by another thread, and
+  // no other method of the player should be called meanwhile. Stats of the
+  // last move are not changed.
+  void Ponder(const FullBoard<BOARD_LEN> &full_board,
+              std::atomic<bool> *is_stopped_ptr);
+  // Statistics of the children of the board summed over the tables, in the
+  // order of position indexes.
+  std::vector<RootChildStat> RootChildStats(
+      const FullBoard<BOARD_LEN> &full_board) const;
+  // Consults the book at each move: the most visited book child is played
+  // without searching if the entry of the board has at least the instant
+  // visited time, which is never if it is zero, or else the root and its
+  // book children start from the visits of the entry, unless the root has
+  // been searched.
+  void SetOpeningBook(const std::shared_ptr<const OpeningBook> &opening_book,
+                      int32_t instant_visited_time = 0) {
+    opening_book_ = opening_book;
+    book_instant_visited_time_ = instant_visited_time;
+  }
+  // Adds the expanded records of the tables of at least the visited time,
+  // which are of the last search and the subtrees retained by it, to the
+  // writer, which should fold symmetries as the player does.
+  void AddToOpeningBook(int32_t min_visited_time,
+                        OpeningBookWriter *writer) const;
 
  protected:
   PositionIndex NextMoveWithPlayableBoard(
       const FullBoard<BOARD_LEN> &full_board);
 
  private:
-  int mc_game_count_per_move_;
-  TranspositionTable<BOARD_LEN> transposition_table_;
   uint32_t seed_;
+  int mc_game_count_per_move_;
+  // The count of search tasks in each move.
   int thread_count_;
-  mutable std::mutex mutex_;
+  ParallelMode parallel_mode_;
+  // One table shared by all threads, or one table per thread.
+  std::vector<std::unique_ptr<TranspositionTable<BOARD_LEN>>>
+      transposition_tables_;
+  float komi_ = DEFAULT_KOMI;
+  int leaf_playout_count_ = 1;
+  bool uses_batch_playout_ = false;
+  float rave_equivalence_ = 0.0f;
+  bool folds_symmetries_ = false;
+  PlayoutConfig playout_config_;
+  int widening_initial_child_count_ = 0;
+  float widening_log_growth_factor_ = 0.0f;
+  // Empty unless searching by PUCT.
+  NetworkEvaluator network_evaluator_;
+  std::unique_ptr<EvaluationCache> evaluation_cache_;
+  float puct_constant_ = 0.0f;
+  float value_weight_ = 1.0f;
+  // Null if searches run on the calling thread, which is worker 0.
+  std::shared_ptr<util::ThreadPool> thread_pool_;
+  // One generator per worker of the pool, seeded by the worker index as
+  // stream.
+  std::vector<RandomEngine> random_engines_;
+  // Null if the search is not timed.
+  std::unique_ptr<TimeControl> time_control_;
+  // Times of the current search, which are set before it starts.
+  std::chrono::steady_clock::time_point search_start_time_;
+  std::chrono::steady_clock::time_point min_search_end_time_;
+  std::chrono::steady_clock::time_point search_end_time_;
+  SearchStats last_search_stats_;
+  SearchStatsSink search_stats_sink_;
+  // Null if there is no remote worker.
+  std::unique_ptr<RemoteSearchClient<BOARD_LEN>> remote_search_client_;
+  // Null if there is no book.
+  std::shared_ptr<const OpeningBook> opening_book_;
+  int32_t book_instant_visited_time_ = 0;
+
+  // Whether the current search stops by the time control.
+  bool is_search_timed_ = false;
+
+  // Descents between two readings of the clock.
+  static const int TIME_CHECK_INTERVAL = 16;
 
   //std::shared_ptr<spdlog::logger> logger_;
 
+  int WorkerCount() const {
+    return thread_pool_ == nullptr ? 1 : thread_pool_->ThreadCount();
+  }
+  // Runs the search tasks of a move until the playout count is reached or
+  // the flag is set, and waits for them.
+  void RunSearchTasks(const FullBoard<BOARD_LEN> &full_board,
+                      int mc_game_count, std::atomic<bool> *is_end_ptr,
+                      std::vector<SearchStats> *task_stats,
+                      std::vector<int> *task_worker_indexes);
+  // Searches until the count reaches the limit, and counts into the stats of
+  // the task. The count is private to the task if mc_game_count_ptr is
+  // nullptr.
   void SearchAndModifyNodes(const FullBoard<BOARD_LEN> &full_board,
+                            TranspositionTable<BOARD_LEN> *transposition_table,
                             std::atomic<int> *mc_game_count_ptr,
+                            int mc_game_count_limit,
                             std::atomic<bool> *is_end_ptr,
-                            int thread_index);
-  PositionIndex MaxUcbChild(
-      const FullBoard<BOARD_LEN> &full_board,
-      int thread_index);
-  float ModifyAverageProfitAndReturnNewProfit(
+                            int worker_index,
+                            SearchStats *search_stats);
+  // The average profit of visits backed up by one descent.
+  struct ProfitUpdate {
+    float average_profit;
+    int32_t visited_time;
+  };
+
+  // Playouts below the current node of a descent, counted for each point by
+  // the force playing it first.
+  struct AmafStatistics {
+    std::array<std::array<int32_t, BoardLenSquare<BOARD_LEN>()>, 2>
+        visited_times;
+    std::array<std::array<float, BoardLenSquare<BOARD_LEN>()>, 2> profit_sums;
+
+    void Clear() {
+      for (int i = 0; i < 2; ++i) {
+        visited_times[i].fill(0);
+        profit_sums[i].fill(0.0f);
+      }
+    }
+    void AddPlayout(const FirstMovePoints<BOARD_LEN> &first_move_points,
+                    float black_profit) {
+      for (int i = 0; i < 2; ++i) {
+        float profit = i == BLACK_FORCE ? black_profit : 1.0f - black_profit;
+        for (PositionIndex index : first_move_points[i]) {
+          ++visited_times[i][index];
+          profit_sums[i][index] += profit;
+        }
+      }
+    }
+    // Counts the move as the first one at the point in all the playouts, and
+    // the update is of the force.
+    void AddTreeMove(Force force, PositionIndex index,
+                     const ProfitUpdate &update) {
+      visited_times[force][index] = update.visited_time;
+      profit_sums[force][index] = update.average_profit * update.visited_time;
+      visited_times[OppositeForce(force)][index] = 0;
+      profit_sums[OppositeForce(force)][index] = 0.0f;
+    }
+  };
+
+  bool IsTimeUp(const FullBoard<BOARD_LEN> &root,
+                const TranspositionTable<BOARD_LEN> &transposition_table,
+                int mc_game_count) const;
+  // The count of children of the highest priors considered in the node.
+  int WidenedChildCount(const NodeRecord &node_record) const;
+  ChildEdge *MaxUcbChild(const NodeRecord &node_record);
+  ChildEdge *MaxPuctChild(const NodeRecord &node_record, int edge_count) const;
+  // Evaluates by the network, unless the board is in the cache.
+  void EvaluateByNetwork(const FullBoard<BOARD_LEN> &full_board,
+                         Evaluation *evaluation, SearchStats *search_stats);
+  // Adds the AMAF statistics of the descent, including the move of the node,
+  // to the children of the node, whose edges are moved by the symmetry.
+  void ModifyRaveProfits(const NodeRecord &node_record, int edge_symmetry,
+                         Force force, PositionIndex position_index,
+                         const ProfitUpdate &child_update,
+                         AmafStatistics *amaf_statistics);
+  // Records AMAF statistics in amaf_statistics, unless it is nullptr. Leaf
+  // playouts run on batch_playout unless it is nullptr. The depth is the
+  // count of moves from the root to the node.
+  ProfitUpdate ModifyAverageProfitAndReturnNewProfit(
+      TranspositionTable<BOARD_LEN> *transposition_table,
       FullBoard<BOARD_LEN> *full_board_ptr,
       std::atomic<int> *mc_game_count_ptr,
-      int thread_index);
-  PositionIndex BestChild(const FullBoard<BOARD_LEN> &full_board);
-  void LogProfits(const FullBoard<BOARD_LEN> &full_board);
+      FullBoard<BOARD_LEN> *playout_board_ptr,
+      BatchPlayout<BOARD_LEN> *batch_playout,
+      RandomEngine *random_engine,
+      AmafStatistics *amaf_statistics,
+      int depth,
+      SearchStats *search_stats);
+  static bool IsBookIndex(PositionIndex index) {
+    return index >= 0 && index < BoardLenSquare<BOARD_LEN>();
+  }
+  // The most visited child of the book entry of the board, if it is played
+  // without searching, or else POSITION_INDEX_PASS.
+  PositionIndex InstantBookMove(const FullBoard<BOARD_LEN> &full_board) const;
+  // Inserts and expands the root of the table by the book entry, if the table
+  // has no record of it.
+  void SeedRootFromBook(const FullBoard<BOARD_LEN> &full_board,
+                        const OpeningBookEntry &entry,
+                        TranspositionTable<BOARD_LEN> *transposition_table);
+  // The most visited child, with visits of the responses of remote workers
+  // added.
+  PositionIndex BestChild(const FullBoard<BOARD_LEN> &full_board,
+                          const std::vector<SearchResponse> &remote_responses);
 };
 
 namespace {
 
-float Ucb(const NodeRecord &node_record, int visited_count_sum) {
-  assert(node_record.GetVisitedTime() > 0);
-  return node_record.GetAverageProfit()
-      + sqrt(2 * log(visited_count_sum) / node_record.GetVisitedTime());
+float Ucb(const ChildEdge &child_edge, int visited_count_sum,
+          float rave_equivalence) {
+  int32_t visited_time = child_edge.GetVisitedTimeWithVirtualLoss();
+  assert(visited_time > 0);
+  float profit = child_edge.GetAverageProfitWithVirtualLoss();
+  if (rave_equivalence > 0.0f && child_edge.GetRaveVisitedTime() > 0) {
+    float beta = sqrt(rave_equivalence
+        / (3 * visited_time + rave_equivalence));
+    profit = (1 - beta) * profit + beta * child_edge.GetRaveAverageProfit();
+  }
+  return profit + sqrt(2 * log(visited_count_sum) / visited_time);
+}
+
+// Adds the AMAF playouts of the force to the children of the node, which are
+// counted for each point of the board, to whose positions the edges are
+// moved by the symmetry.
+template<BoardLen BOARD_LEN>
+void AddRaveProfits(
+    const std::array<int32_t, BoardLenSquare<BOARD_LEN>()> &visited_times,
+    const std::array<float, BoardLenSquare<BOARD_LEN>()> &profit_sums,
+    int edge_symmetry, const NodeRecord &node_record) {
+  ChildEdge *edges = node_record.Edges();
+  int board_symmetry = InverseSymmetry(edge_symmetry);
+
+  for (int i = 0; i < node_record.EdgeCount(); ++i) {
+    PositionIndex index = SymmetricIndex<BOARD_LEN>(
+        board_symmetry, edges[i].GetPositionIndex());
+    if (visited_times[index] > 0) {
+      edges[i].AddRaveProfit(profit_sums[index], visited_times[index]);
+    }
+  }
+}
+
+// Returns 1 if the force wins by the lead of black in points, 0 if it loses,
+// and 0.5 for a draw.
+inline float GetWinningProfit(int black_lead, Force force, float komi) {
+  float black_score = black_lead - komi;
+  float score = force == Force::BLACK_FORCE ? black_score : -black_score;
+  return score > 0 ? 1.0f : (score < 0 ? 0.0f : 0.5f);
 }
 
+// Scores the ended playout, whose areas are approximated by regions, which
+// are nearly exact at the end of a random playout, where empty points are
+// almost all real eyes.
 template<BoardLen BOARD_LEN>
-float GetRegionRatio(const FullBoard<BOARD_LEN> &full_board,
-                Force force) {
-  int black_region = full_board.BlackRegion();
-  float black_ratio = static_cast<float>(black_region)
-      / BoardLenSquare<BOARD_LEN>();
-  return force == Force::BLACK_FORCE ? black_ratio : 1 - black_ratio;
+float GetWinningProfit(const FullBoard<BOARD_LEN> &full_board, Force force,
+                       float komi) {
+  return GetWinningProfit(full_board.Region(Force::BLACK_FORCE)
+      - full_board.Region(Force::WHITE_FORCE), force, komi);
 }
 
 }
 
 template<BoardLen BOARD_LEN>
 UctPlayer<BOARD_LEN>::UctPlayer(uint32_t seed, int mc_game_count_per_move,
-                                int thread_count)
+                                int thread_count,
+                                std::size_t table_memory_bytes,
+                                ParallelMode parallel_mode,
+                                util::ThreadAffinity thread_affinity)
     : seed_(seed),
       mc_game_count_per_move_(mc_game_count_per_move),
-      thread_count_(thread_count) {}
+      thread_count_(thread_count),
+      parallel_mode_(parallel_mode) {
+  SetThreadPool(thread_count_ > 1
+      || thread_affinity != util::ThreadAffinity::NONE ?
+          std::make_shared<util::ThreadPool>(thread_count_, thread_affinity) :
+          nullptr);
+
+  int table_count = parallel_mode_ == ParallelMode::ROOT ? thread_count_ : 1;
+  transposition_tables_.reserve(table_count);
+  for (int i = 0; i < table_count; ++i) {
+    int numa_node = util::ANY_NUMA_NODE;
+    if (thread_affinity != util::ThreadAffinity::NONE
+        && util::NumaNodeCount() > 1) {
+      numa_node = parallel_mode_ == ParallelMode::ROOT ?
+          thread_pool_->WorkerNumaNode(i) : util::INTERLEAVED_NUMA_NODES;
+    }
+    transposition_tables_.push_back(
+        std::unique_ptr<TranspositionTable<BOARD_LEN>>(
+            new TranspositionTable<BOARD_LEN>(
+                table_memory_bytes / table_count, numa_node)));
+  }
+}
+
+template<BoardLen BOARD_LEN>
+void UctPlayer<BOARD_LEN>::SetThreadPool(
+    const std::shared_ptr<util::ThreadPool> &thread_pool) {
+  thread_pool_ = thread_pool;
+  random_engines_.clear();
+  random_engines_.reserve(WorkerCount());
+  for (int i = 0; i < WorkerCount(); ++i) {
+    random_engines_.push_back(RandomEngine(seed_, i));
+  }
+}
+
+template<BoardLen BOARD_LEN>
+void UctPlayer<BOARD_LEN>::SetSymmetryFolding(bool folds_symmetries) {
+  folds_symmetries_ = folds_symmetries;
+  for (auto &transposition_table : transposition_tables_) {
+    transposition_table->SetFoldsSymmetries(folds_symmetries);
+  }
+}
+
+template<BoardLen BOARD_LEN>
+TranspositionTableStats UctPlayer<BOARD_LEN>::TableStats() const {
+  TranspositionTableStats stats = transposition_tables_[0]->Stats();
+
+  for (std::size_t i = 1; i < transposition_tables_.size(); ++i) {
+    TranspositionTableStats table_stats = transposition_tables_[i]->Stats();
+    stats.capacity += table_stats.capacity;
+    stats.occupied_count += table_stats.occupied_count;
+    stats.eviction_count += table_stats.eviction_count;
+    stats.failed_insertion_count += table_stats.failed_insertion_count;
+    stats.edge_capacity += table_stats.edge_capacity;
+    stats.edge_count += table_stats.edge_count;
+    stats.failed_expansion_count += table_stats.failed_expansion_count;
+    stats.expansion_wait_nanoseconds += table_stats.expansion_wait_nanoseconds;
+  }
+
+  return stats;
+}
 
 template<BoardLen BOARD_LEN>
 PositionIndex UctPlayer<BOARD_LEN>::NextMoveWithPlayableBoard(
       const FullBoard<BOARD_LEN> &full_board) {
-  std::atomic<int> current_mc_game_count(0);
   std::atomic<bool> is_end(false);
-  std::vector<std::future<void>> futures;
+  auto start_time = std::chrono::steady_clock::now();
+  TranspositionTableStats start_table_stats = TableStats();
+  // Stats of each task, and the worker running it.
+  std::vector<SearchStats> task_stats(thread_count_);
+  std::vector<int> task_worker_indexes(thread_count_);
+
+  PositionIndex book_index = InstantBookMove(full_board);
+  if (book_index != POSITION_INDEX_PASS) {
+    last_search_stats_ = SearchStats();
+    last_search_stats_.wall_seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start_time).count();
+    if (search_stats_sink_) {
+      search_stats_sink_(last_search_stats_);
+    }
+    return book_index;
+  }
+
+  // Statistics under the moves played since the last search are kept, while
+  // all the other records become unreachable and replaceable.
+  const OpeningBookEntry *book_entry = opening_book_ == nullptr ? nullptr :
+      opening_book_->Find(full_board);
+  for (auto &transposition_table : transposition_tables_) {
+    transposition_table->RetainSubtree(full_board);
+    if (book_entry != nullptr) {
+      SeedRootFromBook(full_board, *book_entry, transposition_table.get());
+    }
+  }
 
 //  SearchAndModifyNodes(full_board, &current_mc_game_count, &is_end);
 
+  if (time_control_ != nullptr) {
+    TimeControl::Duration think_time = ThinkTime(*time_control_, full_board);
+    search_start_time_ = std::chrono::steady_clock::now();
+    min_search_end_time_ = search_start_time_
+        + std::min(think_time, time_control_->min_think_time);
+    search_end_time_ = search_start_time_ + think_time;
+  }
+
+  // Workers search meanwhile, and are waited for after the local search.
+  bool is_remote_searching = remote_search_client_ != nullptr
+      && remote_search_client_->StartSearch(
+          full_board, komi_, mc_game_count_per_move_,
+          time_control_ == nullptr ? 0 :
+              std::chrono::duration_cast<std::chrono::milliseconds>(
+                  search_end_time_ - search_start_time_).count());
+
+  is_search_timed_ = time_control_ != nullptr;
+  RunSearchTasks(full_board, mc_game_count_per_move_, &is_end, &task_stats,
+                 &task_worker_indexes);
+
+  std::vector<SearchResponse> remote_responses;
+  if (is_remote_searching) {
+    remote_responses = remote_search_client_->FinishSearch();
+  }
+
+  if (time_control_ != nullptr) {
+    auto elapsed_time = std::chrono::duration_cast<TimeControl::Duration>(
+        std::chrono::steady_clock::now() - search_start_time_);
+    time_control_->remaining_time = std::max(
+        time_control_->remaining_time - elapsed_time,
+        TimeControl::Duration(0));
+  }
+
+  TranspositionTableStats end_table_stats = TableStats();
+  last_search_stats_ = SearchStats();
+  last_search_stats_.thread_playout_counts.resize(WorkerCount(), 0);
+  for (int i = 0; i < thread_count_; ++i) {
+    last_search_stats_.Add(task_stats[i]);
+    last_search_stats_.thread_playout_counts[task_worker_indexes[i]] +=
+        task_stats[i].playout_count;
+  }
+  last_search_stats_.wall_seconds = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start_time).count();
+  last_search_stats_.table_collision_count =
+      end_table_stats.eviction_count - start_table_stats.eviction_count
+      + end_table_stats.failed_insertion_count
+      - start_table_stats.failed_insertion_count;
+  last_search_stats_.lock_wait_seconds = 1e-9 * (
+      end_table_stats.expansion_wait_nanoseconds
+      - start_table_stats.expansion_wait_nanoseconds);
+  for (const SearchResponse &response : remote_responses) {
+    last_search_stats_.remote_playout_count += response.playout_count;
+  }
+  FOOLGO_TRACE_COUNTER("UctPlayer::Playouts",
+                       last_search_stats_.playout_count);
+  if (search_stats_sink_) {
+    search_stats_sink_(last_search_stats_);
+  }
+
+  return BestChild(full_board, remote_responses);
+}
+
+template<BoardLen BOARD_LEN>
+void UctPlayer<BOARD_LEN>::AddToOpeningBook(int32_t min_visited_time,
+                                            OpeningBookWriter *writer) const {
+  assert(writer->FoldsSymmetries() == folds_symmetries_);
+  for (const auto &transposition_table : transposition_tables_) {
+    transposition_table->ForEachRecord(
+        [=](HashKey hash_key, const NodeRecord &node_record,
+            bool is_expanded) {
+          if (is_expanded && node_record.GetVisitedTime() >= min_visited_time) {
+            OpeningBookEntry entry;
+            FillOpeningBookEntry(hash_key, node_record, &entry);
+            writer->Add(entry);
+          }
+        });
+  }
+}
+
+template<BoardLen BOARD_LEN>
+PositionIndex UctPlayer<BOARD_LEN>::InstantBookMove(
+    const FullBoard<BOARD_LEN> &full_board) const {
+  if (opening_book_ == nullptr || book_instant_visited_time_ <= 0) {
+    return POSITION_INDEX_PASS;
+  }
+  const OpeningBookEntry *entry = opening_book_->Find(full_board);
+  if (entry == nullptr || entry->visited_time < book_instant_visited_time_
+      || entry->children[0].visited_time == 0 || !IsBookIndex(
+          entry->children[0].position_index)) {
+    return POSITION_INDEX_PASS;
+  }
+  PositionIndex index = opening_book_->BoardIndex(
+      full_board, entry->children[0].position_index);
+  // Checked against a collision of keys.
+  if (!full_board.PlayableIndexBitSet(NextForce(full_board))[index]
+      || full_board.IsSuicide(Move(NextForce(full_board), index))) {
+    return POSITION_INDEX_PASS;
+  }
+  return index;
+}
+
+template<BoardLen BOARD_LEN>
+void UctPlayer<BOARD_LEN>::SeedRootFromBook(
+    const FullBoard<BOARD_LEN> &full_board, const OpeningBookEntry &entry,
+    TranspositionTable<BOARD_LEN> *transposition_table) {
+  if (transposition_table->Get(full_board) != nullptr) {
+    return;
+  }
+  NodeRecord *node_record = transposition_table->Insert(
+      full_board, NodeRecord(entry.visited_time, entry.average_profit));
+  Evaluation evaluation;
+  const std::vector<float> *policy = nullptr;
+  if (network_evaluator_) {
+    SearchStats search_stats;
+    EvaluateByNetwork(full_board, &evaluation, &search_stats);
+    policy = &evaluation.policy;
+  }
+  if (node_record == nullptr
+      || !transposition_table->Expand(full_board, node_record, policy)) {
+    return;
+  }
+
+  int edge_symmetry = transposition_table->EdgeSymmetry(full_board);
+  ChildEdge *edges = node_record->Edges();
+  for (const OpeningBookChild &child : entry.children) {
+    if (child.visited_time == 0 || !IsBookIndex(child.position_index)) {
+      continue;
+    }
+    PositionIndex edge_index = SymmetricIndex<BOARD_LEN>(
+        edge_symmetry, opening_book_->BoardIndex(full_board,
+                                                 child.position_index));
+    for (int i = 0; i < node_record->EdgeCount(); ++i) {
+      if (edges[i].GetPositionIndex() == edge_index) {
+        edges[i].AddProfit(child.average_profit, child.visited_time);
+        break;
+      }
+    }
+  }
+}
+
+template<BoardLen BOARD_LEN>
+void UctPlayer<BOARD_LEN>::RunSearchTasks(
+    const FullBoard<BOARD_LEN> &full_board, int mc_game_count,
+    std::atomic<bool> *is_end_ptr, std::vector<SearchStats> *task_stats,
+    std::vector<int> *task_worker_indexes) {
+  std::atomic<int> current_mc_game_count(0);
+
+  // Tasks of the tree parallel mode share the count, so they stop together
+  // once it reaches the limit, and tasks not yet started return at once.
   for (int i=0; i<thread_count_; ++i) {
-    auto f = std::async(std::launch::async,
-                        &UctPlayer<BOARD_LEN>::SearchAndModifyNodes, this,
-                        std::ref(full_board),
-                        &current_mc_game_count,
-                        &is_end,
-                        i);
-    futures.push_back(std::move(f));
+    TranspositionTable<BOARD_LEN> *transposition_table;
+    std::atomic<int> *mc_game_count_ptr;
+    int mc_game_count_limit;
+    if (parallel_mode_ == ParallelMode::ROOT) {
+      // The playouts are divided among tables in advance, and each task
+      // searches its own table, even if it is stolen by a worker which has
+      // run another task.
+      transposition_table = transposition_tables_[i].get();
+      mc_game_count_ptr = nullptr;
+      mc_game_count_limit = mc_game_count / thread_count_
+          + (i < mc_game_count % thread_count_ ? 1 : 0);
+    } else {
+      transposition_table = transposition_tables_[0].get();
+      mc_game_count_ptr = &current_mc_game_count;
+      mc_game_count_limit = mc_game_count;
+    }
+    SearchStats *search_stats = &(*task_stats)[i];
+    int *task_worker_index = &(*task_worker_indexes)[i];
+    util::ThreadPool::Task task = [=, &full_board](int worker_index) {
+      *task_worker_index = worker_index;
+      SearchAndModifyNodes(full_board, transposition_table, mc_game_count_ptr,
+                           mc_game_count_limit, is_end_ptr, worker_index,
+                           search_stats);
+    };
+    if (thread_pool_ == nullptr) {
+      task(0);
+    } else {
+      // Task i starts on worker i, whose NUMA node has table i if the
+      // workers of the player's pool are pinned.
+      thread_pool_->Submit(i % thread_pool_->ThreadCount(), task);
+    }
+  }
+
+  if (thread_pool_ != nullptr) {
+    thread_pool_->Wait();
   }
+}
 
-  for (std::future<void> &future : futures) {
-    future.wait();
+template<BoardLen BOARD_LEN>
+void UctPlayer<BOARD_LEN>::Ponder(const FullBoard<BOARD_LEN> &full_board,
+                                  std::atomic<bool> *is_stopped_ptr) {
+  if (full_board.PlayableIndexBitSet(NextForce(full_board)).none()) {
+    return;
   }
 
-  LogProfits(full_board);
+  for (auto &transposition_table : transposition_tables_) {
+    transposition_table->RetainSubtree(full_board);
+  }
 
-  return BestChild(full_board);
+  std::vector<SearchStats> task_stats(thread_count_);
+  std::vector<int> task_worker_indexes(thread_count_);
+  is_search_timed_ = false;
+  RunSearchTasks(full_board, std::numeric_limits<int>::max(), is_stopped_ptr,
+                 &task_stats, &task_worker_indexes);
 }
 
 template<BoardLen BOARD_LEN>
 void UctPlayer<BOARD_LEN>::SearchAndModifyNodes(
     const FullBoard<BOARD_LEN> &full_board,
+    TranspositionTable<BOARD_LEN> *transposition_table,
     std::atomic<int> *mc_game_count_ptr,
+    int mc_game_count_limit,
     std::atomic<bool> *is_end_ptr,
-    int thread_index) {
-  while (*mc_game_count_ptr < mc_game_count_per_move_) {
-    PositionIndex max_ucb_index = MaxUcbChild(full_board, thread_index);
-    FullBoard<BOARD_LEN> max_ucb_child;
-    max_ucb_child.Copy(full_board);
-    Play(&max_ucb_child, max_ucb_index);
-    ModifyAverageProfitAndReturnNewProfit(&max_ucb_child, mc_game_count_ptr,
-                                          thread_index);
+    int worker_index,
+    SearchStats *search_stats) {
+  // Boards reused by all searches of this task. Every descent from the root
+  // is undone on the way back, so the root is copied only once.
+  FullBoard<BOARD_LEN> root;
+  FullBoard<BOARD_LEN> playout_board;
+  RandomEngine *random_engine = &random_engines_.at(worker_index);
+  std::unique_ptr<AmafStatistics> amaf_statistics(
+      rave_equivalence_ > 0.0f ? new AmafStatistics : nullptr);
+  std::unique_ptr<BatchPlayout<BOARD_LEN>> batch_playout(
+      uses_batch_playout_ && leaf_playout_count_ > 1
+          && amaf_statistics == nullptr
+          && playout_config_.pattern_weights == nullptr ?
+      new BatchPlayout<BOARD_LEN>(leaf_playout_count_) : nullptr);
+  std::atomic<int> private_mc_game_count(0);
+  if (mc_game_count_ptr == nullptr) {
+    mc_game_count_ptr = &private_mc_game_count;
+  }
+  root.SetKeepsSymmetricHashKeys(folds_symmetries_);
+  root.Copy(full_board);
+
+  int descent_count = 0;
+
+  while (*mc_game_count_ptr < mc_game_count_limit && !*is_end_ptr) {
+    FOOLGO_TRACE_SCOPE("UctPlayer::Descent");
+    ModifyAverageProfitAndReturnNewProfit(transposition_table, &root,
+                                          mc_game_count_ptr, &playout_board,
+                                          batch_playout.get(), random_engine,
+                                          amaf_statistics.get(), 0,
+                                          search_stats);
+    if (is_search_timed_ && ++descent_count % TIME_CHECK_INTERVAL == 0
+        && IsTimeUp(root, *transposition_table, *mc_game_count_ptr)) {
+      // Tasks of the root parallel mode decide for their own tables.
+      if (parallel_mode_ == ParallelMode::TREE) {
+        *is_end_ptr = true;
+      }
+      break;
+    }
   }
 }
 
 template<BoardLen BOARD_LEN>
-PositionIndex UctPlayer<BOARD_LEN>::MaxUcbChild(
-    const FullBoard<BOARD_LEN> &full_board,
-    int thread_index) {
-  std::lock_guard<std::mutex> lock(mutex_);
+bool UctPlayer<BOARD_LEN>::IsTimeUp(
+    const FullBoard<BOARD_LEN> &root,
+    const TranspositionTable<BOARD_LEN> &transposition_table,
+    int mc_game_count) const {
+  auto now = std::chrono::steady_clock::now();
+  if (now >= search_end_time_) {
+    return true;
+  }
+  if (now < min_search_end_time_) {
+    return false;
+  }
 
-  Force current_force = NextForce(full_board);
-  auto playable_index_vector = full_board.PlayableIndexes(current_force);
+  // The edges are read only once published in this generation, as the
+  // descent does, since another thread may be expanding the root.
+  const NodeRecord *node_record = transposition_table.Get(root);
+  if (node_record == nullptr || !transposition_table.IsExpanded(*node_record)) {
+    return false;
+  }
+  int32_t max_visited_time = 0, second_visited_time = 0;
+  ChildEdge *edges = node_record->Edges();
+  for (int i = 0; i < node_record->EdgeCount(); ++i) {
+    int32_t visited_time = edges[i].GetVisitedTime();
+    if (visited_time > max_visited_time) {
+      second_visited_time = max_visited_time;
+      max_visited_time = visited_time;
+    } else if (visited_time > second_visited_time) {
+      second_visited_time = visited_time;
+    }
+  }
 
-  assert(!playable_index_vector.empty());
+  // Playouts expected in the time left, at the rate so far.
+  double elapsed_time = std::chrono::duration<double>(
+      now - search_start_time_).count();
+  double left_time = std::chrono::duration<double>(
+      search_end_time_ - now).count();
+  double expected_count = mc_game_count * left_time / elapsed_time;
+  return max_visited_time - second_visited_time > expected_count;
+}
 
-  int visited_count_sum = 0;
-  std::vector<PositionIndex> null_indexes;
+template<BoardLen BOARD_LEN>
+void UctPlayer<BOARD_LEN>::ModifyRaveProfits(const NodeRecord &node_record,
+                                             int edge_symmetry, Force force,
+                                             PositionIndex position_index,
+                                             const ProfitUpdate &child_update,
+                                             AmafStatistics *amaf_statistics) {
+  amaf_statistics->AddTreeMove(force, position_index, child_update);
+  AddRaveProfits<BOARD_LEN>(amaf_statistics->visited_times[force],
+                            amaf_statistics->profit_sums[force], edge_symmetry,
+                            node_record);
+}
 
-  for (PositionIndex position_index : playable_index_vector) {
-    const NodeRecord *node_record_ptr = transposition_table_.GetChild(
-        full_board, position_index);
-    if (node_record_ptr == nullptr) {
-      null_indexes.push_back(position_index);
-    } else if (null_indexes.empty()) {
-      visited_count_sum += node_record_ptr->GetVisitedTime();
-    }
+template<BoardLen BOARD_LEN>
+int UctPlayer<BOARD_LEN>::WidenedChildCount(
+    const NodeRecord &node_record) const {
+  if (widening_initial_child_count_ == 0) {
+    return node_record.EdgeCount();
   }
+  int32_t visited_time = node_record.GetVisitedTime();
+  if (visited_time < widening_initial_child_count_) {
+    return widening_initial_child_count_;
+  }
+  return widening_initial_child_count_ + static_cast<int>(
+      std::log(static_cast<float>(visited_time)
+               / widening_initial_child_count_)
+      / widening_log_growth_factor_);
+}
 
-  if (!null_indexes.empty()) {
-    int index = thread_index % thread_count_;
-    if (index < null_indexes.size()) {
-      return null_indexes.at(index);
+template<BoardLen BOARD_LEN>
+ChildEdge *UctPlayer<BOARD_LEN>::MaxUcbChild(const NodeRecord &node_record) {
+  ChildEdge *edges = node_record.Edges();
+  int edge_count = std::min<int>(node_record.EdgeCount(),
+                                 WidenedChildCount(node_record));
+  if (network_evaluator_) {
+    return MaxPuctChild(node_record, edge_count);
+  }
+  int visited_count_sum = 0;
+
+  // An unvisited child is searched first. Since virtual losses count as
+  // visits, other threads choose other unvisited children meanwhile.
+  for (int i = 0; i < edge_count; ++i) {
+    int32_t visited_time = edges[i].GetVisitedTimeWithVirtualLoss();
+    if (visited_time == 0) {
+      return edges + i;
     }
-    return null_indexes.at(index < null_indexes.size() ? index : 0);
+    visited_count_sum += visited_time;
   }
 
   float max_ucb = -1.0f;
-  PositionIndex max_ucb_index = POSITION_INDEX_PASS;
+  ChildEdge *max_ucb_edge = nullptr;
 
-  for (PositionIndex position_index : playable_index_vector) {
-    const NodeRecord *node_record_ptr = transposition_table_.GetChild(
-        full_board, position_index);
-    if (node_record_ptr == nullptr || node_record_ptr->IsInSearch()) {
-      continue;
-    }
-    // It is guaranteed by the above loop that node_record_ptr is not nullptr.
-    float ucb = Ucb(*node_record_ptr, visited_count_sum);
-    if (ucb > max_ucb
-        && !full_board.IsSuicide(
-            Move(NextForce(full_board), position_index))) {
+  for (int i = 0; i < edge_count; ++i) {
+    float ucb = Ucb(edges[i], visited_count_sum, rave_equivalence_);
+    if (ucb > max_ucb) {
       max_ucb = ucb;
-      max_ucb_index = position_index;
+      max_ucb_edge = edges + i;
+    }
+  }
+
+  return max_ucb_edge;
+}
+
+template<BoardLen BOARD_LEN>
+ChildEdge *UctPlayer<BOARD_LEN>::MaxPuctChild(const NodeRecord &node_record,
+                                              int edge_count) const {
+  ChildEdge *edges = node_record.Edges();
+  int32_t visited_count_sum = 0;
+  for (int i = 0; i < edge_count; ++i) {
+    visited_count_sum += edges[i].GetVisitedTimeWithVirtualLoss();
+  }
+  float exploration = puct_constant_
+      * sqrt(static_cast<float>(std::max(visited_count_sum, 1)));
+  // The profit of the node is of the force having moved to it.
+  float first_play_profit = 1.0f - node_record.GetAverageProfit();
+
+  float max_puct = -std::numeric_limits<float>::max();
+  ChildEdge *max_puct_edge = nullptr;
+  for (int i = 0; i < edge_count; ++i) {
+    int32_t visited_time = edges[i].GetVisitedTimeWithVirtualLoss();
+    float profit = visited_time == 0 ? first_play_profit :
+        edges[i].GetAverageProfitWithVirtualLoss();
+    float puct = profit + exploration * edges[i].GetPrior()
+        / (1 + visited_time);
+    if (puct > max_puct) {
+      max_puct = puct;
+      max_puct_edge = edges + i;
     }
   }
 
-  return max_ucb_index;
+  return max_puct_edge;
 }
 
 template<BoardLen BOARD_LEN>
-float UctPlayer<BOARD_LEN>::ModifyAverageProfitAndReturnNewProfit(
+void UctPlayer<BOARD_LEN>::EvaluateByNetwork(
+    const FullBoard<BOARD_LEN> &full_board, Evaluation *evaluation,
+    SearchStats *search_stats) {
+  if (evaluation_cache_->Get(full_board.HashKey(), evaluation)) {
+    ++search_stats->evaluation_cache_hit_count;
+    return;
+  }
+  *evaluation = network_evaluator_(full_board);
+  ++search_stats->network_evaluation_count;
+  evaluation_cache_->Put(full_board.HashKey(), *evaluation);
+}
+
+template<BoardLen BOARD_LEN>
+typename UctPlayer<BOARD_LEN>::ProfitUpdate
+UctPlayer<BOARD_LEN>::ModifyAverageProfitAndReturnNewProfit(
+    TranspositionTable<BOARD_LEN> *transposition_table,
     FullBoard<BOARD_LEN> *full_board_ptr,
     std::atomic<int> *mc_game_count_ptr,
-    int thread_index) {
-  float new_profit;
-  NodeRecord *node_record_ptr = transposition_table_.Get(*full_board_ptr);
-
+    FullBoard<BOARD_LEN> *playout_board_ptr,
+    BatchPlayout<BOARD_LEN> *batch_playout,
+    RandomEngine *random_engine,
+    AmafStatistics *amaf_statistics,
+    int depth,
+    SearchStats *search_stats) {
+  ProfitUpdate update;
+  NodeRecord *node_record_ptr;
+  {
+    FOOLGO_TRACE_SCOPE("UctPlayer::GetNode");
+    node_record_ptr = transposition_table->Get(*full_board_ptr);
+  }
   if (node_record_ptr == nullptr) {
-    MonteCarloGame<BOARD_LEN> monte_carlo_game(*full_board_ptr, seed_);
-    if (!full_board_ptr->IsEnd()) {
-      monte_carlo_game.Run();
-    }
-    ++(*mc_game_count_ptr);
-    Force force = full_board_ptr->LastForce();
-    new_profit = GetRegionRatio(monte_carlo_game.GetFullBoard(), force);
-    NodeRecord node_record(1, new_profit, false);
-    transposition_table_.Insert(*full_board_ptr, node_record);
+    ++search_stats->table_miss_count;
   } else {
-    mutex_.lock();
-    node_record_ptr->SetIsInSearch(true);
-    mutex_.unlock();
+    ++search_stats->table_hit_count;
+  }
 
-    if (full_board_ptr->IsEnd()) {
-      ++(*mc_game_count_ptr);
-      new_profit = node_record_ptr->GetAverageProfit();
+  // A node is evaluated by random playouts, or by the network too when
+  // searching by PUCT, at its first visit, or when the edge arena has no room
+  // for its children. Its children take the priors of the policy.
+  bool is_leaf = node_record_ptr == nullptr;
+  if (!is_leaf && !full_board_ptr->IsEnd()) {
+    FOOLGO_TRACE_SCOPE("UctPlayer::Expand");
+    Evaluation evaluation;
+    const std::vector<float> *policy = nullptr;
+    if (network_evaluator_
+        && !transposition_table->IsExpanded(*node_record_ptr)) {
+      EvaluateByNetwork(*full_board_ptr, &evaluation, search_stats);
+      policy = &evaluation.policy;
+    }
+    is_leaf = !transposition_table->Expand(*full_board_ptr, node_record_ptr,
+                                           policy);
+  }
+
+  if (is_leaf) {
+    FOOLGO_TRACE_SCOPE("UctPlayer::Playout");
+    Force force = full_board_ptr->LastForce();
+    // Ended boards are scored exactly by a playout.
+    bool is_evaluated_by_network = network_evaluator_
+        && !full_board_ptr->IsEnd();
+    int playout_count = is_evaluated_by_network && value_weight_ == 1.0f ?
+        0 : leaf_playout_count_;
+    float profit_sum = 0.0f;
+    if (amaf_statistics != nullptr) {
+      amaf_statistics->Clear();
+    }
+    if (batch_playout != nullptr && playout_count > 0) {
+      assert(batch_playout->LaneCount() == playout_count);
+      for (int i = 0; i < playout_count; ++i) {
+        batch_playout->Load(i, *full_board_ptr);
+      }
+      batch_playout->Run(random_engine, playout_config_);
+      for (int i = 0; i < playout_count; ++i) {
+        profit_sum += GetWinningProfit(batch_playout->AreaDifference(i),
+                                       force, komi_);
+      }
     } else {
-      if (full_board_ptr->PlayableIndexes(NextForce(*full_board_ptr))
-          .empty()) {
-        full_board_ptr->Pass(NextForce(*full_board_ptr));
-      } else {
-        PositionIndex max_ucb_index = MaxUcbChild(*full_board_ptr,
-                                                         thread_index);
-        Play(full_board_ptr, max_ucb_index);
+      for (int i = 0; i < playout_count; ++i) {
+        playout_board_ptr->Copy(*full_board_ptr);
+        if (amaf_statistics == nullptr) {
+          RunPlayout<BOARD_LEN>(playout_board_ptr, random_engine, nullptr,
+                                playout_config_);
+        } else {
+          FirstMovePoints<BOARD_LEN> first_move_points;
+          RunPlayout(playout_board_ptr, random_engine, &first_move_points,
+                     playout_config_);
+          amaf_statistics->AddPlayout(first_move_points, GetWinningProfit(
+              *playout_board_ptr, Force::BLACK_FORCE, komi_));
+        }
+        profit_sum += GetWinningProfit(*playout_board_ptr, force, komi_);
       }
-      new_profit = 1.0f - ModifyAverageProfitAndReturnNewProfit(full_board_ptr,
-                                                  mc_game_count_ptr,
-                                                  thread_index);
-      float previous_profit = node_record_ptr->GetAverageProfit();
-      float modified_profit = (previous_profit
-          * node_record_ptr->GetVisitedTime() + new_profit)
-          / (node_record_ptr->GetVisitedTime() + 1);
-      node_record_ptr->SetAverageProfit(modified_profit);
     }
+    update.visited_time = std::max(playout_count, 1);
+    update.average_profit = playout_count == 0 ? 0.0f :
+        profit_sum / playout_count;
+    if (is_evaluated_by_network) {
+      Evaluation evaluation;
+      EvaluateByNetwork(*full_board_ptr, &evaluation, search_stats);
+      // The value is of the force to move.
+      update.average_profit = value_weight_ * (1.0f - evaluation.value)
+          + (1.0f - value_weight_) * update.average_profit;
+    }
+    (*mc_game_count_ptr) += update.visited_time;
+    search_stats->playout_count += update.visited_time;
+    search_stats->AddDescent(depth);
+    if (node_record_ptr == nullptr) {
+      NodeRecord node_record(update.visited_time, update.average_profit);
+      if (transposition_table->Insert(*full_board_ptr, node_record)
+          != nullptr) {
+        ++search_stats->created_node_count;
+      }
+    } else {
+      node_record_ptr->AddProfit(update.average_profit, update.visited_time);
+    }
+    return update;
+  }
 
-    node_record_ptr->SetVisitedTimes(node_record_ptr->GetVisitedTime() + 1);
+  if (full_board_ptr->IsEnd()) {
+    ++(*mc_game_count_ptr);
+    ++search_stats->playout_count;
+    search_stats->AddDescent(depth);
+    update.average_profit = node_record_ptr->GetAverageProfit();
+    update.visited_time = 1;
+    if (amaf_statistics != nullptr) {
+      amaf_statistics->Clear();
+    }
+  } else {
+    ChildEdge *child_edge;
+    {
+      FOOLGO_TRACE_SCOPE("UctPlayer::Select");
+      child_edge = MaxUcbChild(*node_record_ptr);
+    }
+    int edge_symmetry = transposition_table->EdgeSymmetry(*full_board_ptr);
+    PositionIndex child_index = POSITION_INDEX_PASS;
+    if (child_edge == nullptr) {
+      // No position is playable without suicide.
+      full_board_ptr->PassWithUndo(NextForce(*full_board_ptr));
+    } else {
+      child_edge->AddVirtualLoss();
+      child_index = SymmetricIndex<BOARD_LEN>(
+          InverseSymmetry(edge_symmetry), child_edge->GetPositionIndex());
+      PlayWithUndo(full_board_ptr, child_index);
+    }
+    ProfitUpdate child_update = ModifyAverageProfitAndReturnNewProfit(
+        transposition_table, full_board_ptr, mc_game_count_ptr,
+        playout_board_ptr, batch_playout, random_engine, amaf_statistics,
+        depth + 1, search_stats);
+    FOOLGO_TRACE_SCOPE("UctPlayer::Backup");
+    full_board_ptr->Undo();
+    if (child_edge != nullptr) {
+      child_edge->RevertVirtualLoss();
+      child_edge->AddProfit(child_update.average_profit,
+                            child_update.visited_time);
+    }
+    if (child_edge != nullptr && amaf_statistics != nullptr) {
+      ModifyRaveProfits(*node_record_ptr, edge_symmetry,
+                        NextForce(*full_board_ptr), child_index, child_update,
+                        amaf_statistics);
+    }
+    update.average_profit = 1.0f - child_update.average_profit;
+    update.visited_time = child_update.visited_time;
   }
 
-  if (node_record_ptr != nullptr) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    node_record_ptr->SetIsInSearch(false);
+  node_record_ptr->AddProfit(update.average_profit, update.visited_time);
+  return update;
+}
+
+template<BoardLen BOARD_LEN>
+void UctPlayer<BOARD_LEN>::AddRemoteWorker(const std::string &host,
+                                           uint16_t port) {
+  if (remote_search_client_ == nullptr) {
+    remote_search_client_.reset(new RemoteSearchClient<BOARD_LEN>);
   }
-  return new_profit;
+  remote_search_client_->AddWorker(host, port);
 }
 
 template<BoardLen BOARD_LEN>
-PositionIndex UctPlayer<BOARD_LEN>::BestChild(
-    const FullBoard<BOARD_LEN> &full_board) {
-  Force force = NextForce(full_board);
-  auto playable_index_vector = full_board.PlayableIndexes(force);
-  int max_visited_count = -1;
-  PositionIndex most_visited_index;
+std::vector<RootChildStat> UctPlayer<BOARD_LEN>::RootChildStats(
+    const FullBoard<BOARD_LEN> &full_board) const {
+  // Visits and profit sums of each child summed over the tables, or -1
+  // visits for a position which is not a child.
+  std::array<int32_t, BoardLenSquare<BOARD_LEN>()> visited_times;
+  std::array<double, BoardLenSquare<BOARD_LEN>()> profit_sums;
+  visited_times.fill(-1);
+  profit_sums.fill(0.0);
+
+  for (const auto &transposition_table : transposition_tables_) {
+    const NodeRecord *node_record = transposition_table->Get(full_board);
+    if (node_record == nullptr
+        || !transposition_table->IsExpanded(*node_record)) {
+      continue;
+    }
 
-  for (PositionIndex index : playable_index_vector) {
-    const NodeRecord *node_record = transposition_table_.GetChild(full_board,
-                                                                  index);
-    assert(node_record != nullptr);
-    std::cout << node_record->GetVisitedTime() << std::endl;
-    if (node_record->GetVisitedTime() > max_visited_count) {
-      max_visited_count = node_record->GetVisitedTime();
-      most_visited_index = index;
+    int board_symmetry = InverseSymmetry(
+        transposition_table->EdgeSymmetry(full_board));
+    ChildEdge *edges = node_record->Edges();
+    for (int i = 0; i < node_record->EdgeCount(); ++i) {
+      PositionIndex index = SymmetricIndex<BOARD_LEN>(
+          board_symmetry, edges[i].GetPositionIndex());
+      int32_t edge_visited_time = edges[i].GetVisitedTime();
+      visited_times[index] = std::max(visited_times[index], 0)
+          + edge_visited_time;
+      profit_sums[index] += static_cast<double>(edge_visited_time)
+          * edges[i].GetAverageProfit();
     }
   }
 
-  return most_visited_index;
+  std::vector<RootChildStat> stats;
+  for (PositionIndex i = 0; i < BoardLenSquare<BOARD_LEN>(); ++i) {
+    if (visited_times[i] < 0) {
+      continue;
+    }
+    RootChildStat stat;
+    stat.position_index = i;
+    stat.visited_time = visited_times[i];
+    stat.average_profit = visited_times[i] == 0 ? 0.0f :
+        static_cast<float>(profit_sums[i] / visited_times[i]);
+    stats.push_back(stat);
+  }
+
+  return stats;
 }
 
 template<BoardLen BOARD_LEN>
-void UctPlayer<BOARD_LEN>::LogProfits(
-    const FullBoard<BOARD_LEN> &full_board) {
-  auto get_profit_str =
-      [this, &full_board](PositionIndex position_index) {
-    Force force = NextForce(full_board);
-    auto indexes = full_board.PlayableIndexes(force);
-    auto it = std::find(indexes.begin(), indexes.end(), position_index);
-    if (it == indexes.end()) {
-      return 'N' + std::string(3, ' ');
-    } else {
-      NodeRecord *node_record = transposition_table_.GetChild(full_board,
-                                                              position_index);
-      assert(node_record != nullptr);
-      float profit = node_record->GetAverageProfit();
-      return boost::lexical_cast<std::string>(profit).substr(0, 4);
+PositionIndex UctPlayer<BOARD_LEN>::BestChild(
+    const FullBoard<BOARD_LEN> &full_board,
+    const std::vector<SearchResponse> &remote_responses) {
+  // Visits of each child, or -1 for a position which is not a local child.
+  // Remote visits of positions which are not local children are ignored.
+  std::array<int32_t, BoardLenSquare<BOARD_LEN>()> visited_times;
+  visited_times.fill(-1);
+
+  for (const RootChildStat &stat : RootChildStats(full_board)) {
+    visited_times[stat.position_index] = stat.visited_time;
+  }
+  for (const SearchResponse &response : remote_responses) {
+    for (const RootChildStat &stat : response.root_child_stats) {
+      if (stat.position_index >= 0
+          && stat.position_index < BoardLenSquare<BOARD_LEN>()
+          && visited_times[stat.position_index] >= 0 && stat.visited_time > 0) {
+        visited_times[stat.position_index] += stat.visited_time;
+      }
     }
-  };
+  }
+
+  int max_visited_count = -1;
+  PositionIndex most_visited_index = POSITION_INDEX_PASS;
+
+  for (PositionIndex i = 0; i < BoardLenSquare<BOARD_LEN>(); ++i) {
+    if (visited_times[i] < 0) {
+      continue;
+    }
+    if (visited_times[i] > max_visited_count) {
+      max_visited_count = visited_times[i];
+      most_visited_index = i;
+    }
+  }
+
+  return most_visited_index;
 }
 
 }
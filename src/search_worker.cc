@@ -0,0 +1,77 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+
+#include "board/zob_hasher.h"
+#include "def.h"
+#include "player/search_server.h"
+#include "player/uct_player.h"
+#include "util/cxxopts.hpp"
+#include "util/rand.h"
+
+using namespace foolgo;
+using std::cerr;
+
+namespace {
+
+struct WorkerConfig {
+  uint16_t port;
+  uint32_t seed;
+  int thread_count;
+  std::size_t table_memory_bytes;
+};
+
+template<BoardLen BOARD_LEN>
+int Serve(const WorkerConfig &config) {
+  ZobHasher<BOARD_LEN>::Init(config.seed);
+  // The playout count of each search is set by its request.
+  UctPlayer<BOARD_LEN> player(config.seed, 1, config.thread_count,
+                              config.table_memory_bytes);
+  SearchServer<BOARD_LEN> server(&player);
+  server.Serve(config.port);
+  cerr << "can not listen on port " << config.port << std::endl;
+  return 1;
+}
+
+}
+
+// Serves searches of a coordinating UctPlayer, which adds this worker by
+// AddRemoteWorker.
+int main(int argc, char *argv[]) {
+  cxxopts::Options options("search_worker", "A remote search worker.");
+  options.add_options()
+    ("port", "TCP port to listen on",
+     cxxopts::value<uint16_t>()->default_value("7450"))
+    ("board-len", "board length of 9, 13 or 19",
+     cxxopts::value<int>()->default_value("9"))
+    ("threads", "search threads",
+     cxxopts::value<int>()->default_value("4"))
+    ("tt-memory", "transposition table memory in MiB",
+     cxxopts::value<std::size_t>()->default_value("128"))
+    ("seed", "random seed, or the time if zero",
+     cxxopts::value<uint32_t>()->default_value("0"));
+  auto args = options.parse(argc, argv);
+
+  WorkerConfig config;
+  config.port = args["port"].as<uint16_t>();
+  config.seed = args["seed"].as<uint32_t>();
+  if (config.seed == 0) {
+    config.seed = GetTimeSeed();
+  }
+  config.thread_count = args["threads"].as<int>();
+  config.table_memory_bytes = args["tt-memory"].as<std::size_t>() << 20;
+
+  switch (args["board-len"].as<int>()) {
+    case 9:
+      return Serve<9>(config);
+    case 13:
+      return Serve<13>(config);
+    case 19:
+      return Serve<19>(config);
+    default:
+      cerr << "unsupported board length: " << args["board-len"].as<int>()
+          << std::endl;
+      return 1;
+  }
+}
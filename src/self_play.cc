@@ -0,0 +1,105 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+#include "deep_learning/sample.h"
+#include "deep_learning/sample_shard.h"
+#include "game/board_len_dispatch.h"
+#include "game/self_play.h"
+#include "util/cxxopts.hpp"
+#include "util/rand.h"
+#include "util/thread_pool.h"
+
+using namespace foolgo;
+using std::cerr;
+using std::cout;
+using std::endl;
+using std::string;
+
+namespace {
+
+struct SelfPlayConfig {
+  int game_count;
+  int concurrent_game_count;
+  int mc_game_count;
+  std::size_t table_memory_bytes;
+  string path_prefix;
+  int64_t samples_per_shard;
+  uint32_t seed;
+};
+
+template<BoardLen BOARD_LEN>
+struct PlaySelfPlayGames {
+  void operator()(const SelfPlayConfig &config, bool *is_written) const {
+    InitZobHasherOnce<BOARD_LEN>(config.seed);
+    typename SelfPlay<BOARD_LEN>::Writer writer(config.path_prefix,
+                                                config.samples_per_shard);
+    SelfPlay<BOARD_LEN> self_play(config.mc_game_count,
+                                  config.table_memory_bytes, config.seed,
+                                  &writer);
+    util::ThreadPool thread_pool(config.concurrent_game_count);
+
+    auto start_time = std::chrono::steady_clock::now();
+    *is_written = self_play.Play(config.game_count, &thread_pool)
+        && writer.Close();
+    double hours = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start_time).count() / 3600.0;
+    if (*is_written) {
+      cout << "games:" << self_play.GameCount() << " samples:"
+          << self_play.SampleCount() << " shards:"
+          << writer.ShardPaths().size() << " games_per_hour:"
+          << self_play.GameCount() / hours << endl;
+    }
+  }
+};
+
+}
+
+// Plays games of UctPlayers against each other, and writes the searched
+// visits and the result of each move to shards of SearchSample.
+int main(int argc, char *argv[]) {
+  cxxopts::Options options("self_play", "Writes self-play games to shards.");
+  options.add_options()
+    ("board-len", "board length of 9, 13, 17 or 19",
+     cxxopts::value<int>()->default_value("19"))
+    ("games", "games to play", cxxopts::value<int>()->default_value("100"))
+    ("concurrent-games", "games played at once",
+     cxxopts::value<int>()->default_value("4"))
+    ("playouts", "playouts per move",
+     cxxopts::value<int>()->default_value("1000"))
+    ("tt-memory", "transposition table memory of each player in MiB",
+     cxxopts::value<std::size_t>()->default_value("16"))
+    ("output", "path prefix of the shards",
+     cxxopts::value<string>()->default_value("self_play"))
+    ("shard-samples", "samples per shard",
+     cxxopts::value<int64_t>()->default_value("1048576"))
+    ("seed", "seed of the games, or of the time if zero",
+     cxxopts::value<uint32_t>()->default_value("0"));
+  auto args = options.parse(argc, argv);
+  SelfPlayConfig config;
+  config.game_count = args["games"].as<int>();
+  config.concurrent_game_count = args["concurrent-games"].as<int>();
+  config.mc_game_count = args["playouts"].as<int>();
+  config.table_memory_bytes = args["tt-memory"].as<std::size_t>() << 20;
+  config.path_prefix = args["output"].as<string>();
+  config.samples_per_shard = args["shard-samples"].as<int64_t>();
+  config.seed = args["seed"].as<uint32_t>();
+  if (config.seed == 0) {
+    config.seed = GetTimeSeed();
+  }
+  cout << "seed:" << config.seed << endl;
+
+  int board_len = args["board-len"].as<int>();
+  bool is_written = false;
+  if (!DispatchBoardLen<PlaySelfPlayGames>(board_len, config, &is_written)) {
+    cerr << "unsupported board length: " << board_len << endl;
+    return 1;
+  }
+  if (!is_written) {
+    cerr << "samples not written" << endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,79 @@
+#include <cstdint>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "board/zob_hasher.h"
+#include "deep_learning/sample.h"
+#include "deep_learning/sample_shard.h"
+#include "game/game_info.h"
+#include "game/sgf_game.h"
+#include "util/cxxopts.hpp"
+#include "util/sgf_reader.h"
+#include "util/thread_pool.h"
+
+using namespace foolgo;
+using std::cerr;
+using std::cout;
+using std::string;
+using std::vector;
+
+// Replays the games of SGF files once, and writes a sample per move to
+// shards, which the trainer maps with --dataset instead of parsing SGF.
+int main(int argc, char *argv[]) {
+  cxxopts::Options options("sgf_converter",
+                           "Converts SGF games to sample shards.");
+  options.add_options()
+    ("sgf", "comma separated SGF files", cxxopts::value<string>())
+    ("output", "path prefix of the shards",
+     cxxopts::value<string>()->default_value("samples"))
+    ("shard-samples", "samples per shard",
+     cxxopts::value<int64_t>()->default_value("1048576"))
+    ("threads", "threads parsing SGF",
+     cxxopts::value<int>()->default_value("4"));
+  auto args = options.parse(argc, argv);
+  if (args.count("sgf") == 0) {
+    cerr << "no SGF files" << std::endl;
+    return 1;
+  }
+
+  // Samples keep no hash keys, so the seed does not matter.
+  ZobHasher<19>::Init(1);
+  SampleShardWriter<19> writer(args["output"].as<string>(),
+                               args["shard-samples"].as<int64_t>());
+  int64_t game_count = 0, sample_count = 0;
+  std::istringstream sgf_stream(args["sgf"].as<string>());
+  string sgf_file_name;
+
+  util::ThreadPool thread_pool(args["threads"].as<int>());
+  SgfReader sgf_reader(&thread_pool);
+  bool is_written = true;
+
+  while (std::getline(sgf_stream, sgf_file_name, ',') && is_written) {
+    bool is_read = sgf_reader.ReadFile(sgf_file_name,
+        [&](const GameInfo &game_info) {
+          vector<Sample<19>> samples;
+          auto game = SgfGame<19>::BuildSgfGame(game_info, &samples);
+          game->Run();
+          for (const Sample<19> &sample : samples) {
+            is_written = is_written && writer.Add(sample);
+          }
+          ++game_count;
+          sample_count += samples.size();
+        });
+    if (!is_read) {
+      cerr << "can not read " << sgf_file_name << std::endl;
+      return 1;
+    }
+  }
+
+  if (!writer.Close() || !is_written) {
+    cerr << "can not write shards of " << args["output"].as<string>()
+        << std::endl;
+    return 1;
+  }
+  cout << "games:" << game_count << " samples:" << sample_count
+      << " shards:" << writer.ShardPaths().size() << std::endl;
+  return 0;
+}
@@ -1,5 +1,6 @@
 #include <cstdint>
 #include <iostream>
+#include <sstream>
 #include <string>
 #include <vector>
 #include <memory>
@@ -13,6 +14,8 @@
 #include "util/SGFParser.h"
 #include "util/rand.h"
 #include "deep_learning/sample.h"
+#include "deep_learning/sample_shard.h"
+#include "deep_learning/training_pipeline.h"
 #include "deep_learning/engine.h"
 #include "deep_learning/cnn/graph_builder.h"
 #include "N3LDG.h"
@@ -27,32 +30,80 @@ int main(int argc, char *argv[]) {
   ZobHasher<19>::Init(seed);
   Options options("FoolGo", "A montecarlo Go A.I.");
   options.add_options()
-    ("s,sgf", "sgf file name", cxxopts::value<string>());
+    ("s,sgf", "sgf file name", cxxopts::value<string>())
+    ("d,dataset", "comma separated sample shards written by sgf_converter",
+     cxxopts::value<string>())
+    ("producers", "threads preparing samples",
+     cxxopts::value<int>()->default_value("4"))
+    ("threads", "threads training shards of each batch",
+     cxxopts::value<int>()->default_value("1"))
+    ("batch", "samples per batch", cxxopts::value<int>()->default_value("64"))
+    ("iterations", "batches to train",
+     cxxopts::value<int>()->default_value("1000"))
+    ("resume", "checkpoint to start from", cxxopts::value<string>())
+    ("checkpoint", "checkpoint written while training",
+     cxxopts::value<string>())
+    ("checkpoint-every", "batches between checkpoints",
+     cxxopts::value<int>()->default_value("1000"));
   auto args = options.parse(argc, argv);
-  string sgf_file_name = args["sgf"].as<string>();
-
-  SGFParser parser;
-  vector<string> strs = parser.chop_all(sgf_file_name);
-  cout << strs.size() << endl;
-  vector<GameInfo> game_infos = parser.get_game_infos(sgf_file_name);
-
-  int iter = 0;
-  cout << "game count:" << game_infos.size() << endl;
-  vector<Sample<19>> samples;
-
-  for (int i=0; i < 1000; ++i) {
-    int rand_game_i = Rand(game_infos.size() - 1, seed);
-    const GameInfo &game_info = game_infos.at(rand_game_i);
-    vector<Sample<19>> single_game_samples;
-    auto game = SgfGame<19>::BuildSgfGame(game_info, &single_game_samples);
-    game->Run();
-    int rand_sample_i = Rand(game_info.moves.size() - 1, seed);
-    samples.push_back(single_game_samples.at(rand_sample_i));
+  int batch_size = args["batch"].as<int>();
+
+  // Both sources outlive the pipeline.
+  SampleDataset<19> dataset;
+  vector<GameInfo> game_infos;
+  TrainingPipeline<19>::SampleSource sample_source;
+
+  // Shards are mapped rather than read, so that a dataset opens at once.
+  if (args.count("dataset") > 0) {
+    istringstream shard_stream(args["dataset"].as<string>());
+    string shard_path;
+    while (getline(shard_stream, shard_path, ',')) {
+      if (!dataset.AddShard(shard_path)) {
+        cerr << "bad sample shard: " << shard_path << endl;
+        return 1;
+      }
+    }
+    cout << "dataset samples:" << dataset.SampleCount() << endl;
+    sample_source = [&dataset, batch_size](RandomEngine *random_engine,
+                                           vector<Sample<19>> *samples) {
+      for (int i = 0; i < batch_size; ++i) {
+        samples->push_back(dataset.RandomSample(random_engine));
+      }
+    };
+  } else {
+    game_infos = SGFParser::get_game_infos(args["sgf"].as<string>());
+    cout << "game count:" << game_infos.size() << endl;
+    sample_source = GameReplaySource<19>(game_infos);
   }
 
-  cout << "samples count:" << samples.size() << endl;
+  HyperParams hyper_params;
+  hyper_params.batch = batch_size;
+  hyper_params.thread_count = args["threads"].as<int>();
+  Engine engine(hyper_params);
+  engine.Init();
+  if (args.count("resume") > 0
+      && !engine.LoadModel(args["resume"].as<string>())) {
+    cerr << "bad checkpoint: " << args["resume"].as<string>() << endl;
+    return 1;
+  }
 
-  Engine engine;
+  // The reservoir mixes the positions of many games into each batch.
+  TrainingPipeline<19> pipeline(sample_source, args["producers"].as<int>(),
+                                64 * batch_size, batch_size, 4, seed);
+  vector<Sample<19>> batch;
+  for (int i = 0; i < args["iterations"].as<int>(); ++i) {
+    pipeline.NextBatch(&batch);
+    dtype cost = engine.Train(batch);
+    if (i % 100 == 0) {
+      cout << "iteration:" << i << " cost:" << cost << endl;
+    }
+    bool is_last = i + 1 == args["iterations"].as<int>();
+    if (args.count("checkpoint") > 0
+        && ((i + 1) % args["checkpoint-every"].as<int>() == 0 || is_last)
+        && !engine.SaveModel(args["checkpoint"].as<string>())) {
+      cerr << "checkpoint not written" << endl;
+    }
+  }
 
   return 0;
 }
@@ -17,6 +17,7 @@
 */
 
 #include "SGFParser.h"
+#include "sgf_reader.h"
 
 #include <cassert>
 #include <cctype>
@@ -24,7 +25,6 @@
 #include <stdexcept>
 #include <string>
 #include <iostream>
-#include <regex>
 #include <utility>
 
 namespace foolgo {
@@ -33,9 +33,6 @@ using std::cout;
 using std::endl;
 using std::string;
 using std::vector;
-using std::regex;
-using std::sregex_iterator;
-using std::move;
 
 std::vector<std::string> SGFParser::chop_stream(std::istream& ins,
                                                 size_t stopat) {
@@ -186,50 +183,13 @@ void Validate(const GameInfo &game_info) {
 }
 
 vector<GameInfo> SGFParser::get_game_infos(const string &fname) {
-   vector<string> strs = chop_all(fname);
-   vector<GameInfo> game_infos;
-
-   for (auto &str : strs) {
-     static regex PATTERN(";([WB])\\[([a-t]?[a-t]?)\\]");
-     vector<Move> moves;
-     for (sregex_iterator it =
-         sregex_iterator(str.begin(), str.end(), PATTERN);
-         it != sregex_iterator(); ++it) {
-       Move move;
-       Force force;
-       string force_str = it->str(1);
-       if (force_str == "B") {
-         force = Force::BLACK_FORCE;
-       } else if (force_str == "W") {
-         force = Force::WHITE_FORCE;
-       } else {
-         abort();
-       }
-       move.force = force;
-
-       PositionIndex indx;
-       if (it->str(2) == "" || it->str(2) == "tt") {
-         indx = POSITION_INDEX_PASS;
-       } else {
-         char col_ch = it->str(2).at(0);
-         int x = col_ch - 'a';
-
-         char row_ch = it->str(2).at(1);
-         int y = row_ch - 'a';
-
-         indx = PstionAndIndxCcltr<19>::Ins().GetIndex(Position(x, y));
-       }
-       move.position_index = indx;
-
-       moves.push_back(move);
-     }
-     GameInfo game_info;
-     game_info.moves = move(moves);
-
-     game_infos.push_back(move(game_info));
-   }
-
-   return game_infos;
+  vector<GameInfo> game_infos;
+  if (!SgfReader().ReadFile(fname, [&game_infos](const GameInfo &game_info) {
+        game_infos.push_back(game_info);
+      })) {
+    throw std::runtime_error("Error opening file");
+  }
+  return game_infos;
 }
 
 }
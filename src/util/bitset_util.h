@@ -3,34 +3,127 @@
 
 #include <bitset>
 #include <cassert>
+#include <cstdint>
+#include <cstring>
 #include <vector>
 
+#ifdef __BMI2__
+#include <immintrin.h>
+#endif
+
 #include "../board/position.h"
 
 namespace foolgo {
 namespace util {
 
 template<int LEN>
-int GetLowestOne(const std::bitset<LEN> &b) {
-  assert(b.count() > 0);
+constexpr int BitSetWordCount() {
+  return (LEN + 63) / 64;
+}
 
-  for (int i = 0;; ++i) {
-    if (b[i]) {
-      return i;
+// Copies the bitset into 64 bit words, in which bit i of the bitset is bit
+// i % 64 of word i / 64.
+template<int LEN>
+void ToWords(const std::bitset<LEN> &b, uint64_t *words) {
+#if (defined(__GLIBCXX__) || defined(_LIBCPP_VERSION)) && defined(__LP64__)
+  // Both libraries store a bitset as an array of unsigned long words.
+  static_assert(sizeof(b) == sizeof(uint64_t) * BitSetWordCount<LEN>(),
+                "unexpected bitset layout");
+  std::memcpy(words, &b, sizeof(b));
+#else
+  for (int i = 0; i < BitSetWordCount<LEN>(); ++i) {
+    words[i] = 0;
+  }
+  for (int i = 0; i < LEN; ++i) {
+    words[i / 64] |= static_cast<uint64_t>(b[i]) << (i % 64);
+  }
+#endif
+}
+
+// Returns the index of the nth one of the word, counting from zero.
+inline int SelectInWord(uint64_t word, int n) {
+  assert(__builtin_popcountll(word) > n);
+#ifdef __BMI2__
+  return __builtin_ctzll(_pdep_u64(uint64_t(1) << n, word));
+#else
+  for (int i = 0; i < n; ++i) {
+    word &= word - 1;
+  }
+  return __builtin_ctzll(word);
+#endif
+}
+
+// Iterates over indexes of ones of a bitset in increasing order.
+template<int LEN>
+class OnePositionIndexRange {
+ public:
+  class Iterator {
+   public:
+    Iterator(const uint64_t *words, int word_index)
+        : words_(words), word_index_(word_index),
+          word_(word_index < BitSetWordCount<LEN>() ? words[word_index] : 0) {
+      SkipEmptyWords();
     }
+
+    PositionIndex operator*() const {
+      return word_index_ * 64 + __builtin_ctzll(word_);
+    }
+    Iterator &operator++() {
+      word_ &= word_ - 1;
+      SkipEmptyWords();
+      return *this;
+    }
+    bool operator!=(const Iterator &iterator) const {
+      return word_index_ != iterator.word_index_ || word_ != iterator.word_;
+    }
+
+   private:
+    const uint64_t *words_;
+    int word_index_;
+    uint64_t word_;
+
+    void SkipEmptyWords() {
+      while (word_ == 0 && word_index_ < BitSetWordCount<LEN>()) {
+        if (++word_index_ < BitSetWordCount<LEN>()) {
+          word_ = words_[word_index_];
+        }
+      }
+    }
+  };
+
+  explicit OnePositionIndexRange(const std::bitset<LEN> &b) {
+    ToWords<LEN>(b, words_);
   }
 
-  return -1;
+  Iterator begin() const {
+    return Iterator(words_, 0);
+  }
+  Iterator end() const {
+    return Iterator(words_, BitSetWordCount<LEN>());
+  }
+
+ private:
+  uint64_t words_[BitSetWordCount<LEN>()];
+};
+
+template<int LEN>
+int GetLowestOne(const std::bitset<LEN> &b) {
+  assert(b.count() > 0);
+  return *OnePositionIndexRange<LEN>(b).begin();
 }
 
 template<int LEN>
 int CalSpecifiedOneOccurrenceTimeIndex(const std::bitset<LEN> &b, int x) {
   assert((int)b.count() > x);
+  uint64_t words[BitSetWordCount<LEN>()];
+  ToWords<LEN>(b, words);
 
   for (int i = 0;; ++i) {
-    if (b[i] && --x < 0) {
-      return i;
+    int count = __builtin_popcountll(words[i]);
+    if (x < count) {
+      return i * 64 + SelectInWord(words[i], x);
     }
+    x -= count;
   }
 
   return -1;
@@ -39,14 +132,11 @@ int CalSpecifiedOneOccurrenceTimeIndex(const std::bitset<LEN> &b, int x) {
 template<int LEN>
 std::vector<PositionIndex> GetOnePositionIndexes(
     const std::bitset<LEN> &b) {
-  PositionIndex c = b.count();
-  std::vector<PositionIndex> v(c);
-  PositionIndex vi = 0;
+  std::vector<PositionIndex> v;
+  v.reserve(b.count());
 
-  for (int i = 0; i < b.size(); ++i) {
-    if (b[i]) {
-      v[vi++] = i;
-    }
+  for (PositionIndex i : OnePositionIndexRange<LEN>(b)) {
+    v.push_back(i);
   }
 
   return v;
@@ -0,0 +1,83 @@
+#ifndef FOOLGO_SRC_UTIL_FENWICK_TREE_H_
+#define FOOLGO_SRC_UTIL_FENWICK_TREE_H_
+
+#include <cassert>
+#include <cstddef>
+
+namespace foolgo {
+namespace util {
+
+/**
+ * Non-negative weights of SIZE items, of which a weight is changed and an
+ * item is drawn with the probability of its weight in O(log SIZE), so that a
+ * playout samples moves by weights at nearly the cost of uniform sampling.
+ */
+template<typename T, std::size_t SIZE>
+class FenwickTree {
+ public:
+  FenwickTree() {
+    Clear();
+  }
+
+  void Clear() {
+    for (std::size_t i = 0; i <= SIZE; ++i) {
+      sums_[i] = 0;
+    }
+    total_ = 0;
+  }
+  // Replaces all weights in O(SIZE).
+  void Build(const T *weights) {
+    total_ = 0;
+    for (std::size_t i = 1; i <= SIZE; ++i) {
+      sums_[i] = weights[i - 1];
+      total_ += weights[i - 1];
+    }
+    for (std::size_t i = 1; i <= SIZE; ++i) {
+      std::size_t parent = i + (i & -i);
+      if (parent <= SIZE) {
+        sums_[parent] += sums_[i];
+      }
+    }
+  }
+
+  void Add(std::size_t index, T delta) {
+    assert(index < SIZE);
+    for (std::size_t i = index + 1; i <= SIZE; i += i & -i) {
+      sums_[i] += delta;
+    }
+    total_ += delta;
+  }
+
+  T Total() const {
+    return total_;
+  }
+
+  // Returns the item at which the prefix sum of weights first exceeds the
+  // target, which should be less than Total().
+  std::size_t Find(T target) const {
+    std::size_t index = 0;
+    for (std::size_t step = HighestPowerOfTwo(); step > 0; step >>= 1) {
+      std::size_t next = index + step;
+      if (next <= SIZE && sums_[next] <= target) {
+        index = next;
+        target -= sums_[next];
+      }
+    }
+    assert(index < SIZE);
+    return index;
+  }
+
+ private:
+  // 1-based; sums_[i] is the sum of the (i & -i) weights ending at item i.
+  T sums_[SIZE + 1];
+  T total_;
+
+  static constexpr std::size_t HighestPowerOfTwo(std::size_t power = 1) {
+    return power * 2 > SIZE ? power : HighestPowerOfTwo(power * 2);
+  }
+};
+
+}
+}
+
+#endif
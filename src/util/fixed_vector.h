@@ -0,0 +1,108 @@
+#ifndef FOOLGO_SRC_UTIL_FIXED_VECTOR_H_
+#define FOOLGO_SRC_UTIL_FIXED_VECTOR_H_
+
+#include <cassert>
+#include <cstddef>
+
+namespace foolgo {
+namespace util {
+
+/**
+ * A vector of no more than CAPACITY elements, stored inline, so that move
+ * temporaries bounded by the board area live on the stack instead of the
+ * heap. T should be trivially copyable, since elements beyond the size are
+ * left uninitialized.
+ */
+template<typename T, std::size_t CAPACITY>
+class FixedVector {
+ public:
+  typedef T value_type;
+  typedef T *iterator;
+  typedef const T *const_iterator;
+
+  FixedVector() : size_(0) {}
+  FixedVector(const FixedVector &v) : size_(v.size_) {
+    for (std::size_t i = 0; i < size_; ++i) {
+      elements_[i] = v.elements_[i];
+    }
+  }
+  FixedVector &operator =(const FixedVector &v) {
+    size_ = v.size_;
+    for (std::size_t i = 0; i < size_; ++i) {
+      elements_[i] = v.elements_[i];
+    }
+    return *this;
+  }
+
+  std::size_t size() const {
+    return size_;
+  }
+  bool empty() const {
+    return size_ == 0;
+  }
+  static constexpr std::size_t capacity() {
+    return CAPACITY;
+  }
+
+  void clear() {
+    size_ = 0;
+  }
+  // New elements are left uninitialized.
+  void resize(std::size_t size) {
+    assert(size <= CAPACITY);
+    size_ = size;
+  }
+  void push_back(const T &value) {
+    assert(size_ < CAPACITY);
+    elements_[size_++] = value;
+  }
+  void pop_back() {
+    assert(size_ > 0);
+    --size_;
+  }
+  T &back() {
+    assert(size_ > 0);
+    return elements_[size_ - 1];
+  }
+  const T &back() const {
+    assert(size_ > 0);
+    return elements_[size_ - 1];
+  }
+  template<typename Container>
+  void Append(const Container &container) {
+    for (const T &value : container) {
+      push_back(value);
+    }
+  }
+
+  T &operator [](std::size_t i) {
+    assert(i < size_);
+    return elements_[i];
+  }
+  const T &operator [](std::size_t i) const {
+    assert(i < size_);
+    return elements_[i];
+  }
+
+  iterator begin() {
+    return elements_;
+  }
+  iterator end() {
+    return elements_ + size_;
+  }
+  const_iterator begin() const {
+    return elements_;
+  }
+  const_iterator end() const {
+    return elements_ + size_;
+  }
+
+ private:
+  std::size_t size_;
+  T elements_[CAPACITY];
+};
+
+}
+}
+
+#endif
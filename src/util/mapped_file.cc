@@ -0,0 +1,46 @@
+#include "mapped_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace foolgo {
+namespace util {
+
+using std::string;
+using std::unique_ptr;
+
+MappedFile::~MappedFile() {
+  if (size_ > 0) {
+    munmap(const_cast<void *>(data_), size_);
+  }
+}
+
+unique_ptr<MappedFile> MappedFile::Open(const string &path) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return nullptr;
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0) {
+    close(fd);
+    return nullptr;
+  }
+
+  std::size_t size = file_stat.st_size;
+  void *data = nullptr;
+  // Empty files can not be mapped, and have no bytes to read anyway.
+  if (size > 0) {
+    data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  }
+  // The mapping stays valid after the file is closed.
+  close(fd);
+  if (data == MAP_FAILED) {
+    return nullptr;
+  }
+  return unique_ptr<MappedFile>(new MappedFile(data, size));
+}
+
+}
+}
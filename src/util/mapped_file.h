@@ -0,0 +1,43 @@
+#ifndef FOOLGO_SRC_UTIL_MAPPED_FILE_H_
+#define FOOLGO_SRC_UTIL_MAPPED_FILE_H_
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include "../def.h"
+
+namespace foolgo {
+namespace util {
+
+/**
+ * A file mapped read only into memory, which is unmapped when destroyed.
+ * Pages are read by the kernel when touched, so opening costs nothing like
+ * reading the file.
+ */
+class MappedFile {
+ public:
+  ~MappedFile();
+  DISALLOW_COPY_AND_ASSIGN_AND_MOVE(MappedFile)
+
+  // Returns nullptr if the file can not be opened or mapped.
+  static std::unique_ptr<MappedFile> Open(const std::string &path);
+
+  const void *Data() const {
+    return data_;
+  }
+  std::size_t Size() const {
+    return size_;
+  }
+
+ private:
+  MappedFile(const void *data, std::size_t size) : data_(data), size_(size) {}
+
+  const void *data_;
+  std::size_t size_;
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,32 @@
+#include "memory_util.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace foolgo {
+namespace util {
+
+void *AllocateAligned(std::size_t size, std::size_t alignment,
+                      int numa_node) {
+  if (numa_node != ANY_NUMA_NODE) {
+    alignment = std::max(alignment,
+                         static_cast<std::size_t>(sysconf(_SC_PAGESIZE)));
+  }
+  void *ptr = nullptr;
+  if (posix_memalign(&ptr, alignment, size) != 0) {
+    return nullptr;
+  }
+  if (numa_node != ANY_NUMA_NODE) {
+    BindMemoryToNumaNode(ptr, size, numa_node);
+  }
+  return ptr;
+}
+
+void FreeAligned(void *ptr) {
+  free(ptr);
+}
+
+}
+}
@@ -0,0 +1,25 @@
+#ifndef FOOLGO_SRC_UTIL_MEMORY_UTIL_H_
+#define FOOLGO_SRC_UTIL_MEMORY_UTIL_H_
+
+#include <cstddef>
+
+#include "numa_util.h"
+
+namespace foolgo {
+namespace util {
+
+constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+// Returns memory aligned to alignment, or nullptr when the allocation fails.
+// Memory placed on a NUMA node, preferably, or interleaved among nodes, is
+// aligned to pages, and its placement applies to pages touched later.
+void *AllocateAligned(std::size_t size,
+                      std::size_t alignment = CACHE_LINE_SIZE,
+                      int numa_node = ANY_NUMA_NODE);
+
+void FreeAligned(void *ptr);
+
+}
+}
+
+#endif
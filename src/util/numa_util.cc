@@ -0,0 +1,98 @@
+#include "numa_util.h"
+
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#ifdef FOOLGO_USE_NUMA
+#include <numa.h>
+#include <numaif.h>
+#endif
+
+namespace foolgo {
+namespace util {
+
+namespace {
+
+#ifdef FOOLGO_USE_NUMA
+bool IsNumaAvailable() {
+  static const bool is_available = numa_available() >= 0;
+  return is_available;
+}
+#endif
+
+}
+
+int CpuCount() {
+  int cpu_count = std::thread::hardware_concurrency();
+  return cpu_count > 0 ? cpu_count : 1;
+}
+
+int NumaNodeCount() {
+#ifdef FOOLGO_USE_NUMA
+  if (IsNumaAvailable()) {
+    return numa_max_node() + 1;
+  }
+#endif
+  return 1;
+}
+
+int NumaNodeOfCpu(int cpu) {
+#ifdef FOOLGO_USE_NUMA
+  if (IsNumaAvailable()) {
+    int numa_node = numa_node_of_cpu(cpu);
+    return numa_node < 0 ? 0 : numa_node;
+  }
+#endif
+  return 0;
+}
+
+bool PinCurrentThreadToCpu(int cpu) {
+#ifdef __linux__
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  CPU_SET(cpu, &cpu_set);
+  return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set)
+      == 0;
+#else
+  return false;
+#endif
+}
+
+bool PinCurrentThreadToNumaNode(int numa_node) {
+#ifdef FOOLGO_USE_NUMA
+  if (IsNumaAvailable()) {
+    return numa_run_on_node(numa_node) == 0;
+  }
+#endif
+  return false;
+}
+
+bool BindMemoryToNumaNode(void *ptr, std::size_t size, int numa_node) {
+#ifdef FOOLGO_USE_NUMA
+  if (!IsNumaAvailable() || numa_node == ANY_NUMA_NODE) {
+    return false;
+  }
+  bitmask *nodes = numa_allocate_nodemask();
+  int mode;
+  if (numa_node == INTERLEAVED_NUMA_NODES) {
+    copy_bitmask_to_bitmask(numa_all_nodes_ptr, nodes);
+    mode = MPOL_INTERLEAVE;
+  } else {
+    numa_bitmask_setbit(nodes, numa_node);
+    mode = MPOL_PREFERRED;
+  }
+  bool is_bound = mbind(ptr, size, mode, nodes->maskp, nodes->size + 1, 0)
+      == 0;
+  numa_free_nodemask(nodes);
+  return is_bound;
+#else
+  return false;
+#endif
+}
+
+}
+}
@@ -0,0 +1,33 @@
+#ifndef FOOLGO_SRC_UTIL_NUMA_UTIL_H_
+#define FOOLGO_SRC_UTIL_NUMA_UTIL_H_
+
+#include <cstddef>
+
+namespace foolgo {
+namespace util {
+
+// Memory placements besides the index of a NUMA node.
+constexpr int ANY_NUMA_NODE = -1;
+constexpr int INTERLEAVED_NUMA_NODES = -2;
+
+// NUMA queries and placements take effect only when built with libnuma, by
+// defining FOOLGO_USE_NUMA. Otherwise the machine is taken as one node, and
+// only pinning threads to CPUs works, on Linux.
+int CpuCount();
+int NumaNodeCount();
+int NumaNodeOfCpu(int cpu);
+
+// Returns false if the thread can not be pinned.
+bool PinCurrentThreadToCpu(int cpu);
+bool PinCurrentThreadToNumaNode(int numa_node);
+
+// Places pages of the memory preferably on the node, or interleaved among
+// all nodes. The memory should start at a page boundary and not be touched
+// yet, since pages already touched are not moved. Returns false if the
+// placement is not set.
+bool BindMemoryToNumaNode(void *ptr, std::size_t size, int numa_node);
+
+}
+}
+
+#endif
@@ -1,17 +1,31 @@
 #include "rand.h"
 
-#include <algorithm>
 #include <cstdint>
-#include <random>
-#include <cstdlib>
-#include <iostream>
-
-using namespace std;
 
 namespace foolgo {
 
-uint32_t Rand(uint32_t max, uint32_t seed) {
-  return rand() % (max + 1);
+namespace {
+
+// SplitMix64, which expands a seed into well mixed state words.
+uint64_t SplitMix64(uint64_t *x) {
+  uint64_t z = (*x += 0x9e3779b97f4a7c15ULL);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+}
+
+RandomEngine::RandomEngine(uint64_t seed, uint64_t stream) {
+  // Mixes the stream into the seed, so that neighbouring streams do not share
+  // a shifted SplitMix64 sequence.
+  uint64_t x = seed;
+  uint64_t mixed_stream = stream;
+  x ^= SplitMix64(&mixed_stream);
+
+  for (uint64_t &word : state_) {
+    word = SplitMix64(&x);
+  }
 }
 
 }
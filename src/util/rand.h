@@ -3,11 +3,75 @@
 
 #include <chrono>
 #include <cstdint>
+#include <limits>
 
 
 namespace foolgo {
 
-uint32_t Rand(uint32_t max, uint32_t seed);
+/**
+ * A xoshiro256** generator. Each search thread owns one, so that no state is
+ * shared between threads, and a run is reproducible from its seed. Generators
+ * of the same seed but different streams yield unrelated sequences.
+ *
+ * It meets the UniformRandomBitGenerator requirements, thus can be used with
+ * the distributions of <random>.
+ */
+class RandomEngine {
+ public:
+  typedef uint64_t result_type;
+
+  explicit RandomEngine(uint64_t seed, uint64_t stream = 0);
+
+  static constexpr result_type min() {
+    return 0;
+  }
+  static constexpr result_type max() {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  result_type operator()() {
+    uint64_t result = RotateLeft(state_[1] * 5, 7) * 9;
+    uint64_t t = state_[1] << 17;
+    state_[2] ^= state_[0];
+    state_[3] ^= state_[1];
+    state_[1] ^= state_[2];
+    state_[0] ^= state_[3];
+    state_[2] ^= t;
+    state_[3] = RotateLeft(state_[3], 45);
+    return result;
+  }
+
+  // Returns a uniformly distributed integer in [0, max], without modulo bias.
+  uint32_t Uniform(uint32_t max);
+
+ private:
+  uint64_t state_[4];
+
+  static uint64_t RotateLeft(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+  }
+};
+
+inline uint32_t RandomEngine::Uniform(uint32_t max) {
+  uint32_t random = static_cast<uint32_t>((*this)() >> 32);
+  if (max == std::numeric_limits<uint32_t>::max()) {
+    return random;
+  }
+  uint32_t range = max + 1;
+  // Lemire's multiply and shift, which rejects the low products lying in the
+  // biased remainder.
+  uint64_t product = static_cast<uint64_t>(random) * range;
+  uint32_t low = static_cast<uint32_t>(product);
+  if (low < range) {
+    uint32_t threshold = static_cast<uint32_t>(-range) % range;
+    while (low < threshold) {
+      random = static_cast<uint32_t>((*this)() >> 32);
+      product = static_cast<uint64_t>(random) * range;
+      low = static_cast<uint32_t>(product);
+    }
+  }
+  return static_cast<uint32_t>(product >> 32);
+}
 
 inline uint32_t GetTimeSeed() {
   static unsigned time_seed =
@@ -0,0 +1,187 @@
+#include "sgf_reader.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "../board/pos_cal.h"
+#include "../board/position.h"
+#include "mapped_file.h"
+
+namespace foolgo {
+
+using std::pair;
+using std::string;
+using std::vector;
+
+namespace {
+
+const int SGF_BOARD_LEN = 19;
+
+// Returns the end of the property value beginning after its '[', which is at
+// its ']' or at the end of the bytes.
+const char *FindValueEnd(const char *value_begin, const char *end) {
+  const char *p = value_begin;
+  while (p < end && *p != ']') {
+    p += (*p == '\\' && p + 1 < end) ? 2 : 1;
+  }
+  return p;
+}
+
+}
+
+bool SgfReader::ReadFile(const string &path, const GameInfoSink &sink) const {
+  std::unique_ptr<util::MappedFile> mapped_file = util::MappedFile::Open(path);
+  if (mapped_file == nullptr) {
+    return false;
+  }
+  const char *begin = static_cast<const char *>(mapped_file->Data());
+  Read(begin, begin + mapped_file->Size(), sink);
+  return true;
+}
+
+void SgfReader::Read(const char *begin, const char *end,
+                     const GameInfoSink &sink) const {
+  vector<pair<const char *, const char *>> game_ranges;
+  vector<GameInfo> game_infos;
+  vector<char> are_games_valid;
+
+  auto parse_batch = [&]() {
+    int game_count = game_ranges.size();
+    game_infos.clear();
+    game_infos.resize(game_count);
+    are_games_valid.assign(game_count, false);
+    auto parse_games = [&](int first, int last) {
+      for (int i = first; i < last; ++i) {
+        are_games_valid[i] = ParseGame(game_ranges[i].first,
+                                       game_ranges[i].second, &game_infos[i]);
+      }
+    };
+
+    if (thread_pool_ == nullptr) {
+      parse_games(0, game_count);
+    } else {
+      int task_count = thread_pool_->ThreadCount();
+      for (int i = 0; i < task_count; ++i) {
+        int first = game_count * i / task_count;
+        int last = game_count * (i + 1) / task_count;
+        thread_pool_->Submit([&parse_games, first, last](int) {
+          parse_games(first, last);
+        });
+      }
+      thread_pool_->Wait();
+    }
+
+    for (int i = 0; i < game_count; ++i) {
+      if (are_games_valid[i]) {
+        sink(game_infos[i]);
+      }
+    }
+    game_ranges.clear();
+  };
+
+  int depth = 0;
+  const char *game_begin = nullptr;
+  for (const char *p = begin; p < end; ++p) {
+    if (*p == '[') {
+      p = FindValueEnd(p + 1, end);
+      if (p == end) {
+        break;
+      }
+    } else if (*p == '(') {
+      if (depth++ == 0) {
+        game_begin = p;
+      }
+    } else if (*p == ')' && depth > 0) {
+      if (--depth == 0) {
+        game_ranges.push_back(std::make_pair(game_begin, p + 1));
+        if (static_cast<int>(game_ranges.size()) == batch_game_count_) {
+          parse_batch();
+        }
+      }
+    }
+  }
+
+  // A game missing its closing parenthesis, as OGS writes, ends at the end.
+  if (depth > 0) {
+    game_ranges.push_back(std::make_pair(game_begin, end));
+  }
+  parse_batch();
+}
+
+bool SgfReader::ParseGame(const char *begin, const char *end,
+                          GameInfo *game_info) {
+  int depth = 0;
+  // The main line ends where its first variation does, after which only
+  // other variations follow, which are skipped.
+  bool is_main_line_done = false;
+  // Only the first letters of the identifier are kept, as they are enough to
+  // tell the properties read.
+  char identifier[3];
+  int identifier_len = 0;
+  bool is_last_letter = false;
+
+  for (const char *p = begin; p < end; ++p) {
+    char c = *p;
+    // Lower case letters of identifiers, as of FF[3], are ignored.
+    if (c >= 'a' && c <= 'z') {
+      continue;
+    }
+    bool is_letter = c >= 'A' && c <= 'Z';
+    if (is_letter) {
+      if (!is_last_letter) {
+        identifier_len = 0;
+      }
+      if (identifier_len < 3) {
+        identifier[identifier_len++] = c;
+      }
+    } else if (c == '(') {
+      ++depth;
+    } else if (c == ')') {
+      if (--depth > 0) {
+        is_main_line_done = true;
+      }
+    } else if (c == '[') {
+      const char *value_begin = p + 1;
+      p = FindValueEnd(value_begin, end);
+      int value_len = p - value_begin;
+
+      if (identifier_len == 1 && (identifier[0] == 'B' || identifier[0] == 'W')
+          && !is_main_line_done) {
+        Move move;
+        move.force = identifier[0] == 'B' ? Force::BLACK_FORCE :
+            Force::WHITE_FORCE;
+        if (value_len == 0 || (value_len == 2 && value_begin[0] == 't'
+            && value_begin[1] == 't')) {
+          move.position_index = POSITION_INDEX_PASS;
+        } else {
+          int x = value_begin[0] - 'a';
+          int y = value_len == 2 ? value_begin[1] - 'a' : -1;
+          if (x < 0 || x >= SGF_BOARD_LEN || y < 0 || y >= SGF_BOARD_LEN) {
+            return false;
+          }
+          move.position_index = PstionAndIndxCcltr<SGF_BOARD_LEN>::Ins()
+              .GetIndex(Position(x, y));
+        }
+        game_info->moves.push_back(move);
+      } else if (identifier_len == 2 && identifier[0] == 'R'
+          && identifier[1] == 'E' && value_len >= 2 && value_begin[1] == '+'
+          && (value_begin[0] == 'B' || value_begin[0] == 'W')) {
+        game_info->has_winner = true;
+        game_info->winner = value_begin[0] == 'B' ? Force::BLACK_FORCE :
+            Force::WHITE_FORCE;
+      }
+
+      if (p == end) {
+        break;
+      }
+    }
+    // Values of a property follow one another, so a property ends only at
+    // the next identifier.
+    is_last_letter = is_letter;
+  }
+
+  return true;
+}
+
+}
@@ -0,0 +1,48 @@
+#ifndef FOOLGO_SRC_UTIL_SGF_READER_H_
+#define FOOLGO_SRC_UTIL_SGF_READER_H_
+
+#include <functional>
+#include <string>
+
+#include "../def.h"
+#include "../game/game_info.h"
+#include "thread_pool.h"
+
+namespace foolgo {
+
+/**
+ * Reads the 19x19 games of an SGF collection without copying it: game
+ * boundaries are found by one pass over the bytes, which tracks only
+ * parentheses and property values, and the games of each batch are then
+ * parsed by the workers of the pool, without regex. Games are handed to the
+ * sink in the order of the file, one batch at a time, so that memory does not
+ * grow with the collection.
+ */
+class SgfReader {
+ public:
+  typedef std::function<void(const GameInfo &)> GameInfoSink;
+
+  // Parses on the calling thread if the pool is nullptr.
+  explicit SgfReader(util::ThreadPool *thread_pool = nullptr,
+                     int batch_game_count = 4096)
+      : thread_pool_(thread_pool), batch_game_count_(batch_game_count) {}
+  DISALLOW_COPY_AND_ASSIGN_AND_MOVE(SgfReader)
+
+  // Maps the file, and returns false if it can not be mapped.
+  bool ReadFile(const std::string &path, const GameInfoSink &sink) const;
+  void Read(const char *begin, const char *end,
+            const GameInfoSink &sink) const;
+
+  // Parses the moves of the main line and the winner of the game between the
+  // parentheses. Returns false if a move is not on the 19x19 board.
+  static bool ParseGame(const char *begin, const char *end,
+                        GameInfo *game_info);
+
+ private:
+  util::ThreadPool *thread_pool_;
+  int batch_game_count_;
+};
+
+}
+
+#endif
@@ -0,0 +1,146 @@
+#include "socket.h"
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <cstring>
+
+namespace foolgo {
+namespace util {
+
+using std::string;
+using std::unique_ptr;
+
+namespace {
+
+// Messages are small and answered at once, so they are sent without delay.
+void DisableNagle(int fd) {
+  int flag = 1;
+  setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+}
+
+}
+
+Socket::~Socket() {
+  close(fd_);
+}
+
+unique_ptr<Socket> Socket::Connect(const string &host, uint16_t port) {
+  addrinfo hints;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  addrinfo *addresses;
+  if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints,
+                  &addresses) != 0) {
+    return nullptr;
+  }
+
+  int fd = -1;
+  for (addrinfo *address = addresses; address != nullptr;
+      address = address->ai_next) {
+    fd = socket(address->ai_family, address->ai_socktype,
+                address->ai_protocol);
+    if (fd < 0) {
+      continue;
+    }
+    if (connect(fd, address->ai_addr, address->ai_addrlen) == 0) {
+      break;
+    }
+    close(fd);
+    fd = -1;
+  }
+  freeaddrinfo(addresses);
+
+  if (fd < 0) {
+    return nullptr;
+  }
+  DisableNagle(fd);
+  return unique_ptr<Socket>(new Socket(fd));
+}
+
+bool Socket::SendAll(const void *data, std::size_t size) {
+  const char *bytes = static_cast<const char *>(data);
+  while (size > 0) {
+    ssize_t sent_size = send(fd_, bytes, size, MSG_NOSIGNAL);
+    if (sent_size <= 0) {
+      return false;
+    }
+    bytes += sent_size;
+    size -= sent_size;
+  }
+  return true;
+}
+
+bool Socket::ReceiveAll(void *data, std::size_t size) {
+  char *bytes = static_cast<char *>(data);
+  while (size > 0) {
+    ssize_t received_size = recv(fd_, bytes, size, 0);
+    if (received_size <= 0) {
+      return false;
+    }
+    bytes += received_size;
+    size -= received_size;
+  }
+  return true;
+}
+
+bool Socket::SetReceiveTimeout(int milliseconds) {
+  timeval timeout;
+  timeout.tv_sec = milliseconds / 1000;
+  timeout.tv_usec = milliseconds % 1000 * 1000;
+  return setsockopt(fd_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout))
+      == 0;
+}
+
+ServerSocket::~ServerSocket() {
+  if (fd_ >= 0) {
+    close(fd_);
+  }
+}
+
+bool ServerSocket::Listen(uint16_t port) {
+  fd_ = socket(AF_INET6, SOCK_STREAM, 0);
+  if (fd_ < 0) {
+    return false;
+  }
+  int flag = 1;
+  setsockopt(fd_, SOL_SOCKET, SO_REUSEADDR, &flag, sizeof(flag));
+  // Accepts IPv4 connections as well.
+  flag = 0;
+  setsockopt(fd_, IPPROTO_IPV6, IPV6_V6ONLY, &flag, sizeof(flag));
+
+  sockaddr_in6 address;
+  memset(&address, 0, sizeof(address));
+  address.sin6_family = AF_INET6;
+  address.sin6_addr = in6addr_any;
+  address.sin6_port = htons(port);
+  return bind(fd_, reinterpret_cast<sockaddr *>(&address), sizeof(address))
+      == 0 && listen(fd_, SOMAXCONN) == 0;
+}
+
+uint16_t ServerSocket::Port() const {
+  sockaddr_in6 address;
+  socklen_t address_size = sizeof(address);
+  if (getsockname(fd_, reinterpret_cast<sockaddr *>(&address), &address_size)
+      != 0) {
+    return 0;
+  }
+  return ntohs(address.sin6_port);
+}
+
+unique_ptr<Socket> ServerSocket::Accept() {
+  int fd = accept(fd_, nullptr, nullptr);
+  if (fd < 0) {
+    return nullptr;
+  }
+  DisableNagle(fd);
+  return unique_ptr<Socket>(new Socket(fd));
+}
+
+}
+}
@@ -0,0 +1,63 @@
+#ifndef FOOLGO_SRC_UTIL_SOCKET_H_
+#define FOOLGO_SRC_UTIL_SOCKET_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "../def.h"
+
+namespace foolgo {
+namespace util {
+
+/**
+ * A blocking TCP connection, which is closed when destroyed.
+ */
+class Socket {
+ public:
+  explicit Socket(int fd) : fd_(fd) {}
+  ~Socket();
+  DISALLOW_COPY_AND_ASSIGN_AND_MOVE(Socket)
+
+  // Returns nullptr if the connection fails.
+  static std::unique_ptr<Socket> Connect(const std::string &host,
+                                         uint16_t port);
+
+  // Both return false if the connection is closed or broken before all the
+  // bytes are transferred.
+  bool SendAll(const void *data, std::size_t size);
+  bool ReceiveAll(void *data, std::size_t size);
+
+  // A receive waiting longer than the timeout fails, and 0 waits forever.
+  // Returns false if the timeout can not be set.
+  bool SetReceiveTimeout(int milliseconds);
+
+ private:
+  int fd_;
+};
+
+/**
+ * A socket listening on a TCP port of all interfaces.
+ */
+class ServerSocket {
+ public:
+  ServerSocket() = default;
+  ~ServerSocket();
+  DISALLOW_COPY_AND_ASSIGN_AND_MOVE(ServerSocket)
+
+  // Returns false if the port can not be listened on. Port 0 listens on a
+  // free port, which Port returns.
+  bool Listen(uint16_t port);
+  uint16_t Port() const;
+  // Blocks until a connection comes, or returns nullptr on failure.
+  std::unique_ptr<Socket> Accept();
+
+ private:
+  int fd_ = -1;
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef FOOLGO_SRC_UTIL_SPSC_QUEUE_H_
+#define FOOLGO_SRC_UTIL_SPSC_QUEUE_H_
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "../def.h"
+#include "memory_util.h"
+
+namespace foolgo {
+namespace util {
+
+/**
+ * A bounded ring of values passed from one producer thread to one consumer
+ * thread without locks. Each index is written by one side only, and is
+ * published by a release store after its slot is written or read, so neither
+ * side ever waits for the other inside the queue. The indexes are on separate
+ * cache lines, so that the two sides do not share one.
+ */
+template<typename T>
+class SpscQueue {
+ public:
+  explicit SpscQueue(std::size_t capacity)
+      : slots_(capacity + 1), head_(0), tail_(0) {
+    assert(capacity > 0);
+  }
+  DISALLOW_COPY_AND_ASSIGN_AND_MOVE(SpscQueue)
+
+  // Called by the producer only. Returns false if the queue is full, in which
+  // case the value is not moved from.
+  bool TryPush(T &&value) {
+    std::size_t tail = tail_.load(std::memory_order_relaxed);
+    std::size_t next_tail = NextIndex(tail);
+    if (next_tail == head_.load(std::memory_order_acquire)) {
+      return false;
+    }
+    slots_[tail] = std::move(value);
+    tail_.store(next_tail, std::memory_order_release);
+    return true;
+  }
+
+  // Called by the consumer only. Returns false if the queue is empty.
+  bool TryPop(T *value) {
+    std::size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire)) {
+      return false;
+    }
+    *value = std::move(slots_[head]);
+    head_.store(NextIndex(head), std::memory_order_release);
+    return true;
+  }
+
+ private:
+  // One more slot than the capacity, so that a full queue differs from an
+  // empty one.
+  std::vector<T> slots_;
+  alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> head_;
+  alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> tail_;
+
+  std::size_t NextIndex(std::size_t index) const {
+    return index + 1 == slots_.size() ? 0 : index + 1;
+  }
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,141 @@
+#include "thread_pool.h"
+
+#include <cassert>
+
+namespace foolgo {
+namespace util {
+
+ThreadPool::ThreadPool(int thread_count, ThreadAffinity thread_affinity)
+    : thread_affinity_(thread_affinity) {
+  assert(thread_count > 0);
+  workers_.reserve(thread_count);
+  for (int i = 0; i < thread_count; ++i) {
+    workers_.push_back(std::unique_ptr<Worker>(new Worker));
+  }
+
+  threads_.reserve(thread_count);
+  for (int i = 0; i < thread_count; ++i) {
+    threads_.push_back(std::thread(&ThreadPool::Run, this, i));
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_stopping_ = true;
+  }
+  task_condition_.notify_all();
+
+  for (std::thread &thread : threads_) {
+    thread.join();
+  }
+}
+
+int ThreadPool::WorkerNumaNode(int worker_index) const {
+  switch (thread_affinity_) {
+    case ThreadAffinity::CPU:
+      return NumaNodeOfCpu(worker_index % CpuCount());
+    case ThreadAffinity::NUMA_NODE:
+      return worker_index % NumaNodeCount();
+    default:
+      return ANY_NUMA_NODE;
+  }
+}
+
+void ThreadPool::Submit(int worker_index, const Task &task) {
+  Worker &worker = *workers_.at(worker_index);
+  {
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    worker.tasks.push_back(task);
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++queued_count_;
+    ++unfinished_count_;
+  }
+  task_condition_.notify_one();
+}
+
+void ThreadPool::Submit(const Task &task) {
+  int worker_index = next_worker_index_;
+  next_worker_index_ = (next_worker_index_ + 1) % ThreadCount();
+  Submit(worker_index, task);
+}
+
+void ThreadPool::Wait() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  done_condition_.wait(lock, [this]() {
+    return unfinished_count_ == 0;
+  });
+}
+
+bool ThreadPool::PopTask(int worker_index, Task *task) {
+  for (int i = 0; i < ThreadCount(); ++i) {
+    bool is_own = i == 0;
+    Worker &worker = *workers_[(worker_index + i) % ThreadCount()];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.tasks.empty()) {
+      continue;
+    }
+    if (is_own) {
+      *task = std::move(worker.tasks.front());
+      worker.tasks.pop_front();
+    } else {
+      *task = std::move(worker.tasks.back());
+      worker.tasks.pop_back();
+    }
+    return true;
+  }
+
+  return false;
+}
+
+void ThreadPool::PinCurrentThread(int worker_index) const {
+  switch (thread_affinity_) {
+    case ThreadAffinity::CPU:
+      PinCurrentThreadToCpu(worker_index % CpuCount());
+      break;
+    case ThreadAffinity::NUMA_NODE:
+      PinCurrentThreadToNumaNode(WorkerNumaNode(worker_index));
+      break;
+    default:
+      break;
+  }
+}
+
+void ThreadPool::Run(int worker_index) {
+  PinCurrentThread(worker_index);
+
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      task_condition_.wait(lock, [this]() {
+        return is_stopping_ || queued_count_ > 0;
+      });
+      if (queued_count_ == 0) {
+        return;
+      }
+      // A queued task is reserved by this worker, so it is taken below even
+      // if another worker steals the task submitted to this one.
+      --queued_count_;
+    }
+
+    Task task;
+    while (!PopTask(worker_index, &task)) {
+      std::this_thread::yield();
+    }
+    task(worker_index);
+
+    bool is_done;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      is_done = --unfinished_count_ == 0;
+    }
+    if (is_done) {
+      done_condition_.notify_all();
+    }
+  }
+}
+
+}
+}
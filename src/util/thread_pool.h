@@ -0,0 +1,80 @@
+#ifndef FOOLGO_SRC_UTIL_THREAD_POOL_H_
+#define FOOLGO_SRC_UTIL_THREAD_POOL_H_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../def.h"
+#include "numa_util.h"
+
+namespace foolgo {
+namespace util {
+
+// Where workers run: anywhere, each on one CPU in turn, or each on the CPUs
+// of one NUMA node in turn.
+enum class ThreadAffinity { NONE, CPU, NUMA_NODE };
+
+/**
+ * Threads kept alive until the pool is destroyed, so that searches of
+ * successive moves, or of several players in a process, start without
+ * creating threads. Each worker owns a deque of tasks: it takes tasks from the
+ * front of its own deque, and steals from the back of others' when its own is
+ * empty.
+ */
+class ThreadPool {
+ public:
+  // A task is given the index of the worker running it, which indexes states
+  // kept per worker.
+  typedef std::function<void(int)> Task;
+
+  explicit ThreadPool(int thread_count,
+                      ThreadAffinity thread_affinity = ThreadAffinity::NONE);
+  ~ThreadPool();
+  DISALLOW_COPY_AND_ASSIGN_AND_MOVE(ThreadPool)
+
+  int ThreadCount() const {
+    return threads_.size();
+  }
+  // The NUMA node the worker is pinned to, or ANY_NUMA_NODE if it is not.
+  int WorkerNumaNode(int worker_index) const;
+
+  // Puts the task to the deque of the worker, or of a worker chosen in turn.
+  void Submit(int worker_index, const Task &task);
+  void Submit(const Task &task);
+  // Blocks until all submitted tasks are finished.
+  void Wait();
+
+ private:
+  struct Worker {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  ThreadAffinity thread_affinity_;
+  std::vector<std::thread> threads_;
+  std::vector<std::unique_ptr<Worker>> workers_;
+  int next_worker_index_ = 0;
+
+  // Guards the counts below and the stopping flag.
+  std::mutex mutex_;
+  std::condition_variable task_condition_;
+  std::condition_variable done_condition_;
+  // Tasks in deques, and tasks submitted but not finished.
+  int queued_count_ = 0;
+  int unfinished_count_ = 0;
+  bool is_stopping_ = false;
+
+  void PinCurrentThread(int worker_index) const;
+  bool PopTask(int worker_index, Task *task);
+  void Run(int worker_index);
+};
+
+}
+}
+
+#endif
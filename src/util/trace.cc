@@ -0,0 +1,138 @@
+#include "trace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace foolgo {
+namespace util {
+
+using std::unique_ptr;
+using std::vector;
+
+namespace {
+
+struct TraceEvent {
+  const char *name;
+  int64_t begin_nanoseconds;
+  // Of a counter, the value.
+  int64_t duration_nanoseconds;
+  bool is_counter;
+};
+
+// Written by its thread only. The count is published after each event.
+struct TraceBuffer {
+  vector<TraceEvent> events;
+  std::atomic<uint64_t> event_count;
+  int thread_index;
+
+  explicit TraceBuffer(int thread_index)
+      : events(TRACE_EVENT_COUNT_PER_THREAD),
+        event_count(0),
+        thread_index(thread_index) {}
+};
+
+// Buffers are kept after their threads exit, so that pool threads of ended
+// searches are traced too.
+std::mutex &BuffersMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+vector<unique_ptr<TraceBuffer>> &Buffers() {
+  static vector<unique_ptr<TraceBuffer>> buffers;
+  return buffers;
+}
+
+TraceBuffer *ThreadBuffer() {
+  thread_local TraceBuffer *buffer = nullptr;
+  if (buffer == nullptr) {
+    std::lock_guard<std::mutex> lock(BuffersMutex());
+    auto &buffers = Buffers();
+    buffers.emplace_back(new TraceBuffer(buffers.size()));
+    buffer = buffers.back().get();
+  }
+  return buffer;
+}
+
+void Record(const TraceEvent &event) {
+  TraceBuffer *buffer = ThreadBuffer();
+  uint64_t count = buffer->event_count.load(std::memory_order_relaxed);
+  buffer->events[count % TRACE_EVENT_COUNT_PER_THREAD] = event;
+  buffer->event_count.store(count + 1, std::memory_order_release);
+}
+
+void WriteJsonString(const char *s, std::ostream &os) {
+  os << '"';
+  for (; *s != '\0'; ++s) {
+    if (*s == '"' || *s == '\\') {
+      os << '\\';
+    }
+    os << *s;
+  }
+  os << '"';
+}
+
+}
+
+int64_t TraceNanoseconds() {
+  static const auto start_time = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - start_time).count();
+}
+
+void RecordTraceEvent(const char *name, int64_t begin_nanoseconds,
+                      int64_t duration_nanoseconds) {
+  Record(TraceEvent{name, begin_nanoseconds, duration_nanoseconds, false});
+}
+
+void RecordTraceCounter(const char *name, int64_t value) {
+  Record(TraceEvent{name, TraceNanoseconds(), value, true});
+}
+
+void WriteChromeTrace(std::ostream &os) {
+  std::lock_guard<std::mutex> lock(BuffersMutex());
+  std::ios_base::fmtflags flags = os.flags();
+  std::streamsize precision = os.precision();
+  os << std::fixed << std::setprecision(3) << "{\"traceEvents\":[";
+  bool is_first = true;
+  for (const auto &buffer : Buffers()) {
+    uint64_t count = buffer->event_count.load(std::memory_order_acquire);
+    uint64_t begin = count - std::min<uint64_t>(count,
+                                                TRACE_EVENT_COUNT_PER_THREAD);
+    for (uint64_t i = begin; i < count; ++i) {
+      const TraceEvent &event =
+          buffer->events[i % TRACE_EVENT_COUNT_PER_THREAD];
+      os << (is_first ? "\n" : ",\n") << "{\"name\":";
+      is_first = false;
+      WriteJsonString(event.name, os);
+      // Timestamps are in microseconds.
+      os << ",\"pid\":0,\"tid\":" << buffer->thread_index << ",\"ts\":"
+          << event.begin_nanoseconds / 1000.0;
+      if (event.is_counter) {
+        os << ",\"ph\":\"C\",\"args\":{\"value\":"
+            << event.duration_nanoseconds << "}}";
+      } else {
+        os << ",\"ph\":\"X\",\"dur\":" << event.duration_nanoseconds / 1000.0
+            << "}";
+      }
+    }
+  }
+  os << "\n],\"displayTimeUnit\":\"ns\"}\n";
+  os.flags(flags);
+  os.precision(precision);
+}
+
+void ClearTrace() {
+  std::lock_guard<std::mutex> lock(BuffersMutex());
+  for (const auto &buffer : Buffers()) {
+    buffer->event_count.store(0, std::memory_order_relaxed);
+  }
+}
+
+}
+}
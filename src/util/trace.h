@@ -0,0 +1,66 @@
+#ifndef FOOLGO_SRC_UTIL_TRACE_H_
+#define FOOLGO_SRC_UTIL_TRACE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+#include "../def.h"
+
+// Hot paths are traced only if FOOLGO_TRACE is defined, and the macros
+// compile to nothing otherwise. Names should be string literals, whose
+// pointers are kept until the trace is written.
+#ifdef FOOLGO_TRACE
+#define FOOLGO_TRACE_CONCAT_INNER(a, b) a##b
+#define FOOLGO_TRACE_CONCAT(a, b) FOOLGO_TRACE_CONCAT_INNER(a, b)
+// Records the time from here to the end of the scope.
+#define FOOLGO_TRACE_SCOPE(name) \
+    foolgo::util::TraceScope FOOLGO_TRACE_CONCAT(trace_scope_, __LINE__)(name)
+#define FOOLGO_TRACE_COUNTER(name, value) \
+    foolgo::util::RecordTraceCounter(name, value)
+#else
+#define FOOLGO_TRACE_SCOPE(name)
+#define FOOLGO_TRACE_COUNTER(name, value)
+#endif
+
+namespace foolgo {
+namespace util {
+
+// Events kept by each thread, of which the oldest are overwritten.
+constexpr std::size_t TRACE_EVENT_COUNT_PER_THREAD = 1 << 16;
+
+// Nanoseconds since the first call in the process.
+int64_t TraceNanoseconds();
+
+// Each thread records to a ring buffer of its own, which takes no lock after
+// the first event of the thread.
+void RecordTraceEvent(const char *name, int64_t begin_nanoseconds,
+                      int64_t duration_nanoseconds);
+void RecordTraceCounter(const char *name, int64_t value);
+
+// Writes events of all threads in the Chrome trace event format, which
+// chrome://tracing and Perfetto open. Threads should stop recording before,
+// since slots being overwritten are not skipped.
+void WriteChromeTrace(std::ostream &os);
+// Drops the recorded events, while no thread records.
+void ClearTrace();
+
+class TraceScope {
+ public:
+  explicit TraceScope(const char *name)
+      : name_(name), begin_nanoseconds_(TraceNanoseconds()) {}
+  ~TraceScope() {
+    RecordTraceEvent(name_, begin_nanoseconds_,
+                     TraceNanoseconds() - begin_nanoseconds_);
+  }
+  DISALLOW_COPY_AND_ASSIGN_AND_MOVE(TraceScope)
+
+ private:
+  const char *name_;
+  int64_t begin_nanoseconds_;
+};
+
+}
+}
+
+#endif
@@ -10,13 +10,14 @@
 namespace foolgo {
 namespace util {
 
-void RandomizeVector(std::vector<PositionIndex> *vctr, uint32_t seed) {
+void RandomizeVector(std::vector<PositionIndex> *vctr,
+                     RandomEngine *random_engine) {
   int len = vctr->size();
   assert(len > 0);
 
   for (int i = 0; i < len; ++i) {
     int max = len - i - 1;
-    int rand = Rand(max, seed) + i;
+    int rand = random_engine->Uniform(max) + i;
     std::swap(vctr->at(i), vctr->at(rand));
   }
 }
@@ -4,23 +4,13 @@
 #include <vector>
 
 #include "../board/position.h"
+#include "rand.h"
 
 namespace foolgo {
 namespace util {
 
-void RandomizeVector(std::vector<PositionIndex> *vctr, uint32_t seed);
-
-template<typename T>
-std::vector<T> ConcatVectors(const std::vector<T> vctrs[4]) {
-  std::vector<T> r(vctrs[0]);
-
-  for (int i = 1; i < 4; ++i) {
-    for (const T &v : vctrs[i])
-      r.push_back(v);
-  }
-
-  return r;
-}
+void RandomizeVector(std::vector<PositionIndex> *vctr,
+                     RandomEngine *random_engine);
 
 }
 }
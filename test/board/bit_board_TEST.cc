@@ -0,0 +1,71 @@
+#include "../../src/board/bit_board.h"
+
+#include <gtest/gtest.h>
+
+#include "../../src/board/pos_cal.h"
+#include "../def_for_test.h"
+#include "../test.h"
+
+namespace foolgo {
+
+class BitBoardTest : public Test {
+ protected:
+  const PstionAndIndxCcltr<DEFAULT_BOARD_LEN> &calculator_ =
+      PstionAndIndxCcltr<DEFAULT_BOARD_LEN>::Ins();
+};
+
+TEST_F(BitBoardTest, Dilate) {
+  for (PositionIndex index = 0;
+      index < BoardLenSquare<DEFAULT_BOARD_LEN>(); ++index) {
+    BitBoard<DEFAULT_BOARD_LEN> point;
+    point.set(index);
+    BitBoard<DEFAULT_BOARD_LEN> expected;
+    for (PositionIndex adjacent_index : calculator_.AdjacentIndexes(index)) {
+      expected.set(adjacent_index);
+    }
+
+    EXPECT_EQ(point.North() | point.South() | point.East() | point.West(),
+              expected);
+    EXPECT_EQ(point.Adjacent(), expected);
+    EXPECT_EQ(point.Dilate(), expected.set(index));
+  }
+}
+
+TEST_F(BitBoardTest, FloodFill) {
+  BitBoard<DEFAULT_BOARD_LEN> wall;
+  for (BoardLen y = 0; y < DEFAULT_BOARD_LEN; ++y) {
+    wall.set(calculator_.GetIndex(Position(3, y)));
+  }
+  BitBoard<DEFAULT_BOARD_LEN> seed;
+  seed.set(calculator_.GetIndex(Position(0, 0)));
+
+  BitBoard<DEFAULT_BOARD_LEN> region = seed.FloodFill(~wall);
+
+  EXPECT_EQ(region.count(), 3 * DEFAULT_BOARD_LEN);
+  EXPECT_TRUE((region & wall).none());
+  EXPECT_EQ(region.FloodFill(~wall), region);
+  EXPECT_EQ(region.Dilate().count(), 4 * DEFAULT_BOARD_LEN);
+}
+
+TEST_F(BitBoardTest, SelectAndIterate) {
+  // Ones lie across words of a 19 * 19 board.
+  BitBoard<19> b;
+  std::vector<PositionIndex> indexes = {0, 5, 63, 64, 200, 360};
+  for (PositionIndex index : indexes) {
+    b.set(index);
+  }
+
+  EXPECT_EQ(b.count(), 6);
+  EXPECT_EQ(b.Indexes(), indexes);
+  for (int i = 0; i < 6; ++i) {
+    EXPECT_EQ(b.Select(i), indexes[i]);
+  }
+  EXPECT_EQ((~b).count(), BoardLenSquare<19>() - 6);
+  EXPECT_EQ(BitBoard<19>().set().AndNot(~b), b);
+  // Point 360 lies at the south east corner.
+  EXPECT_EQ(b.South().count(), 5);
+  EXPECT_EQ(b.East().count(), 5);
+  EXPECT_EQ(b.North().West().count(), 4);
+}
+
+}
@@ -2,7 +2,10 @@
 
 #include <gtest/gtest.h>
 #include <gtest/internal/gtest-internal.h>
+#include <algorithm>
 
+#include "game/monte_carlo_game.h"
+#include "util/rand.h"
 #include "../def_for_test.h"
 #include "../test.h"
 
@@ -22,5 +25,337 @@ TEST_F(BoardInGmTest, Init) {
   }
 }
 
+TEST_F(BoardInGmTest, Undo) {
+  ZobHasher<DEFAULT_BOARD_LEN>::Init(SEED);
+  RandomEngine random_engine(SEED);
+  FullBoard<DEFAULT_BOARD_LEN> board;
+  board.Init();
+  std::vector<std::string> strings;
+  std::vector<HashKey> hash_keys;
+
+  // Covers captures, suicides and passes of a whole random game.
+  while (!board.IsEnd()) {
+    strings.push_back(board.ToString(false));
+    hash_keys.push_back(board.HashKey());
+    auto playable_bitset = board.PlayableIndexBitSet(NextForce(board));
+    PositionIndex index = POSITION_INDEX_PASS;
+    if (playable_bitset.any()) {
+      index = playable_bitset.Select(
+          random_engine.Uniform(playable_bitset.count() - 1));
+    }
+    PlayWithUndo(&board, index);
+  }
+
+  while (!strings.empty()) {
+    board.Undo();
+    EXPECT_EQ(board.ToString(false), strings.back());
+    EXPECT_EQ(board.HashKey(), hash_keys.back());
+    strings.pop_back();
+    hash_keys.pop_back();
+  }
+
+  // Chains are reverted as well, so the same playout follows.
+  FullBoard<DEFAULT_BOARD_LEN> copy;
+  copy.Init();
+  RandomEngine engine_a(SEED), engine_b(SEED);
+  RunRandomPlayout(&board, &engine_a);
+  RunRandomPlayout(&copy, &engine_b);
+  EXPECT_EQ(board.ToString(false), copy.ToString(false));
+  EXPECT_EQ(board.HashKey(), copy.HashKey());
+}
+
+namespace {
+
+// The pattern code computed from the points, to be compared with the one
+// kept by moves.
+PatternCode ComputePatternCode(const FullBoard<DEFAULT_BOARD_LEN> &board,
+                               PositionIndex index) {
+  PatternCode code = 0;
+  int x = index % DEFAULT_BOARD_LEN;
+  int y = index / DEFAULT_BOARD_LEN;
+  for (int k = 0; k < PATTERN_NEIGHBOR_COUNT; ++k) {
+    int neighbor_x = x + PATTERN_NEIGHBOR_OFFSETS[k][0];
+    int neighbor_y = y + PATTERN_NEIGHBOR_OFFSETS[k][1];
+    bool is_in_board = neighbor_x >= 0 && neighbor_x < DEFAULT_BOARD_LEN
+        && neighbor_y >= 0 && neighbor_y < DEFAULT_BOARD_LEN;
+    code = SetPatternNeighborState(code, 2 * k, is_in_board ?
+        board.GetPointState(neighbor_y * DEFAULT_BOARD_LEN + neighbor_x) :
+        OFF_BOARD_PATTERN_STATE);
+  }
+  return code;
+}
+
+void ExpectPatternCodes(const FullBoard<DEFAULT_BOARD_LEN> &board) {
+  for (PositionIndex i = 0; i < BoardLenSquare<DEFAULT_BOARD_LEN>(); ++i) {
+    EXPECT_EQ(board.GetPatternCode(i), ComputePatternCode(board, i));
+  }
+}
+
+}
+
+TEST_F(BoardInGmTest, PatternCodes) {
+  ZobHasher<DEFAULT_BOARD_LEN>::Init(SEED);
+  RandomEngine random_engine(SEED);
+  FullBoard<DEFAULT_BOARD_LEN> board;
+  board.Init();
+  ExpectPatternCodes(board);
+  int move_count = 0;
+
+  // Codes are kept by captures and undos too.
+  while (!board.IsEnd()) {
+    auto playable_bitset = board.PlayableIndexBitSet(NextForce(board));
+    PositionIndex index = POSITION_INDEX_PASS;
+    if (playable_bitset.any()) {
+      index = playable_bitset.Select(
+          random_engine.Uniform(playable_bitset.count() - 1));
+    }
+    PlayWithUndo(&board, index);
+    ++move_count;
+    ExpectPatternCodes(board);
+  }
+  FullBoard<DEFAULT_BOARD_LEN> copy;
+  copy.Copy(board);
+  ExpectPatternCodes(copy);
+
+  for (int i = 0; i < move_count / 2; ++i) {
+    board.Undo();
+  }
+  ExpectPatternCodes(board);
+}
+
+namespace {
+
+// Compares the airs kept by pseudo airs with those counted from the points.
+void ExpectChainAirs(const FullBoard<DEFAULT_BOARD_LEN> &board) {
+  BitSet<DEFAULT_BOARD_LEN> empty_points = board.PointBitSet(EMPTY_POINT);
+  for (PointState point : {BLACK_POINT, WHITE_POINT}) {
+    const BitSet<DEFAULT_BOARD_LEN> &pieces = board.PointBitSet(point);
+    for (PositionIndex index : pieces) {
+      BitSet<DEFAULT_BOARD_LEN> chain;
+      chain.set(index);
+      chain = chain.FloodFill(pieces);
+      BitSet<DEFAULT_BOARD_LEN> airs = chain.Adjacent() & empty_points;
+      EXPECT_EQ(board.ChainAirCount(index), airs.count());
+      for (piece_structure::AirCount max_air_count : {1, 2, 3}) {
+        EXPECT_EQ(board.ChainAirCount(index, max_air_count),
+                  std::min<int>(airs.count(), max_air_count));
+      }
+      for (PositionIndex piece_index : chain) {
+        EXPECT_EQ(board.ChainHead(piece_index), board.ChainHead(index));
+      }
+      EXPECT_EQ(board.IsChainInAtari(index), airs.count() == 1);
+      if (airs.count() == 1) {
+        EXPECT_EQ(board.ChainLastAir(index), *airs.begin());
+      }
+    }
+  }
+}
+
+}
+
+TEST_F(BoardInGmTest, ChainAirs) {
+  ZobHasher<DEFAULT_BOARD_LEN>::Init(SEED);
+  RandomEngine random_engine(SEED);
+  FullBoard<DEFAULT_BOARD_LEN> board;
+  board.Init();
+  int move_count = 0;
+
+  while (!board.IsEnd()) {
+    const auto &playable_bitset = board.PlayableIndexBitSet(NextForce(board));
+    PositionIndex index = POSITION_INDEX_PASS;
+    if (playable_bitset.any()) {
+      index = playable_bitset.Select(
+          random_engine.Uniform(playable_bitset.count() - 1));
+    }
+    PlayWithUndo(&board, index);
+    ++move_count;
+    ExpectChainAirs(board);
+  }
+
+  for (int i = 0; i < move_count / 2; ++i) {
+    board.Undo();
+  }
+  ExpectChainAirs(board);
+}
+
+namespace {
+
+// Compares the playable states of real eyes, which are recomputed around the
+// changes of each move only, with those recomputed over every real eye: the
+// opposite force may play in a real eye only when the chain around it is in
+// atari.
+void ExpectRealEyesPlayableStates(const FullBoard<DEFAULT_BOARD_LEN> &board) {
+  auto &calculator = PstionAndIndxCcltr<DEFAULT_BOARD_LEN>::Ins();
+  for (Force force : {BLACK_FORCE, WHITE_FORCE}) {
+    Force opposite_force = OppositeForce(force);
+    for (PositionIndex eye_index : board.RealEyeBitSet(force)) {
+      if (eye_index == board.KoIndex()) {
+        continue;
+      }
+      PositionIndex adjacent_index =
+          calculator.AdjacentIndexes(eye_index).indexes[0];
+      EXPECT_EQ(board.PlayableIndexBitSet(opposite_force)[eye_index],
+                board.IsChainInAtari(adjacent_index));
+    }
+  }
+}
+
+}
+
+TEST_F(BoardInGmTest, RealEyesPlayableStates) {
+  ZobHasher<DEFAULT_BOARD_LEN>::Init(SEED);
+  RandomEngine random_engine(SEED);
+
+  for (int game = 0; game < 20; ++game) {
+    FullBoard<DEFAULT_BOARD_LEN> board;
+    board.Init();
+    int move_count = 0;
+
+    while (!board.IsEnd()) {
+      const auto &playable_bitset = board.PlayableIndexBitSet(NextForce(board));
+      PositionIndex index = POSITION_INDEX_PASS;
+      if (playable_bitset.any()) {
+        index = playable_bitset.Select(
+            random_engine.Uniform(playable_bitset.count() - 1));
+      }
+      PlayWithUndo(&board, index);
+      ++move_count;
+      ExpectRealEyesPlayableStates(board);
+    }
+
+    for (int i = 0; i < move_count / 2; ++i) {
+      board.Undo();
+    }
+    ExpectRealEyesPlayableStates(board);
+  }
+}
+
+TEST_F(BoardInGmTest, ChildHashKey) {
+  ZobHasher<DEFAULT_BOARD_LEN>::Init(SEED);
+  RandomEngine random_engine(SEED);
+
+  for (int game = 0; game < 20; ++game) {
+    FullBoard<DEFAULT_BOARD_LEN> board;
+    board.Init();
+
+    while (!board.IsEnd()) {
+      Force force = NextForce(board);
+      for (PositionIndex index : board.PlayableIndexes(force)) {
+        Move move(force, index);
+        if (board.IsSuicide(move)) {
+          continue;
+        }
+        FullBoard<DEFAULT_BOARD_LEN> child;
+        child.Copy(board);
+        child.PlayMove(move);
+        EXPECT_EQ(board.ChildHashKey(move), child.HashKey());
+      }
+
+      auto playable_bitset = board.PlayableIndexBitSet(force);
+      PositionIndex index = POSITION_INDEX_PASS;
+      if (playable_bitset.any()) {
+        index = playable_bitset.Select(
+            random_engine.Uniform(playable_bitset.count() - 1));
+      }
+      Play(&board, index);
+    }
+  }
+}
+
+TEST_F(BoardInGmTest, SymmetricHashKeys) {
+  ZobHasher<DEFAULT_BOARD_LEN>::Init(SEED);
+  RandomEngine random_engine(SEED);
+
+  for (int symmetry = 0; symmetry < SYMMETRY_COUNT; ++symmetry) {
+    // Only the board of the game keeps its symmetric keys.
+    FullBoard<DEFAULT_BOARD_LEN> board, symmetric_board;
+    board.SetKeepsSymmetricHashKeys(true);
+    board.Init();
+    symmetric_board.Init();
+
+    while (!board.IsEnd()) {
+      EXPECT_EQ(board.SymmetricHashKey(symmetry), symmetric_board.HashKey());
+      EXPECT_EQ(board.CanonicalHashKey(), symmetric_board.CanonicalHashKey());
+
+      Force force = NextForce(board);
+      auto playable_bitset = board.PlayableIndexBitSet(force);
+      PositionIndex index = POSITION_INDEX_PASS;
+      if (playable_bitset.any()) {
+        index = playable_bitset.Select(
+            random_engine.Uniform(playable_bitset.count() - 1));
+        if (!board.IsSuicide(Move(force, index))) {
+          FullBoard<DEFAULT_BOARD_LEN> child;
+          child.Copy(board);
+          child.PlayMove(Move(force, index));
+          EXPECT_EQ(board.ChildCanonicalHashKey(Move(force, index)),
+                    child.CanonicalHashKey());
+        }
+      }
+      PlayWithUndo(&board, index);
+      Play(&symmetric_board, index == POSITION_INDEX_PASS ? index :
+          SymmetricIndex<DEFAULT_BOARD_LEN>(symmetry, index));
+    }
+
+    // Kept keys are reverted by undo.
+    board.Undo();
+    FullBoard<DEFAULT_BOARD_LEN> copy;
+    copy.Copy(board);
+    EXPECT_EQ(board.SymmetricHashKey(symmetry),
+              copy.SymmetricHashKey(symmetry));
+  }
+}
+
+TEST_F(BoardInGmTest, Area) {
+  ZobHasher<DEFAULT_BOARD_LEN>::Init(SEED);
+  FullBoard<DEFAULT_BOARD_LEN> board;
+  board.Init();
+  auto &calculator = PstionAndIndxCcltr<DEFAULT_BOARD_LEN>::Ins();
+
+  // Black walls the three western columns off, and white the others.
+  for (BoardLen y = 0; y < DEFAULT_BOARD_LEN; ++y) {
+    board.PlayMove(Move(BLACK_FORCE, calculator.GetIndex(Position(2, y))));
+    board.PlayMove(Move(WHITE_FORCE, calculator.GetIndex(Position(3, y))));
+  }
+
+  EXPECT_EQ(board.Area(BLACK_FORCE), 3 * DEFAULT_BOARD_LEN);
+  EXPECT_EQ(board.Area(WHITE_FORCE), 2 * DEFAULT_BOARD_LEN);
+  EXPECT_EQ(board.Region(BLACK_FORCE), board.BlackRegion());
+
+  // Empty points reaching a white piece inside the black wall belong to
+  // neither force, since dead pieces are not removed.
+  board.PlayMove(Move(WHITE_FORCE, calculator.GetIndex(Position(0, 0))));
+  EXPECT_EQ(board.Area(BLACK_FORCE), DEFAULT_BOARD_LEN);
+  EXPECT_EQ(board.Area(WHITE_FORCE), 2 * DEFAULT_BOARD_LEN + 1);
+}
+
+TEST_F(BoardInGmTest, PlayableIndexBitSetWithoutKo) {
+  ZobHasher<DEFAULT_BOARD_LEN>::Init(SEED);
+  FullBoard<DEFAULT_BOARD_LEN> board;
+  board.Init();
+  auto &calculator = PstionAndIndxCcltr<DEFAULT_BOARD_LEN>::Ins();
+  const int moves[][2] = {{1, 0}, {2, 0}, {0, 1}, {1, 1}, {1, 2}, {3, 1},
+      {4, 4}, {2, 2}};
+  for (const auto &move : moves) {
+    board.PlayMove(Move(OppositeForce(board.LastForce()),
+                        calculator.GetIndex(Position(move[0], move[1]))));
+  }
+  PositionIndex ko_index = calculator.GetIndex(Position(1, 1));
+
+  // Black takes the ko, which white can not take back at once.
+  board.PlayMoveWithUndo(Move(BLACK_FORCE,
+                              calculator.GetIndex(Position(2, 1))));
+  ASSERT_EQ(board.KoIndex(), ko_index);
+  EXPECT_FALSE(board.PlayableIndexBitSet(WHITE_FORCE)[ko_index]);
+  EXPECT_FALSE(board.IsEnd());
+
+  board.PassWithUndo(WHITE_FORCE);
+  EXPECT_TRUE(board.PlayableIndexBitSet(WHITE_FORCE)[ko_index]);
+  board.Undo();
+  EXPECT_FALSE(board.PlayableIndexBitSet(WHITE_FORCE)[ko_index]);
+  board.Undo();
+  EXPECT_EQ(board.GetPointState(ko_index), WHITE_FORCE);
+  EXPECT_FALSE(board.PlayableIndexBitSet(WHITE_FORCE)[ko_index]);
+}
+
 }
 }
@@ -0,0 +1,45 @@
+#include "../../src/board/pos_cal.h"
+
+#include <gtest/gtest.h>
+
+#include "../def_for_test.h"
+#include "../test.h"
+
+namespace foolgo {
+
+class PstionAndIndxCcltrTest : public Test {
+ protected:
+  const PstionAndIndxCcltr<DEFAULT_BOARD_LEN> &calculator_ =
+      PstionAndIndxCcltr<DEFAULT_BOARD_LEN>::Ins();
+};
+
+TEST_F(PstionAndIndxCcltrTest, NeighborIndexes) {
+  for (PositionIndex index = 0;
+      index < BoardLenSquare<DEFAULT_BOARD_LEN>(); ++index) {
+    const Position &position = calculator_.GetPosition(index);
+    const NeighborIndexes &adjacent = calculator_.AdjacentIndexes(index);
+    const NeighborIndexes &oblique = calculator_.ObliqueIndexes(index);
+    int adjacent_count = 0, oblique_count = 0;
+
+    for (int i = 0; i < 4; ++i) {
+      Position adjacent_position = AdjacentPosition(position, i);
+      if (calculator_.IsInBoard(adjacent_position)) {
+        EXPECT_EQ(adjacent.indexes[adjacent_count++],
+                  calculator_.GetIndex(adjacent_position));
+      }
+      Position oblique_position = ObliquePosition(position, i);
+      if (calculator_.IsInBoard(oblique_position)) {
+        EXPECT_EQ(oblique.indexes[oblique_count++],
+                  calculator_.GetIndex(oblique_position));
+      }
+    }
+
+    EXPECT_EQ(adjacent.count, adjacent_count);
+    EXPECT_EQ(oblique.count, oblique_count);
+  }
+
+  EXPECT_EQ(calculator_.AdjacentIndexes(0).count, 2);
+  EXPECT_EQ(calculator_.ObliqueIndexes(0).count, 1);
+}
+
+}
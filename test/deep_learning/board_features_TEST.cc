@@ -0,0 +1,94 @@
+#include "../../src/deep_learning/board_features.h"
+
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "board/full_board.h"
+#include "board/zob_hasher.h"
+#include "game/monte_carlo_game.h"
+#include "util/rand.h"
+#include "../def_for_test.h"
+#include "../test.h"
+
+namespace foolgo {
+
+class BoardFeaturesTest : public Test {
+ protected:
+  virtual void SetUp() {
+    Test::SetUp();
+    ZobHasher<DEFAULT_BOARD_LEN>::Init(SEED);
+  }
+};
+
+TEST_F(BoardFeaturesTest, MatchesPointStates) {
+  const int plane_len = FeaturePlaneLen<DEFAULT_BOARD_LEN>();
+  const int plane_size = plane_len * plane_len;
+  FullBoard<DEFAULT_BOARD_LEN> empty_board;
+  empty_board.Init();
+  FullBoard<DEFAULT_BOARD_LEN> full_board;
+  full_board.Copy(empty_board);
+  RandomEngine random_engine(SEED);
+  PlayoutConfig playout_config;
+  playout_config.max_length_factor = 0.5f;
+  RunRandomPlayout<DEFAULT_BOARD_LEN>(&full_board, &random_engine, nullptr,
+                                      playout_config);
+
+  // The second board follows the first in the batch.
+  std::vector<float> features(2 * FeatureSize<DEFAULT_BOARD_LEN>(), -1.0f);
+  EncodeBoardFeatures<DEFAULT_BOARD_LEN>({&empty_board, &full_board},
+                                          features.data());
+  const float *board_features = features.data()
+      + FeatureSize<DEFAULT_BOARD_LEN>();
+  Force own_force = NextForce(full_board);
+
+  for (int y = 0; y < plane_len; ++y) {
+    for (int x = 0; x < plane_len; ++x) {
+      auto feature = [&](FeaturePlane plane) {
+        return board_features[plane * plane_size + y * plane_len + x];
+      };
+      EXPECT_EQ(feature(SIDE_PLANE), full_board.LastForce());
+      bool is_border = x == 0 || y == 0 || x == plane_len - 1
+          || y == plane_len - 1;
+      EXPECT_EQ(feature(BORDER_PLANE), is_border);
+      if (is_border) {
+        continue;
+      }
+
+      PositionIndex index = (y - 1) * DEFAULT_BOARD_LEN + x - 1;
+      PointState point_state = full_board.GetPointState(index);
+      EXPECT_EQ(feature(OWN_PIECE_PLANE),
+                point_state == ForceToPointState(own_force));
+      EXPECT_EQ(feature(OPPONENT_PIECE_PLANE),
+                point_state == ForceToPointState(OppositeForce(own_force)));
+      EXPECT_EQ(feature(KO_PLANE), full_board.KoIndex() == index);
+      int air_count = point_state == EMPTY_POINT ?
+          0 : full_board.ChainAirCount(index);
+      EXPECT_EQ(feature(ONE_LIBERTY_PLANE), air_count == 1);
+      EXPECT_EQ(feature(TWO_LIBERTIES_PLANE), air_count == 2);
+      EXPECT_EQ(feature(MORE_LIBERTIES_PLANE), air_count >= 3);
+    }
+  }
+}
+
+TEST_F(BoardFeaturesTest, SampleMatchesBoard) {
+  FullBoard<DEFAULT_BOARD_LEN> full_board;
+  full_board.Init();
+  RandomEngine random_engine(SEED);
+  PlayoutConfig playout_config;
+  playout_config.max_length_factor = 0.8f;
+  RunRandomPlayout<DEFAULT_BOARD_LEN>(&full_board, &random_engine, nullptr,
+                                      playout_config);
+  Sample<DEFAULT_BOARD_LEN> sample;
+  sample.Pack(full_board, 3, -1);
+  EXPECT_EQ(sample.position_index, 3);
+  EXPECT_EQ(sample.value, -1);
+
+  std::vector<float> board_features(FeatureSize<DEFAULT_BOARD_LEN>());
+  EncodeBoardFeatures(full_board, board_features.data());
+  std::vector<float> sample_features(FeatureSize<DEFAULT_BOARD_LEN>());
+  EncodeSampleFeatures(sample, sample_features.data());
+  EXPECT_EQ(sample_features, board_features);
+  EXPECT_LE(sizeof(Sample<19>), 104u);
+}
+
+}
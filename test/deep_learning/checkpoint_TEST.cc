@@ -0,0 +1,60 @@
+#include "../../src/deep_learning/checkpoint.h"
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../test.h"
+
+namespace foolgo {
+
+class CheckpointTest : public Test {
+};
+
+TEST_F(CheckpointTest, WriteAndMap) {
+  std::string path = testing::TempDir() + "checkpoint_test.model";
+  std::vector<float> weight = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  std::vector<float> bias = {-1.0f, -2.0f, -3.0f};
+  {
+    CheckpointWriter writer;
+    writer.AddTensor("weight", 3, 2, weight.data());
+    writer.AddTensor("bias", 3, 1, bias.data());
+    ASSERT_TRUE(writer.Write(path));
+  }
+  EXPECT_NE(access((path + ".tmp").c_str(), F_OK), 0);
+
+  std::unique_ptr<Checkpoint> checkpoint = Checkpoint::Open(path);
+  ASSERT_NE(checkpoint, nullptr);
+  const float *mapped_weight = checkpoint->Tensor("weight", 3, 2);
+  const float *mapped_bias = checkpoint->Tensor("bias", 3, 1);
+  ASSERT_NE(mapped_weight, nullptr);
+  ASSERT_NE(mapped_bias, nullptr);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(mapped_bias) % CHECKPOINT_ALIGNMENT,
+            0u);
+  EXPECT_EQ(std::vector<float>(mapped_weight, mapped_weight + 6), weight);
+  EXPECT_EQ(std::vector<float>(mapped_bias, mapped_bias + 3), bias);
+
+  EXPECT_EQ(checkpoint->Tensor("weight", 2, 3), nullptr);
+  EXPECT_EQ(checkpoint->Tensor("output", 3, 1), nullptr);
+  std::remove(path.c_str());
+}
+
+TEST_F(CheckpointTest, RejectTruncated) {
+  std::string path = testing::TempDir() + "checkpoint_test_truncated.model";
+  std::vector<float> weight(100, 1.0f);
+  CheckpointWriter writer;
+  writer.AddTensor("weight", 10, 10, weight.data());
+  ASSERT_TRUE(writer.Write(path));
+  ASSERT_NE(Checkpoint::Open(path), nullptr);
+
+  ASSERT_EQ(truncate(path.c_str(), sizeof(CheckpointHeader) + 32), 0);
+  EXPECT_EQ(Checkpoint::Open(path), nullptr);
+  std::remove(path.c_str());
+  EXPECT_EQ(Checkpoint::Open(path), nullptr);
+}
+
+}
@@ -0,0 +1,95 @@
+#include "../../src/deep_learning/cnn/conv_layer.h"
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+
+#include "../test.h"
+
+namespace foolgo {
+
+class ConvLayerTest : public Test {
+};
+
+namespace {
+
+// The sum of the outputs weighted by their indexes, whose gradient of each
+// output is its index.
+float WeightedSum(const std::vector<float> &output) {
+  float sum = 0.0f;
+  for (size_t i = 0; i < output.size(); ++i) {
+    sum += i * output[i];
+  }
+  return sum;
+}
+
+}
+
+TEST_F(ConvLayerTest, Forward) {
+  ConvParams params;
+  params.Init(1, 1);
+  params.weight.setOnes();
+  params.bias << -10.0f;
+  // Maps of 4x4 with values 0 to 15 for two samples.
+  std::vector<float> input(32);
+  for (int i = 0; i < 32; ++i) {
+    input[i] = i % 16;
+  }
+  std::vector<float> output(8);
+  ConvLayer layer;
+  layer.Forward(params, 4, input.data(), 2, output.data());
+  // The patch sums are 45, 54, 81 and 90.
+  EXPECT_EQ(output, std::vector<float>({35.0f, 44.0f, 71.0f, 80.0f,
+                                        35.0f, 44.0f, 71.0f, 80.0f}));
+}
+
+TEST_F(ConvLayerTest, BackwardMatchesFiniteDifferences) {
+  const int in_len = 5, batch_size = 2, out_size = 3 * 3 * 3;
+  ConvParams params;
+  params.Init(2, 3);
+  params.bias.setConstant(0.5f);
+  std::vector<float> input(batch_size * 2 * in_len * in_len);
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = (i * 7 % 11) / 11.0f;
+  }
+  std::vector<float> output(batch_size * out_size);
+  std::vector<float> output_grad(output.size());
+  for (size_t i = 0; i < output_grad.size(); ++i) {
+    output_grad[i] = i;
+  }
+  std::vector<float> input_grad(input.size());
+  ConvLayer layer;
+  layer.Forward(params, in_len, input.data(), batch_size, output.data());
+  layer.Backward(params, in_len, input.data(), output.data(),
+                 output_grad.data(), batch_size, &params.grad,
+                 input_grad.data());
+
+  const float delta = 1e-2f;
+  for (int i = 0; i < params.weight.size(); i += 5) {
+    float original = params.weight.data()[i];
+    params.weight.data()[i] = original + delta;
+    layer.Forward(params, in_len, input.data(), batch_size, output.data());
+    float plus = WeightedSum(output);
+    params.weight.data()[i] = original - delta;
+    layer.Forward(params, in_len, input.data(), batch_size, output.data());
+    float minus = WeightedSum(output);
+    params.weight.data()[i] = original;
+    EXPECT_NEAR(params.grad.weight.data()[i], (plus - minus) / (2 * delta),
+                0.05f * (1.0f + std::abs(params.grad.weight.data()[i])));
+  }
+
+  for (size_t i = 0; i < input.size(); i += 3) {
+    float original = input[i];
+    input[i] = original + delta;
+    layer.Forward(params, in_len, input.data(), batch_size, output.data());
+    float plus = WeightedSum(output);
+    input[i] = original - delta;
+    layer.Forward(params, in_len, input.data(), batch_size, output.data());
+    float minus = WeightedSum(output);
+    input[i] = original;
+    EXPECT_NEAR(input_grad[i], (plus - minus) / (2 * delta),
+                0.05f * (1.0f + std::abs(input_grad[i])));
+  }
+}
+
+}
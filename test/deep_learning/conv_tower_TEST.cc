@@ -0,0 +1,67 @@
+#include "../../src/deep_learning/cnn/conv_tower.h"
+
+#include <gtest/gtest.h>
+#include <array>
+#include <vector>
+
+#include "../test.h"
+
+namespace foolgo {
+
+class ConvTowerTest : public Test {
+};
+
+namespace {
+
+void FillShard(ConvTower *tower, int begin, int end) {
+  float *input = tower->MutableInput(end - begin);
+  for (int i = 0; i < (end - begin) * tower->InputSize(); ++i) {
+    input[i] = ((begin * tower->InputSize() + i) * 7 % 11) / 11.0f;
+  }
+  tower->Forward();
+  float *output_grad = tower->MutableOutputGrad();
+  for (int i = 0; i < (end - begin) * tower->OutputSize(); ++i) {
+    output_grad[i] = begin * tower->OutputSize() + i;
+  }
+}
+
+}
+
+TEST_F(ConvTowerTest, ReducedShardsMatchWholeBatch) {
+  const int batch_size = 5;
+  std::array<ConvParams, 2> params_arr;
+  params_arr[0].Init(2, 3);
+  params_arr[1].Init(3, 2);
+  for (ConvParams &params : params_arr) {
+    params.bias.setConstant(0.5f);
+  }
+
+  ConvTower whole(params_arr.data(), 2, 5);
+  EXPECT_EQ(2, whole.OutputSize());
+  FillShard(&whole, 0, batch_size);
+  whole.Backward();
+
+  // Three shards, one of them empty.
+  std::vector<ConvTower *> towers;
+  std::vector<int> bounds = {0, 2, 2, batch_size};
+  for (size_t i = 0; i + 1 < bounds.size(); ++i) {
+    towers.push_back(new ConvTower(params_arr.data(), 2, 5));
+    FillShard(towers.back(), bounds[i], bounds[i + 1]);
+    towers.back()->Backward();
+  }
+  for (int j = 0; j < whole.OutputSize(); ++j) {
+    EXPECT_FLOAT_EQ(whole.Output(2)[j], towers[2]->Output(0)[j]);
+  }
+
+  for (int i = 0; i < 2; ++i) {
+    ReduceConvGrads(towers, i, &params_arr[i]);
+    EXPECT_TRUE(params_arr[i].grad.weight.isApprox(whole.Grad(i).weight,
+                                                   1e-4f));
+    EXPECT_TRUE(params_arr[i].grad.bias.isApprox(whole.Grad(i).bias, 1e-4f));
+  }
+  for (ConvTower *tower : towers) {
+    delete tower;
+  }
+}
+
+}
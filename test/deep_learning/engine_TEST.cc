@@ -0,0 +1,102 @@
+#include "../../src/deep_learning/engine.h"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "board/full_board.h"
+#include "board/zob_hasher.h"
+#include "deep_learning/sample.h"
+#include "../def_for_test.h"
+#include "../test.h"
+
+namespace foolgo {
+
+class EngineTest : public Test {
+ protected:
+  virtual void SetUp() {
+    Test::SetUp();
+    ZobHasher<19>::Init(SEED);
+  }
+};
+
+TEST_F(EngineTest, HiddenVectorsOfBatch) {
+  HyperParams hyper_params;
+  hyper_params.batch = 2;
+  hyper_params.hidden_dim = 4;
+  Engine engine(hyper_params);
+  engine.Init();
+
+  FullBoard<19> empty_board;
+  empty_board.Init();
+  FullBoard<19> full_board;
+  full_board.Copy(empty_board);
+  Play(&full_board, 60);
+  Play(&full_board, 300);
+
+  // The convolutions shrink each board to one hidden vector, so the second
+  // board of a batch is evaluated as if it were alone.
+  std::vector<Evaluation> batch_evaluations;
+  engine.Evaluate({&empty_board, &full_board}, &batch_evaluations);
+  ASSERT_EQ(batch_evaluations.size(), 2u);
+  for (int i = 0; i < 2; ++i) {
+    const FullBoard<19> *board = i == 0 ? &empty_board : &full_board;
+    std::vector<Evaluation> evaluations;
+    engine.Evaluate({board}, &evaluations);
+    ASSERT_EQ(evaluations.size(), 1u);
+    ASSERT_EQ(evaluations[0].policy.size(), 362u);
+    for (int j = 0; j < 362; ++j) {
+      EXPECT_FLOAT_EQ(batch_evaluations[i].policy[j], evaluations[0].policy[j]);
+    }
+  }
+  EXPECT_NE(batch_evaluations[0].policy, batch_evaluations[1].policy);
+}
+
+TEST_F(EngineTest, ShardedTrainStep) {
+  HyperParams hyper_params;
+  hyper_params.batch = 4;
+  hyper_params.hidden_dim = 4;
+  hyper_params.learning_rate = 0.1f;
+  Engine engine(hyper_params);
+  engine.Init();
+  hyper_params.thread_count = 2;
+  Engine sharded_engine(hyper_params);
+  sharded_engine.Init();
+  // Both engines start from the same params.
+  std::string path = testing::TempDir() + "engine_test_sharded.model";
+  ASSERT_TRUE(engine.SaveModel(path));
+  ASSERT_TRUE(sharded_engine.LoadModel(path));
+  std::remove(path.c_str());
+
+  std::vector<Sample<19>> samples;
+  FullBoard<19> full_board;
+  full_board.Init();
+  const std::vector<PositionIndex> moves = {60, 300, 72, POSITION_INDEX_PASS};
+  for (PositionIndex index : moves) {
+    Sample<19> sample;
+    sample.Pack(full_board, index);
+    samples.push_back(sample);
+    Play(&full_board, index);
+  }
+  std::vector<Evaluation> initial_evaluations;
+  engine.Evaluate({&full_board}, &initial_evaluations);
+
+  // The shards sum the same gradients in another order.
+  EXPECT_NEAR(engine.Train(samples), sharded_engine.Train(samples), 1e-4f);
+  std::vector<Evaluation> evaluations, sharded_evaluations;
+  engine.Evaluate({&full_board}, &evaluations);
+  sharded_engine.Evaluate({&full_board}, &sharded_evaluations);
+  float max_change = 0.0f;
+  for (int i = 0; i < 362; ++i) {
+    EXPECT_NEAR(evaluations[0].policy[i], sharded_evaluations[0].policy[i],
+                1e-5f);
+    max_change = std::max(max_change, std::abs(
+        evaluations[0].policy[i] - initial_evaluations[0].policy[i]));
+  }
+  EXPECT_GT(max_change, 1e-4f);
+}
+
+}
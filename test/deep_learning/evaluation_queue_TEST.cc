@@ -0,0 +1,91 @@
+#include "../../src/deep_learning/evaluation_queue.h"
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <future>
+#include <stdexcept>
+#include <vector>
+
+#include "board/full_board.h"
+#include "board/zob_hasher.h"
+#include "../def_for_test.h"
+#include "../test.h"
+
+namespace foolgo {
+
+class EvaluationQueueTest : public Test {
+ protected:
+  virtual void SetUp() {
+    Test::SetUp();
+    ZobHasher<DEFAULT_BOARD_LEN>::Init(SEED);
+  }
+};
+
+namespace {
+
+typedef std::vector<const FullBoard<DEFAULT_BOARD_LEN>*> Boards;
+
+// Evaluates a board by the count of its moves, and records batch sizes.
+EvaluationQueue<DEFAULT_BOARD_LEN>::BatchEvaluator MoveCountEvaluator(
+    std::vector<int> *batch_sizes) {
+  return [batch_sizes](const Boards &full_boards,
+                       std::vector<Evaluation> *evaluations) {
+    batch_sizes->push_back(full_boards.size());
+    for (size_t i = 0; i < full_boards.size(); ++i) {
+      evaluations->at(i).value = full_boards[i]->MoveCount();
+    }
+  };
+}
+
+}
+
+TEST_F(EvaluationQueueTest, Batches) {
+  std::vector<int> batch_sizes;
+  std::vector<std::future<Evaluation>> futures;
+  {
+    // Batches are evaluated once full, since no deadline passes during the
+    // test, and the boards left are evaluated when the queue is destroyed.
+    EvaluationQueue<DEFAULT_BOARD_LEN> queue(MoveCountEvaluator(&batch_sizes),
+                                             2, std::chrono::hours(1));
+    FullBoard<DEFAULT_BOARD_LEN> full_board;
+    full_board.Init();
+    for (int i = 0; i < 5; ++i) {
+      futures.push_back(queue.Submit(full_board));
+      full_board.Pass(NextForce(full_board));
+    }
+    for (int i = 0; i < 4; ++i) {
+      EXPECT_EQ(futures[i].get().value, i);
+    }
+    EXPECT_EQ(queue.BatchCount(), 2);
+    EXPECT_EQ(queue.EvaluatedCount(), 4);
+  }
+
+  EXPECT_EQ(futures[4].get().value, 4);
+  EXPECT_EQ(batch_sizes, std::vector<int>({2, 2, 1}));
+}
+
+TEST_F(EvaluationQueueTest, Deadline) {
+  std::vector<int> batch_sizes;
+  EvaluationQueue<DEFAULT_BOARD_LEN> queue(MoveCountEvaluator(&batch_sizes),
+                                           4, std::chrono::milliseconds(1));
+  FullBoard<DEFAULT_BOARD_LEN> full_board;
+  full_board.Init();
+
+  // A partial batch is evaluated once its first board has waited.
+  EXPECT_EQ(queue.Submit(full_board).get().value, 0);
+  EXPECT_EQ(batch_sizes, std::vector<int>({1}));
+}
+
+TEST_F(EvaluationQueueTest, Exception) {
+  EvaluationQueue<DEFAULT_BOARD_LEN> queue(
+      [](const std::vector<const FullBoard<DEFAULT_BOARD_LEN>*> &,
+         std::vector<Evaluation> *) {
+        throw std::runtime_error("evaluation failed");
+      }, 4, std::chrono::milliseconds(1));
+  FullBoard<DEFAULT_BOARD_LEN> full_board;
+  full_board.Init();
+  std::future<Evaluation> future = queue.Submit(full_board);
+  EXPECT_THROW(future.get(), std::runtime_error);
+}
+
+}
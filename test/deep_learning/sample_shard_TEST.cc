@@ -0,0 +1,63 @@
+#include "../../src/deep_learning/sample_shard.h"
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <string>
+
+#include "board/full_board.h"
+#include "board/zob_hasher.h"
+#include "util/rand.h"
+#include "../def_for_test.h"
+#include "../test.h"
+
+namespace foolgo {
+
+class SampleShardTest : public Test {
+ protected:
+  virtual void SetUp() {
+    Test::SetUp();
+    ZobHasher<DEFAULT_BOARD_LEN>::Init(SEED);
+  }
+};
+
+TEST_F(SampleShardTest, WriteAndMap) {
+  std::string path_prefix = testing::TempDir() + "sample_shard_test";
+  FullBoard<DEFAULT_BOARD_LEN> full_board;
+  full_board.Init();
+  std::vector<std::string> shard_paths;
+  {
+    SampleShardWriter<DEFAULT_BOARD_LEN> writer(path_prefix, 2);
+    for (int i = 0; i < 5; ++i) {
+      Sample<DEFAULT_BOARD_LEN> sample;
+      sample.Pack(full_board, i);
+      ASSERT_TRUE(writer.Add(sample));
+      full_board.PlayMove(Move(NextForce(full_board), i * 3));
+    }
+    ASSERT_TRUE(writer.Close());
+    shard_paths = writer.ShardPaths();
+  }
+  ASSERT_EQ(shard_paths.size(), 3u);
+
+  SampleDataset<DEFAULT_BOARD_LEN> dataset;
+  for (const std::string &shard_path : shard_paths) {
+    ASSERT_TRUE(dataset.AddShard(shard_path));
+  }
+  ASSERT_EQ(dataset.SampleCount(), 5);
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_EQ(dataset.At(i).position_index, i);
+    EXPECT_EQ(dataset.At(i).PieceBitSet(BLACK_FORCE).count(), (i + 1) / 2);
+  }
+  RandomEngine random_engine(SEED);
+  EXPECT_LT(dataset.RandomSample(&random_engine).position_index, 5);
+
+  // Shards of another board length are refused.
+  SampleDataset<DEFAULT_BOARD_LEN + 2> other_dataset;
+  EXPECT_FALSE(other_dataset.AddShard(shard_paths[0]));
+  EXPECT_FALSE(dataset.AddShard(path_prefix + "-missing"));
+
+  for (const std::string &shard_path : shard_paths) {
+    std::remove(shard_path.c_str());
+  }
+}
+
+}
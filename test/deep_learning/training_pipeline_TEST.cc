@@ -0,0 +1,71 @@
+#include "../../src/deep_learning/training_pipeline.h"
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <vector>
+
+#include "board/full_board.h"
+#include "board/zob_hasher.h"
+#include "../def_for_test.h"
+#include "../test.h"
+
+namespace foolgo {
+
+class TrainingPipelineTest : public Test {
+ protected:
+  virtual void SetUp() {
+    Test::SetUp();
+    ZobHasher<DEFAULT_BOARD_LEN>::Init(SEED);
+  }
+};
+
+TEST_F(TrainingPipelineTest, Batches) {
+  // Chunks of 10 samples, each marked by the number of its chunk.
+  std::atomic<int> chunk_count(0);
+  TrainingPipeline<DEFAULT_BOARD_LEN> pipeline(
+      [&chunk_count](RandomEngine *,
+                     std::vector<Sample<DEFAULT_BOARD_LEN>> *samples) {
+        FullBoard<DEFAULT_BOARD_LEN> full_board;
+        full_board.Init();
+        int chunk_index = chunk_count++;
+        for (int i = 0; i < 10; ++i) {
+          Sample<DEFAULT_BOARD_LEN> sample;
+          sample.Pack(full_board, chunk_index);
+          samples->push_back(sample);
+        }
+      }, 2, 40, 8, 2, SEED);
+
+  std::vector<Sample<DEFAULT_BOARD_LEN>> batch;
+  bool is_mixed = false;
+  for (int i = 0; i < 20; ++i) {
+    pipeline.NextBatch(&batch);
+    ASSERT_EQ(batch.size(), 8u);
+    for (const auto &sample : batch) {
+      is_mixed = is_mixed
+          || sample.position_index != batch[0].position_index;
+    }
+  }
+  // Samples of a chunk are spread over batches.
+  EXPECT_TRUE(is_mixed);
+}
+
+TEST_F(TrainingPipelineTest, ChunksLargerThanReservoir) {
+  // Chunks of 100 samples overflow the reservoir of 16 midway, which the
+  // batcher empties before the producer puts the rest. A regression hangs.
+  TrainingPipeline<DEFAULT_BOARD_LEN> pipeline(
+      [](RandomEngine *, std::vector<Sample<DEFAULT_BOARD_LEN>> *samples) {
+        FullBoard<DEFAULT_BOARD_LEN> full_board;
+        full_board.Init();
+        Sample<DEFAULT_BOARD_LEN> sample;
+        sample.Pack(full_board, 0);
+        samples->assign(100, sample);
+      }, 1, 16, 8, 2, SEED);
+
+  std::vector<Sample<DEFAULT_BOARD_LEN>> batch;
+  for (int i = 0; i < 30; ++i) {
+    pipeline.NextBatch(&batch);
+    ASSERT_EQ(batch.size(), 8u);
+  }
+}
+
+}
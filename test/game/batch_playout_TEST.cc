@@ -0,0 +1,149 @@
+#include "../../src/game/batch_playout.h"
+
+#include <gtest/gtest.h>
+
+#include "board/full_board.h"
+#include "board/zob_hasher.h"
+#include "util/rand.h"
+#include "../def_for_test.h"
+#include "../test.h"
+
+namespace foolgo {
+
+class BatchPlayoutTest : public Test {
+ protected:
+  virtual void SetUp() {
+    Test::SetUp();
+    ZobHasher<DEFAULT_BOARD_LEN>::Init(SEED);
+    ZobHasher<19>::Init(SEED);
+  }
+};
+
+namespace {
+
+// Pieces of the force in the lane.
+template<BoardLen BOARD_LEN>
+BitSet<BOARD_LEN> LanePieces(const BatchPlayout<BOARD_LEN> &batch_playout,
+                             int lane_index, Force force) {
+  BitSet<BOARD_LEN> pieces;
+  for (PositionIndex i = 0; i < BoardLenSquare<BOARD_LEN>(); ++i) {
+    if (batch_playout.GetPointState(lane_index, i)
+        == ForceToPointState(force)) {
+      pieces.set(i);
+    }
+  }
+  return pieces;
+}
+
+// Expects every chain of the ended lane to have a liberty, so that no
+// capture is missed, and the area difference to be that of FullBoard::Area.
+template<BoardLen BOARD_LEN>
+void ExpectLaneValid(const BatchPlayout<BOARD_LEN> &batch_playout,
+                     int lane_index) {
+  BitSet<BOARD_LEN> black = LanePieces(batch_playout, lane_index, BLACK_FORCE);
+  BitSet<BOARD_LEN> white = LanePieces(batch_playout, lane_index, WHITE_FORCE);
+  EXPECT_TRUE((black & white).none());
+  BitSet<BOARD_LEN> empty_points = ~(black | white);
+
+  for (const BitSet<BOARD_LEN> &pieces : {black, white}) {
+    for (PositionIndex index : pieces) {
+      BitSet<BOARD_LEN> piece;
+      piece.set(index);
+      EXPECT_TRUE((piece.FloodFill(pieces).Adjacent() & empty_points).any());
+    }
+  }
+
+  BitSet<BOARD_LEN> black_reached = black.FloodFill(empty_points | black);
+  BitSet<BOARD_LEN> white_reached = white.FloodFill(empty_points | white);
+  int area_difference =
+      BitSet<BOARD_LEN>(black_reached).AndNot(white_reached).count()
+      - BitSet<BOARD_LEN>(white_reached).AndNot(black_reached).count();
+  EXPECT_EQ(batch_playout.AreaDifference(lane_index), area_difference);
+}
+
+template<BoardLen BOARD_LEN>
+void RunFromEmptyBoard(int lane_count) {
+  FullBoard<BOARD_LEN> full_board;
+  full_board.Init();
+  BatchPlayout<BOARD_LEN> batch_playout(lane_count);
+  for (int i = 0; i < lane_count; ++i) {
+    batch_playout.Load(i, full_board);
+  }
+  RandomEngine random_engine(SEED);
+  batch_playout.Run(&random_engine);
+
+  int different_lane_count = 0;
+  for (int i = 0; i < lane_count; ++i) {
+    ExpectLaneValid(batch_playout, i);
+    // Playouts end with most points played.
+    EXPECT_GT((LanePieces(batch_playout, i, BLACK_FORCE)
+        | LanePieces(batch_playout, i, WHITE_FORCE)).count(),
+        BoardLenSquare<BOARD_LEN>() / 2);
+    different_lane_count += LanePieces(batch_playout, i, BLACK_FORCE)
+        != LanePieces(batch_playout, 0, BLACK_FORCE);
+  }
+  EXPECT_GT(different_lane_count, 0);
+}
+
+}
+
+TEST_F(BatchPlayoutTest, RunFromEmptyBoard) {
+  RunFromEmptyBoard<DEFAULT_BOARD_LEN>(8);
+  // Chains of the larger board span several words.
+  RunFromEmptyBoard<19>(4);
+}
+
+TEST_F(BatchPlayoutTest, LoadBoards) {
+  FullBoard<DEFAULT_BOARD_LEN> empty_board;
+  empty_board.Init();
+  FullBoard<DEFAULT_BOARD_LEN> full_board;
+  full_board.Copy(empty_board);
+  Play(&full_board, 6);
+  Play(&full_board, 18);
+  Play(&full_board, 12);
+
+  BatchPlayout<DEFAULT_BOARD_LEN> batch_playout(3);
+  batch_playout.Load(0, empty_board);
+  batch_playout.Load(1, full_board);
+  batch_playout.Load(2, full_board);
+  RandomEngine random_engine(SEED);
+  PlayoutConfig playout_config;
+  playout_config.max_length_factor = 0.04f;
+  batch_playout.Run(&random_engine, playout_config);
+
+  // Each lane plays one move of the force to move.
+  EXPECT_EQ(LanePieces(batch_playout, 0, BLACK_FORCE).count(), 1);
+  EXPECT_TRUE(LanePieces(batch_playout, 0, WHITE_FORCE).none());
+  for (int i = 1; i < 3; ++i) {
+    BitSet<DEFAULT_BOARD_LEN> black = LanePieces(batch_playout, i,
+                                                 BLACK_FORCE);
+    BitSet<DEFAULT_BOARD_LEN> white = LanePieces(batch_playout, i,
+                                                 WHITE_FORCE);
+    EXPECT_EQ(black, full_board.PointBitSet(BLACK_POINT));
+    EXPECT_EQ(white.count(), 2);
+    EXPECT_TRUE(white[18]);
+  }
+}
+
+TEST_F(BatchPlayoutTest, RunWithMercyThreshold) {
+  FullBoard<DEFAULT_BOARD_LEN> full_board;
+  full_board.Init();
+  BatchPlayout<DEFAULT_BOARD_LEN> batch_playout(2);
+  for (int i = 0; i < 2; ++i) {
+    batch_playout.Load(i, full_board);
+  }
+  RandomEngine random_engine(SEED);
+  PlayoutConfig playout_config;
+  playout_config.mercy_threshold = 1;
+  batch_playout.Run(&random_engine, playout_config);
+
+  // The first piece leads by one point, and reaches the whole board.
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_EQ(LanePieces(batch_playout, i, BLACK_FORCE).count(), 1);
+    EXPECT_TRUE(LanePieces(batch_playout, i, WHITE_FORCE).none());
+    EXPECT_EQ(batch_playout.AreaDifference(i),
+              BoardLenSquare<DEFAULT_BOARD_LEN>());
+  }
+}
+
+}
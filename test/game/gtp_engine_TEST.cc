@@ -0,0 +1,47 @@
+#include "../../src/game/gtp_engine.h"
+
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+
+#include "board/zob_hasher.h"
+#include "player/uct_player.h"
+#include "../def_for_test.h"
+#include "../test.h"
+
+namespace foolgo {
+
+class GtpEngineTest : public Test {
+ protected:
+  virtual void SetUp() {
+    Test::SetUp();
+    ZobHasher<DEFAULT_BOARD_LEN>::Init(SEED);
+  }
+};
+
+TEST_F(GtpEngineTest, Run) {
+  UctPlayer<DEFAULT_BOARD_LEN> player(SEED, 200, 1, 1 << 20);
+  GtpEngine<DEFAULT_BOARD_LEN> engine(&player, true);
+  std::istringstream is("1 boardsize 5\n"
+                        "boardsize 9\n"
+                        "play b C3 # the center\n"
+                        "play b C3\n"
+                        "play w E1\n"
+                        "undo\n"
+                        "undo\n"
+                        "undo\n"
+                        "2 genmove w\n"
+                        "quit\n"
+                        "name\n");
+  std::ostringstream os;
+  engine.Run(is, os);
+
+  std::string output = os.str();
+  EXPECT_EQ(output.find("=1\n\n? unacceptable size\n\n=\n\n? illegal move\n\n"
+                        "=\n\n=\n\n=\n\n? cannot undo\n\n=2 "), 0);
+  // Nothing is read after quit.
+  EXPECT_EQ(output.substr(output.size() - 5), "\n\n=\n\n");
+  EXPECT_EQ(output.find("FoolGo"), std::string::npos);
+}
+
+}
@@ -0,0 +1,59 @@
+#include "../../src/game/match.h"
+
+#include <gtest/gtest.h>
+
+#include "board/zob_hasher.h"
+#include "util/thread_pool.h"
+#include "../def_for_test.h"
+#include "../test.h"
+
+namespace foolgo {
+
+class MatchTest : public Test {
+ protected:
+  virtual void SetUp() {
+    Test::SetUp();
+    ZobHasher<DEFAULT_BOARD_LEN>::Init(SEED);
+  }
+};
+
+TEST_F(MatchTest, PlayGames) {
+  MatchPlayerConfig strong_config;
+  strong_config.mc_game_count = 100;
+  strong_config.table_memory_bytes = 1 << 20;
+  MatchPlayerConfig weak_config = strong_config;
+  weak_config.mc_game_count = 10;
+  // Never decides within the games.
+  SprtConfig sprt_config;
+  sprt_config.alpha = 1e-9;
+  sprt_config.beta = 1e-9;
+
+  Match<DEFAULT_BOARD_LEN> match(strong_config, weak_config, SEED,
+                                 sprt_config);
+  util::ThreadPool thread_pool(2);
+  match.Play(4, &thread_pool);
+  EXPECT_EQ(match.Score().GameCount(), 4);
+  EXPECT_EQ(match.Result(), SprtResult::CONTINUE);
+  EXPECT_GT(match.SecondsPerMove(0), 0.0);
+  EXPECT_GT(match.SecondsPerMove(1), 0.0);
+}
+
+TEST_F(MatchTest, StopWhenDecided) {
+  MatchPlayerConfig config;
+  config.mc_game_count = 10;
+  config.table_memory_bytes = 1 << 20;
+  // Decides at the first decisive game.
+  SprtConfig sprt_config;
+  sprt_config.elo0 = -2000.0;
+  sprt_config.elo1 = 2000.0;
+  sprt_config.alpha = 0.4;
+  sprt_config.beta = 0.4;
+
+  Match<DEFAULT_BOARD_LEN> match(config, config, SEED, sprt_config);
+  util::ThreadPool thread_pool(1);
+  match.Play(20, &thread_pool);
+  EXPECT_NE(match.Result(), SprtResult::CONTINUE);
+  EXPECT_LT(match.Score().GameCount(), 20);
+}
+
+}
@@ -4,6 +4,8 @@
 
 #include "board/full_board.h"
 #include "board/zob_hasher.h"
+#include "game/pattern_playout.h"
+#include "game/pattern_weights.h"
 #include "util/rand.h"
 #include "../def_for_test.h"
 #include "../test.h"
@@ -38,4 +40,98 @@ TEST_F(MonteCarloGameTest, Run) {
   game_->Run();
 }
 
+TEST_F(MonteCarloGameTest, RunRandomPlayout) {
+  FullBoard<DEFAULT_BOARD_LEN> full_board;
+  full_board.Init();
+  RandomEngine random_engine(SEED);
+  FirstMovePoints<DEFAULT_BOARD_LEN> first_move_points;
+  RunRandomPlayout(&full_board, &random_engine, &first_move_points);
+  EXPECT_TRUE(full_board.IsEnd());
+  EXPECT_GT(full_board.MoveCount(), 0);
+
+  // A point is first played by one force, and every piece remaining at the
+  // end lies on a played point.
+  BitSet<DEFAULT_BOARD_LEN> played_points =
+      first_move_points[BLACK_FORCE] | first_move_points[WHITE_FORCE];
+  EXPECT_TRUE((first_move_points[BLACK_FORCE]
+      & first_move_points[WHITE_FORCE]).none());
+  EXPECT_TRUE(BitSet<DEFAULT_BOARD_LEN>(~full_board.PointBitSet(EMPTY_POINT))
+      .AndNot(played_points).none());
+}
+
+TEST_F(MonteCarloGameTest, RunRandomPlayoutWithLimits) {
+  FullBoard<DEFAULT_BOARD_LEN> empty_board;
+  empty_board.Init();
+  FullBoard<DEFAULT_BOARD_LEN> full_board;
+  full_board.Copy(empty_board);
+  RandomEngine random_engine(SEED);
+  PlayoutConfig playout_config;
+  playout_config.max_length_factor = 0.4f;
+  RunRandomPlayout<DEFAULT_BOARD_LEN>(&full_board, &random_engine, nullptr,
+                                      playout_config);
+  EXPECT_EQ(full_board.MoveCount(), 10);
+
+  // The first piece leads by one point.
+  full_board.Copy(empty_board);
+  playout_config.max_length_factor = 0.0f;
+  playout_config.mercy_threshold = 1;
+  RunRandomPlayout<DEFAULT_BOARD_LEN>(&full_board, &random_engine, nullptr,
+                                      playout_config);
+  EXPECT_EQ(full_board.MoveCount(), 1);
+  EXPECT_FALSE(full_board.IsEnd());
+}
+
+TEST_F(MonteCarloGameTest, RunPatternPlayout) {
+  FullBoard<DEFAULT_BOARD_LEN> full_board;
+  full_board.Init();
+  RandomEngine random_engine(SEED);
+  FirstMovePoints<DEFAULT_BOARD_LEN> first_move_points;
+  PlayoutConfig playout_config;
+  playout_config.pattern_weights = &PatternWeights::Default();
+  RunPlayout(&full_board, &random_engine, &first_move_points, playout_config);
+  EXPECT_TRUE(full_board.IsEnd());
+  EXPECT_GT(full_board.MoveCount(), 0);
+  BitSet<DEFAULT_BOARD_LEN> played_points =
+      first_move_points[BLACK_FORCE] | first_move_points[WHITE_FORCE];
+  EXPECT_TRUE(BitSet<DEFAULT_BOARD_LEN>(~full_board.PointBitSet(EMPTY_POINT))
+      .AndNot(played_points).none());
+}
+
+TEST_F(MonteCarloGameTest, CaptureByPatternPlayout) {
+  FullBoard<DEFAULT_BOARD_LEN> full_board;
+  full_board.Init();
+  // The white piece in the corner is in atari.
+  Play(&full_board, 1);
+  Play(&full_board, 0);
+  PatternWeights pattern_weights(
+      std::vector<uint16_t>(PATTERN_CODE_COUNT, 1), 100000, 1);
+  RandomEngine random_engine(SEED);
+  PlayoutConfig playout_config;
+  playout_config.pattern_weights = &pattern_weights;
+  playout_config.max_length_factor = 0.04f;
+  RunPatternPlayout<DEFAULT_BOARD_LEN>(&full_board, &random_engine, nullptr,
+                                       playout_config);
+  EXPECT_EQ(full_board.GetPointState(0), EMPTY_POINT);
+  EXPECT_EQ(full_board.GetPointState(DEFAULT_BOARD_LEN), BLACK_POINT);
+}
+
+TEST_F(MonteCarloGameTest, DefaultPatternWeights) {
+  const PatternWeights &pattern_weights = PatternWeights::Default();
+  PatternCode empty_center = 0xaaaa;
+  PatternCode empty_edge = SetPatternNeighborState(
+      SetPatternNeighborState(SetPatternNeighborState(empty_center, 0,
+          OFF_BOARD_PATTERN_STATE), 2, OFF_BOARD_PATTERN_STATE), 4,
+      OFF_BOARD_PATTERN_STATE);
+  EXPECT_LT(pattern_weights.Weight(empty_edge, BLACK_FORCE),
+            pattern_weights.Weight(empty_center, BLACK_FORCE));
+
+  // A hane of black weighs as that of white with colors swapped.
+  PatternCode hane = SetPatternNeighborState(
+      SetPatternNeighborState(empty_center, 2, WHITE_POINT), 0, BLACK_POINT);
+  EXPECT_GT(pattern_weights.Weight(hane, BLACK_FORCE),
+            pattern_weights.Weight(empty_center, BLACK_FORCE));
+  EXPECT_EQ(pattern_weights.Weight(SwapPatternColors(hane), WHITE_FORCE),
+            pattern_weights.Weight(hane, BLACK_FORCE));
+}
+
 }
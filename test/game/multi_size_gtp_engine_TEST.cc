@@ -0,0 +1,80 @@
+#include "../../src/game/multi_size_gtp_engine.h"
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "../def_for_test.h"
+#include "../test.h"
+
+namespace foolgo {
+
+class MultiSizeGtpEngineTest : public Test {};
+
+namespace {
+
+GtpPlayerConfig SmallPlayerConfig() {
+  GtpPlayerConfig config;
+  config.seed = SEED;
+  config.mc_game_count = 50;
+  config.table_memory_bytes = 1 << 20;
+  config.is_pondering = false;
+  return config;
+}
+
+}
+
+TEST_F(MultiSizeGtpEngineTest, New) {
+  EXPECT_EQ(MultiSizeGtpEngine::New(7, SmallPlayerConfig()), nullptr);
+  auto engine = MultiSizeGtpEngine::New(9, SmallPlayerConfig());
+  ASSERT_NE(engine, nullptr);
+  EXPECT_EQ(engine->BoardLength(), 9);
+}
+
+TEST_F(MultiSizeGtpEngineTest, Run) {
+  auto engine = MultiSizeGtpEngine::New(9, SmallPlayerConfig());
+  std::istringstream is("komi 0.5\n"
+                        "play b J9\n"
+                        "boardsize 7\n"
+                        "boardsize 13\n"
+                        "play b N13\n"
+                        "play w J9\n"
+                        "genmove w\n"
+                        "quit\n");
+  std::ostringstream os;
+  engine->Run(is, os);
+
+  EXPECT_EQ(os.str().find("=\n\n=\n\n? unacceptable size\n\n=\n\n=\n\n"
+                          "=\n\n= "), 0);
+  EXPECT_EQ(engine->BoardLength(), 13);
+
+  // The komi is kept across lengths, and the new board is empty.
+  std::string response;
+  bool is_quit;
+  EXPECT_TRUE(engine->Execute("boardsize 19", &response, &is_quit));
+  EXPECT_EQ(engine->BoardLength(), 19);
+  EXPECT_TRUE(engine->Execute("final_score", &response, &is_quit));
+  EXPECT_EQ(response, "W+0.5");
+}
+
+TEST_F(MultiSizeGtpEngineTest, OpenNetworkOf19x19Players) {
+  GtpPlayerConfig config = SmallPlayerConfig();
+  int open_count = 0;
+  config.open_network = [&open_count](const GtpPlayerConfig &,
+                                      UctPlayer<19> *uct_player) {
+    EXPECT_NE(uct_player, nullptr);
+    ++open_count;
+    return std::unique_ptr<PlayerNetwork>(new PlayerNetwork);
+  };
+  auto engine = MultiSizeGtpEngine::New(9, config);
+  EXPECT_EQ(open_count, 0);
+
+  std::string response;
+  bool is_quit;
+  EXPECT_TRUE(engine->Execute("boardsize 19", &response, &is_quit));
+  EXPECT_EQ(open_count, 1);
+  EXPECT_TRUE(engine->Execute("genmove b", &response, &is_quit));
+}
+
+}
@@ -0,0 +1,54 @@
+#include "../../src/game/self_play.h"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdio>
+#include <string>
+
+#include "board/zob_hasher.h"
+#include "util/thread_pool.h"
+#include "../def_for_test.h"
+#include "../test.h"
+
+namespace foolgo {
+
+class SelfPlayTest : public Test {
+ protected:
+  virtual void SetUp() {
+    Test::SetUp();
+    ZobHasher<DEFAULT_BOARD_LEN>::Init(SEED);
+  }
+};
+
+TEST_F(SelfPlayTest, WriteGames) {
+  std::string path_prefix = testing::TempDir() + "self_play_test";
+  SelfPlay<DEFAULT_BOARD_LEN>::Writer writer(path_prefix, 1 << 20);
+  SelfPlay<DEFAULT_BOARD_LEN> self_play(50, 1 << 20, SEED, &writer);
+  util::ThreadPool thread_pool(2);
+  ASSERT_TRUE(self_play.Play(3, &thread_pool));
+  ASSERT_TRUE(writer.Close());
+  EXPECT_EQ(self_play.GameCount(), 3);
+  ASSERT_EQ(writer.ShardPaths().size(), 1u);
+
+  SampleDataset<DEFAULT_BOARD_LEN, SearchSample<DEFAULT_BOARD_LEN>> dataset;
+  ASSERT_TRUE(dataset.AddShard(writer.ShardPaths()[0]));
+  ASSERT_EQ(dataset.SampleCount(), self_play.SampleCount());
+  ASSERT_GT(dataset.SampleCount(), 3);
+  // A shard of other samples is not taken for one of search samples.
+  SampleDataset<DEFAULT_BOARD_LEN> other_dataset;
+  EXPECT_FALSE(other_dataset.AddShard(writer.ShardPaths()[0]));
+
+  for (int64_t i = 0; i < dataset.SampleCount(); ++i) {
+    const SearchSample<DEFAULT_BOARD_LEN> &sample = dataset.At(i);
+    EXPECT_TRUE(sample.sample.value == 1 || sample.sample.value == -1);
+    const uint16_t *visit_counts = sample.visit_counts;
+    EXPECT_EQ(*std::max_element(visit_counts, visit_counts
+        + SearchSample<DEFAULT_BOARD_LEN>::VISIT_COUNT_SIZE), 65535);
+    if (sample.sample.position_index != POSITION_INDEX_PASS) {
+      EXPECT_GT(visit_counts[sample.sample.position_index], 0);
+    }
+  }
+  std::remove(writer.ShardPaths()[0].c_str());
+}
+
+}
@@ -0,0 +1,48 @@
+#include "../../src/game/sprt.h"
+
+#include <gtest/gtest.h>
+#include <cmath>
+
+#include "../test.h"
+
+namespace foolgo {
+
+class SprtTest : public Test {
+ protected:
+  static MatchScore Score(int64_t win_count, int64_t draw_count,
+                          int64_t loss_count) {
+    MatchScore score;
+    score.win_count = win_count;
+    score.draw_count = draw_count;
+    score.loss_count = loss_count;
+    return score;
+  }
+};
+
+TEST_F(SprtTest, EstimateElo) {
+  EloEstimate even = EstimateElo(Score(50, 0, 50));
+  EXPECT_NEAR(even.elo, 0.0, 1e-9);
+  EXPECT_NEAR(even.lower, -even.upper, 1e-9);
+  EXPECT_GT(even.upper, 60.0);
+  EXPECT_LT(even.upper, 80.0);
+
+  // A score of 0.75 is 400 * log10(3) Elo.
+  EloEstimate stronger = EstimateElo(Score(70, 10, 20));
+  EXPECT_NEAR(stronger.elo, 400.0 * std::log10(3.0), 1e-6);
+  EXPECT_LT(stronger.lower, stronger.elo);
+  EXPECT_GT(stronger.upper, stronger.elo);
+
+  EXPECT_TRUE(std::isinf(EstimateElo(Score(10, 0, 0)).elo));
+}
+
+TEST_F(SprtTest, Decide) {
+  SprtConfig config;
+  EXPECT_EQ(TestSprt(Score(0, 0, 0), config), SprtResult::CONTINUE);
+  EXPECT_EQ(TestSprt(Score(6, 0, 4), config), SprtResult::CONTINUE);
+  EXPECT_EQ(TestSprt(Score(400, 0, 200), config), SprtResult::ACCEPT_ELO1);
+  EXPECT_EQ(TestSprt(Score(200, 0, 400), config), SprtResult::ACCEPT_ELO0);
+  EXPECT_EQ(TestSprt(Score(100, 0, 0), config), SprtResult::ACCEPT_ELO1);
+  EXPECT_LT(SprtLogLikelihoodRatio(Score(500, 0, 500), config), 0.0);
+}
+
+}
@@ -0,0 +1,37 @@
+#include "../../src/player/evaluation_cache.h"
+
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "../test.h"
+
+namespace foolgo {
+
+class EvaluationCacheTest : public Test {
+};
+
+TEST_F(EvaluationCacheTest, PutAndGet) {
+  EvaluationCache cache(8);
+  Evaluation evaluation;
+  EXPECT_FALSE(cache.Get(3, &evaluation));
+
+  Evaluation put_evaluation;
+  put_evaluation.policy = {0.25f, 0.75f};
+  put_evaluation.value = 0.9f;
+  cache.Put(3, put_evaluation);
+  ASSERT_TRUE(cache.Get(3, &evaluation));
+  EXPECT_EQ(evaluation.policy, put_evaluation.policy);
+  EXPECT_FLOAT_EQ(evaluation.value, 0.9f);
+
+  // The key of the same slot replaces it.
+  put_evaluation.value = 0.1f;
+  cache.Put(11, put_evaluation);
+  EXPECT_FALSE(cache.Get(3, &evaluation));
+  ASSERT_TRUE(cache.Get(11, &evaluation));
+  EXPECT_FLOAT_EQ(evaluation.value, 0.1f);
+
+  EXPECT_EQ(cache.HitCount(), 2);
+  EXPECT_EQ(cache.MissCount(), 2);
+}
+
+}
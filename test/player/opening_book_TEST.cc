@@ -0,0 +1,94 @@
+#include "../../src/player/opening_book.h"
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+#include "board/full_board.h"
+#include "board/zob_hasher.h"
+#include "player/uct_player.h"
+#include "../def_for_test.h"
+#include "../test.h"
+
+namespace foolgo {
+
+class OpeningBookTest : public Test {
+ protected:
+  virtual void SetUp() {
+    Test::SetUp();
+    ZobHasher<DEFAULT_BOARD_LEN>::Init(SEED);
+    full_board_.Init();
+    path_ = testing::TempDir() + "opening_book_test.book";
+  }
+  virtual void TearDown() {
+    std::remove(path_.c_str());
+    Test::TearDown();
+  }
+
+  // Searches the empty board and writes the book of the search.
+  void WriteSearchedBook() {
+    UctPlayer<DEFAULT_BOARD_LEN> player(SEED, 500, 1, 1 << 20);
+    player.NextMove(full_board_);
+    OpeningBookWriter writer(DEFAULT_BOARD_LEN, false,
+                             EmptyBoardHashKey<DEFAULT_BOARD_LEN>());
+    player.AddToOpeningBook(100, &writer);
+    ASSERT_GT(writer.EntryCount(), 0u);
+    ASSERT_TRUE(writer.Write(path_));
+  }
+
+  FullBoard<DEFAULT_BOARD_LEN> full_board_;
+  std::string path_;
+};
+
+TEST_F(OpeningBookTest, WriteAndFind) {
+  WriteSearchedBook();
+  std::unique_ptr<OpeningBook> book = OpeningBook::Open(
+      path_, DEFAULT_BOARD_LEN, full_board_.HashKey());
+  ASSERT_NE(book, nullptr);
+
+  const OpeningBookEntry *entry = book->Find(full_board_);
+  ASSERT_NE(entry, nullptr);
+  EXPECT_GE(entry->visited_time, 500);
+  EXPECT_GT(entry->children[0].visited_time, 0);
+  for (int i = 1; i < OPENING_BOOK_CHILD_COUNT; ++i) {
+    EXPECT_LE(entry->children[i].visited_time,
+              entry->children[i - 1].visited_time);
+  }
+  EXPECT_EQ(book->Find(full_board_.HashKey() + 1), nullptr);
+
+  EXPECT_EQ(OpeningBook::Open(path_, DEFAULT_BOARD_LEN + 2,
+                              full_board_.HashKey()), nullptr);
+  EXPECT_EQ(OpeningBook::Open(path_, DEFAULT_BOARD_LEN,
+                              full_board_.HashKey() + 1), nullptr);
+}
+
+TEST_F(OpeningBookTest, InstantMoveAndSeededRoot) {
+  WriteSearchedBook();
+  std::shared_ptr<const OpeningBook> book(OpeningBook::Open(
+      path_, DEFAULT_BOARD_LEN, full_board_.HashKey()));
+  ASSERT_NE(book, nullptr);
+  const OpeningBookEntry *entry = book->Find(full_board_);
+  ASSERT_NE(entry, nullptr);
+
+  UctPlayer<DEFAULT_BOARD_LEN> instant_player(SEED + 1, 500, 1, 1 << 20);
+  instant_player.SetOpeningBook(book, entry->visited_time);
+  EXPECT_EQ(instant_player.NextMove(full_board_),
+            entry->children[0].position_index);
+  EXPECT_EQ(instant_player.LastSearchStats().playout_count, 0);
+
+  // Below the instant visited time, the search starts from the book visits.
+  UctPlayer<DEFAULT_BOARD_LEN> seeded_player(SEED + 1, 10, 1, 1 << 20);
+  seeded_player.SetOpeningBook(book, entry->visited_time + 1);
+  seeded_player.NextMove(full_board_);
+  EXPECT_GT(seeded_player.LastSearchStats().playout_count, 0);
+  int32_t child_visited_time = 0;
+  for (const RootChildStat &stat : seeded_player.RootChildStats(full_board_)) {
+    if (stat.position_index == entry->children[0].position_index) {
+      child_visited_time = stat.visited_time;
+    }
+  }
+  EXPECT_GE(child_visited_time, entry->children[0].visited_time);
+}
+
+}
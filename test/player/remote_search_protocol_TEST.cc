@@ -0,0 +1,55 @@
+#include "../../src/player/remote_search_protocol.h"
+
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "../../src/board/full_board.h"
+#include "../test.h"
+
+namespace foolgo {
+
+class RemoteSearchProtocolTest : public Test {
+};
+
+TEST_F(RemoteSearchProtocolTest, RequestRoundTrip) {
+  SearchRequest request;
+  request.board_len = 9;
+  request.komi = 6.5f;
+  request.mc_game_count = 10000;
+  request.think_milliseconds = 250;
+  request.moves = {PositionIndex(40), POSITION_INDEX_PASS, PositionIndex(80)};
+
+  std::vector<uint8_t> message = EncodeSearchRequest(request);
+  SearchRequest decoded;
+  ASSERT_TRUE(DecodeSearchRequest(message, &decoded));
+  EXPECT_EQ(decoded.board_len, 9);
+  EXPECT_EQ(decoded.komi, 6.5f);
+  EXPECT_EQ(decoded.mc_game_count, 10000);
+  EXPECT_EQ(decoded.think_milliseconds, 250);
+  EXPECT_EQ(decoded.moves, request.moves);
+
+  message.pop_back();
+  EXPECT_FALSE(DecodeSearchRequest(message, &decoded));
+}
+
+TEST_F(RemoteSearchProtocolTest, ResponseRoundTrip) {
+  SearchResponse response;
+  response.playout_count = 1234;
+  response.root_child_stats = {{PositionIndex(3), 100, 0.25f},
+                               {PositionIndex(360), 7, 0.75f}};
+
+  std::vector<uint8_t> message = EncodeSearchResponse(response);
+  SearchResponse decoded;
+  ASSERT_TRUE(DecodeSearchResponse(message, &decoded));
+  EXPECT_EQ(decoded.playout_count, 1234);
+  ASSERT_EQ(decoded.root_child_stats.size(), 2u);
+  EXPECT_EQ(decoded.root_child_stats[1].position_index, 360);
+  EXPECT_EQ(decoded.root_child_stats[1].visited_time, 7);
+  EXPECT_EQ(decoded.root_child_stats[1].average_profit, 0.75f);
+
+  // A request is not a response.
+  EXPECT_FALSE(DecodeSearchResponse(
+      EncodeSearchRequest(SearchRequest()), &decoded));
+}
+
+}
@@ -0,0 +1,142 @@
+#include "../../src/player/search_server.h"
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include "board/full_board.h"
+#include "board/zob_hasher.h"
+#include "player/remote_search_client.h"
+#include "player/remote_search_protocol.h"
+#include "player/uct_player.h"
+#include "util/socket.h"
+#include "../def_for_test.h"
+#include "../test.h"
+
+namespace foolgo {
+
+class SearchServerTest : public Test {
+ protected:
+  static const std::size_t TABLE_MEMORY_BYTES = 1 << 20;
+
+  virtual void SetUp() {
+    Test::SetUp();
+    ZobHasher<DEFAULT_BOARD_LEN>::Init(SEED);
+    ASSERT_TRUE(server_socket_.Listen(0));
+  }
+
+  util::ServerSocket server_socket_;
+};
+
+TEST_F(SearchServerTest, Loopback) {
+  UctPlayer<DEFAULT_BOARD_LEN> worker_player(SEED, 100, 1, TABLE_MEMORY_BYTES);
+  SearchServer<DEFAULT_BOARD_LEN> server(&worker_player);
+  std::vector<SearchRequest> requests;
+  // Serves one connection, until the client closes it.
+  std::thread worker([this, &server, &requests]() {
+    std::unique_ptr<util::Socket> socket = server_socket_.Accept();
+    std::vector<uint8_t> message;
+    while (socket != nullptr && ReceiveMessage(socket.get(), &message)) {
+      SearchRequest request;
+      SearchResponse response;
+      if (!DecodeSearchRequest(message, &request)) {
+        break;
+      }
+      // Recorded before the response, which the client waits for.
+      requests.push_back(request);
+      if (!server.Search(request, &response)
+          || !SendMessage(EncodeSearchResponse(response), socket.get())) {
+        break;
+      }
+    }
+  });
+
+  {
+    RemoteSearchClient<DEFAULT_BOARD_LEN> client;
+    client.AddWorker("localhost", server_socket_.Port());
+    FullBoard<DEFAULT_BOARD_LEN> full_board;
+    full_board.Init();
+    // Black captures the white corner stone, and white passes.
+    const std::vector<PositionIndex> moves = {1, 0, 5, POSITION_INDEX_PASS};
+
+    for (std::size_t i = 0; i <= moves.size(); ++i) {
+      ASSERT_TRUE(client.StartSearch(full_board, 0.5f, 100, 0));
+      std::vector<SearchResponse> responses = client.FinishSearch();
+      ASSERT_EQ(responses.size(), 1u);
+      EXPECT_EQ(responses[0].playout_count, 100);
+      int32_t visited_time_sum = 0;
+      for (const RootChildStat &stat : responses[0].root_child_stats) {
+        visited_time_sum += stat.visited_time;
+      }
+      EXPECT_GT(visited_time_sum, 0);
+      if (i < moves.size()) {
+        Play(&full_board, moves[i]);
+      }
+    }
+
+    // The worker follows the moves the client told from the boards.
+    ASSERT_EQ(requests.size(), moves.size() + 1);
+    EXPECT_EQ(requests.back().moves, moves);
+    EXPECT_EQ(requests.back().komi, 0.5f);
+
+    // Two black stones at once can not be told apart, until the next game.
+    Play(&full_board, 10);
+    Play(&full_board, 11);
+    Play(&full_board, 12);
+    EXPECT_FALSE(client.StartSearch(full_board, 0.5f, 100, 0));
+    FullBoard<DEFAULT_BOARD_LEN> next_game_board;
+    next_game_board.Init();
+    EXPECT_TRUE(client.StartSearch(next_game_board, 0.5f, 100, 0));
+    EXPECT_EQ(client.FinishSearch().size(), 1u);
+    EXPECT_TRUE(requests.back().moves.empty());
+  }
+  worker.join();
+}
+
+TEST_F(SearchServerTest, InvalidRequest) {
+  UctPlayer<DEFAULT_BOARD_LEN> worker_player(SEED, 100, 1, TABLE_MEMORY_BYTES);
+  SearchServer<DEFAULT_BOARD_LEN> server(&worker_player);
+  SearchRequest request;
+  request.board_len = DEFAULT_BOARD_LEN;
+  request.komi = 0.5f;
+  request.mc_game_count = 100;
+  request.think_milliseconds = 0;
+  request.moves = {6, 6};
+  SearchResponse response;
+  EXPECT_FALSE(server.Search(request, &response));
+
+  request.moves = {6};
+  request.board_len = DEFAULT_BOARD_LEN + 2;
+  EXPECT_FALSE(server.Search(request, &response));
+}
+
+TEST_F(SearchServerTest, SilentWorkerDropped) {
+  // Receives the request and never responds.
+  std::promise<void> is_finished;
+  std::thread worker([this, &is_finished]() {
+    std::unique_ptr<util::Socket> socket = server_socket_.Accept();
+    std::vector<uint8_t> message;
+    if (socket != nullptr) {
+      ReceiveMessage(socket.get(), &message);
+    }
+    is_finished.get_future().wait();
+  });
+
+  RemoteSearchClient<DEFAULT_BOARD_LEN> client;
+  client.AddWorker("localhost", server_socket_.Port());
+  FullBoard<DEFAULT_BOARD_LEN> full_board;
+  full_board.Init();
+  ASSERT_TRUE(client.StartSearch(full_board, 0.5f, 100, 10));
+  auto start_time = std::chrono::steady_clock::now();
+  EXPECT_TRUE(client.FinishSearch().empty());
+  // The budget and the margin of 1 second pass.
+  EXPECT_LT(std::chrono::steady_clock::now() - start_time,
+            std::chrono::seconds(3));
+
+  is_finished.set_value();
+  worker.join();
+}
+
+}
@@ -0,0 +1,41 @@
+#include "../../src/player/search_stats.h"
+
+#include <gtest/gtest.h>
+#include <sstream>
+
+#include "../test.h"
+
+namespace foolgo {
+
+class SearchStatsTest : public Test {
+};
+
+TEST_F(SearchStatsTest, AddAndWriteJsonLine) {
+  SearchStats task_stats;
+  task_stats.playout_count = 3;
+  task_stats.AddDescent(1);
+  task_stats.AddDescent(3);
+  task_stats.AddDescent(3);
+
+  SearchStats stats;
+  stats.AddDescent(2);
+  stats.Add(task_stats);
+  stats.wall_seconds = 0.5;
+  stats.thread_playout_counts = {3, 0};
+
+  EXPECT_EQ(stats.descent_count, 4);
+  EXPECT_EQ(stats.max_depth, 3);
+  EXPECT_DOUBLE_EQ(stats.AverageDepth(), 2.25);
+  EXPECT_DOUBLE_EQ(stats.PlayoutsPerSecond(), 6.0);
+  EXPECT_EQ(stats.depth_histogram, std::vector<int64_t>({0, 1, 1, 2}));
+
+  std::ostringstream os;
+  JsonLineSink(&os)(stats);
+  std::string line = os.str();
+  EXPECT_EQ(line.find("{\"playout_count\":3,"), 0);
+  EXPECT_NE(line.find("\"depth_histogram\":[0,1,1,2],"
+                      "\"thread_playout_counts\":[3,0]}\n"),
+            std::string::npos);
+}
+
+}
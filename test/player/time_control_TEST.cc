@@ -0,0 +1,38 @@
+#include "../../src/player/time_control.h"
+
+#include <gtest/gtest.h>
+
+#include "../def_for_test.h"
+#include "../test.h"
+
+namespace foolgo {
+
+class TimeControlTest : public Test {
+};
+
+TEST_F(TimeControlTest, ThinkTime) {
+  typedef TimeControl::Duration Duration;
+  ZobHasher<DEFAULT_BOARD_LEN>::Init(SEED);
+  FullBoard<DEFAULT_BOARD_LEN> board;
+  board.Init();
+
+  // The time is divided among the twelve moves expected on 25 empty points.
+  TimeControl time_control(Duration(12000), Duration(100), Duration(5000));
+  EXPECT_EQ(ThinkTime(time_control, board).count(), 1000);
+  time_control.min_expected_move_count = 20;
+  EXPECT_EQ(ThinkTime(time_control, board).count(), 600);
+
+  time_control.max_think_time = Duration(500);
+  EXPECT_EQ(ThinkTime(time_control, board).count(), 500);
+
+  time_control.remaining_time = Duration(300);
+  EXPECT_EQ(ThinkTime(time_control, board).count(), 100);
+
+  // The margin of the clock is kept even against the minimum.
+  time_control.remaining_time = Duration(120);
+  EXPECT_EQ(ThinkTime(time_control, board).count(), 70);
+  time_control.remaining_time = Duration(10);
+  EXPECT_EQ(ThinkTime(time_control, board).count(), 0);
+}
+
+}
@@ -0,0 +1,213 @@
+#include "../../src/player/transposition_table.h"
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "board/full_board.h"
+#include "board/zob_hasher.h"
+#include "../def_for_test.h"
+#include "../test.h"
+
+namespace foolgo {
+
+class TranspositionTableTest : public Test {
+ protected:
+  virtual void SetUp() {
+    Test::SetUp();
+    ZobHasher<DEFAULT_BOARD_LEN>::Init(SEED);
+    full_board_.Init();
+  }
+
+  FullBoard<DEFAULT_BOARD_LEN> full_board_;
+};
+
+TEST_F(TranspositionTableTest, InsertAndGet) {
+  TranspositionTable<DEFAULT_BOARD_LEN> table(1 << 14);
+  EXPECT_EQ(table.Get(full_board_), nullptr);
+
+  NodeRecord *inserted = table.Insert(full_board_, NodeRecord(3, 0.5f));
+  ASSERT_NE(inserted, nullptr);
+  EXPECT_EQ(table.Get(full_board_), inserted);
+  EXPECT_EQ(inserted->GetVisitedTime(), 3);
+
+  NodeRecord *again = table.Insert(full_board_, NodeRecord(7, 0.1f));
+  EXPECT_EQ(again, inserted);
+  EXPECT_EQ(again->GetVisitedTime(), 3);
+}
+
+TEST_F(TranspositionTableTest, GetChild) {
+  TranspositionTable<DEFAULT_BOARD_LEN> table(1 << 14);
+  EXPECT_EQ(table.GetChild(full_board_, 0), nullptr);
+
+  FullBoard<DEFAULT_BOARD_LEN> child;
+  child.Copy(full_board_);
+  Play(&child, 0);
+  table.Insert(child, NodeRecord(1, 1.0f));
+  EXPECT_EQ(table.GetChild(full_board_, 0), table.Get(child));
+
+  NodeRecord *root = table.Insert(full_board_, NodeRecord(1, 0.0f));
+  ASSERT_TRUE(table.Expand(full_board_, root));
+  EXPECT_EQ(root->EdgeCount(), DEFAULT_BOARD_LEN * DEFAULT_BOARD_LEN);
+  EXPECT_EQ(table.GetChild(full_board_, 0), table.Get(child));
+  EXPECT_EQ(table.GetChild(full_board_, 1), nullptr);
+}
+
+TEST_F(TranspositionTableTest, ExpandWithExhaustedArena) {
+  TranspositionTable<DEFAULT_BOARD_LEN> table(0);
+  NodeRecord *root = table.Insert(full_board_, NodeRecord(1, 0.0f));
+  ASSERT_NE(root, nullptr);
+  EXPECT_FALSE(table.Expand(full_board_, root));
+  EXPECT_FALSE(root->IsExpanded(0));
+  EXPECT_EQ(table.Stats().failed_expansion_count, 1);
+}
+
+TEST_F(TranspositionTableTest, ExpandInPriorOrder) {
+  auto &calculator = PstionAndIndxCcltr<DEFAULT_BOARD_LEN>::Ins();
+  full_board_.PlayMove(Move(BLACK_FORCE, calculator.GetIndex(Position(1, 0))));
+  full_board_.PlayMove(Move(WHITE_FORCE, calculator.GetIndex(Position(0, 0))));
+
+  TranspositionTable<DEFAULT_BOARD_LEN> table(1 << 14);
+  NodeRecord *root = table.Insert(full_board_, NodeRecord(1, 0.0f));
+  ASSERT_TRUE(table.Expand(full_board_, root));
+  ChildEdge *edges = root->Edges();
+  // Capturing the white piece comes first.
+  EXPECT_EQ(edges[0].GetPositionIndex(), calculator.GetIndex(Position(0, 1)));
+
+  for (int i = 1; i < root->EdgeCount(); ++i) {
+    EXPECT_GE(edges[i - 1].GetPrior(), edges[i].GetPrior());
+  }
+}
+
+TEST_F(TranspositionTableTest, ExpandWithPolicy) {
+  std::vector<float> policy(BoardLenSquare<DEFAULT_BOARD_LEN>() + 1, 0.01f);
+  policy[7] = 0.5f;
+  policy[3] = 0.2f;
+
+  TranspositionTable<DEFAULT_BOARD_LEN> table(1 << 14);
+  NodeRecord *root = table.Insert(full_board_, NodeRecord(1, 0.0f));
+  EXPECT_FALSE(table.IsExpanded(*root));
+  ASSERT_TRUE(table.Expand(full_board_, root, &policy));
+  EXPECT_TRUE(table.IsExpanded(*root));
+  ChildEdge *edges = root->Edges();
+  EXPECT_EQ(edges[0].GetPositionIndex(), 7);
+  EXPECT_FLOAT_EQ(edges[0].GetPrior(), 0.5f);
+  EXPECT_EQ(edges[1].GetPositionIndex(), 3);
+  EXPECT_FLOAT_EQ(edges[2].GetPrior(), 0.01f);
+}
+
+TEST_F(TranspositionTableTest, ConcurrentInsert) {
+  TranspositionTable<DEFAULT_BOARD_LEN> table(1 << 16);
+  std::vector<NodeRecord *> results(4);
+  std::vector<std::thread> threads;
+
+  for (int i = 0; i < 4; ++i) {
+    threads.push_back(std::thread([this, &table, &results, i]() {
+      results.at(i) = table.Insert(full_board_, NodeRecord(i, 0.0f));
+    }));
+  }
+
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+
+  for (NodeRecord *result : results) {
+    EXPECT_EQ(result, results.at(0));
+  }
+}
+
+TEST_F(TranspositionTableTest, RetainSubtree) {
+  TranspositionTable<DEFAULT_BOARD_LEN> table(1 << 14);
+  FullBoard<DEFAULT_BOARD_LEN> child, grandchild, other;
+  child.Copy(full_board_);
+  Play(&child, 0);
+  grandchild.Copy(child);
+  Play(&grandchild, 1);
+  other.Copy(full_board_);
+  Play(&other, 2);
+
+  NodeRecord *root_record = table.Insert(full_board_, NodeRecord(2, 0.5f));
+  NodeRecord *child_record = table.Insert(child, NodeRecord(1, 0.5f));
+  table.Insert(grandchild, NodeRecord(1, 0.5f));
+  table.Insert(other, NodeRecord(1, 0.5f));
+  ASSERT_TRUE(table.Expand(full_board_, root_record));
+  ASSERT_TRUE(table.Expand(child, child_record));
+  int16_t child_edge_count = child_record->EdgeCount();
+
+  EXPECT_EQ(table.RetainSubtree(child), 2);
+  EXPECT_NE(table.Get(child), nullptr);
+  EXPECT_NE(table.Get(grandchild), nullptr);
+  // Only edges of the child are kept, and moved to the front of the arena.
+  EXPECT_EQ(child_record->EdgeCount(), child_edge_count);
+  EXPECT_EQ(table.Stats().edge_count, child_edge_count);
+  EXPECT_EQ(table.GetChild(child, 1), table.Get(grandchild));
+}
+
+TEST_F(TranspositionTableTest, FoldSymmetries) {
+  TranspositionTable<DEFAULT_BOARD_LEN> table(1 << 14);
+  table.SetFoldsSymmetries(true);
+  FullBoard<DEFAULT_BOARD_LEN> corner, opposite_corner;
+  corner.Copy(full_board_);
+  Play(&corner, 0);
+  opposite_corner.Copy(full_board_);
+  Play(&opposite_corner, BoardLenSquare<DEFAULT_BOARD_LEN>() - 1);
+
+  NodeRecord *root_record = table.Insert(full_board_, NodeRecord(1, 0.5f));
+  NodeRecord *corner_record = table.Insert(corner, NodeRecord(1, 0.5f));
+  EXPECT_EQ(table.Get(opposite_corner), corner_record);
+
+  // Edges of symmetric children lead to the same record.
+  ASSERT_TRUE(table.Expand(full_board_, root_record));
+  EXPECT_EQ(root_record->EdgeCount(), BoardLenSquare<DEFAULT_BOARD_LEN>());
+  EXPECT_EQ(table.GetChild(full_board_, 0), corner_record);
+  EXPECT_EQ(table.GetChild(full_board_, DEFAULT_BOARD_LEN - 1),
+            corner_record);
+
+  // Edges of a record expanded from a board are found from its symmetric
+  // boards by their own position indexes.
+  ASSERT_TRUE(table.Expand(corner, corner_record));
+  FullBoard<DEFAULT_BOARD_LEN> grandchild;
+  grandchild.Copy(opposite_corner);
+  Play(&grandchild, 1);
+  NodeRecord *grandchild_record = table.Insert(grandchild,
+                                               NodeRecord(1, 0.5f));
+  EXPECT_EQ(table.GetChild(opposite_corner, 1), grandchild_record);
+}
+
+TEST_F(TranspositionTableTest, ReplaceOlderGeneration) {
+  // The smallest table, which has only one bucket.
+  TranspositionTable<DEFAULT_BOARD_LEN> table(0);
+  std::size_t capacity = table.Capacity();
+  std::vector<std::unique_ptr<FullBoard<DEFAULT_BOARD_LEN>>> boards;
+
+  for (std::size_t i = 0; i <= capacity; ++i) {
+    boards.push_back(std::unique_ptr<FullBoard<DEFAULT_BOARD_LEN>>(
+        new FullBoard<DEFAULT_BOARD_LEN>));
+    boards.back()->Copy(full_board_);
+    Play(boards.back().get(), i);
+  }
+
+  for (std::size_t i = 0; i < capacity; ++i) {
+    EXPECT_NE(table.Insert(*boards.at(i), NodeRecord(i + 1, 0.5f)),
+              nullptr);
+  }
+  EXPECT_EQ(table.Insert(*boards.at(capacity), NodeRecord(1, 0.5f)),
+            nullptr);
+  EXPECT_EQ(table.Stats().failed_insertion_count, 1);
+
+  table.RetainSubtree(full_board_);
+  NodeRecord *inserted = table.Insert(*boards.at(capacity),
+                                      NodeRecord(1, 0.5f));
+  ASSERT_NE(inserted, nullptr);
+  EXPECT_EQ(table.Get(*boards.at(capacity)), inserted);
+  // The least visited record is replaced.
+  EXPECT_EQ(table.Get(*boards.at(0)), nullptr);
+  EXPECT_NE(table.Get(*boards.at(1)), nullptr);
+
+  TranspositionTableStats stats = table.Stats();
+  EXPECT_EQ(stats.occupied_count, capacity);
+  EXPECT_EQ(stats.eviction_count, 1);
+}
+
+}
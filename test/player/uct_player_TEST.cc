@@ -0,0 +1,212 @@
+#include "../../src/player/uct_player.h"
+
+#include <gtest/gtest.h>
+#include <array>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "board/full_board.h"
+#include "board/symmetry.h"
+#include "board/zob_hasher.h"
+#include "player/transposition_table.h"
+#include "util/thread_pool.h"
+#include "../def_for_test.h"
+#include "../test.h"
+
+namespace foolgo {
+
+class UctPlayerTest : public Test {
+ protected:
+  static const std::size_t TABLE_MEMORY_BYTES = 1 << 20;
+
+  virtual void SetUp() {
+    Test::SetUp();
+    ZobHasher<DEFAULT_BOARD_LEN>::Init(SEED);
+    full_board_.Init();
+  }
+
+  int32_t RootChildVisitedTimeSum(
+      const UctPlayer<DEFAULT_BOARD_LEN> &player) const {
+    int32_t visited_time_sum = 0;
+    for (const RootChildStat &stat : player.RootChildStats(full_board_)) {
+      visited_time_sum += stat.visited_time;
+    }
+    return visited_time_sum;
+  }
+
+  FullBoard<DEFAULT_BOARD_LEN> full_board_;
+};
+
+TEST_F(UctPlayerTest, LeafPlayouts) {
+  UctPlayer<DEFAULT_BOARD_LEN> player(SEED, 400, 1, TABLE_MEMORY_BYTES);
+  player.SetLeafPlayoutCount(4);
+  player.NextMove(full_board_);
+
+  const SearchStats &stats = player.LastSearchStats();
+  EXPECT_EQ(stats.playout_count, 400);
+  EXPECT_EQ(stats.descent_count * 4, 400);
+  // The first descent evaluates the root itself.
+  EXPECT_EQ(RootChildVisitedTimeSum(player), 400 - 4);
+
+  // Each descent adds its playouts as 4 visits of their average, so that
+  // the profit sums stay whole counts of wins, for komi rules out draws.
+  for (const RootChildStat &stat : player.RootChildStats(full_board_)) {
+    EXPECT_EQ(stat.visited_time % 4, 0);
+    EXPECT_GE(stat.average_profit, 0.0f);
+    EXPECT_LE(stat.average_profit, 1.0f);
+    float win_count = stat.average_profit * stat.visited_time;
+    EXPECT_NEAR(win_count, std::round(win_count), 1e-3);
+  }
+}
+
+TEST_F(UctPlayerTest, RootParallelSumsTables) {
+  UctPlayer<DEFAULT_BOARD_LEN> player(SEED, 400, 2, TABLE_MEMORY_BYTES,
+                                      ParallelMode::ROOT);
+  PositionIndex index = player.NextMove(full_board_);
+
+  // Each table runs half of the playouts, the first of which is of the root.
+  EXPECT_EQ(player.LastSearchStats().playout_count, 400);
+  EXPECT_EQ(RootChildVisitedTimeSum(player), 400 - 2);
+
+  // The move is the most visited child of the summed visits.
+  int32_t max_visited_time = -1;
+  PositionIndex most_visited_index = POSITION_INDEX_PASS;
+  for (const RootChildStat &stat : player.RootChildStats(full_board_)) {
+    if (stat.visited_time > max_visited_time) {
+      max_visited_time = stat.visited_time;
+      most_visited_index = stat.position_index;
+    }
+  }
+  EXPECT_EQ(index, most_visited_index);
+}
+
+TEST_F(UctPlayerTest, RootTasksSearchTheirOwnTables) {
+  UctPlayer<DEFAULT_BOARD_LEN> player(SEED, 200, 2, TABLE_MEMORY_BYTES,
+                                      ParallelMode::ROOT);
+  // One worker runs both tasks, which still search both tables.
+  player.SetThreadPool(std::make_shared<util::ThreadPool>(1));
+  player.NextMove(full_board_);
+
+  // The first playout of each table is of the root itself.
+  EXPECT_EQ(player.LastSearchStats().playout_count, 200);
+  EXPECT_EQ(RootChildVisitedTimeSum(player), 200 - 2);
+}
+
+TEST_F(UctPlayerTest, SearchesOnCallingThread) {
+  UctPlayer<DEFAULT_BOARD_LEN> player(SEED, 200, 2, TABLE_MEMORY_BYTES,
+                                      ParallelMode::ROOT);
+  player.SetThreadPool(nullptr);
+  player.NextMove(full_board_);
+
+  // Both tasks run in turn as worker 0.
+  EXPECT_EQ(player.LastSearchStats().playout_count, 200);
+  EXPECT_EQ(player.LastSearchStats().thread_playout_counts,
+            std::vector<int64_t>({200}));
+  EXPECT_EQ(RootChildVisitedTimeSum(player), 200 - 2);
+}
+
+TEST_F(UctPlayerTest, AddRaveProfits) {
+  TranspositionTable<DEFAULT_BOARD_LEN> table(1 << 14);
+  NodeRecord *root = table.Insert(full_board_, NodeRecord(1, 0.0f));
+  ASSERT_TRUE(table.Expand(full_board_, root));
+  std::array<int32_t, BoardLenSquare<DEFAULT_BOARD_LEN>()> visited_times;
+  std::array<float, BoardLenSquare<DEFAULT_BOARD_LEN>()> profit_sums;
+  visited_times.fill(0);
+  profit_sums.fill(0.0f);
+  visited_times[3] = 2;
+  profit_sums[3] = 1.5f;
+  visited_times[7] = 1;
+
+  // Every sibling whose point the force played first in the playouts gets
+  // them, where edges are moved by the symmetry.
+  const int edge_symmetry = 1;
+  AddRaveProfits<DEFAULT_BOARD_LEN>(visited_times, profit_sums, edge_symmetry,
+                                    *root);
+  ChildEdge *edges = root->Edges();
+  for (int i = 0; i < root->EdgeCount(); ++i) {
+    PositionIndex index = SymmetricIndex<DEFAULT_BOARD_LEN>(
+        InverseSymmetry(edge_symmetry), edges[i].GetPositionIndex());
+    EXPECT_EQ(edges[i].GetRaveVisitedTime(), visited_times[index]);
+    if (index == 3) {
+      EXPECT_FLOAT_EQ(edges[i].GetRaveAverageProfit(), 0.75f);
+    }
+    EXPECT_EQ(edges[i].GetVisitedTime(), 0);
+  }
+}
+
+TEST_F(UctPlayerTest, UcbBlendsRaveProfit) {
+  ChildEdge child_edge(0, 0);
+  child_edge.AddProfit(0.25f, 3);
+  child_edge.AddRaveProfit(6.0f, 8);
+  float exploration = std::sqrt(2 * std::log(12.0f) / 3);
+
+  // Nothing is blended without the equivalence.
+  EXPECT_FLOAT_EQ(Ucb(child_edge, 12, 0.0f), 0.25f + exploration);
+
+  // At 3 visits, the weight of the RAVE profit is sqrt(k / (3 * 3 + k)).
+  const float rave_equivalence = 9.0f;
+  float beta = std::sqrt(rave_equivalence / (3 * 3 + rave_equivalence));
+  EXPECT_FLOAT_EQ(Ucb(child_edge, 12, rave_equivalence),
+                  (1 - beta) * 0.25f + beta * 0.75f + exploration);
+  EXPECT_LT(Ucb(child_edge, 12, rave_equivalence),
+            Ucb(child_edge, 12, 4 * rave_equivalence));
+}
+
+namespace {
+
+// A network putting the whole policy on one point, and valuing every board
+// the same for the force to move.
+Evaluation OneHotEvaluation(PositionIndex index, float value) {
+  Evaluation evaluation;
+  evaluation.policy.assign(BoardLenSquare<DEFAULT_BOARD_LEN>() + 1, 0.0f);
+  evaluation.policy[index] = 1.0f;
+  evaluation.value = value;
+  return evaluation;
+}
+
+}
+
+TEST_F(UctPlayerTest, PuctFollowsPrior) {
+  const PositionIndex prior_index = 12;
+  UctPlayer<DEFAULT_BOARD_LEN> player(SEED, 100, 1, TABLE_MEMORY_BYTES);
+  player.SetNetworkEvaluator(
+      [=](const FullBoard<DEFAULT_BOARD_LEN>&) {
+        return OneHotEvaluation(prior_index, 0.5f);
+      }, 1 << 10);
+  EXPECT_EQ(player.NextMove(full_board_), prior_index);
+
+  // Children of no prior are never chosen, for every value is even.
+  for (const RootChildStat &stat : player.RootChildStats(full_board_)) {
+    EXPECT_EQ(stat.visited_time, stat.position_index == prior_index ?
+        100 - 1 : 0);
+  }
+  // Leaves are valued by the network alone, so no playout runs.
+  EXPECT_EQ(player.LastSearchStats().playout_count, 100);
+  EXPECT_GT(player.LastSearchStats().network_evaluation_count, 0);
+}
+
+TEST_F(UctPlayerTest, PuctBacksValueUp) {
+  const PositionIndex prior_index = 6;
+  UctPlayer<DEFAULT_BOARD_LEN> player(SEED, 2, 1, TABLE_MEMORY_BYTES);
+  player.SetNetworkEvaluator(
+      [=](const FullBoard<DEFAULT_BOARD_LEN>&) {
+        return OneHotEvaluation(prior_index, 0.3f);
+      }, 1 << 10);
+  player.NextMove(full_board_);
+
+  // The value is of white to move at the child, so black gains the rest.
+  for (const RootChildStat &stat : player.RootChildStats(full_board_)) {
+    if (stat.position_index == prior_index) {
+      EXPECT_EQ(stat.visited_time, 1);
+      EXPECT_FLOAT_EQ(stat.average_profit, 1.0f - 0.3f);
+    } else {
+      EXPECT_EQ(stat.visited_time, 0);
+    }
+  }
+  // The root is evaluated once, its policy taken from the cache.
+  EXPECT_EQ(player.LastSearchStats().network_evaluation_count, 2);
+  EXPECT_EQ(player.LastSearchStats().evaluation_cache_hit_count, 1);
+}
+
+}
@@ -0,0 +1,54 @@
+#include "../../src/util/bitset_util.h"
+
+#include <gtest/gtest.h>
+#include <bitset>
+#include <vector>
+
+#include "util/rand.h"
+#include "../def_for_test.h"
+#include "../test.h"
+
+namespace foolgo {
+
+class BitSetUtilTest : public Test {
+ protected:
+  // Longer than two words, as the bitset of a 19x19 board.
+  static const int LEN = 361;
+
+  virtual void SetUp() {
+    Test::SetUp();
+    RandomEngine random_engine(SEED);
+    for (int i = 0; i < LEN; ++i) {
+      if (random_engine.Uniform(3) == 0) {
+        bitset_.set(i);
+        ones_.push_back(i);
+      }
+    }
+  }
+
+  std::bitset<LEN> bitset_;
+  std::vector<PositionIndex> ones_;
+};
+
+TEST_F(BitSetUtilTest, GetOnePositionIndexes) {
+  EXPECT_EQ(util::GetOnePositionIndexes<LEN>(bitset_), ones_);
+  EXPECT_TRUE(util::GetOnePositionIndexes<LEN>(std::bitset<LEN>()).empty());
+}
+
+TEST_F(BitSetUtilTest, CalSpecifiedOneOccurrenceTimeIndex) {
+  for (int i = 0; i < ones_.size(); ++i) {
+    EXPECT_EQ(util::CalSpecifiedOneOccurrenceTimeIndex<LEN>(bitset_, i),
+              ones_.at(i));
+  }
+  EXPECT_EQ(util::GetLowestOne<LEN>(bitset_), ones_.front());
+}
+
+TEST_F(BitSetUtilTest, LastBit) {
+  std::bitset<LEN> b;
+  b.set(LEN - 1);
+  EXPECT_EQ(util::GetLowestOne<LEN>(b), LEN - 1);
+  EXPECT_EQ(util::GetOnePositionIndexes<LEN>(b),
+            std::vector<PositionIndex>(1, LEN - 1));
+}
+
+}
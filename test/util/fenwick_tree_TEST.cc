@@ -0,0 +1,37 @@
+#include "../../src/util/fenwick_tree.h"
+
+#include <gtest/gtest.h>
+
+#include "../test.h"
+
+namespace foolgo {
+namespace util {
+
+class FenwickTreeTest : public Test {
+};
+
+TEST_F(FenwickTreeTest, FindByWeights) {
+  const int weights[7] = { 2, 0, 3, 1, 0, 0, 4 };
+  FenwickTree<int, 7> tree;
+  tree.Build(weights);
+  EXPECT_EQ(tree.Total(), 10);
+
+  // Each item is found by as many targets as its weight.
+  int found_counts[7] = { 0 };
+  for (int target = 0; target < tree.Total(); ++target) {
+    ++found_counts[tree.Find(target)];
+  }
+  for (int i = 0; i < 7; ++i) {
+    EXPECT_EQ(found_counts[i], weights[i]);
+  }
+
+  tree.Add(0, -2);
+  tree.Add(5, 1);
+  EXPECT_EQ(tree.Total(), 9);
+  EXPECT_EQ(tree.Find(0), 2);
+  EXPECT_EQ(tree.Find(4), 5);
+  EXPECT_EQ(tree.Find(8), 6);
+}
+
+}
+}
@@ -0,0 +1,72 @@
+#include "../../src/util/fixed_vector.h"
+
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <vector>
+
+#include "../test.h"
+
+namespace foolgo {
+namespace util {
+
+class FixedVectorTest : public Test {
+};
+
+TEST_F(FixedVectorTest, PushAndPop) {
+  FixedVector<int, 4> vector;
+  EXPECT_TRUE(vector.empty());
+  EXPECT_EQ(vector.capacity(), 4u);
+
+  for (int i = 0; i < 4; ++i) {
+    vector.push_back(i * 10);
+    EXPECT_EQ(vector.size(), static_cast<std::size_t>(i + 1));
+    EXPECT_EQ(vector.back(), i * 10);
+  }
+  EXPECT_EQ(vector[2], 20);
+
+  vector.pop_back();
+  EXPECT_EQ(vector.size(), 3u);
+  EXPECT_EQ(vector.back(), 20);
+  // The freed slot is reused.
+  vector.push_back(7);
+  EXPECT_EQ(vector.back(), 7);
+
+  vector.clear();
+  EXPECT_TRUE(vector.empty());
+  EXPECT_EQ(vector.begin(), vector.end());
+}
+
+TEST_F(FixedVectorTest, IterateAndCopy) {
+  FixedVector<int, 8> vector;
+  vector.Append(std::vector<int>{3, 1, 4, 1, 5});
+
+  std::vector<int> values(vector.begin(), vector.end());
+  EXPECT_EQ(values, std::vector<int>({3, 1, 4, 1, 5}));
+  for (int &value : vector) {
+    value *= 2;
+  }
+
+  // Copies take only the elements within the size.
+  FixedVector<int, 8> copy(vector);
+  vector.resize(2);
+  copy = vector;
+  ASSERT_EQ(copy.size(), 2u);
+  EXPECT_EQ(copy[0], 6);
+  EXPECT_EQ(copy[1], 2);
+}
+
+#ifndef NDEBUG
+TEST_F(FixedVectorTest, OverflowAsserts) {
+  FixedVector<int, 2> vector;
+  vector.push_back(1);
+  vector.push_back(2);
+  EXPECT_DEATH(vector.push_back(3), "");
+  EXPECT_DEATH(vector.resize(3), "");
+
+  vector.clear();
+  EXPECT_DEATH(vector.pop_back(), "");
+}
+#endif
+
+}
+}
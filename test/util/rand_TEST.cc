@@ -0,0 +1,43 @@
+#include "../../src/util/rand.h"
+
+#include <gtest/gtest.h>
+
+#include "../def_for_test.h"
+#include "../test.h"
+
+namespace foolgo {
+
+class RandomEngineTest : public Test {
+};
+
+TEST_F(RandomEngineTest, Reproducible) {
+  RandomEngine a(SEED), b(SEED);
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(a(), b());
+  }
+}
+
+TEST_F(RandomEngineTest, StreamsDiffer) {
+  RandomEngine a(SEED, 0), b(SEED, 1);
+  int equal_count = 0;
+  for (int i = 0; i < 100; ++i) {
+    equal_count += a() == b();
+  }
+  EXPECT_EQ(equal_count, 0);
+}
+
+TEST_F(RandomEngineTest, Uniform) {
+  RandomEngine engine(SEED);
+  int counts[3] = {0};
+  for (int i = 0; i < 3000; ++i) {
+    uint32_t value = engine.Uniform(2);
+    ASSERT_LE(value, 2);
+    ++counts[value];
+  }
+  for (int count : counts) {
+    EXPECT_GT(count, 800);
+  }
+  EXPECT_EQ(engine.Uniform(0), 0);
+}
+
+}
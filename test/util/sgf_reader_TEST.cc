@@ -0,0 +1,59 @@
+#include "../../src/util/sgf_reader.h"
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include "../../src/board/full_board.h"
+#include "../../src/util/thread_pool.h"
+#include "../test.h"
+
+namespace foolgo {
+
+class SgfReaderTest : public Test {
+ protected:
+  std::vector<GameInfo> Read(const SgfReader &sgf_reader,
+                             const std::string &sgf) {
+    std::vector<GameInfo> game_infos;
+    sgf_reader.Read(sgf.data(), sgf.data() + sgf.size(),
+        [&game_infos](const GameInfo &game_info) {
+          game_infos.push_back(game_info);
+        });
+    return game_infos;
+  }
+};
+
+TEST_F(SgfReaderTest, Read) {
+  // A comment with brackets and parentheses, a variation, a game off the
+  // board, a property of FF[3] and a game missing its closing parenthesis.
+  std::string sgf =
+      "(;GM[1]C[a (comment\\] ;B[aa]]RE[W+R]AB[cc][dd];B[pd];W[]\n"
+      "(;B[tt];W[ab])(;B[qq]))\n"
+      "(;B[zz])\n"
+      "(;PlayerBlack[x]RE[B+3.5];B[sa]";
+  util::ThreadPool thread_pool(2);
+  SgfReader serial_reader;
+  SgfReader parallel_reader(&thread_pool, 1);
+  for (const SgfReader *sgf_reader : {&serial_reader, &parallel_reader}) {
+    std::vector<GameInfo> game_infos = Read(*sgf_reader, sgf);
+    ASSERT_EQ(game_infos.size(), 2u);
+
+    const GameInfo &first = game_infos[0];
+    ASSERT_EQ(first.moves.size(), 4u);
+    EXPECT_EQ(first.moves[0].force, Force::BLACK_FORCE);
+    EXPECT_EQ(first.moves[0].position_index, 3 * 19 + 15);
+    EXPECT_EQ(first.moves[1].force, Force::WHITE_FORCE);
+    EXPECT_EQ(first.moves[1].position_index, POSITION_INDEX_PASS);
+    EXPECT_EQ(first.moves[2].position_index, POSITION_INDEX_PASS);
+    EXPECT_EQ(first.moves[3].position_index, 1 * 19 + 0);
+    EXPECT_TRUE(first.has_winner);
+    EXPECT_EQ(first.winner, Force::WHITE_FORCE);
+
+    const GameInfo &last = game_infos[1];
+    ASSERT_EQ(last.moves.size(), 1u);
+    EXPECT_EQ(last.moves[0].position_index, 18);
+    EXPECT_EQ(last.winner, Force::BLACK_FORCE);
+  }
+}
+
+}
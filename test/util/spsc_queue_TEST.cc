@@ -0,0 +1,55 @@
+#include "../../src/util/spsc_queue.h"
+
+#include <gtest/gtest.h>
+#include <thread>
+
+#include "../test.h"
+
+namespace foolgo {
+namespace util {
+
+class SpscQueueTest : public Test {
+};
+
+TEST_F(SpscQueueTest, PushAndPop) {
+  SpscQueue<int> queue(2);
+  int value;
+  EXPECT_FALSE(queue.TryPop(&value));
+  EXPECT_TRUE(queue.TryPush(1));
+  EXPECT_TRUE(queue.TryPush(2));
+  EXPECT_FALSE(queue.TryPush(3));
+  ASSERT_TRUE(queue.TryPop(&value));
+  EXPECT_EQ(value, 1);
+  EXPECT_TRUE(queue.TryPush(3));
+  ASSERT_TRUE(queue.TryPop(&value));
+  EXPECT_EQ(value, 2);
+  ASSERT_TRUE(queue.TryPop(&value));
+  EXPECT_EQ(value, 3);
+  EXPECT_FALSE(queue.TryPop(&value));
+}
+
+TEST_F(SpscQueueTest, KeepsOrderAcrossThreads) {
+  const int VALUE_COUNT = 100000;
+  SpscQueue<int> queue(16);
+  std::thread producer([&queue]() {
+    for (int i = 0; i < VALUE_COUNT; ++i) {
+      while (!queue.TryPush(int(i))) {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  bool is_in_order = true;
+  for (int i = 0; i < VALUE_COUNT; ++i) {
+    int value;
+    while (!queue.TryPop(&value)) {
+      std::this_thread::yield();
+    }
+    is_in_order = is_in_order && value == i;
+  }
+  producer.join();
+  EXPECT_TRUE(is_in_order);
+}
+
+}
+}
@@ -0,0 +1,79 @@
+#include "../../src/util/thread_pool.h"
+
+#include <gtest/gtest.h>
+#include <atomic>
+
+#include "../test.h"
+
+namespace foolgo {
+namespace util {
+
+class ThreadPoolTest : public Test {
+};
+
+TEST_F(ThreadPoolTest, WaitForAllTasks) {
+  const int THREAD_COUNT = 4;
+  ThreadPool thread_pool(THREAD_COUNT);
+  std::atomic<int> finished_count(0);
+  std::atomic<bool> is_index_valid(true);
+
+  // The pool is reused after each wait.
+  for (int round = 1; round <= 3; ++round) {
+    for (int i = 0; i < 100; ++i) {
+      thread_pool.Submit([&](int worker_index) {
+        if (worker_index < 0 || worker_index >= THREAD_COUNT) {
+          is_index_valid = false;
+        }
+        ++finished_count;
+      });
+    }
+    thread_pool.Wait();
+    EXPECT_EQ(finished_count, round * 100);
+  }
+
+  EXPECT_TRUE(is_index_valid);
+}
+
+TEST_F(ThreadPoolTest, StealTasks) {
+  ThreadPool thread_pool(2);
+  std::atomic<int> finished_count(0);
+  std::atomic<bool> is_blocking(true);
+
+  // While the first worker is blocked, tasks submitted to it are stolen.
+  thread_pool.Submit(0, [&](int worker_index) {
+    while (is_blocking) {
+      std::this_thread::yield();
+    }
+  });
+  for (int i = 0; i < 10; ++i) {
+    thread_pool.Submit(0, [&](int worker_index) {
+      ++finished_count;
+    });
+  }
+  while (finished_count < 10) {
+    std::this_thread::yield();
+  }
+
+  is_blocking = false;
+  thread_pool.Wait();
+  EXPECT_EQ(finished_count, 10);
+}
+
+TEST_F(ThreadPoolTest, PinWorkers) {
+  ThreadPool thread_pool(2, ThreadAffinity::CPU);
+  std::atomic<int> finished_count(0);
+
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_GE(thread_pool.WorkerNumaNode(i), 0);
+    EXPECT_LT(thread_pool.WorkerNumaNode(i), NumaNodeCount());
+    thread_pool.Submit(i, [&](int worker_index) {
+      ++finished_count;
+    });
+  }
+  thread_pool.Wait();
+  EXPECT_EQ(finished_count, 2);
+  EXPECT_EQ(ThreadPool(1).WorkerNumaNode(0), ANY_NUMA_NODE);
+}
+
+}
+}
@@ -0,0 +1,73 @@
+#include "../../src/util/trace.h"
+
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "../test.h"
+
+namespace foolgo {
+namespace util {
+
+class TraceTest : public Test {
+ protected:
+  virtual void SetUp() {
+    Test::SetUp();
+    ClearTrace();
+  }
+};
+
+namespace {
+
+int CountOccurrences(const std::string &s, const std::string &part) {
+  int count = 0;
+  for (std::size_t i = s.find(part); i != std::string::npos;
+      i = s.find(part, i + 1)) {
+    ++count;
+  }
+  return count;
+}
+
+}
+
+TEST_F(TraceTest, WriteChromeTrace) {
+  {
+    TraceScope scope("scope");
+  }
+  RecordTraceCounter("counter", 7);
+  std::thread thread([]() {
+    RecordTraceEvent("other \"thread\"", 1000, 2500);
+  });
+  thread.join();
+
+  std::ostringstream os;
+  WriteChromeTrace(os);
+  std::string trace = os.str();
+  EXPECT_EQ(trace.find("{\"traceEvents\":["), 0);
+  EXPECT_EQ(CountOccurrences(trace, "\"name\":\"scope\""), 1);
+  EXPECT_NE(trace.find("\"name\":\"counter\""), std::string::npos);
+  EXPECT_NE(trace.find("\"ph\":\"C\",\"args\":{\"value\":7}"),
+            std::string::npos);
+  EXPECT_NE(trace.find("\"name\":\"other \\\"thread\\\"\""),
+            std::string::npos);
+  EXPECT_NE(trace.find("\"ts\":1.000,\"ph\":\"X\",\"dur\":2.500"),
+            std::string::npos);
+}
+
+TEST_F(TraceTest, KeepLatestEvents) {
+  for (std::size_t i = 0; i < TRACE_EVENT_COUNT_PER_THREAD; ++i) {
+    RecordTraceEvent("old", 0, 0);
+  }
+  RecordTraceEvent("new", 0, 0);
+
+  std::ostringstream os;
+  WriteChromeTrace(os);
+  std::string trace = os.str();
+  EXPECT_EQ(CountOccurrences(trace, "\"name\":\"old\""),
+            TRACE_EVENT_COUNT_PER_THREAD - 1);
+  EXPECT_EQ(CountOccurrences(trace, "\"name\":\"new\""), 1);
+}
+
+}
+}